@@ -36,6 +36,7 @@
 // #define DEBUG_FILE_STREAM_SESSIONS
 // #define DEBUG_FILE_STREAM_SESSION_MATCHING
 // #define DEBUG_RAW_CMD_FRAME
+// #define DEBUG_DEVICE_CMD_BINARY
 // #define DEBUG_SLOW_PROC_ENDPOINT_MESSAGE_DETAIL
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -203,6 +204,22 @@ bool ProtocolExchange::processEndpointMsg(CommsChannelMsg &cmdMsg)
     {
         // Not implemented as ROSSERIAL is unused in this direction
     }
+    else if ((protocol == MSG_PROTOCOL_RICREST) && (cmdMsg.getBufLen() > RICREST_ELEM_CODE_POS) &&
+                (cmdMsg.getBuf()[RICREST_ELEM_CODE_POS] == RICRESTMsg::RICREST_ELEM_CODE_DEVICE_CMD_BINARY))
+    {
+        // Binary device command - no response unless the command fails (commands may be streamed at a high rate)
+        RaftRetCode retc = processDeviceCmdBinary(cmdMsg.getBuf(), cmdMsg.getBufLen());
+        rslt = retc == RAFT_OK;
+        if (!rslt)
+        {
+            String respMsg;
+            Raft::setJsonErrorResult("devCmdBin", respMsg, Raft::getRetCodeStr(retc));
+            CommsChannelMsg endpointMsg;
+            RICRESTMsg::encode(respMsg, endpointMsg, RICRESTMsg::RICREST_ELEM_CODE_CMDRESPJSON);
+            endpointMsg.setAsResponse(cmdMsg);
+            getCommsCore()->outboundHandleMsg(endpointMsg);
+        }
+    }
     else if (protocol == MSG_PROTOCOL_RICREST)
     {
         // Extract request msg
@@ -247,6 +264,11 @@ bool ProtocolExchange::processEndpointMsg(CommsChannelMsg &cmdMsg)
                 rslt = processRICRESTFileStreamBlock(ricRESTReqMsg, respMsg, cmdMsg) == RAFT_OK;;
                 break;
             }
+            case RICRESTMsg::RICREST_ELEM_CODE_DEVICE_CMD_BINARY:
+            {
+                // Handled before decoding
+                break;
+            }
         }
 
         // Check for response
@@ -397,6 +419,29 @@ RaftRetCode ProtocolExchange::processRICRESTCmdRespJSON(RICRESTMsg& ricRESTReqMs
     return RAFT_NOT_IMPLEMENTED;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Process binary device command
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+RaftRetCode ProtocolExchange::processDeviceCmdBinary(const uint8_t* pMsg, uint32_t msgLen)
+{
+    // Decode in place
+    uint32_t busNum = 0, address = 0, formatCode = 0, payloadLen = 0;
+    const uint8_t* pPayload = nullptr;
+    if (!RICRESTMsg::decodeDeviceCmdBinary(pMsg, msgLen, busNum, address, formatCode, pPayload, payloadLen))
+        return RAFT_INVALID_DATA;
+
+#ifdef DEBUG_DEVICE_CMD_BINARY
+    LOG_I(MODULE_PREFIX, "processDeviceCmdBinary bus %d addr 0x%x formatCode %d payloadLen %d", 
+                busNum, address, formatCode, payloadLen);
+#endif
+
+    // Route to device
+    if (!_deviceCmdBinaryHookFn)
+        return RAFT_NOT_IMPLEMENTED;
+    return _deviceCmdBinaryHookFn(busNum, address, formatCode, pPayload, payloadLen);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Process RICRESTMsg CmdFrame
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -17,6 +17,7 @@
 #include "FileStreamBase.h"
 #include "FileStreamSession.h"
 #include "FileStreamActivityHookFnType.h"
+#include "DeviceCmdBinaryHookFnType.h"
 
 class APISourceInfo;
 
@@ -32,6 +33,12 @@ public:
         _fileStreamActivityHookFn = fileStreamActivityHookFn;
     }
 
+    // Set binary device command hook function (fast path for device commands which bypasses REST/JSON)
+    void setDeviceCmdBinaryHook(DeviceCmdBinaryHookFnType deviceCmdBinaryHookFn)
+    {
+        _deviceCmdBinaryHookFn = deviceCmdBinaryHookFn;
+    }
+
     // Set firmware update handler
     void setFWUpdateHandler(RaftSysMod* pFirmwareUpdater)
     {
@@ -43,6 +50,9 @@ public:
             const APISourceInfo& sourceInfo, FileStreamBase::FileStreamContentType fileStreamContentType,
             const char* restAPIEndpointName);
 
+    // Binary device command - routed directly to the device by numeric ID and format code
+    RaftRetCode processDeviceCmdBinary(const uint8_t* pMsg, uint32_t msgLen);
+
 protected:
     // Loop - called frequently
     virtual void loop() override final;
@@ -93,6 +103,9 @@ private:
     // File stream activity hook fn
     FileStreamActivityHookFnType _fileStreamActivityHookFn = nullptr;
 
+    // Binary device command hook fn
+    DeviceCmdBinaryHookFnType _deviceCmdBinaryHookFn = nullptr;
+
     // Debug
     void debugEndpointMessage(const CommsChannelMsg& msg);
     void debugRICRESTMessage(const CommsChannelMsg &cmdMsg, const RICRESTMsg& ricRESTReqMsg);
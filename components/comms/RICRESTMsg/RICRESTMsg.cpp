@@ -155,6 +155,15 @@ bool RICRESTMsg::decode(const uint8_t* pBuf, uint32_t len)
             _req = "ufBlock";
             break;
         }
+        case RICREST_ELEM_CODE_DEVICE_CMD_BINARY:
+        {
+            // Normally handled without decoding into a RICRESTMsg - see decodeDeviceCmdBinary()
+            if (len < RICREST_DEVICE_CMD_PAYLOAD_POS)
+                return false;
+            _binaryData.assign(pBuf + RICREST_DEVICE_CMD_PAYLOAD_POS, pBuf + len);
+            _req = "devCmdBin";
+            break;
+        }
         default:
         {
             _binaryData.clear();
@@ -206,6 +215,40 @@ void RICRESTMsg::encodeFileBlock(uint32_t filePos, const uint8_t* pBuf, uint32_t
     endpointMsg.setPartBuffer(sizeof(msgPrefixBuf), pBuf, len);
 }
 
+void RICRESTMsg::encodeDeviceCmdBinary(uint32_t busNum, uint32_t address, uint32_t formatCode,
+            const uint8_t* pBuf, uint32_t len, CommsChannelMsg& endpointMsg)
+{
+    // Setup header
+    uint8_t msgPrefixBuf[RICREST_DEVICE_CMD_PAYLOAD_POS];
+    msgPrefixBuf[RICREST_ELEM_CODE_POS] = RICREST_ELEM_CODE_DEVICE_CMD_BINARY;
+    msgPrefixBuf[RICREST_DEVICE_CMD_BUS_NUM_POS] = busNum & 0xff;
+    Raft::setBEUInt32(msgPrefixBuf, RICREST_DEVICE_CMD_ADDRESS_POS, address);
+    Raft::setBEUInt16(msgPrefixBuf, RICREST_DEVICE_CMD_FORMAT_CODE_POS, formatCode);
+
+    // Set the message
+    endpointMsg.setBufferSize(sizeof(msgPrefixBuf) + len);
+    endpointMsg.setPartBuffer(RICREST_ELEM_CODE_POS, msgPrefixBuf, sizeof(msgPrefixBuf));
+    if (len > 0)
+        endpointMsg.setPartBuffer(sizeof(msgPrefixBuf), pBuf, len);
+}
+
+bool RICRESTMsg::decodeDeviceCmdBinary(const uint8_t* pBuf, uint32_t len, uint32_t& busNum, uint32_t& address, 
+            uint32_t& formatCode, const uint8_t*& pPayload, uint32_t& payloadLen)
+{
+    // Check valid
+    if ((len < RICREST_DEVICE_CMD_PAYLOAD_POS) || (pBuf[RICREST_ELEM_CODE_POS] != RICREST_ELEM_CODE_DEVICE_CMD_BINARY))
+        return false;
+
+    // Extract fields
+    const uint8_t* pData = pBuf + RICREST_DEVICE_CMD_ADDRESS_POS;
+    busNum = pBuf[RICREST_DEVICE_CMD_BUS_NUM_POS];
+    address = Raft::getBEUInt32AndInc(pData);
+    formatCode = Raft::getBEUInt16AndInc(pData);
+    pPayload = pData;
+    payloadLen = len - RICREST_DEVICE_CMD_PAYLOAD_POS;
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Debug
 ////////////////////////////////////////////////////////////////////////////////////////////////////
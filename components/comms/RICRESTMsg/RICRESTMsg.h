@@ -25,6 +25,10 @@ static const uint32_t RICREST_FILEBLOCK_CHANNEL_POS = 0;
 static const uint32_t RICREST_FILEBLOCK_FILEPOS_POS = 1;
 static const uint32_t RICREST_FILEBLOCK_FILEPOS_POS_BYTES = 4;
 static const uint32_t RICREST_FILEBLOCK_PAYLOAD_POS = 5;
+static const uint32_t RICREST_DEVICE_CMD_BUS_NUM_POS = 1;
+static const uint32_t RICREST_DEVICE_CMD_ADDRESS_POS = 2;
+static const uint32_t RICREST_DEVICE_CMD_FORMAT_CODE_POS = 6;
+static const uint32_t RICREST_DEVICE_CMD_PAYLOAD_POS = 8;
 
 class CommsChannelMsg;
 
@@ -37,7 +41,8 @@ public:
         RICREST_ELEM_CODE_CMDRESPJSON,
         RICREST_ELEM_CODE_BODY,
         RICREST_ELEM_CODE_COMMAND_FRAME,
-        RICREST_ELEM_CODE_FILEBLOCK
+        RICREST_ELEM_CODE_FILEBLOCK,
+        RICREST_ELEM_CODE_DEVICE_CMD_BINARY
     };
 
     static const char* getRICRESTElemCodeStr(RICRESTElemCode elemCode)
@@ -49,6 +54,7 @@ public:
             case RICREST_ELEM_CODE_BODY: return "BODY";
             case RICREST_ELEM_CODE_COMMAND_FRAME: return "COMMAND_FRAME";
             case RICREST_ELEM_CODE_FILEBLOCK: return "FILEBLOCK";
+            case RICREST_ELEM_CODE_DEVICE_CMD_BINARY: return "DEVICE_CMD_BINARY";
             default: return "UNKNOWN";
         }
     }
@@ -78,6 +84,13 @@ public:
     static void encodeFileBlock(uint32_t filePos, const uint8_t* pBuf, uint32_t len, 
                 CommsChannelMsg& endpointMsg);
 
+    // Binary device command - the layout is elemCode(1), busNum(1), address(4 BE), formatCode(2 BE), payload
+    // Decoding doesn't copy or allocate - pPayload points into the message buffer
+    static void encodeDeviceCmdBinary(uint32_t busNum, uint32_t address, uint32_t formatCode,
+                const uint8_t* pBuf, uint32_t len, CommsChannelMsg& endpointMsg);
+    static bool decodeDeviceCmdBinary(const uint8_t* pBuf, uint32_t len, uint32_t& busNum, uint32_t& address, 
+                uint32_t& formatCode, const uint8_t*& pPayload, uint32_t& payloadLen);
+
     const String& getReq() const
     {
         return _req;
@@ -0,0 +1,15 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DeviceCmdBinaryHookFnType
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <functional>
+#include "RaftRetCode.h"
+
+typedef std::function<RaftRetCode(uint32_t busNum, uint32_t address, uint32_t formatCode, 
+            const uint8_t* pData, uint32_t dataLen)> DeviceCmdBinaryHookFnType;
@@ -223,52 +223,163 @@ extern "C" uint16_t IRAM_ATTR __analogRead(uint8_t pin)
 
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Interrupts
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool __gpioIsrServiceInstalled = false;
+
+extern "C" void __attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode)
+{
+    // The shared ISR service may already have been installed elsewhere
+    if (!__gpioIsrServiceInstalled)
+    {
+        esp_err_t err = gpio_install_isr_service(0);
+        __gpioIsrServiceInstalled = (err == ESP_OK) || (err == ESP_ERR_INVALID_STATE);
+        if (!__gpioIsrServiceInstalled)
+            return;
+    }
+    gpio_set_intr_type((gpio_num_t)pin, mode == RISING ? GPIO_INTR_POSEDGE :
+                (mode == FALLING ? GPIO_INTR_NEGEDGE : GPIO_INTR_ANYEDGE));
+    gpio_isr_handler_add((gpio_num_t)pin, handler, arg);
+    gpio_intr_enable((gpio_num_t)pin);
+}
+
+extern "C" void __detachInterrupt(uint8_t pin)
+{
+    gpio_intr_disable((gpio_num_t)pin);
+    gpio_isr_handler_remove((gpio_num_t)pin);
+    gpio_set_intr_type((gpio_num_t)pin, GPIO_INTR_DISABLE);
+}
+
 extern void pinMode(int pin, uint8_t mode) __attribute__ ((weak, alias("__pinMode")));
 extern void digitalWrite(uint8_t pin, uint8_t val) __attribute__ ((weak, alias("__digitalWrite")));
 extern int digitalRead(uint8_t pin) __attribute__ ((weak, alias("__digitalRead")));
 extern uint16_t analogRead(uint8_t pin) __attribute__ ((weak, alias("__analogRead")));
+extern void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) __attribute__ ((weak, alias("__attachInterruptArg")));
+extern void detachInterrupt(uint8_t pin) __attribute__ ((weak, alias("__detachInterrupt")));
 
 #endif // ARDUINO
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Multi-pin access - direct register set/clear
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "ArduinoGPIO.h"
+#include "esp_attr.h"
+#include "soc/soc.h"
+#include "soc/soc_caps.h"
+#include "soc/gpio_reg.h"
+
+extern "C" void IRAM_ATTR digitalWriteMask(uint64_t setMask, uint64_t clearMask)
+{
+    // Pins in both masks are cleared
+    setMask &= ~clearMask & SOC_GPIO_VALID_OUTPUT_GPIO_MASK;
+    clearMask &= SOC_GPIO_VALID_OUTPUT_GPIO_MASK;
+    if ((uint32_t)clearMask)
+        REG_WRITE(GPIO_OUT_W1TC_REG, (uint32_t)clearMask);
+    if ((uint32_t)setMask)
+        REG_WRITE(GPIO_OUT_W1TS_REG, (uint32_t)setMask);
+#if SOC_GPIO_PIN_COUNT > 32
+    if (clearMask >> 32)
+        REG_WRITE(GPIO_OUT1_W1TC_REG, (uint32_t)(clearMask >> 32));
+    if (setMask >> 32)
+        REG_WRITE(GPIO_OUT1_W1TS_REG, (uint32_t)(setMask >> 32));
+#endif
+}
+
+extern "C" uint64_t IRAM_ATTR digitalReadMask(uint64_t pinMask)
+{
+    uint64_t levels = REG_READ(GPIO_IN_REG);
+#if SOC_GPIO_PIN_COUNT > 32
+    levels |= (uint64_t)REG_READ(GPIO_IN1_REG) << 32;
+#endif
+    return levels & pinMask;
+}
+
 #endif // ESP_PLATFORM
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// Linux stub implementations
+// Linux simulated GPIO
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #if defined(__linux__) && !defined(ESP_PLATFORM)
 
+#include <vector>
 #include "ArduinoGPIO.h"
+#include "ArduinoTime.h"
 #include "Logger.h"
 
-#define WARN_ON_GPIO_MODE_STUBS
-// #define WARN_ON_GPIO_READ_STUBS
-// #define WARN_ON_GPIO_WRITE_STUBS
+// #define DEBUG_GPIO_SIM_MODE
+// #define DEBUG_GPIO_SIM_WRITE
 // #define WARN_ON_GPIO_ANALOG_READ_STUBS
 
+#if defined(DEBUG_GPIO_SIM_MODE) || defined(DEBUG_GPIO_SIM_WRITE) || defined(WARN_ON_GPIO_ANALOG_READ_STUBS)
 static const char* MODULE_PREFIX = "ArduinoGPIO";
+#endif
+
+// Simulated pins - inputs are driven by gpioSimSetInputLevel() and outputs by digitalWrite()
+static const uint32_t GPIO_SIM_NUM_PINS = 64;
+struct GPIOSimPin
+{
+    uint8_t mode = 0;
+    uint8_t level = LOW;
+    uint8_t intrMode = 0;
+    void (*pIntrHandler)(void*) = nullptr;
+    void* pIntrArg = nullptr;
+};
+static GPIOSimPin __gpioSimPins[GPIO_SIM_NUM_PINS];
+
+// Pin-change log
+static std::vector<GPIOSimChange> __gpioSimChangeLog;
+static uint32_t __gpioSimChangeLogMax = 0;
+static uint32_t __gpioSimWriteSeq = 0;
+
+// Set a simulated pin level (as part of write operation writeSeq) and call the interrupt handler on a matching edge
+static void gpioSimSetLevel(uint8_t pin, uint8_t level, uint32_t writeSeq)
+{
+    if (pin >= GPIO_SIM_NUM_PINS)
+        return;
+    GPIOSimPin& simPin = __gpioSimPins[pin];
+    level = level ? HIGH : LOW;
+    if (simPin.level == level)
+        return;
+    simPin.level = level;
+    if (__gpioSimChangeLog.size() < __gpioSimChangeLogMax)
+        __gpioSimChangeLog.push_back({micros(), writeSeq, pin, level, simPin.mode});
+    bool edgeMatches = (simPin.intrMode == CHANGE) || ((simPin.intrMode == RISING) && level) ||
+                ((simPin.intrMode == FALLING) && !level);
+    if (edgeMatches && simPin.pIntrHandler)
+        simPin.pIntrHandler(simPin.pIntrArg);
+}
 
-// Stub implementations for Linux - these do nothing but log warnings
 extern "C" void pinMode(int pin, uint8_t mode)
 {
-#ifdef WARN_ON_GPIO_MODE_STUBS
-    LOG_W(MODULE_PREFIX, "pinMode(%d, %d) - stub implementation for Linux", pin, mode);
+    if ((pin < 0) || (pin >= (int)GPIO_SIM_NUM_PINS))
+        return;
+#ifdef DEBUG_GPIO_SIM_MODE
+    LOG_I(MODULE_PREFIX, "pinMode(%d, %d) simulated", pin, mode);
 #endif
+    __gpioSimPins[pin].mode = mode;
+    if (mode == INPUT_PULLUP)
+        gpioSimSetLevel(pin, HIGH, ++__gpioSimWriteSeq);
+    else if (mode == INPUT_PULLDOWN)
+        gpioSimSetLevel(pin, LOW, ++__gpioSimWriteSeq);
 }
 
 extern "C" void digitalWrite(uint8_t pin, uint8_t val)
 {
-#ifdef WARN_ON_GPIO_WRITE_STUBS
-    LOG_W(MODULE_PREFIX, "digitalWrite(%d, %d) - stub implementation for Linux", pin, val);
+#ifdef DEBUG_GPIO_SIM_WRITE
+    LOG_I(MODULE_PREFIX, "digitalWrite(%d, %d) simulated", pin, val);
 #endif
+    gpioSimSetLevel(pin, val, ++__gpioSimWriteSeq);
 }
 
 extern "C" int digitalRead(uint8_t pin)
 {
-#ifdef WARN_ON_GPIO_READ_STUBS
-    LOG_W(MODULE_PREFIX, "digitalRead(%d) - stub implementation for Linux", pin);
-#endif
-    return 0;
+    if (pin >= GPIO_SIM_NUM_PINS)
+        return 0;
+    return __gpioSimPins[pin].level;
 }
 
 extern "C" uint16_t analogRead(uint8_t pin)
@@ -279,4 +390,72 @@ extern "C" uint16_t analogRead(uint8_t pin)
     return 0;
 }
 
+extern "C" void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode)
+{
+    if (pin >= GPIO_SIM_NUM_PINS)
+        return;
+    __gpioSimPins[pin].intrMode = mode;
+    __gpioSimPins[pin].pIntrHandler = handler;
+    __gpioSimPins[pin].pIntrArg = arg;
+}
+
+extern "C" void detachInterrupt(uint8_t pin)
+{
+    if (pin >= GPIO_SIM_NUM_PINS)
+        return;
+    __gpioSimPins[pin].intrMode = 0;
+    __gpioSimPins[pin].pIntrHandler = nullptr;
+    __gpioSimPins[pin].pIntrArg = nullptr;
+}
+
+extern "C" void digitalWriteMask(uint64_t setMask, uint64_t clearMask)
+{
+    uint32_t writeSeq = ++__gpioSimWriteSeq;
+    for (uint64_t pinsLeft = setMask | clearMask; pinsLeft; pinsLeft &= pinsLeft - 1)
+    {
+        uint32_t pin = __builtin_ctzll(pinsLeft);
+        gpioSimSetLevel(pin, (clearMask >> pin) & 1 ? LOW : HIGH, writeSeq);
+    }
+}
+
+extern "C" uint64_t digitalReadMask(uint64_t pinMask)
+{
+    uint64_t levels = 0;
+    for (uint64_t pinsLeft = pinMask; pinsLeft; pinsLeft &= pinsLeft - 1)
+    {
+        uint32_t pin = __builtin_ctzll(pinsLeft);
+        if (__gpioSimPins[pin].level)
+            levels |= 1ULL << pin;
+    }
+    return levels;
+}
+
+extern "C" void gpioSimSetInputLevel(uint8_t pin, uint8_t level)
+{
+    gpioSimSetLevel(pin, level, ++__gpioSimWriteSeq);
+}
+
+extern "C" uint8_t gpioSimGetPinMode(uint8_t pin)
+{
+    if (pin >= GPIO_SIM_NUM_PINS)
+        return 0;
+    return __gpioSimPins[pin].mode;
+}
+
+extern "C" void gpioSimSetChangeLogLen(uint32_t maxChanges)
+{
+    __gpioSimChangeLogMax = maxChanges;
+    __gpioSimChangeLog.clear();
+    __gpioSimChangeLog.reserve(maxChanges);
+}
+
+extern "C" uint32_t gpioSimGetChangeLog(GPIOSimChange* pChanges, uint32_t maxChanges)
+{
+    uint32_t numChanges = __gpioSimChangeLog.size() < maxChanges ? __gpioSimChangeLog.size() : maxChanges;
+    for (uint32_t i = 0; i < numChanges; i++)
+        pChanges[i] = __gpioSimChangeLog[i];
+    __gpioSimChangeLog.clear();
+    return numChanges;
+}
+
 #endif // __linux__ && !ESP_PLATFORM
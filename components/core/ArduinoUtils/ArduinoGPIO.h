@@ -34,14 +34,60 @@ extern "C" {
 #define FUNCTION_6        0xA0
 #define ANALOG            0xC0
 
+// Interrupt modes
+#define RISING            0x01
+#define FALLING           0x02
+#define CHANGE            0x03
+
 // From arduino-esp32
 void pinMode(int pin, uint8_t mode);
 void digitalWrite(uint8_t pin, uint8_t val);
 int digitalRead(uint8_t pin);
 uint16_t analogRead(uint8_t pin);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+#if defined(__linux__) && !defined(ESP_PLATFORM)
+// Simulated GPIO (Linux) - drive an input as if from external hardware (calls any attached interrupt handler)
+void gpioSimSetInputLevel(uint8_t pin, uint8_t level);
+
+// Simulated GPIO pin mode (as set by pinMode)
+uint8_t gpioSimGetPinMode(uint8_t pin);
+
+// Simulated GPIO pin-change log - pins changed by the same write operation share a writeSeq and mode is the
+// pin mode at the time of the change
+typedef struct {
+    uint64_t timeUs;
+    uint32_t writeSeq;
+    uint8_t pin;
+    uint8_t level;
+    uint8_t mode;
+} GPIOSimChange;
+
+// Set the maximum number of logged changes (0 disables logging) and clear the log
+void gpioSimSetChangeLogLen(uint32_t maxChanges);
+
+// Get (and clear) logged changes - returns the number copied
+uint32_t gpioSimGetChangeLog(GPIOSimChange* pChanges, uint32_t maxChanges);
+#endif
 
 #ifdef __cplusplus
 }
 #endif
 
 #endif // ARDUINO
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Multi-pin access (bit n of a mask is GPIO n) - on ESP32 these are direct register accesses so all pins in
+// a 32-pin bank change (or are sampled) together. Where a pin is in both masks it is cleared
+void digitalWriteMask(uint64_t setMask, uint64_t clearMask);
+uint64_t digitalReadMask(uint64_t pinMask);
+
+#ifdef __cplusplus
+}
+#endif
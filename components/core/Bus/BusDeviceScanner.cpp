@@ -0,0 +1,155 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// BusDeviceScanner
+// Incremental device scanning with warm start from the bus topology cache
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BusDeviceScanner.h"
+#include "BusTopologyCache.h"
+#include "DeviceTypeRecords.h"
+#include "Logger.h"
+
+// #define DEBUG_BUS_DEVICE_SCANNER
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor
+/// @param topologyCache topology cache of the bus
+/// @param probeFn probe function
+/// @param identifyFn identify function
+/// @param identifiedCB called when a device is identified
+BusDeviceScanner::BusDeviceScanner(BusTopologyCache& topologyCache, BusScanProbeFn probeFn,
+            BusScanIdentifyFn identifyFn, BusScanIdentifiedCB identifiedCB) :
+    _topologyCache(topologyCache), _probeFn(probeFn), _identifyFn(identifyFn), _identifiedCB(identifiedCB)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Setup the address range and start scanning
+/// @param minAddr minimum address
+/// @param maxAddr maximum address
+void BusDeviceScanner::setup(BusElemAddrType minAddr, BusElemAddrType maxAddr)
+{
+    // Priority addresses first then the rest of the range
+    _scanOrder.clear();
+    std::vector<std::vector<BusElemAddrType>> priorityLists;
+    deviceTypeRecords.getScanPriorityLists(priorityLists);
+    for (const auto& priorityList : priorityLists)
+        for (BusElemAddrType address : priorityList)
+            addToScanOrder(_scanOrder, address, minAddr, maxAddr);
+    for (BusElemAddrType address = minAddr; address <= maxAddr; address++)
+    {
+        addToScanOrder(_scanOrder, address, minAddr, maxAddr);
+        if (address == maxAddr)
+            break;
+    }
+    restart();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Service - performs one verification or scans one address
+/// @return true if work was done, false if scanning is complete
+bool BusDeviceScanner::service()
+{
+    // Warm start - verify a known device with a single targeted identification
+    BusElemAddrType address = 0;
+    DeviceTypeIndexType deviceTypeIndex = DEVICE_TYPE_INDEX_INVALID;
+    if (_topologyCache.getNextToVerify(address, deviceTypeIndex))
+    {
+        _numProbes++;
+        bool identified = false;
+        if (_probeFn(address))
+        {
+            _numIdentAttempts++;
+            identified = _identifyFn(address, deviceTypeIndex);
+        }
+
+#ifdef DEBUG_BUS_DEVICE_SCANNER
+        LOG_I(MODULE_PREFIX, "service verify addr %04x devTypeIdx %d %s",
+                    address, deviceTypeIndex, identified ? "OK" : "FAILED");
+#endif
+
+        _topologyCache.handleVerifyResult(address, identified);
+        if (identified)
+            deviceIdentified(address, deviceTypeIndex);
+        return true;
+    }
+
+    // Scan the next address which hasn't already been identified
+    while (_scanPos < _scanOrder.size())
+    {
+        address = _scanOrder[_scanPos++];
+        if (isIdentified(address))
+            continue;
+        _numProbes++;
+        if (!_probeFn(address))
+            return true;
+
+        // Try each candidate device type
+        for (DeviceTypeIndexType candTypeIdx : deviceTypeRecords.getDeviceTypeIdxsForAddr(address))
+        {
+            _numIdentAttempts++;
+            if (_identifyFn(address, candTypeIdx))
+            {
+                deviceIdentified(address, candTypeIdx);
+                break;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Check if scanning is complete
+/// @return true if complete
+bool BusDeviceScanner::isComplete() const
+{
+    return (_scanPos >= _scanOrder.size()) && _topologyCache.isVerifyComplete();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Restart scanning
+void BusDeviceScanner::restart()
+{
+    _scanPos = 0;
+    _identifiedAddrs.clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Check if an address has been identified in this scan
+/// @param address address
+/// @return true if identified
+bool BusDeviceScanner::isIdentified(BusElemAddrType address) const
+{
+    for (BusElemAddrType identifiedAddr : _identifiedAddrs)
+        if (identifiedAddr == address)
+            return true;
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Record an identified device and inform the bus
+/// @param address address
+/// @param deviceTypeIndex device type index
+void BusDeviceScanner::deviceIdentified(BusElemAddrType address, DeviceTypeIndexType deviceTypeIndex)
+{
+    _identifiedAddrs.push_back(address);
+    if (_identifiedCB)
+        _identifiedCB(address, deviceTypeIndex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add an address to the scan order (if in range and not already present)
+void BusDeviceScanner::addToScanOrder(std::vector<BusElemAddrType>& scanOrder, BusElemAddrType address,
+            BusElemAddrType minAddr, BusElemAddrType maxAddr)
+{
+    if ((address < minAddr) || (address > maxAddr))
+        return;
+    for (BusElemAddrType existing : scanOrder)
+        if (existing == address)
+            return;
+    scanOrder.push_back(address);
+}
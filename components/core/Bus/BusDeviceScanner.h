@@ -0,0 +1,101 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// BusDeviceScanner
+// Incremental device scanning with warm start from the bus topology cache
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include "RaftBusConsts.h"
+#include "RaftDeviceConsts.h"
+
+class BusTopologyCache;
+
+// Probe an address - returns true if an element responds
+typedef std::function<bool(BusElemAddrType address)> BusScanProbeFn;
+
+// Attempt identification of one device type at an address (using that type's detection values only)
+typedef std::function<bool(BusElemAddrType address, DeviceTypeIndexType deviceTypeIndex)> BusScanIdentifyFn;
+
+// Device identified at an address
+typedef std::function<void(BusElemAddrType address, DeviceTypeIndexType deviceTypeIndex)> BusScanIdentifiedCB;
+
+/// @brief Bus device scanner
+/// Bus implementations call service() from their scanning context and each call does one unit of work. Devices
+/// known to the topology cache are verified first with a single targeted identification each, then addresses
+/// are scanned in priority order (the device type records' scan priority lists followed by the rest of the
+/// address range) trying each candidate device type at an address which responds. Addresses verified at
+/// warm start are not scanned again.
+class BusDeviceScanner
+{
+public:
+    /// @brief Constructor
+    /// @param topologyCache topology cache of the bus
+    /// @param probeFn probe function
+    /// @param identifyFn identify function
+    /// @param identifiedCB called when a device is identified (the bus reports the status change from here)
+    BusDeviceScanner(BusTopologyCache& topologyCache, BusScanProbeFn probeFn, BusScanIdentifyFn identifyFn,
+                BusScanIdentifiedCB identifiedCB);
+
+    /// @brief Setup the address range and start scanning
+    /// @param minAddr minimum address
+    /// @param maxAddr maximum address
+    void setup(BusElemAddrType minAddr, BusElemAddrType maxAddr);
+
+    /// @brief Service - performs one verification or scans one address
+    /// @return true if work was done, false if scanning is complete
+    bool service();
+
+    /// @brief Check if scanning is complete
+    /// @return true if complete
+    bool isComplete() const;
+
+    /// @brief Restart scanning (devices previously identified are scanned again)
+    void restart();
+
+    /// @brief Get number of probes performed
+    uint32_t getNumProbes() const
+    {
+        return _numProbes;
+    }
+
+    /// @brief Get number of identification attempts performed
+    uint32_t getNumIdentAttempts() const
+    {
+        return _numIdentAttempts;
+    }
+
+private:
+    // Topology cache
+    BusTopologyCache& _topologyCache;
+
+    // Bus functions
+    BusScanProbeFn _probeFn;
+    BusScanIdentifyFn _identifyFn;
+    BusScanIdentifiedCB _identifiedCB;
+
+    // Scan order and position
+    std::vector<BusElemAddrType> _scanOrder;
+    uint32_t _scanPos = 0;
+
+    // Addresses identified in this scan
+    std::vector<BusElemAddrType> _identifiedAddrs;
+
+    // Stats
+    uint32_t _numProbes = 0;
+    uint32_t _numIdentAttempts = 0;
+
+    // Helpers
+    bool isIdentified(BusElemAddrType address) const;
+    void deviceIdentified(BusElemAddrType address, DeviceTypeIndexType deviceTypeIndex);
+    static void addToScanOrder(std::vector<BusElemAddrType>& scanOrder, BusElemAddrType address,
+                BusElemAddrType minAddr, BusElemAddrType maxAddr);
+
+    // Debug
+    static constexpr const char* MODULE_PREFIX = "BusScanner";
+};
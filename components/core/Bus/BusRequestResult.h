@@ -63,6 +63,11 @@ public:
         return _result;
     }
 
+    void setResult(RaftRetCode result)
+    {
+        _result = result;
+    }
+
     uint32_t getAddress()
     {
         return _address;
@@ -6,18 +6,29 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <string.h>
 #include "Logger.h"
 #include "BusSerial.h"
 #include "BusRequestInfo.h"
+#include "BusRequestResult.h"
 #include "RaftJsonPrefixed.h"
-#include "ConfigPinMap.h"
 #include "RaftUtils.h"
 #include "RaftArduino.h"
+#ifdef ESP_PLATFORM
+#include "ConfigPinMap.h"
 #include "esp_err.h"
 #include "driver/uart.h"
 #include "esp_idf_version.h"
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#endif
 
 // #define DEBUG_BUS_SERIAL
+// #define DEBUG_BUS_SERIAL_FRAMES
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Construct / Destruct
@@ -36,12 +47,18 @@ BusSerial::BusSerial(BusElemStatusCB busElemStatusCB, BusOperationStatusCB busOp
     _txBufSize = TX_BUF_SIZE_DEFAULT;
     _minTimeBetweenSendsMs = 0;
     _lastSendTimeMs = 0;
+    RaftMutex_init(_accessMutex);
+    RaftAtomicBool_init(_rxTaskStop, false);
+    RaftSemaphore_init(_rxTaskExitSem, 0, 1);
 }
 
 BusSerial::~BusSerial()
 {
+    stopRxTask();
     if (_isInitialised)
-        uart_driver_delete((uart_port_t)_uartNum);
+        serialDeinit();
+    RaftMutex_destroy(_accessMutex);
+    RaftSemaphore_destroy(_rxTaskExitSem);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -58,22 +75,41 @@ bool BusSerial::setup(BusNumType busNum, const RaftJsonIF& config)
 
     // Get bus details
     _uartNum = config.getLong("uartNum", 0);
-    String pinName = config.getString("rxPin", "");
-    _rxPin = ConfigPinMap::getPinFromName(pinName.c_str());
-    pinName = config.getString("txPin", "");
-    _txPin = ConfigPinMap::getPinFromName(pinName.c_str());
     _baudRate = config.getLong("baudRate", BAUD_RATE_DEFAULT);
     _busName = config.getString("name", "");
     _rxBufSize = config.getLong("rxBufSize", RX_BUF_SIZE_DEFAULT);
     _txBufSize = config.getLong("txBufSize", TX_BUF_SIZE_DEFAULT);
     _minTimeBetweenSendsMs = config.getLong("minAfterSendMs", 0);
 
+    // Framing and response matching
+    RaftJsonPrefixed frameConfig(config, "frame");
+    _framer.setup(frameConfig);
+    _respTimeoutMs = config.getLong("respTimeoutMs", RESP_TIMEOUT_MS_DEFAULT);
+    _matchAddrPos = config.getLong("matchAddrPos", -1);
+    _maxPendingRequests = config.getLong("maxPending", MAX_PENDING_REQUESTS_DEFAULT);
+    _maxRxFrames = config.getLong("maxRxFrames", MAX_RX_FRAMES_DEFAULT);
+
+#ifdef ESP_PLATFORM
+    String pinName = config.getString("rxPin", "");
+    _rxPin = ConfigPinMap::getPinFromName(pinName.c_str());
+    pinName = config.getString("txPin", "");
+    _txPin = ConfigPinMap::getPinFromName(pinName.c_str());
+
     // Check valid
     if ((_rxPin < 0) || (_txPin < 0))
     {
         LOG_W(MODULE_PREFIX, "setup INVALID PARAMS name %s uart %d Rx %d Tx %d baud %d", _busName.c_str(), _uartNum, _rxPin, _txPin, _baudRate);
         return false;
     }
+#else
+    // Serial device (e.g. /dev/ttyUSB0 or a pty)
+    _devPath = config.getString("dev", "");
+    if (_devPath.isEmpty())
+    {
+        LOG_W(MODULE_PREFIX, "setup INVALID PARAMS name %s dev not specified", _busName.c_str());
+        return false;
+    }
+#endif
 
     // Initialise serial
     if (!serialInit())
@@ -85,8 +121,18 @@ bool BusSerial::setup(BusNumType busNum, const RaftJsonIF& config)
     // Ok
     _isInitialised = true;
 
+    // Start receive task if framing is used
+    if (_framer.isEnabled() && !startRxTask())
+    {
+        LOG_W(MODULE_PREFIX, "setup bus FAILED name %s to start rx task", _busName.c_str());
+        serialDeinit();
+        _isInitialised = false;
+        return false;
+    }
+
     // Debug
-    LOG_I(MODULE_PREFIX, "setup bus OK name %s uart %d Rx %d Tx %d baud %d", _busName.c_str(), _uartNum, _rxPin, _txPin, _baudRate);
+    LOG_I(MODULE_PREFIX, "setup bus OK name %s uart %d Rx %d Tx %d baud %d %s", _busName.c_str(), _uartNum, _rxPin, _txPin, _baudRate,
+                _framer.isEnabled() ? "framed" : "polled");
 
     // Ok
     return true;
@@ -113,6 +159,7 @@ void BusSerial::clear(bool incPolling)
 
 bool BusSerial::serialInit()
 {
+#ifdef ESP_PLATFORM
     // Configure UART. Note that REF_TICK is used so that the baud rate remains
     // correct while APB frequency is changing in light sleep mode
     const uart_config_t uart_config = {
@@ -155,14 +202,69 @@ bool BusSerial::serialInit()
     // TODO - what does this achieve?
     vTaskDelay(1);
 
-    // Install UART driver for interrupt-driven reads and writes
-    err = uart_driver_install((uart_port_t)_uartNum, _rxBufSize, _txBufSize, 0, NULL, 0);
+    // Install UART driver for interrupt-driven reads and writes - in framed mode the driver posts
+    // events to a queue which is serviced by the receive task
+    err = uart_driver_install((uart_port_t)_uartNum, _rxBufSize, _txBufSize,
+                _framer.isEnabled() ? UART_EVENT_QUEUE_SIZE : 0,
+                _framer.isEnabled() ? &_uartEventQueue : NULL, 0);
     if (err != ESP_OK)
     {
         LOG_E(MODULE_PREFIX, "Failed to install uart driver, err %d", err);
         return false;
     }
     return true;
+#else
+    // Open serial device
+    _devFd = open(_devPath.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (_devFd < 0)
+    {
+        LOG_E(MODULE_PREFIX, "Failed to open %s", _devPath.c_str());
+        return false;
+    }
+
+    // Raw mode at the requested baud rate
+    struct termios tio;
+    if (tcgetattr(_devFd, &tio) != 0)
+    {
+        LOG_E(MODULE_PREFIX, "Failed to get attributes %s", _devPath.c_str());
+        ::close(_devFd);
+        _devFd = -1;
+        return false;
+    }
+    cfmakeraw(&tio);
+    speed_t speed = B115200;
+    switch (_baudRate)
+    {
+        case 9600: speed = B9600; break;
+        case 19200: speed = B19200; break;
+        case 38400: speed = B38400; break;
+        case 57600: speed = B57600; break;
+        case 230400: speed = B230400; break;
+        case 460800: speed = B460800; break;
+        case 921600: speed = B921600; break;
+        default: break;
+    }
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    tcsetattr(_devFd, TCSANOW, &tio);
+    return true;
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Deinit bus
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void BusSerial::serialDeinit()
+{
+#ifdef ESP_PLATFORM
+    uart_driver_delete((uart_port_t)_uartNum);
+    _uartEventQueue = nullptr;
+#else
+    if (_devFd >= 0)
+        ::close(_devFd);
+    _devFd = -1;
+#endif
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -190,18 +292,64 @@ bool BusSerial::addRequest(BusRequestInfo& busReqInfo)
     if (busReqInfo.getBusReqType() != BUS_REQ_TYPE_STD)
         return false;
 
+    // In framed mode record the request (before sending so that a fast response can be matched)
+    bool awaitResponse = _framer.isEnabled() && busReqInfo.getCallback();
+    uint32_t pendingSeqNum = 0;
+    if (awaitResponse)
+    {
+        if (!RaftMutex_lock(_accessMutex, 5))
+            return false;
+        if (_pendingRequests.size() >= _maxPendingRequests)
+        {
+            RaftMutex_unlock(_accessMutex);
+            _busStats.reqBufferFull();
+            return false;
+        }
+        PendingRequest pendingReq;
+        pendingReq.address = busReqInfo.getAddress();
+        pendingReq.cmdId = busReqInfo.getCmdId();
+        pendingReq.callback = busReqInfo.getCallback();
+        pendingReq.pCallbackData = busReqInfo.getCallbackParam();
+        pendingReq.sendTimeUs = micros();
+        pendingReq.seqNum = pendingSeqNum = ++_pendingReqSeqNum;
+        _pendingRequests.push_back(pendingReq);
+        _busStats.reqQueueCount(_pendingRequests.size());
+        RaftMutex_unlock(_accessMutex);
+    }
+
     // Send the message
-    int bytesSent = uart_write_bytes((uart_port_t)_uartNum, 
+#ifdef ESP_PLATFORM
+    int bytesSent = uart_write_bytes((uart_port_t)_uartNum,
                 (const char*)busReqInfo.getWriteData(), busReqInfo.getWriteDataLen());
+#else
+    int bytesSent = busReqInfo.getWriteDataLen() == 0 ? 0 : write(_devFd, busReqInfo.getWriteData(), busReqInfo.getWriteDataLen());
+#endif
     if (bytesSent != busReqInfo.getWriteDataLen())
     {
         LOG_W(MODULE_PREFIX, "addRequest len %d only wrote %d bytes",
                 busReqInfo.getWriteDataLen(), bytesSent);
 
+        // Remove this request - it is found by sequence number as other requests may have been added
+        // and the receive task may already have completed it (so an iterator could be invalid)
+        if (awaitResponse && RaftMutex_lock(_accessMutex, RAFT_MUTEX_WAIT_FOREVER))
+        {
+            for (auto it = _pendingRequests.begin(); it != _pendingRequests.end(); ++it)
+            {
+                if (it->seqNum == pendingSeqNum)
+                {
+                    _pendingRequests.erase(it);
+                    break;
+                }
+            }
+            _busStats.reqQueueCount(_pendingRequests.size());
+            RaftMutex_unlock(_accessMutex);
+        }
         return false;
     }
 
     // Record time message sent
+    _busStats.activity();
+    _busStats.bytesTransferred(bytesSent);
     _lastSendTimeMs = millis();
     return true;
 }
@@ -212,8 +360,24 @@ bool BusSerial::addRequest(BusRequestInfo& busReqInfo)
 
 void BusSerial::rxDataClear()
 {
+    // Clear unsolicited frames
+    if (_framer.isEnabled())
+    {
+        if (RaftMutex_lock(_accessMutex, 5))
+        {
+            _rxFrames.clear();
+            RaftMutex_unlock(_accessMutex);
+        }
+        return;
+    }
+
     // Clear received data
+#ifdef ESP_PLATFORM
     uart_flush_input((uart_port_t)_uartNum);
+#else
+    if (_devFd >= 0)
+        tcflush(_devFd, TCIFLUSH);
+#endif
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -222,9 +386,28 @@ void BusSerial::rxDataClear()
 
 uint32_t BusSerial::rxDataBytesAvailable() const
 {
+    // Framed mode
+    if (_framer.isEnabled())
+    {
+        uint32_t numAvailable = 0;
+        if (RaftMutex_lock(_accessMutex, 5))
+        {
+            if (!_rxFrames.empty())
+                numAvailable = _rxFrames.front().size();
+            RaftMutex_unlock(_accessMutex);
+        }
+        return numAvailable;
+    }
+
+#ifdef ESP_PLATFORM
     size_t numAvailable = 0;
     if (uart_get_buffered_data_len((uart_port_t)_uartNum, &numAvailable) == ESP_OK)
         return numAvailable;
+#else
+    int numAvailable = 0;
+    if ((_devFd >= 0) && (ioctl(_devFd, FIONREAD, &numAvailable) == 0) && (numAvailable > 0))
+        return numAvailable;
+#endif
     return 0;
 }
 
@@ -234,6 +417,297 @@ uint32_t BusSerial::rxDataBytesAvailable() const
 
 uint32_t BusSerial::rxDataGet(uint8_t* pData, uint32_t maxLen)
 {
-    uint32_t bytesRead = uart_read_bytes((uart_port_t)_uartNum, pData, maxLen, 0);
+    // Framed mode
+    if (_framer.isEnabled())
+    {
+        uint32_t bytesRead = 0;
+        if (RaftMutex_lock(_accessMutex, 5))
+        {
+            if (!_rxFrames.empty())
+            {
+                std::vector<uint8_t>& frame = _rxFrames.front();
+                bytesRead = frame.size() < maxLen ? frame.size() : maxLen;
+                memcpy(pData, frame.data(), bytesRead);
+                _rxFrames.pop_front();
+            }
+            RaftMutex_unlock(_accessMutex);
+        }
+        return bytesRead;
+    }
+
+#ifdef ESP_PLATFORM
+    int bytesRead = uart_read_bytes((uart_port_t)_uartNum, pData, maxLen, 0);
+#else
+    if (_devFd < 0)
+        return 0;
+    int bytesRead = read(_devFd, pData, maxLen);
+#endif
+    if (bytesRead <= 0)
+        return 0;
+    _busStats.bytesTransferred(bytesRead);
     return bytesRead;
 }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Get bus statistics
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+String BusSerial::getBusStatsJSON() const
+{
+    String statsJson = _busStats.getStatsJSON(getBusName());
+    if (!_framer.isEnabled())
+        return statsJson;
+
+    // Snapshot framed-mode stats (updated by the receive task)
+    if (!RaftMutex_lock(_accessMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return statsJson;
+    uint32_t respMatched = _statsRespMatched;
+    uint32_t respTimeouts = _statsRespTimeouts;
+    uint32_t unsolicited = _statsUnsolicited;
+    uint32_t rxFramesDropped = _statsRxFramesDropped;
+    uint64_t respLatencyTotalUs = _statsRespLatencyTotalUs;
+    uint32_t respLatencyMaxUs = _statsRespLatencyMaxUs;
+    RaftMutex_unlock(_accessMutex);
+
+    // Add framed-mode stats to the bus stats object
+    char frameStats[200];
+    snprintf(frameStats, sizeof(frameStats), R"(,"rspOk":%u,"rspTO":%u,"unsol":%u,"rxDrop":%u,"frmDisc":%u,"latAvgUs":%u,"latMaxUs":%u})",
+                (unsigned)respMatched, (unsigned)respTimeouts, (unsigned)unsolicited,
+                (unsigned)rxFramesDropped, (unsigned)_framer.getDiscardCount(),
+                (unsigned)(respMatched == 0 ? 0 : respLatencyTotalUs / respMatched),
+                (unsigned)respLatencyMaxUs);
+    return statsJson.substring(0, statsJson.length() - 1) + frameStats;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get number of requests awaiting a response (framed mode)
+/// @return number of queued requests
+uint32_t BusSerial::getQueuedRequestCount() const
+{
+    if (!RaftMutex_lock(_accessMutex, 5))
+        return 0;
+    uint32_t numQueued = _pendingRequests.size();
+    RaftMutex_unlock(_accessMutex);
+    return numQueued;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get number of unsolicited frames waiting to be read (framed mode)
+/// @return number of pending frames
+uint32_t BusSerial::getPendingPollResultCount() const
+{
+    if (!RaftMutex_lock(_accessMutex, 5))
+        return 0;
+    uint32_t numPending = _rxFrames.size();
+    RaftMutex_unlock(_accessMutex);
+    return numPending;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Receive task
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool BusSerial::startRxTask()
+{
+    RaftAtomicBool_set(_rxTaskStop, false);
+    RaftSemaphore_take(_rxTaskExitSem, 0);
+    if (!RaftThread_start(_rxTaskHandle, rxTaskFn, this, RX_TASK_STACK_SIZE, "BusSerialRx"))
+    {
+        _rxTaskHandle = RAFT_THREAD_HANDLE_INVALID;
+        return false;
+    }
+    return true;
+}
+
+void BusSerial::stopRxTask()
+{
+    if (_rxTaskHandle == RAFT_THREAD_HANDLE_INVALID)
+        return;
+    RaftAtomicBool_set(_rxTaskStop, true);
+#ifdef ESP_PLATFORM
+    // Wait for the task to signal its exit (it doesn't access this object after signalling)
+    RaftSemaphore_take(_rxTaskExitSem, RAFT_WAIT_FOREVER);
+#else
+    pthread_join(_rxTaskHandle, NULL);
+#endif
+    _rxTaskHandle = RAFT_THREAD_HANDLE_INVALID;
+}
+
+void BusSerial::rxTaskFn(void* pArg)
+{
+    BusSerial* pBusSerial = (BusSerial*)pArg;
+    pBusSerial->rxTaskLoop();
+#ifdef ESP_PLATFORM
+    // Signalling exit must be the last access to the object as it may be deleted as soon as this is given
+    RaftSemaphore_give(pBusSerial->_rxTaskExitSem);
+    vTaskDelete(NULL);
+#endif
+}
+
+void BusSerial::rxTaskLoop()
+{
+    uint8_t rxBuf[RX_READ_BUF_SIZE];
+    while (!RaftAtomicBool_get(_rxTaskStop))
+    {
+#ifdef ESP_PLATFORM
+        // Wait for UART event
+        uart_event_t event;
+        if (xQueueReceive(_uartEventQueue, &event, pdMS_TO_TICKS(RX_TASK_WAIT_MS)))
+        {
+            switch (event.type)
+            {
+                case UART_DATA:
+                {
+                    // Read all buffered data
+                    while (true)
+                    {
+                        int bytesRead = uart_read_bytes((uart_port_t)_uartNum, rxBuf, sizeof(rxBuf), 0);
+                        if (bytesRead <= 0)
+                            break;
+                        processRxBytes(rxBuf, bytesRead);
+                    }
+                    break;
+                }
+                case UART_FIFO_OVF:
+                case UART_BUFFER_FULL:
+                    // Data has been lost so discard any partial frame
+                    LOG_W(MODULE_PREFIX, "rxTask %s overflow", _busName.c_str());
+                    uart_flush_input((uart_port_t)_uartNum);
+                    xQueueReset(_uartEventQueue);
+                    _framer.clear();
+                    _busStats.respBufferFull();
+                    break;
+                default:
+                    break;
+            }
+        }
+#else
+        // Wait for data
+        struct pollfd pfd = { _devFd, POLLIN, 0 };
+        if ((poll(&pfd, 1, RX_TASK_WAIT_MS) > 0) && (pfd.revents & POLLIN))
+        {
+            int bytesRead = read(_devFd, rxBuf, sizeof(rxBuf));
+            if (bytesRead > 0)
+                processRxBytes(rxBuf, bytesRead);
+        }
+#endif
+
+        // Handle idle gaps and response timeouts
+        if (_framer.getIdleUs() > 0)
+        {
+            _framer.checkIdle(micros(), [this](const uint8_t* pFrame, uint32_t frameLen) {
+                handleFrame(pFrame, frameLen);
+            });
+        }
+        serviceTimeouts();
+        dispatchCompleted();
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Process received bytes (receive task)
+/// @param pData received data
+/// @param dataLen length of received data
+void BusSerial::processRxBytes(const uint8_t* pData, uint32_t dataLen)
+{
+    _busStats.bytesTransferred(dataLen);
+    _framer.addBytes(pData, dataLen, micros(), [this](const uint8_t* pFrame, uint32_t frameLen) {
+        handleFrame(pFrame, frameLen);
+    });
+    dispatchCompleted();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Handle a received frame (receive task)
+/// @param pFrame frame data
+/// @param frameLen frame length
+void BusSerial::handleFrame(const uint8_t* pFrame, uint32_t frameLen)
+{
+#ifdef DEBUG_BUS_SERIAL_FRAMES
+    String hexStr;
+    Raft::getHexStrFromBytes(pFrame, frameLen, hexStr);
+    LOG_I(MODULE_PREFIX, "handleFrame %s len %d %s", _busName.c_str(), frameLen, hexStr.c_str());
+#endif
+
+    // Wait for the mutex (other holders only keep it briefly) so that a received frame is never dropped
+    if (!RaftMutex_lock(_accessMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+
+    // Find the matching request
+    auto reqIt = _pendingRequests.begin();
+    if (_matchAddrPos >= 0)
+    {
+        if ((uint32_t)_matchAddrPos >= frameLen)
+            reqIt = _pendingRequests.end();
+        for (; reqIt != _pendingRequests.end(); ++reqIt)
+        {
+            if ((reqIt->address & 0xff) == pFrame[_matchAddrPos])
+                break;
+        }
+    }
+
+    // Unsolicited frame
+    if (reqIt == _pendingRequests.end())
+    {
+        _statsUnsolicited++;
+        if (_rxFrames.size() >= _maxRxFrames)
+        {
+            _rxFrames.pop_front();
+            _statsRxFramesDropped++;
+        }
+        _rxFrames.push_back(std::vector<uint8_t>(pFrame, pFrame + frameLen));
+        _busStats.respQueueCount(_rxFrames.size());
+        RaftMutex_unlock(_accessMutex);
+        return;
+    }
+
+    // Response to a request
+    CompletedRequest completed;
+    completed.req = *reqIt;
+    completed.respData.assign(pFrame, pFrame + frameLen);
+    _pendingRequests.erase(reqIt);
+    uint32_t latencyUs = micros() - completed.req.sendTimeUs;
+    _statsRespMatched++;
+    _statsRespLatencyTotalUs += latencyUs;
+    if (_statsRespLatencyMaxUs < latencyUs)
+        _statsRespLatencyMaxUs = latencyUs;
+    RaftMutex_unlock(_accessMutex);
+    _completedRequests.push_back(completed);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Time out outstanding requests (receive task)
+void BusSerial::serviceTimeouts()
+{
+    if (!RaftMutex_lock(_accessMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    uint64_t timeNowUs = micros();
+    while (!_pendingRequests.empty() &&
+                (timeNowUs - _pendingRequests.front().sendTimeUs >= (uint64_t)_respTimeoutMs * 1000))
+    {
+        CompletedRequest completed;
+        completed.req = _pendingRequests.front();
+        completed.result = RAFT_BUS_SW_TIME_OUT;
+        _pendingRequests.pop_front();
+        _statsRespTimeouts++;
+        _completedRequests.push_back(completed);
+    }
+    RaftMutex_unlock(_accessMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Call callbacks for completed requests (receive task, called without the mutex held)
+void BusSerial::dispatchCompleted()
+{
+    for (CompletedRequest& completed : _completedRequests)
+    {
+        BusRequestResult reqResult(completed.req.address, completed.req.cmdId,
+                    completed.respData.data(), completed.respData.size(),
+                    completed.result == RAFT_OK, completed.req.callback, completed.req.pCallbackData);
+        reqResult.setResult(completed.result);
+        _busStats.cmdComplete();
+        if (completed.req.callback)
+            completed.req.callback(completed.req.pCallbackData, reqResult);
+    }
+    _completedRequests.clear();
+}
@@ -9,11 +9,18 @@
 #pragma once
 
 #include <list>
+#include <vector>
 #include <stdint.h>
 #include "RaftThreading.h"
 #include "RaftBus.h"
 #include "RaftArduino.h"
 #include "RaftJsonIF.h"
+#include "BusRequestInfo.h"
+#include "BusSerialFramer.h"
+
+#ifdef ESP_PLATFORM
+#include "freertos/queue.h"
+#endif
 
 class BusSerial : public RaftBus
 {
@@ -28,6 +35,9 @@ public:
     /// @param busNum - bus number
     /// @param config - configuration
     /// @return true if setup was successful
+    /// @note If a "frame" object is present in the config (see BusSerialFramer) then received data is handled
+    ///       by a receive task which assembles frames and matches them to outstanding requests - otherwise
+    ///       received data must be polled using rxDataBytesAvailable()/rxDataGet()
     virtual bool setup(BusNumType busNum, const RaftJsonIF& config) override final;
 
     /// @brief Loop
@@ -62,21 +72,41 @@ public:
     /// @brief Request bus action
     /// @param busReqInfo - bus request information
     /// @return true if the request was added successfully
+    /// @note In framed mode a request with a callback is held until a matching response frame arrives (the callback
+    ///       is then called from the receive task) or until respTimeoutMs elapses (result RAFT_BUS_SW_TIME_OUT)
     virtual bool addRequest(BusRequestInfo& busReqInfo) override final;
 
     /// @brief Clear receive buffer
     virtual void rxDataClear() override final;
 
     /// @brief Received data bytes available
-    /// @return number of bytes available to read
+    /// @return number of bytes available to read (in framed mode the length of the next unsolicited frame)
     virtual uint32_t rxDataBytesAvailable() const override final;
 
     /// @brief Get rx data
     /// @param pData - buffer to store the data (should be at least as big as maxLen)
     /// @param maxLen - maximum number of bytes to read
-    /// @return number of bytes read
+    /// @return number of bytes read (in framed mode a single unsolicited frame, truncated to maxLen)
     virtual uint32_t rxDataGet(uint8_t* pData, uint32_t maxLen) override final;
 
+    /// @brief Get bus statistics as a JSON string
+    /// @return JSON string
+    virtual String getBusStatsJSON() const override final;
+
+    /// @brief Get number of requests awaiting a response (framed mode)
+    /// @return number of queued requests
+    virtual uint32_t getQueuedRequestCount() const override final;
+
+    /// @brief Get number of unsolicited frames waiting to be read (framed mode)
+    /// @return number of pending frames
+    virtual uint32_t getPendingPollResultCount() const override final;
+
+    /// @brief Check if received data is handled by the receive task (framed mode)
+    bool isFramed() const
+    {
+        return _framer.isEnabled();
+    }
+
     /// @brief Create function to create a new instance of this class
     /// @param busElemStatusCB - callback for bus element status changes
     /// @param busOperationStatusCB - callback for bus operation status changes
@@ -98,16 +128,94 @@ private:
     uint32_t _minTimeBetweenSendsMs;
     uint32_t _lastSendTimeMs;
 
+#ifndef ESP_PLATFORM
+    // Serial device path and file descriptor (termios)
+    String _devPath;
+    int _devFd = -1;
+#endif
+
     // isInitialised
     bool _isInitialised;
 
+    // Framing of received data
+    BusSerialFramer _framer;
+
+    // Response matching - if _matchAddrPos >= 0 then the byte at that position in a response frame is
+    // matched against the low byte of request addresses, otherwise responses are matched in order
+    uint32_t _respTimeoutMs = RESP_TIMEOUT_MS_DEFAULT;
+    int32_t _matchAddrPos = -1;
+
+    // Outstanding requests
+    class PendingRequest
+    {
+    public:
+        BusElemAddrType address = 0;
+        uint32_t cmdId = 0;
+        BusRequestCallbackType callback = nullptr;
+        void* pCallbackData = nullptr;
+        uint64_t sendTimeUs = 0;
+        uint32_t seqNum = 0;
+    };
+    std::list<PendingRequest> _pendingRequests;
+    uint32_t _pendingReqSeqNum = 0;
+    uint32_t _maxPendingRequests = MAX_PENDING_REQUESTS_DEFAULT;
+
+    // Unsolicited frames (not matched to a request)
+    std::list<std::vector<uint8_t>> _rxFrames;
+    uint32_t _maxRxFrames = MAX_RX_FRAMES_DEFAULT;
+
+    // Mutex for pending requests and rx frames
+    mutable RaftMutex _accessMutex;
+
+    // Receive task
+    RaftThreadHandle _rxTaskHandle = RAFT_THREAD_HANDLE_INVALID;
+    RaftAtomicBool _rxTaskStop;
+    RaftSemaphore _rxTaskExitSem;
+#ifdef ESP_PLATFORM
+    QueueHandle_t _uartEventQueue = nullptr;
+#endif
+
+    // Stats
+    uint32_t _statsRespMatched = 0;
+    uint32_t _statsUnsolicited = 0;
+    uint32_t _statsRespTimeouts = 0;
+    uint32_t _statsRxFramesDropped = 0;
+    uint64_t _statsRespLatencyTotalUs = 0;
+    uint32_t _statsRespLatencyMaxUs = 0;
+
+    // Completed requests (only used within the receive task)
+    class CompletedRequest
+    {
+    public:
+        PendingRequest req;
+        RaftRetCode result = RAFT_OK;
+        std::vector<uint8_t> respData;
+    };
+    std::vector<CompletedRequest> _completedRequests;
+
     // Defaults
     static const uint32_t BAUD_RATE_DEFAULT = 115200;
     static const uint32_t RX_BUF_SIZE_DEFAULT = 256;
     static const uint32_t TX_BUF_SIZE_DEFAULT = 256;
+    static const uint32_t RESP_TIMEOUT_MS_DEFAULT = 100;
+    static const uint32_t MAX_PENDING_REQUESTS_DEFAULT = 10;
+    static const uint32_t MAX_RX_FRAMES_DEFAULT = 10;
+    static const uint32_t RX_TASK_WAIT_MS = 10;
+    static const uint32_t RX_TASK_STACK_SIZE = 4000;
+    static const uint32_t UART_EVENT_QUEUE_SIZE = 20;
+    static const uint32_t RX_READ_BUF_SIZE = 128;
 
     // Helpers
     bool serialInit();
+    void serialDeinit();
+    bool startRxTask();
+    void stopRxTask();
+    static void rxTaskFn(void* pArg);
+    void rxTaskLoop();
+    void processRxBytes(const uint8_t* pData, uint32_t dataLen);
+    void handleFrame(const uint8_t* pFrame, uint32_t frameLen);
+    void serviceTimeouts();
+    void dispatchCompleted();
 
     // Debug
     static constexpr const char* MODULE_PREFIX = "BusSerial";
@@ -0,0 +1,182 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// BusSerialFramer
+// Assembles received serial bytes into frames using configurable delimiter/length/idle-gap rules
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "BusSerialFramer.h"
+#include "RaftUtils.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor
+BusSerialFramer::BusSerialFramer()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Setup from config
+/// @param config JSON config
+void BusSerialFramer::setup(const RaftJsonIF& config)
+{
+    // Frame type
+    String typeStr = config.getString("type", "");
+    _frameType = FRAME_TYPE_NONE;
+    if (typeStr.equalsIgnoreCase("delim"))
+        _frameType = FRAME_TYPE_DELIM;
+    else if (typeStr.equalsIgnoreCase("len"))
+        _frameType = FRAME_TYPE_LENGTH;
+    else if (typeStr.equalsIgnoreCase("idle"))
+        _frameType = FRAME_TYPE_IDLE;
+
+    // Sequences
+    _startSeq = Raft::getBytesFromHexStr(config.getString("start", "").c_str(), 16);
+    _delimSeq = Raft::getBytesFromHexStr(config.getString("delim", "0a").c_str(), 16);
+    if ((_frameType == FRAME_TYPE_DELIM) && _delimSeq.empty())
+        _frameType = FRAME_TYPE_NONE;
+
+    // Length rules
+    _fixedLen = config.getLong("fixedLen", 0);
+    _lenPos = config.getLong("lenPos", 0);
+    _lenBytes = config.getLong("lenBytes", 1);
+    if (_lenBytes > 4)
+        _lenBytes = 4;
+    _lenBigEndian = config.getBool("lenBE", true);
+    _lenAdj = config.getLong("lenAdj", 0);
+    _maxLen = config.getLong("maxLen", MAX_LEN_DEFAULT);
+
+    // Idle gap
+    _idleUs = config.getLong("idleMs", _frameType == FRAME_TYPE_IDLE ? 5 : 0) * 1000;
+    clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add received bytes
+/// @param pData received data
+/// @param dataLen length of received data
+/// @param timeNowUs time of reception
+/// @param frameCB callback for each frame completed
+void BusSerialFramer::addBytes(const uint8_t* pData, uint32_t dataLen, uint64_t timeNowUs, const BusSerialFrameCB& frameCB)
+{
+    // A gap before these bytes ends (or invalidates) any partial frame
+    checkIdle(timeNowUs, frameCB);
+    _lastRxTimeUs = timeNowUs;
+
+    // Process bytes
+    for (uint32_t i = 0; i < dataLen; i++)
+        addByte(pData[i], frameCB);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Service idle-gap processing
+/// @param timeNowUs current time
+/// @param frameCB callback for a frame completed by the idle gap
+void BusSerialFramer::checkIdle(uint64_t timeNowUs, const BusSerialFrameCB& frameCB)
+{
+    if ((_idleUs == 0) || _frameBuf.empty() || (timeNowUs - _lastRxTimeUs < _idleUs))
+        return;
+    if (_frameType == FRAME_TYPE_IDLE)
+        completeFrame(frameCB);
+    else
+        discardFrame();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add a single byte
+/// @param byte received byte
+/// @param frameCB callback for a completed frame
+void BusSerialFramer::addByte(uint8_t byte, const BusSerialFrameCB& frameCB)
+{
+    // Hunt for start sequence
+    if (_frameBuf.size() < _startSeq.size())
+    {
+        if (byte != _startSeq[_frameBuf.size()])
+        {
+            _frameBuf.clear();
+            if (byte != _startSeq[0])
+                return;
+        }
+    }
+
+    // Add to frame
+    _frameBuf.push_back(byte);
+    if (_frameBuf.size() > _maxLen)
+    {
+        discardFrame();
+        return;
+    }
+
+    // Check for completion
+    switch (_frameType)
+    {
+        case FRAME_TYPE_DELIM:
+        {
+            uint32_t frameLen = _frameBuf.size();
+            uint32_t delimLen = _delimSeq.size();
+            if ((frameLen >= _startSeq.size() + delimLen) &&
+                        (memcmp(_frameBuf.data() + frameLen - delimLen, _delimSeq.data(), delimLen) == 0))
+            {
+                // Delimiter is not included in the frame and empty frames (blank lines) are discarded
+                _frameBuf.resize(frameLen - delimLen);
+                if (_frameBuf.empty())
+                    discardFrame();
+                else
+                    completeFrame(frameCB);
+            }
+            break;
+        }
+        case FRAME_TYPE_LENGTH:
+        {
+            uint32_t frameLen = _frameBuf.size();
+            if (_fixedLen > 0)
+            {
+                if (frameLen >= _fixedLen)
+                    completeFrame(frameCB);
+                break;
+            }
+            if (frameLen == _lenPos + _lenBytes)
+            {
+                // Extract length field
+                uint32_t lenField = 0;
+                for (uint32_t i = 0; i < _lenBytes; i++)
+                {
+                    uint32_t byteIdx = _lenBigEndian ? _lenPos + i : _lenPos + _lenBytes - 1 - i;
+                    lenField = (lenField << 8) | _frameBuf[byteIdx];
+                }
+                int64_t expectedLen = (int64_t)lenField + _lenAdj;
+                if ((expectedLen < (int64_t)frameLen) || (expectedLen > _maxLen))
+                {
+                    discardFrame();
+                    break;
+                }
+                _expectedLen = expectedLen;
+            }
+            if ((_expectedLen > 0) && (frameLen >= _expectedLen))
+                completeFrame(frameCB);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Complete the current frame
+/// @param frameCB callback for the frame
+void BusSerialFramer::completeFrame(const BusSerialFrameCB& frameCB)
+{
+    if (frameCB)
+        frameCB(_frameBuf.data(), _frameBuf.size());
+    clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Discard the current frame
+void BusSerialFramer::discardFrame()
+{
+    _discardCount++;
+    clear();
+}
@@ -0,0 +1,103 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// BusSerialFramer
+// Assembles received serial bytes into frames using configurable delimiter/length/idle-gap rules
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <stdint.h>
+#include "RaftJsonIF.h"
+
+// Callback for each complete frame
+typedef std::function<void(const uint8_t* pFrame, uint32_t frameLen)> BusSerialFrameCB;
+
+class BusSerialFramer
+{
+public:
+    enum FrameType
+    {
+        FRAME_TYPE_NONE,        // No framing - bytes are not assembled into frames
+        FRAME_TYPE_DELIM,       // Frame ends with a delimiter sequence (e.g. "\r\n")
+        FRAME_TYPE_LENGTH,      // Frame length is fixed or read from a length field in the frame header
+        FRAME_TYPE_IDLE,        // Frame ends when the line has been idle for idleMs
+    };
+
+    BusSerialFramer();
+
+    /// @brief Setup from config
+    /// @param config JSON config e.g. {"type":"delim","delim":"0d0a"} or
+    ///        {"type":"len","start":"aa","lenPos":1,"lenBytes":1,"lenAdj":3} or {"type":"idle","idleMs":5}
+    /// @note  common options are "start" (hex start sequence - bytes before it are discarded), "maxLen"
+    ///        (longer frames are discarded) and "idleMs" (an incomplete frame is discarded after this gap)
+    void setup(const RaftJsonIF& config);
+
+    /// @brief Check if framing is enabled
+    bool isEnabled() const
+    {
+        return _frameType != FRAME_TYPE_NONE;
+    }
+
+    /// @brief Add received bytes
+    /// @param pData received data
+    /// @param dataLen length of received data
+    /// @param timeNowUs time of reception
+    /// @param frameCB callback for each frame completed
+    void addBytes(const uint8_t* pData, uint32_t dataLen, uint64_t timeNowUs, const BusSerialFrameCB& frameCB);
+
+    /// @brief Service idle-gap processing (completes idle-terminated frames and discards stale partial frames)
+    /// @param timeNowUs current time
+    /// @param frameCB callback for a frame completed by the idle gap
+    void checkIdle(uint64_t timeNowUs, const BusSerialFrameCB& frameCB);
+
+    /// @brief Get the idle period in us (0 if not used)
+    uint32_t getIdleUs() const
+    {
+        return _idleUs;
+    }
+
+    /// @brief Clear any partial frame
+    void clear()
+    {
+        _frameBuf.clear();
+        _expectedLen = 0;
+    }
+
+    /// @brief Get number of frames discarded (overlength or incomplete)
+    uint32_t getDiscardCount() const
+    {
+        return _discardCount;
+    }
+
+private:
+    // Settings
+    FrameType _frameType = FRAME_TYPE_NONE;
+    std::vector<uint8_t> _startSeq;
+    std::vector<uint8_t> _delimSeq;
+    uint32_t _fixedLen = 0;
+    uint32_t _lenPos = 0;
+    uint32_t _lenBytes = 0;
+    bool _lenBigEndian = true;
+    int32_t _lenAdj = 0;
+    uint32_t _maxLen = MAX_LEN_DEFAULT;
+    uint32_t _idleUs = 0;
+
+    // State
+    std::vector<uint8_t> _frameBuf;
+    uint32_t _expectedLen = 0;
+    uint64_t _lastRxTimeUs = 0;
+    uint32_t _discardCount = 0;
+
+    // Defaults
+    static const uint32_t MAX_LEN_DEFAULT = 256;
+
+    // Helpers
+    void addByte(uint8_t byte, const BusSerialFrameCB& frameCB);
+    void completeFrame(const BusSerialFrameCB& frameCB);
+    void discardFrame();
+};
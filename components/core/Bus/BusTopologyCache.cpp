@@ -0,0 +1,397 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// BusTopologyCache
+// Persisted map of bus addresses to device types used to warm-start device detection
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "BusTopologyCache.h"
+#include "RaftJson.h"
+#include "RaftUtils.h"
+#include "Logger.h"
+#include "FileSystem.h"
+#include "DeviceTypeRecords.h"
+
+// #define DEBUG_BUS_TOPOLOGY_CACHE
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor
+BusTopologyCache::BusTopologyCache()
+{
+    RaftMutex_init(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Destructor
+BusTopologyCache::~BusTopologyCache()
+{
+    RaftMutex_destroy(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Setup (loads the persisted topology if enabled)
+/// @param busName name of the bus (used in the default filename)
+/// @param config bus configuration - "topoCache" enables and "topoFile" overrides the filename
+void BusTopologyCache::setup(const String& busName, const RaftJsonIF& config)
+{
+    if (!config.getBool("topoCache", false))
+        return;
+    String filename = config.getString("topoFile", ("__topo_" + busName + ".json").c_str());
+    setup(config.getString("topoFS", "local"), filename);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Setup with explicit file (loads the persisted topology)
+/// @param fileSystemStr file system
+/// @param filename filename
+void BusTopologyCache::setup(const String& fileSystemStr, const String& filename)
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    _fileSystemStr = fileSystemStr;
+    _filename = filename;
+    _isEnabled = true;
+    load();
+    RaftMutex_unlock(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Loop (saves changes after they have settled)
+void BusTopologyCache::loop()
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    bool saveRequired = _isDirty && Raft::isTimeout(millis(), _lastChangeMs, SAVE_AFTER_CHANGE_MS);
+    RaftMutex_unlock(_cacheMutex);
+    if (saveRequired)
+        save();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Handle bus element status changes (called by the bus with its status change list)
+/// @param statusChanges status changes
+void BusTopologyCache::handleStatusChanges(const std::vector<BusAddrStatus>& statusChanges)
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    if (!_isEnabled)
+    {
+        RaftMutex_unlock(_cacheMutex);
+        return;
+    }
+    for (const BusAddrStatus& status : statusChanges)
+    {
+        auto it = findKnown(status.address);
+        if ((status.onlineState == DeviceOnlineState::ONLINE) && (status.deviceTypeIndex != DEVICE_TYPE_INDEX_INVALID))
+        {
+            // Identified (a device identified by normal scanning also counts as verified)
+            if (it == _knownDevs.end())
+            {
+                _knownDevs.push_back(KnownDev(status.address, status.deviceTypeIndex, false));
+            }
+            else
+            {
+                if (it->awaitingVerify)
+                    _numAwaitingVerify--;
+                it->awaitingVerify = false;
+                if (it->deviceTypeIndex == status.deviceTypeIndex)
+                    continue;
+                it->deviceTypeIndex = status.deviceTypeIndex;
+            }
+        }
+        else if ((status.onlineState == DeviceOnlineState::PENDING_DELETION) && (it != _knownDevs.end()))
+        {
+            // Removed (devices which are just offline are kept as they may well be present on the next boot)
+            if (it->awaitingVerify)
+                _numAwaitingVerify--;
+            _knownDevs.erase(it);
+        }
+        else
+        {
+            continue;
+        }
+        _isDirty = true;
+        _lastChangeMs = millis();
+
+#ifdef DEBUG_BUS_TOPOLOGY_CACHE
+        LOG_I(MODULE_PREFIX, "handleStatusChanges addr %04x state %s devTypeIdx %d numKnown %d",
+                    status.address, BusAddrStatus::getOnlineStateStr(status.onlineState),
+                    status.deviceTypeIndex, _knownDevs.size());
+#endif
+    }
+    RaftMutex_unlock(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get next known device to verify at warm start
+/// @param address (out) address
+/// @param deviceTypeIndex (out) device type index expected at the address
+/// @return true if there is a device awaiting verification
+bool BusTopologyCache::getNextToVerify(BusElemAddrType& address, DeviceTypeIndexType& deviceTypeIndex) const
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return false;
+    bool found = false;
+    for (const KnownDev& knownDev : _knownDevs)
+    {
+        if ((_numAwaitingVerify > 0) && knownDev.awaitingVerify)
+        {
+            address = knownDev.address;
+            deviceTypeIndex = knownDev.deviceTypeIndex;
+            found = true;
+            break;
+        }
+    }
+    RaftMutex_unlock(_cacheMutex);
+    return found;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Handle result of a targeted identification
+/// @param address address
+/// @param identified true if the expected device type was identified
+void BusTopologyCache::handleVerifyResult(BusElemAddrType address, bool identified)
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    auto it = findKnown(address);
+    if ((it == _knownDevs.end()) || !it->awaitingVerify)
+    {
+        RaftMutex_unlock(_cacheMutex);
+        return;
+    }
+    it->awaitingVerify = false;
+    _numAwaitingVerify--;
+
+#ifdef DEBUG_BUS_TOPOLOGY_CACHE
+    LOG_I(MODULE_PREFIX, "handleVerifyResult addr %04x devTypeIdx %d %s",
+                address, it->deviceTypeIndex, identified ? "VERIFIED" : "CHANGED");
+#endif
+
+    // A changed address is dropped so that normal scanning determines what (if anything) is there
+    if (!identified)
+    {
+        _knownDevs.erase(it);
+        _isDirty = true;
+        _lastChangeMs = millis();
+    }
+    RaftMutex_unlock(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Check if an address is awaiting verification (full scanning of it can be deferred)
+/// @param address address
+/// @return true if awaiting verification
+bool BusTopologyCache::isAwaitingVerify(BusElemAddrType address) const
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return false;
+    auto it = findKnown(address);
+    bool awaitingVerify = (_numAwaitingVerify > 0) && (it != _knownDevs.end()) && it->awaitingVerify;
+    RaftMutex_unlock(_cacheMutex);
+    return awaitingVerify;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Check if warm start verification is complete
+/// @return true if there are no devices awaiting verification
+bool BusTopologyCache::isVerifyComplete() const
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return true;
+    bool verifyComplete = _numAwaitingVerify == 0;
+    RaftMutex_unlock(_cacheMutex);
+    return verifyComplete;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get number of known devices
+/// @return number of known devices
+uint32_t BusTopologyCache::getNumKnown() const
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return 0;
+    uint32_t numKnown = _knownDevs.size();
+    RaftMutex_unlock(_cacheMutex);
+    return numKnown;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Save now (if there are unsaved changes)
+/// @return true if saved or nothing to save
+bool BusTopologyCache::save()
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return false;
+    if (!_isEnabled || !_isDirty)
+    {
+        RaftMutex_unlock(_cacheMutex);
+        return true;
+    }
+    _isDirty = false;
+
+    // Avoid rewriting identical contents (flash wear)
+    String jsonStr = getJsonNoLock();
+    String fileSystemStr = _fileSystemStr;
+    String filename = _filename;
+    bool isUnchanged = jsonStr == _lastSavedJson;
+    RaftMutex_unlock(_cacheMutex);
+    if (isUnchanged)
+        return true;
+
+    // File is written without the mutex held so that status changes are not held up
+    if (!fileSystem.setFileContents(fileSystemStr, filename, jsonStr))
+    {
+        LOG_W(MODULE_PREFIX, "save failed %s", filename.c_str());
+        return false;
+    }
+    if (RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+    {
+        _lastSavedJson = jsonStr;
+        RaftMutex_unlock(_cacheMutex);
+    }
+
+#ifdef DEBUG_BUS_TOPOLOGY_CACHE
+    LOG_I(MODULE_PREFIX, "save %s %s", _filename.c_str(), jsonStr.c_str());
+#endif
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Clear the cache (and the persisted topology)
+void BusTopologyCache::clear()
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    _knownDevs.clear();
+    _numAwaitingVerify = 0;
+    _isDirty = false;
+    _lastSavedJson = "";
+    bool deleteFile = _isEnabled;
+    String fileSystemStr = _fileSystemStr;
+    String filename = _filename;
+    RaftMutex_unlock(_cacheMutex);
+    if (deleteFile)
+        fileSystem.deleteFile(fileSystemStr, filename);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get JSON
+/// @return JSON string
+/// @note device types are stored by name as type indices can change between firmware builds
+String BusTopologyCache::getJson() const
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return "{}";
+    String jsonStr = getJsonNoLock();
+    RaftMutex_unlock(_cacheMutex);
+    return jsonStr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get JSON (mutex must be held)
+/// @return JSON string
+String BusTopologyCache::getJsonNoLock() const
+{
+    String jsonStr;
+    for (const KnownDev& knownDev : _knownDevs)
+    {
+        DeviceTypeRecord devTypeRec;
+        if (!deviceTypeRecords.getDeviceInfo(knownDev.deviceTypeIndex, devTypeRec))
+            continue;
+        char addrStr[20];
+        snprintf(addrStr, sizeof(addrStr), "{\"a\":%u,\"t\":\"", (unsigned int)knownDev.address);
+        jsonStr += (jsonStr.length() > 0 ? "," : "") + String(addrStr) + devTypeRec.deviceType + "\"}";
+    }
+    return "{\"devs\":[" + jsonStr + "]}";
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Load persisted topology (mutex must be held)
+/// @note Loaded devices are awaiting verification - addresses which the bus has already reported are kept
+///       as reported (and count as changes to save if they are not in the file)
+void BusTopologyCache::load()
+{
+    for (auto it = _knownDevs.begin(); it != _knownDevs.end();)
+    {
+        if (it->awaitingVerify)
+        {
+            // Previously loaded (setup called again) - reload from the file
+            it = _knownDevs.erase(it);
+            _numAwaitingVerify--;
+            continue;
+        }
+        _isDirty = true;
+        _lastChangeMs = millis();
+        ++it;
+    }
+    FileContentsCache::ContentsPtr pContents = fileSystem.getFileContentsShared(_fileSystemStr, _filename);
+    if (!pContents)
+        return;
+    _lastSavedJson = pContents->c_str();
+    RaftJson topoJson(_lastSavedJson);
+    std::vector<String> devList;
+    topoJson.getArrayElems("devs", devList);
+    for (RaftJson devJson : devList)
+    {
+        BusElemAddrType address = devJson.getInt("a", 0);
+        DeviceTypeIndexType deviceTypeIndex = DEVICE_TYPE_INDEX_INVALID;
+        if (!findDevTypeIdxForAddr(address, devJson.getString("t", ""), deviceTypeIndex))
+        {
+            LOG_I(MODULE_PREFIX, "load addr %04x type %s no longer valid", address, devJson.getString("t", "").c_str());
+            _isDirty = true;
+            continue;
+        }
+        if (findKnown(address) != _knownDevs.end())
+            continue;
+        _knownDevs.push_back(KnownDev(address, deviceTypeIndex, true));
+        _numAwaitingVerify++;
+    }
+
+#ifdef DEBUG_BUS_TOPOLOGY_CACHE
+    LOG_I(MODULE_PREFIX, "load %s numKnown %d", _filename.c_str(), _knownDevs.size());
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Find known device by address
+std::vector<BusTopologyCache::KnownDev>::iterator BusTopologyCache::findKnown(BusElemAddrType address)
+{
+    for (auto it = _knownDevs.begin(); it != _knownDevs.end(); ++it)
+        if (it->address == address)
+            return it;
+    return _knownDevs.end();
+}
+std::vector<BusTopologyCache::KnownDev>::const_iterator BusTopologyCache::findKnown(BusElemAddrType address) const
+{
+    for (auto it = _knownDevs.begin(); it != _knownDevs.end(); ++it)
+        if (it->address == address)
+            return it;
+    return _knownDevs.end();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Find the device type index for a device type name which is valid at an address
+/// @param address address (including slot)
+/// @param deviceTypeName device type name
+/// @param deviceTypeIndex (out) device type index
+/// @return true if found
+/// @note names are not unique (the same device type can have records for different address ranges) so a
+///       record for the address is preferred - composite addresses (e.g. including a slot) fall back to the name
+bool BusTopologyCache::findDevTypeIdxForAddr(BusElemAddrType address, const String& deviceTypeName,
+            DeviceTypeIndexType& deviceTypeIndex)
+{
+    for (DeviceTypeIndexType devTypeIdx : deviceTypeRecords.getDeviceTypeIdxsForAddr(address))
+    {
+        DeviceTypeRecord devTypeRec;
+        if (deviceTypeRecords.getDeviceInfo(devTypeIdx, devTypeRec) && deviceTypeName.equals(devTypeRec.deviceType))
+        {
+            deviceTypeIndex = devTypeIdx;
+            return true;
+        }
+    }
+    DeviceTypeRecord devTypeRec;
+    return (deviceTypeName.length() > 0) && deviceTypeRecords.getDeviceInfo(deviceTypeName, devTypeRec, deviceTypeIndex);
+}
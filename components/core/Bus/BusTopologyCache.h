@@ -0,0 +1,134 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// BusTopologyCache
+// Persisted map of bus addresses to device types used to warm-start device detection
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include "RaftArduino.h"
+#include "RaftThreading.h"
+#include "RaftBusConsts.h"
+#include "RaftDeviceConsts.h"
+#include "BusAddrStatus.h"
+
+class RaftJsonIF;
+
+/// @brief Bus topology cache
+/// The address and device type of every identified bus element is persisted (to a file) so that on the
+/// next boot a bus implementation can verify each known device with a single targeted identification
+/// (using only the known device type's detection values) before falling back to full scanning. Addresses
+/// which fail verification are dropped from the cache and are then found (or not) by normal scanning.
+/// Status changes arrive from the bus context while loop() and save() run from the main loop so access is
+/// protected by a mutex.
+class BusTopologyCache
+{
+public:
+    BusTopologyCache();
+    virtual ~BusTopologyCache();
+
+    /// @brief Setup (loads the persisted topology if enabled)
+    /// @param busName name of the bus (used in the default filename)
+    /// @param config bus configuration - "topoCache" enables and "topoFile" overrides the filename
+    /// @note Call before the bus starts scanning so that warm start data is available to the first scan
+    void setup(const String& busName, const RaftJsonIF& config);
+
+    /// @brief Setup with explicit file (loads the persisted topology)
+    /// @param fileSystemStr file system
+    /// @param filename filename
+    /// @note Devices already reported by the bus are kept - loaded devices are added for other addresses
+    void setup(const String& fileSystemStr, const String& filename);
+
+    /// @brief Loop (saves changes after they have settled)
+    void loop();
+
+    /// @brief Check if enabled
+    /// @return true if enabled
+    bool isEnabled() const
+    {
+        return _isEnabled;
+    }
+
+    /// @brief Handle bus element status changes (called by the bus with its status change list)
+    /// @param statusChanges status changes
+    void handleStatusChanges(const std::vector<BusAddrStatus>& statusChanges);
+
+    /// @brief Get next known device to verify at warm start
+    /// @param address (out) address
+    /// @param deviceTypeIndex (out) device type index expected at the address
+    /// @return true if there is a device awaiting verification
+    bool getNextToVerify(BusElemAddrType& address, DeviceTypeIndexType& deviceTypeIndex) const;
+
+    /// @brief Handle result of a targeted identification
+    /// @param address address
+    /// @param identified true if the expected device type was identified
+    void handleVerifyResult(BusElemAddrType address, bool identified);
+
+    /// @brief Check if an address is awaiting verification (full scanning of it can be deferred)
+    /// @param address address
+    /// @return true if awaiting verification
+    bool isAwaitingVerify(BusElemAddrType address) const;
+
+    /// @brief Check if warm start verification is complete
+    /// @return true if there are no devices awaiting verification
+    bool isVerifyComplete() const;
+
+    /// @brief Get number of known devices
+    /// @return number of known devices
+    uint32_t getNumKnown() const;
+
+    /// @brief Save now (if there are unsaved changes)
+    /// @return true if saved or nothing to save
+    bool save();
+
+    /// @brief Clear the cache (and the persisted topology)
+    void clear();
+
+    /// @brief Get JSON
+    /// @return JSON string
+    String getJson() const;
+
+    // Time after the last change before the topology is saved (ms)
+    static const uint32_t SAVE_AFTER_CHANGE_MS = 5000;
+
+private:
+    // Known device
+    class KnownDev
+    {
+    public:
+        KnownDev(BusElemAddrType address, DeviceTypeIndexType deviceTypeIndex, bool awaitingVerify) :
+            address(address), deviceTypeIndex(deviceTypeIndex), awaitingVerify(awaitingVerify)
+        {
+        }
+        BusElemAddrType address;
+        DeviceTypeIndexType deviceTypeIndex;
+        bool awaitingVerify;
+    };
+    std::vector<KnownDev> _knownDevs;
+    uint32_t _numAwaitingVerify = 0;
+
+    // Persistence
+    bool _isEnabled = false;
+    String _fileSystemStr;
+    String _filename;
+    bool _isDirty = false;
+    uint32_t _lastChangeMs = 0;
+    String _lastSavedJson;
+
+    // Mutex
+    mutable RaftMutex _cacheMutex;
+
+    // Helpers
+    void load();
+    String getJsonNoLock() const;
+    std::vector<KnownDev>::iterator findKnown(BusElemAddrType address);
+    std::vector<KnownDev>::const_iterator findKnown(BusElemAddrType address) const;
+    static bool findDevTypeIdxForAddr(BusElemAddrType address, const String& deviceTypeName, DeviceTypeIndexType& deviceTypeIndex);
+
+    // Debug
+    static constexpr const char* MODULE_PREFIX = "BusTopoCache";
+};
@@ -28,9 +28,12 @@ bool DeviceStatus::getPendingIdentPollInfo(uint64_t timeNowUs, DevicePollingInfo
     uint32_t callIntervalUs = isStartOfPoll ? deviceIdentPolling.pollIntervalUs : deviceIdentPolling.partialPollPauseAfterSendMs * 1000;
     if (Raft::isTimeout(timeNowUs, deviceIdentPolling.lastPollTimeUs, callIntervalUs))
     {
-        // Clear the poll result data if this is the start of the poll
+        // Clear the poll result data and record the request time if this is the start of the poll
         if (isStartOfPoll)
+        {
             pollInfo._pollDataResult.clear();
+            deviceIdentPolling.pollStartTimeUs = timeNowUs;
+        }
 
         // Update timestamp
         deviceIdentPolling.lastPollTimeUs = timeNowUs;
@@ -73,18 +76,36 @@ bool DeviceStatus::storePollResults(uint32_t nextReqIdx, uint64_t timeNowUs, con
     else
     {
         // Get the any partial poll results
-        std::vector<uint8_t> partialPollResult;
-        if (deviceIdentPolling.getPartialPollResultsAndClear(partialPollResult))
+        std::vector<uint8_t> completePollResult;
+        if (deviceIdentPolling.getPartialPollResultsAndClear(completePollResult))
         {
             // Add the new poll result to the partial poll result
-            partialPollResult.insert(partialPollResult.end(), pollResult.begin(), pollResult.end());
-
-            // Add complete poll result to aggregator
-            return pDataAggregator->put(timeNowUs, partialPollResult);
+            completePollResult.insert(completePollResult.end(), pollResult.begin(), pollResult.end());
+        }
+        else
+        {
+            completePollResult = pollResult;
         }
 
-        // Poll complete without partial poll - add result to aggregator
-        return pDataAggregator->put(timeNowUs, pollResult);
+        // Align the timestamp to the modelled sample time
+        uint64_t sampleTimeUs = deviceIdentPolling.getSampleTimeUs(timeNowUs, _sampleLatencyUs);
+        if (sampleTimeUs != timeNowUs)
+            setPollResultTimestamp(completePollResult, sampleTimeUs);
+
+        // Update state hash and add complete poll result to aggregator
+        updateStateHash(sampleTimeUs, completePollResult);
+        return pDataAggregator->put(sampleTimeUs, completePollResult);
     }
     return true;
 }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Set the timestamp at the start of a poll result
+/// @param pollResult poll result data (starting with a timestamp)
+/// @param timeUs time in us
+void DeviceStatus::setPollResultTimestamp(std::vector<uint8_t>& pollResult, uint64_t timeUs)
+{
+    if (pollResult.size() < DevicePollingInfo::POLL_RESULT_TIMESTAMP_SIZE)
+        return;
+    Raft::setBEUInt16(pollResult.data(), 0, (timeUs / DevicePollingInfo::POLL_RESULT_RESOLUTION_US) & 0xffff);
+}
@@ -13,6 +13,7 @@
 #include "DevicePollingInfo.h"
 #include "PollDataAggregatorIF.h"
 #include "RaftDeviceConsts.h"
+#include "RaftStateHash.h"
 #include <memory>
 
 class DeviceStatus
@@ -30,6 +31,7 @@ public:
         deviceIdentPolling.clear();
         if (pDataAggregator)
             pDataAggregator->clear();
+        _stateHash = 0;
     }
 
     bool isValid() const
@@ -85,6 +87,53 @@ public:
         return 0;
     }
 
+    /// @brief Get state hash
+    /// @return 64-bit hash which changes whenever a new poll result is stored
+    /// @note This is maintained incrementally in storePollResults() so it is cheap to read - buses
+    ///       should combine it with the device address using RaftStateHashSet::elemHash()
+    uint64_t getStateHash() const
+    {
+        return _stateHash;
+    }
+
+    /// @brief Update this device's element in a bus state hash set
+    /// @param hashSet bus state hash set
+    /// @param elemID element identity (e.g. bus address)
+    /// @param isOnline device online state (so that online/offline changes also change the set hash)
+    /// @return true if the element changed
+    /// @note Only the changed element is replaced so the bus hash is maintained in O(changed devices)
+    bool syncStateHashSet(RaftStateHashSet& hashSet, uint64_t elemID, bool isOnline)
+    {
+        uint64_t elemHash = RaftStateHashSet::elemHash(elemID, RaftStateHash::combine(_stateHash, isOnline ? 1 : 0));
+        if (_inStateHashSet && (elemHash == _stateHashSetElem))
+            return false;
+        if (_inStateHashSet)
+            hashSet.replace(_stateHashSetElem, elemHash);
+        else
+            hashSet.add(elemHash);
+        _stateHashSetElem = elemHash;
+        _inStateHashSet = true;
+        return true;
+    }
+
+    /// @brief Remove this device's element from a bus state hash set
+    /// @param hashSet bus state hash set
+    void removeFromStateHashSet(RaftStateHashSet& hashSet)
+    {
+        if (_inStateHashSet)
+            hashSet.remove(_stateHashSetElem);
+        _inStateHashSet = false;
+    }
+
+    /// @brief Set sample latency compensation for the bus this device is on
+    /// @param latencyUs time from a request being issued to it reaching the device (us)
+    /// @note Poll result timestamps are set to the modelled sample time (poll request time + latency +
+    ///       device sample delay) so that results from different buses can be correlated
+    void setSampleLatencyUs(int32_t latencyUs)
+    {
+        _sampleLatencyUs = latencyUs;
+    }
+
     /// @brief Set the data aggregator (shared ownership to allow safe copies of DeviceStatus)
     /// @param pAggregator 
     void setAndOwnPollDataAggregator(std::shared_ptr<PollDataAggregatorIF> pAggregator)
@@ -103,4 +152,29 @@ public:
 
     // Debug
     static constexpr const char* MODULE_PREFIX = "RaftI2CDevStat";    
+
+private:
+    // State hash (updated as poll results are stored)
+    uint64_t _stateHash = 0;
+
+    // Element hash currently in the bus state hash set
+    uint64_t _stateHashSetElem = 0;
+    bool _inStateHashSet = false;
+
+    // Sample latency compensation for the bus (us)
+    int32_t _sampleLatencyUs = 0;
+
+    /// @brief Set the timestamp at the start of a poll result
+    /// @param pollResult poll result data (starting with a timestamp)
+    /// @param timeUs time in us
+    static void setPollResultTimestamp(std::vector<uint8_t>& pollResult, uint64_t timeUs);
+
+    /// @brief Update state hash with a complete poll result
+    /// @param timeNowUs time of poll result
+    /// @param pollResult poll result data
+    void updateStateHash(uint64_t timeNowUs, const std::vector<uint8_t>& pollResult)
+    {
+        _stateHash = RaftStateHash::hashBytes(pollResult.data(), pollResult.size(), 
+                    RaftStateHash::combine(_stateHash, timeNowUs));
+    }
 };
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <vector>
+#include <atomic>
 #include <functional>
 #include "RaftArduino.h"
 #include "RaftBusConsts.h"
@@ -16,6 +17,9 @@
 #include "RaftBusDevicesIF.h"
 #include "VirtualPinResult.h"
 #include "BusAddrStatus.h"
+#include "RaftStateHash.h"
+#include "DeviceStatus.h"
+#include "BusTopologyCache.h"
 
 class BusRequestInfo;
 class RaftBus;
@@ -153,6 +157,22 @@ public:
         return _busStats.getStatsJSON(getBusName());
     }
 
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Get number of requests queued on the bus (not yet completed)
+    /// @return number of queued requests (used for backlog reporting)
+    virtual uint32_t getQueuedRequestCount() const
+    {
+        return 0;
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Get number of poll results (or received frames) waiting to be processed
+    /// @return number of pending results (used for backlog reporting)
+    virtual uint32_t getPendingPollResultCount() const
+    {
+        return 0;
+    }
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Set device polling interval (us) for an address, if supported by the bus
     /// @param address Composite bus element address
@@ -307,6 +327,19 @@ public:
         return 0;
     }
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Get 64-bit hash of the state of all devices on the bus (for change detection)
+    /// @return hash value which changes when any device's online status or data changes
+    /// @note Buses which own DeviceStatus records call updateDeviceStateHash() when a device's poll data or
+    ///       online state changes so only changed devices are rehashed - otherwise this falls back to
+    ///       hashing getDeviceInfoTimestampMs()
+    virtual uint64_t getDevicesStateHash() const
+    {
+        if (_devicesStateHashInUse.load(std::memory_order_acquire))
+            return _devicesStateHash.load(std::memory_order_relaxed);
+        return RaftStateHash::hashValue(getDeviceInfoTimestampMs(true, true));
+    }
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Get bus status (JSON)
     /// @return JSON string
@@ -356,6 +389,7 @@ public:
     /// @param busElemStatusCB - callback for bus element status changes
     void callBusElemStatusCB(const std::vector<BusAddrStatus>& statusChanges)
     {
+        _topologyCache.handleStatusChanges(statusChanges);
         if (_busElemStatusCB)
             _busElemStatusCB(*this, statusChanges);
     }
@@ -376,6 +410,15 @@ public:
         return _busStats;
     }
 
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Get bus topology cache
+    /// @note Bus implementations use this at startup to verify previously identified devices (with a single
+    ///       targeted identification each) before full scanning - see BusTopologyCache
+    BusTopologyCache& getTopologyCache()
+    {
+        return _topologyCache;
+    }
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Get bus number
     /// @return bus number
@@ -384,9 +427,68 @@ public:
         return _busNum;
     }
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Set sample latency compensation
+    /// @param latencyUs time from a request being issued to it reaching a device on this bus (us)
+    /// @note Applied by initDeviceStatus() to device records created after this is called (RaftBusSystem sets
+    ///       it before setup) so that poll result timestamps from all buses are aligned on the shared micros()
+    ///       timebase
+    void setSampleLatencyUs(int32_t latencyUs)
+    {
+        _sampleLatencyUs = latencyUs;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Get sample latency compensation
+    /// @return latency in us
+    int32_t getSampleLatencyUs() const
+    {
+        return _sampleLatencyUs;
+    }
+
 protected:
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Initialise a device status record with bus-wide settings
+    /// @param deviceStatus device status (call when the bus creates a record for a device)
+    void initDeviceStatus(DeviceStatus& deviceStatus) const
+    {
+        deviceStatus.setSampleLatencyUs(_sampleLatencyUs);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Update a device's contribution to the bus state hash
+    /// @param address device address on the bus
+    /// @param deviceStatus device status (after storing poll results or changing online state)
+    /// @param isOnline device online state
+    /// @note Must be called from a single context (e.g. the bus worker) - the result is published atomically
+    ///       for getDevicesStateHash()
+    void updateDeviceStateHash(BusElemAddrType address, DeviceStatus& deviceStatus, bool isOnline)
+    {
+        if (!deviceStatus.syncStateHashSet(_devicesStateHashSet, address, isOnline))
+            return;
+        _devicesStateHash.store(_devicesStateHashSet.get(), std::memory_order_relaxed);
+        _devicesStateHashInUse.store(true, std::memory_order_release);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Remove a device from the bus state hash (when its record is discarded)
+    /// @param deviceStatus device status
+    void removeDeviceStateHash(DeviceStatus& deviceStatus)
+    {
+        deviceStatus.removeFromStateHashSet(_devicesStateHashSet);
+        _devicesStateHash.store(_devicesStateHashSet.get(), std::memory_order_relaxed);
+    }
+
     BusNumType _busNum = RaftDeviceID::BUS_NUM_FIRST_BUS;
+    int32_t _sampleLatencyUs = 0;
     RaftBusStats _busStats;
+    BusTopologyCache _topologyCache;
     BusElemStatusCB _busElemStatusCB;
     BusOperationStatusCB _busOperationStatusCB;
+
+private:
+    // Incrementally maintained hash of device states (see updateDeviceStateHash)
+    RaftStateHashSet _devicesStateHashSet;
+    std::atomic<uint64_t> _devicesStateHash{0};
+    std::atomic<bool> _devicesStateHashInUse{false};
 };
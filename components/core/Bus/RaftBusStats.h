@@ -9,27 +9,30 @@
 #pragma once
 
 #include <stdio.h>
+#include <atomic>
 #include "RaftArduino.h"
-#include "RaftBusStats.h"
 
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+/// @brief Bus statistics
+/// Counters are updated from bus worker contexts (tasks, callbacks) and read from the main loop. To keep the
+/// per-transaction cost low each counter is split into shards (one per core on ESP32, one per thread slot on
+/// Linux) which are incremented with relaxed atomics and summed when read - so there is no locking and little
+/// cache-line contention on the hot path. A task migrating between cores mid-update is harmless as each shard
+/// update is itself atomic. Rates (transactions, errors and bytes per second) are computed over a rolling window
+/// of snapshots taken by sampleRates() which must be called from a single context (the bus system loop).
 class RaftBusStats
 {
-public:
-    
 public:
     // Constructor
     RaftBusStats()
     {
-        _busInteractionCount = 0;
-        _respBufferFulls = 0;
-        _reqBufferFulls = 0;
-        _pollCompletes = 0;
-        _cmdCompletes = 0;
-        _respQueueCount = 0;
-        _respQueuePeak = 0;
-        _reqQueueCount = 0;
-        _reqQueuePeak = 0;
-        _respLengthError = 0;
+        for (Shard& shard : _shards)
+            for (std::atomic<uint32_t>& count : shard.counts)
+                count.store(0, std::memory_order_relaxed);
     }
     virtual ~RaftBusStats()
     {
@@ -38,88 +41,214 @@ public:
     // Get stats
     String getStatsJSON(const String& busName) const
     {
-        char outStr[150];
-            snprintf(outStr, sizeof(outStr), R"("%s":{"cnt":%d,"reqF":%d,"reqQ":%d,"reqQPk":%d,"rspF":%d,"rspQ":%d,"rspQPk":%d,"rspE":%d,"poll":%d,"cmds":%d})",
+        char outStr[300];
+        snprintf(outStr, sizeof(outStr),
+                R"("%s":{"cnt":%u,"reqF":%u,"reqQ":%u,"reqQPk":%u,"rspF":%u,"rspQ":%u,"rspQPk":%u,"rspE":%u,"poll":%u,"cmds":%u,)"
+                R"("bytes":%u,"txnPS":%u,"errPS":%u,"bytesPS":%u})",
                 busName.c_str(),
-                (unsigned int)_busInteractionCount, 
-                (unsigned int)_reqBufferFulls, (unsigned int)_reqQueueCount, (unsigned int)_reqQueuePeak,
-                (unsigned int)_respBufferFulls, (unsigned int)_respQueueCount, (unsigned int)_respQueuePeak, 
-                (unsigned int)_respLengthError, (unsigned int)_pollCompletes, (unsigned int)_cmdCompletes);
+                (unsigned int)getCount(COUNT_ACTIVITY),
+                (unsigned int)getCount(COUNT_REQ_BUFFER_FULL), (unsigned int)_reqQueueCount.load(std::memory_order_relaxed),
+                (unsigned int)_reqQueuePeak.load(std::memory_order_relaxed),
+                (unsigned int)getCount(COUNT_RESP_BUFFER_FULL), (unsigned int)_respQueueCount.load(std::memory_order_relaxed),
+                (unsigned int)_respQueuePeak.load(std::memory_order_relaxed),
+                (unsigned int)getCount(COUNT_RESP_LENGTH_ERROR), (unsigned int)getCount(COUNT_POLL_COMPLETE),
+                (unsigned int)getCount(COUNT_CMD_COMPLETE), (unsigned int)getCount(COUNT_BYTES),
+                (unsigned int)_txnPerSec.load(std::memory_order_relaxed),
+                (unsigned int)_errPerSec.load(std::memory_order_relaxed),
+                (unsigned int)_bytesPerSec.load(std::memory_order_relaxed));
         return outStr;
     }
-    
+
     // Record activity
     void activity()
     {
-        _busInteractionCount++;
+        increment(COUNT_ACTIVITY);
     }
 
     void respBufferFull()
     {
-        _respBufferFulls++;
+        increment(COUNT_RESP_BUFFER_FULL);
     }
 
     void reqBufferFull()
     {
-        _reqBufferFulls++;
+        increment(COUNT_REQ_BUFFER_FULL);
     }
 
     void pollComplete()
     {
-        _pollCompletes++;
+        increment(COUNT_POLL_COMPLETE);
     }
 
     void cmdComplete()
     {
-        _cmdCompletes++;
+        increment(COUNT_CMD_COMPLETE);
     }
 
     void respLengthError()
     {
-        _respLengthError++;
+        increment(COUNT_RESP_LENGTH_ERROR);
+    }
+
+    void bytesTransferred(uint32_t numBytes)
+    {
+        increment(COUNT_BYTES, numBytes);
     }
 
     void respQueueCount(uint32_t count)
     {
-        // LOG_I("BUSSTATS", "respQueueCount %d pk %d", count, _respQueuePeak);
-        _respQueueCount = count;
-        if (_respQueuePeak < _respQueueCount)
-            _respQueuePeak = _respQueueCount;
+        _respQueueCount.store(count, std::memory_order_relaxed);
+        updatePeak(_respQueuePeak, count);
     }
 
     void reqQueueCount(uint32_t count)
     {
-        // LOG_I("BUSSTATS", "reqQueueCount %d pk %d", count, _reqQueuePeak);
-        _reqQueueCount = count;
-        if (_reqQueuePeak < _reqQueueCount)
-            _reqQueuePeak = _reqQueueCount;
+        _reqQueueCount.store(count, std::memory_order_relaxed);
+        updatePeak(_reqQueuePeak, count);
     }
 
-private:
-    // Count of calls
-    uint32_t _busInteractionCount;
+    // Counters
+    enum CounterIdx
+    {
+        COUNT_ACTIVITY,
+        COUNT_REQ_BUFFER_FULL,
+        COUNT_RESP_BUFFER_FULL,
+        COUNT_POLL_COMPLETE,
+        COUNT_CMD_COMPLETE,
+        COUNT_RESP_LENGTH_ERROR,
+        COUNT_BYTES,
+        COUNT_NUM_COUNTERS
+    };
+
+    /// @brief Get counter value (summed over shards)
+    /// @param counterIdx counter
+    /// @return value
+    uint32_t getCount(CounterIdx counterIdx) const
+    {
+        uint32_t total = 0;
+        for (const Shard& shard : _shards)
+            total += shard.counts[counterIdx].load(std::memory_order_relaxed);
+        return total;
+    }
 
-    // Request buffer fulls
-    uint32_t _reqBufferFulls;
+    /// @brief Get number of errors (buffer fulls and response length errors)
+    uint32_t getErrorCount() const
+    {
+        return getCount(COUNT_REQ_BUFFER_FULL) + getCount(COUNT_RESP_BUFFER_FULL) + getCount(COUNT_RESP_LENGTH_ERROR);
+    }
 
-    // Response buffer fulls
-    uint32_t _respBufferFulls;
+    /// @brief Sample counters for rate calculation (call regularly from a single context)
+    /// @param timeNowMs time now (ms)
+    void sampleRates(uint32_t timeNowMs)
+    {
+        // Snapshots are taken at most once per sample interval
+        RateSnapshot& latest = _rateSnapshots[(_rateSnapshotPos + RATE_WINDOW_SNAPSHOTS - 1) % RATE_WINDOW_SNAPSHOTS];
+        if ((_numRateSnapshots > 0) && (timeNowMs - latest.timeMs < RATE_SAMPLE_INTERVAL_MS))
+            return;
+        RateSnapshot& snapshot = _rateSnapshots[_rateSnapshotPos];
+        snapshot.timeMs = timeNowMs;
+        snapshot.txns = getCount(COUNT_ACTIVITY);
+        snapshot.errors = getErrorCount();
+        snapshot.bytes = getCount(COUNT_BYTES);
+        _rateSnapshotPos = (_rateSnapshotPos + 1) % RATE_WINDOW_SNAPSHOTS;
+        if (_numRateSnapshots < RATE_WINDOW_SNAPSHOTS)
+            _numRateSnapshots++;
+
+        // Rates over the window (from the oldest snapshot to this one)
+        if (_numRateSnapshots < 2)
+            return;
+        const RateSnapshot& oldest = _rateSnapshots[(_rateSnapshotPos + RATE_WINDOW_SNAPSHOTS - _numRateSnapshots) % RATE_WINDOW_SNAPSHOTS];
+        uint32_t windowMs = snapshot.timeMs - oldest.timeMs;
+        if (windowMs == 0)
+            return;
+        _txnPerSec.store((uint64_t)(snapshot.txns - oldest.txns) * 1000 / windowMs, std::memory_order_relaxed);
+        _errPerSec.store((uint64_t)(snapshot.errors - oldest.errors) * 1000 / windowMs, std::memory_order_relaxed);
+        _bytesPerSec.store((uint64_t)(snapshot.bytes - oldest.bytes) * 1000 / windowMs, std::memory_order_relaxed);
+    }
 
-    // Poll complete
-    uint32_t _pollCompletes;
+    /// @brief Get transactions per second (over the rolling window)
+    uint32_t getTxnPerSec() const
+    {
+        return _txnPerSec.load(std::memory_order_relaxed);
+    }
 
-    // Command complete
-    uint32_t _cmdCompletes;
+    /// @brief Get errors per second (over the rolling window)
+    uint32_t getErrPerSec() const
+    {
+        return _errPerSec.load(std::memory_order_relaxed);
+    }
 
-    // Length error
-    uint32_t _respLengthError;
+    /// @brief Get bytes per second (over the rolling window)
+    uint32_t getBytesPerSec() const
+    {
+        return _bytesPerSec.load(std::memory_order_relaxed);
+    }
 
-    // Request queue instantaneous and peak levels
-    uint32_t _reqQueueCount;
-    uint32_t _reqQueuePeak;
+    // Rolling window for rates
+    static const uint32_t RATE_SAMPLE_INTERVAL_MS = 1000;
+    static const uint32_t RATE_WINDOW_SNAPSHOTS = 6;
+
+private:
+    // Shards (aligned so that shards updated from different cores don't share a cache line)
+#ifdef ESP_PLATFORM
+    static const uint32_t NUM_SHARDS = portNUM_PROCESSORS;
+#else
+    static const uint32_t NUM_SHARDS = 4;
+#endif
+    struct alignas(64) Shard
+    {
+        std::atomic<uint32_t> counts[COUNT_NUM_COUNTERS];
+    };
+    Shard _shards[NUM_SHARDS];
+
+    // Queue levels (gauges - only the latest value and peak are kept)
+    std::atomic<uint32_t> _reqQueueCount{0};
+    std::atomic<uint32_t> _reqQueuePeak{0};
+    std::atomic<uint32_t> _respQueueCount{0};
+    std::atomic<uint32_t> _respQueuePeak{0};
+
+    // Rate snapshots (only accessed by sampleRates)
+    struct RateSnapshot
+    {
+        uint32_t timeMs = 0;
+        uint32_t txns = 0;
+        uint32_t errors = 0;
+        uint32_t bytes = 0;
+    };
+    RateSnapshot _rateSnapshots[RATE_WINDOW_SNAPSHOTS];
+    uint32_t _rateSnapshotPos = 0;
+    uint32_t _numRateSnapshots = 0;
+
+    // Rates
+    std::atomic<uint32_t> _txnPerSec{0};
+    std::atomic<uint32_t> _errPerSec{0};
+    std::atomic<uint32_t> _bytesPerSec{0};
+
+    // Shard for the calling context
+    static uint32_t getShardIdx()
+    {
+#ifdef ESP_PLATFORM
+        return xPortGetCoreID();
+#else
+        // Constant-initialised so access doesn't need a guard - a slot is assigned on first use by each thread
+        static std::atomic<uint32_t> nextThreadSlot{0};
+        static thread_local uint32_t threadShardIdx = UINT32_MAX;
+        if (threadShardIdx == UINT32_MAX)
+            threadShardIdx = nextThreadSlot.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+        return threadShardIdx;
+#endif
+    }
 
-    // Response queue instantaneous and peak levels
-    uint32_t _respQueueCount;
-    uint32_t _respQueuePeak;
+    void increment(CounterIdx counterIdx, uint32_t val = 1)
+    {
+        _shards[getShardIdx()].counts[counterIdx].fetch_add(val, std::memory_order_relaxed);
+    }
 
+    static void updatePeak(std::atomic<uint32_t>& peak, uint32_t val)
+    {
+        uint32_t curPeak = peak.load(std::memory_order_relaxed);
+        while ((curPeak < val) && !peak.compare_exchange_weak(curPeak, val, std::memory_order_relaxed))
+        {
+        }
+    }
 };
@@ -81,6 +81,11 @@ void RaftBusSystem::setup(const char* busConfigName, const RaftJsonIF& config,
         // Setup if valid
         if (pNewBus)
         {
+            // Latency compensation for sample timestamps (set before setup so the bus can apply it)
+            pNewBus->setSampleLatencyUs(busConfig.getInt("latencyUs", 0));
+
+            // Persisted topology (loaded before setup so that a scan started by the bus can use it)
+            pNewBus->getTopologyCache().setup(busConfig.getString("name", busType.c_str()), busConfig);
             if (pNewBus->setup(RaftDeviceID::BUS_NUM_FIRST_BUS + _busList.size(), busConfig))
             {
                 // Add to bus list
@@ -107,14 +112,26 @@ void RaftBusSystem::setup(const char* busConfigName, const RaftJsonIF& config,
 
 void RaftBusSystem::loop()
 {
-    uint32_t busIdx = 0;
+    for (uint32_t busIdx = 0; busIdx < _busList.size(); busIdx++)
+        loopBus(busIdx);
+}
+
+void RaftBusSystem::loopBus(uint32_t busIdx)
+{
+    uint32_t idx = 0;
     for (RaftBus* pBus : _busList)
     {
-        if (pBus)
+        if (idx == busIdx)
         {
-            SUPERVISE_LOOP_CALL(_supervisorStats, _supervisorBusFirstIdx+busIdx, __loggerGlobalDebugValueBusSys, pBus->loop())
+            if (pBus)
+            {
+                SUPERVISE_LOOP_CALL(_supervisorStats, _supervisorBusFirstIdx+busIdx, __loggerGlobalDebugValueBusSys, pBus->loop())
+                pBus->getTopologyCache().loop();
+                pBus->getBusStats().sampleRates(millis());
+            }
+            return;
         }
-        busIdx++;
+        idx++;
     }
 }
 
@@ -127,7 +144,10 @@ void RaftBusSystem::deinit()
     for (RaftBus* pBus : _busList)
     {
         if (pBus)
+        {
+            pBus->getTopologyCache().save();
             delete pBus;
+        }
     }
     _busList.clear();
 }
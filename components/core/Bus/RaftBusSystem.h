@@ -58,6 +58,17 @@ public:
     /// @brief Loop for buses
     void loop();
 
+    /// @brief Loop for a single bus (allows the caller to spread bus servicing over multiple passes)
+    /// @param busIdx Index of the bus in the bus list
+    void loopBus(uint32_t busIdx);
+
+    /// @brief Get number of buses
+    /// @return Number of buses
+    uint32_t getNumBuses() const
+    {
+        return _busList.size();
+    }
+
     /// @brief Deinit
     void deinit();
 
@@ -108,6 +108,10 @@ int ConfigPinMap::mapPinModeToArduino(PinMode pinMode)
 // Configure multople IOs
 void ConfigPinMap::configMultiple(RaftJsonIF& config, PinDef* pPinDefs, int numPinDefs, bool deinit)
 {
+    // Initial levels of outputs are set together before pin modes are set
+    uint64_t setMask = 0;
+    uint64_t clearMask = 0;
+
     // Loop through pins
     for (int defIdx = 0; defIdx < numPinDefs; defIdx++)
     {
@@ -131,25 +135,34 @@ void ConfigPinMap::configMultiple(RaftJsonIF& config, PinDef* pPinDefs, int numP
                         pPinDefs[defIdx]._pinMode, deinit);
 #endif
 
-#if defined(ARDUINO) || defined(ESP_PLATFORM)
-        // Check option
-        if (deinit)
-        {
-            pinMode(pinNumber, INPUT);
-        }
-        else
+        // Initial output levels
+        if (!deinit && (pPinDefs[defIdx]._pinMode == GPIO_OUTPUT) && (pinNumber < 64))
         {
-            // Get mapped pin mode
-            int mappedPinMode = mapPinModeToArduino(pPinDefs[defIdx]._pinMode);
-            pinMode(pinNumber, mappedPinMode);
-            if (pPinDefs[defIdx]._pinMode == GPIO_OUTPUT)
-                digitalWrite(pinNumber, pPinDefs[defIdx]._initialLevel);
+            if (pPinDefs[defIdx]._initialLevel)
+                setMask |= 1ULL << pinNumber;
+            else
+                clearMask |= 1ULL << pinNumber;
         }
-#endif
 
         // Store accordingly
         pPinDefs[defIdx]._pinNumber = pinNumber;
         if (pPinDefs[defIdx]._pPinNumber != NULL)
             *(pPinDefs[defIdx]._pPinNumber) = pinNumber;
     }
+
+#if defined(ARDUINO) || defined(ESP_PLATFORM) || defined(__linux__)
+    // Set initial output levels together before any pin becomes an output (so outputs start at their
+    // initial level rather than changing from their reset level once the mode is set)
+    if (setMask || clearMask)
+        digitalWriteMask(setMask, clearMask);
+
+    // Set pin modes
+    for (int defIdx = 0; defIdx < numPinDefs; defIdx++)
+    {
+        int pinNumber = pPinDefs[defIdx]._pinNumber;
+        if (pinNumber < 0)
+            continue;
+        pinMode(pinNumber, deinit ? INPUT : mapPinModeToArduino(pPinDefs[defIdx]._pinMode));
+    }
+#endif
 }
@@ -7,13 +7,8 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-#include "RaftUtils.h"
 #include "DNSResolver.h"
-#include "NetworkSystem.h"
-
-#define WARN_DNS_LOOKUP_FAILED
-// #define DEBUG_DNS_LOOKUP
-// #define DEBUG_DNS_LOOKUP_WHEN_NOT_CONNECTED
+#include "DNSTransportLwIP.h"
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Get the IP address
@@ -21,96 +16,25 @@
 
 bool DNSResolver::getIPAddr(ip_addr_t &ipAddr)
 {
-    // Check if lookup in progress
-    if (_lookupInProgress)
-        return false;
-
-    // Check if address is valid
-    if (_addrValid)
-    {
-        ipAddr = _ipAddr;
-        return true;
-    }
-
-    // Check minimum time between lookups
-    if (!Raft::isTimeout(millis(), _addrLastLookupMs, ADDR_REPEAT_FAILED_LOOKUP_MS))
-        return false;
-
-    // Set time of last lookup
-    _addrLastLookupMs = millis();        
-
-    // Check IP is connected
-    if (!networkSystem.isIPConnected())
-    {
-#ifdef DEBUG_DNS_LOOKUP_WHEN_NOT_CONNECTED
-        ESP_LOGI(MODULE_PREFIX, "getIPAddr not connected %s", _hostname.c_str());
-#endif
-        return false;
-    }
-
-    // Lookup address (use base ESP_LOGX functions to avoid recursion in logging modules like LogPapertrail)
-#ifdef DEBUG_DNS_LOOKUP
-    ESP_LOGI(MODULE_PREFIX, "getIPAddr dns_gethostbyname %s", _hostname.c_str());
-#endif
-
-    // Set the IP address to blank and start the lookup
-    IP_ADDR4(&_ipAddr, 0,0,0,0);
-    err_t dnsErr = dns_gethostbyname(_hostname.c_str(), &_ipAddr, dnsResultCallback, this);
-    if (dnsErr == ERR_OK)
-    {
-        // ERR_OK means the address was cached and is returned immediately
-#ifdef DEBUG_DNS_LOOKUP
-        ESP_LOGI(MODULE_PREFIX, "getIPAddr lookup OK %s addr %s", _hostname.c_str(), ipaddr_ntoa(&_ipAddr));
-#endif
-        _addrValid = true;
-        _lookupInProgress = false;
-        ipAddr = _ipAddr;
-        return true;
-    }
-
-    // Check for ERR_INPROGRESS which means the lookup is in progress and the callback will carry the result
-    if (dnsErr == ERR_INPROGRESS)
-    {
-        _addrValid = false;
-        _lookupInProgress = true;
-        return false;
-    }
-
-    // Any other error is a failure
-#ifdef WARN_DNS_LOOKUP_FAILED
-    ESP_LOGW(MODULE_PREFIX, "getIPAddr lookup FAILED %s error %d", _hostname.c_str(), dnsErr);
-#endif
-    _addrValid = false;
-    _lookupInProgress = false;
-    return false;
+    return getSharedCache().resolve(_hostname.c_str(), ipAddr) == DNSResolverCache::RESOLVE_OK;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-// DNS result callback
+// Invalidate the cached address
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void DNSResolver::dnsResultCallback(const char *name, const ip_addr_t *ipaddr, void *callback_arg)
+void DNSResolver::invalidate()
 {
-    // Lookup now complete
-    DNSResolver* pResolver = (DNSResolver*)callback_arg;
-    if (!pResolver)
-        return;
-    pResolver->_lookupInProgress = false;
+    getSharedCache().invalidate(_hostname.c_str());
+}
 
-    // Check for error
-    if (ipaddr == nullptr)
-    {
-        pResolver->_addrValid = false;
-#ifdef WARN_DNS_LOOKUP_FAILED
-        ESP_LOGW(MODULE_PREFIX, "dnsResultCallback lookup failed for %s\n", name);
-#endif
-        return;
-    }
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Shared cache
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-    // Set the IP address
-    pResolver->_ipAddr = *ipaddr;
-    pResolver->_addrValid = true;
-#ifdef DEBUG_DNS_LOOKUP
-    ESP_LOGI(MODULE_PREFIX, "dnsResultCallback lookup OK for %s addr %s", name, ipaddr_ntoa(ipaddr));
-#endif
+DNSResolverCache& DNSResolver::getSharedCache()
+{
+    static DNSTransportLwIP lwipTransport;
+    static DNSResolverCache sharedCache(&lwipTransport);
+    return sharedCache;
 }
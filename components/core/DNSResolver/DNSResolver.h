@@ -9,6 +9,7 @@
 #pragma once
 #include "RaftArduino.h"
 #include "lwip/dns.h"
+#include "DNSResolverCache.h"
 
 class DNSResolver
 {
@@ -16,10 +17,7 @@ public:
     // Set the hostname to resolve
     void setHostname(const char *hostname)
     {
-        // Set the hostname
         _hostname = hostname;
-        _lookupInProgress = false;
-        _addrValid = false;
     }
 
     // Get hostname
@@ -28,21 +26,16 @@ public:
         return _hostname.c_str(); 
     }
 
-    // Get IP address
+    // Get IP address (from the shared cache - starts a lookup and returns false if not yet resolved)
     bool getIPAddr(ip_addr_t &ipAddr);
 
+    // Invalidate the cached address (e.g. after a connection to it fails)
+    void invalidate();
+
+    // Shared cache (using lwIP lookups) used by all resolvers
+    static DNSResolverCache& getSharedCache();
+
 private:
     // State
     String _hostname;
-    bool _addrValid = false;
-    ip_addr_t _ipAddr;
-    uint64_t _addrLastLookupMs = 0;
-    static const uint32_t ADDR_REPEAT_FAILED_LOOKUP_MS = 5000;
-    bool _lookupInProgress = false;
-
-    // Helper
-    static void dnsResultCallback(const char *name, const ip_addr_t *ipaddr, void *callback_arg);
-
-    // Debug
-    static constexpr const char* MODULE_PREFIX = "DNSResolver";
 };
@@ -0,0 +1,339 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DNSResolverCache.cpp
+// Shared cache of resolved hostnames with TTL, negative caching and stale-while-revalidate
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DNSResolverCache.h"
+#include "RaftUtils.h"
+#include "Logger.h"
+
+#define WARN_DNS_CACHE_LOOKUP_TIMEOUT
+// #define DEBUG_DNS_CACHE
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor
+/// @param pTransport transport used for lookups (not owned)
+DNSResolverCache::DNSResolverCache(DNSTransportIF* pTransport)
+{
+    RaftMutex_init(_cacheMutex);
+    setTransport(pTransport);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Destructor
+DNSResolverCache::~DNSResolverCache()
+{
+    if (_pTransport)
+        _pTransport->setResultCB(nullptr);
+    RaftMutex_destroy(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Set the transport used for lookups
+/// @param pTransport transport (not owned)
+void DNSResolverCache::setTransport(DNSTransportIF* pTransport)
+{
+    _pTransport = pTransport;
+    if (_pTransport)
+    {
+        _pTransport->setResultCB([this](uint32_t lookupID, const char* hostname, bool success, const DNSIPAddr& addr) {
+            handleLookupResult(lookupID, hostname, success, addr);
+        });
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Configure cache timing and size
+void DNSResolverCache::setConfig(uint32_t ttlMs, uint32_t staleMs, uint32_t negativeTTLMs, uint32_t maxEntries,
+            uint32_t lookupTimeoutMs)
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    _ttlMs = ttlMs;
+    _staleMs = staleMs;
+    _negativeTTLMs = negativeTTLMs;
+    _maxEntries = maxEntries > 0 ? maxEntries : 1;
+    _lookupTimeoutMs = lookupTimeoutMs;
+    RaftMutex_unlock(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Resolve a hostname
+/// @param hostname hostname
+/// @param addr (out) address if the result is RESOLVE_OK (this may be a stale address being revalidated)
+/// @param resultCB callback when the lookup completes (only called if the result is RESOLVE_PENDING)
+/// @return RESOLVE_OK, RESOLVE_PENDING (lookup outstanding) or RESOLVE_FAILED (recent lookup failed)
+DNSResolverCache::ResolveResult DNSResolverCache::resolve(const char* hostname, DNSIPAddr& addr, DNSLookupResultCB resultCB)
+{
+    if (!hostname || (hostname[0] == 0))
+        return RESOLVE_FAILED;
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return RESOLVE_FAILED;
+
+    // Find or add entry
+    Entry* pEntry = findEntry(hostname);
+    if (!pEntry)
+        pEntry = addEntry(hostname);
+    uint64_t nowMs = millis();
+    pEntry->lastUsedMs = nowMs;
+
+    // Fresh address
+    if (pEntry->addrValid && !Raft::isTimeout(nowMs, pEntry->resolvedMs, _ttlMs))
+    {
+        addr = pEntry->addr;
+        _stats.hits++;
+        RaftMutex_unlock(_cacheMutex);
+        return RESOLVE_OK;
+    }
+
+    // Discard the address if it is past the stale period
+    if (pEntry->addrValid && Raft::isTimeout(nowMs, pEntry->resolvedMs, (uint64_t)_ttlMs + _staleMs))
+        pEntry->addrValid = false;
+
+    // Abandon a lookup which the transport never completed (a late result is ignored as its ID won't match)
+    bool lookupTimedOut = false;
+    std::vector<DNSLookupResultCB> abandonedWaiters;
+    if (pEntry->lookupInProgress && Raft::isTimeout(nowMs, pEntry->lookupStartMs, _lookupTimeoutMs))
+    {
+        lookupTimedOut = true;
+        pEntry->lookupInProgress = false;
+        pEntry->lastLookupFailed = true;
+        pEntry->lastFailedMs = nowMs;
+        abandonedWaiters.swap(pEntry->waiters);
+        _stats.lookupFailures++;
+    }
+
+    // Start a lookup unless one is outstanding or a recent lookup failed
+    bool lookupRequired = false;
+    uint32_t lookupID = 0;
+    bool negativeHit = false;
+    if (!pEntry->lookupInProgress)
+    {
+        if (pEntry->lastLookupFailed && !Raft::isTimeout(nowMs, pEntry->lastFailedMs, _negativeTTLMs))
+        {
+            negativeHit = true;
+        }
+        else
+        {
+            pEntry->lookupInProgress = true;
+            pEntry->lookupID = _nextLookupID++;
+            lookupID = pEntry->lookupID;
+            pEntry->lookupStartMs = nowMs;
+            lookupRequired = true;
+            _stats.lookups++;
+        }
+    }
+
+    // Stale address is returned while revalidating
+    ResolveResult result = RESOLVE_PENDING;
+    if (pEntry->addrValid)
+    {
+        addr = pEntry->addr;
+        _stats.staleHits++;
+        result = RESOLVE_OK;
+    }
+    else if (negativeHit)
+    {
+        _stats.negativeHits++;
+        result = RESOLVE_FAILED;
+    }
+    else
+    {
+        _stats.misses++;
+        if (resultCB && !lookupRequired)
+            pEntry->waiters.push_back(resultCB);
+    }
+    RaftMutex_unlock(_cacheMutex);
+
+    // Warn without the mutex held (base ESP_LOGX functions avoid recursion in logging modules like LogPapertrail)
+#ifdef WARN_DNS_CACHE_LOOKUP_TIMEOUT
+    if (lookupTimedOut)
+    {
+#ifdef ESP_PLATFORM
+        ESP_LOGW(MODULE_PREFIX, "resolve lookup timed out %s", hostname);
+#else
+        LOG_W(MODULE_PREFIX, "resolve lookup timed out %s", hostname);
+#endif
+    }
+#endif
+
+    // Inform waiters of an abandoned lookup
+    DNSIPAddr noAddr = {};
+    for (DNSLookupResultCB& waiterCB : abandonedWaiters)
+        waiterCB(hostname, false, noAddr);
+
+    // Lookup is started without the mutex held as the transport may report the result immediately
+    if (lookupRequired)
+    {
+#ifdef DEBUG_DNS_CACHE
+        LOG_I(MODULE_PREFIX, "resolve starting lookup %s %s", hostname, result == RESOLVE_OK ? "(stale)" : "");
+#endif
+        startLookup(hostname, lookupID);
+
+        // Return the result if the lookup has already completed, otherwise wait for it
+        if (result == RESOLVE_PENDING)
+        {
+            if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+                return RESOLVE_FAILED;
+            pEntry = findEntry(hostname);
+            if (!pEntry)
+            {
+                result = RESOLVE_FAILED;
+            }
+            else if (pEntry->lookupInProgress)
+            {
+                if (resultCB)
+                    pEntry->waiters.push_back(resultCB);
+            }
+            else if (pEntry->addrValid)
+            {
+                addr = pEntry->addr;
+                result = RESOLVE_OK;
+            }
+            else
+            {
+                result = RESOLVE_FAILED;
+            }
+            RaftMutex_unlock(_cacheMutex);
+        }
+    }
+    return result;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Invalidate a hostname (e.g. after a connection to its address fails)
+/// @param hostname hostname
+void DNSResolverCache::invalidate(const char* hostname)
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    Entry* pEntry = findEntry(hostname);
+    if (pEntry)
+        pEntry->addrValid = false;
+    RaftMutex_unlock(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Clear the cache (outstanding lookups complete but their results are discarded)
+void DNSResolverCache::clear()
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    std::list<Entry> entries;
+    entries.swap(_entries);
+    RaftMutex_unlock(_cacheMutex);
+
+    // Inform waiters
+    DNSIPAddr noAddr = {};
+    for (Entry& entry : entries)
+        for (DNSLookupResultCB& waiterCB : entry.waiters)
+            waiterCB(entry.hostname.c_str(), false, noAddr);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Find entry (mutex must be held)
+/// @param hostname hostname
+/// @return pointer to entry or nullptr
+DNSResolverCache::Entry* DNSResolverCache::findEntry(const char* hostname)
+{
+    for (Entry& entry : _entries)
+    {
+        if (entry.hostname.equals(hostname))
+            return &entry;
+    }
+    return nullptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add entry evicting the least recently used entry if full (mutex must be held)
+/// @param hostname hostname
+/// @return pointer to entry
+DNSResolverCache::Entry* DNSResolverCache::addEntry(const char* hostname)
+{
+    if (_entries.size() >= _maxEntries)
+    {
+        // Entries with outstanding lookups are not evicted
+        auto lruIt = _entries.end();
+        for (auto it = _entries.begin(); it != _entries.end(); ++it)
+        {
+            if (it->lookupInProgress)
+                continue;
+            if ((lruIt == _entries.end()) || (it->lastUsedMs < lruIt->lastUsedMs))
+                lruIt = it;
+        }
+        if (lruIt != _entries.end())
+        {
+#ifdef DEBUG_DNS_CACHE
+            LOG_I(MODULE_PREFIX, "addEntry evicting %s", lruIt->hostname.c_str());
+#endif
+            _entries.erase(lruIt);
+        }
+    }
+    _entries.emplace_back(hostname);
+    return &_entries.back();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Start a lookup using the transport (mutex must not be held)
+/// @param hostname hostname
+/// @param lookupID ID of the lookup
+void DNSResolverCache::startLookup(const char* hostname, uint32_t lookupID)
+{
+    DNSIPAddr addr = {};
+    DNSTransportIF::LookupResult lookupResult = _pTransport ?
+                _pTransport->startLookup(hostname, lookupID, addr) : DNSTransportIF::LOOKUP_FAILED;
+    if (lookupResult == DNSTransportIF::LOOKUP_DONE)
+        handleLookupResult(lookupID, hostname, true, addr);
+    else if (lookupResult == DNSTransportIF::LOOKUP_FAILED)
+        handleLookupResult(lookupID, hostname, false, addr);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Handle lookup result (from the transport or immediately from startLookup)
+/// @param lookupID ID of the lookup (results of abandoned or discarded lookups are ignored)
+/// @param hostname hostname
+/// @param success true if the address is valid
+/// @param addr address
+void DNSResolverCache::handleLookupResult(uint32_t lookupID, const char* hostname, bool success, const DNSIPAddr& addr)
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    Entry* pEntry = findEntry(hostname);
+    if (!pEntry || !pEntry->lookupInProgress || (pEntry->lookupID != lookupID))
+    {
+        RaftMutex_unlock(_cacheMutex);
+        return;
+    }
+
+    // Update entry - a failed revalidation keeps the stale address until the stale period ends
+    uint64_t nowMs = millis();
+    pEntry->lookupInProgress = false;
+    if (success)
+    {
+        pEntry->addr = addr;
+        pEntry->addrValid = true;
+        pEntry->resolvedMs = nowMs;
+        pEntry->lastLookupFailed = false;
+    }
+    else
+    {
+        pEntry->lastLookupFailed = true;
+        pEntry->lastFailedMs = nowMs;
+        _stats.lookupFailures++;
+    }
+    std::vector<DNSLookupResultCB> waiters;
+    waiters.swap(pEntry->waiters);
+    RaftMutex_unlock(_cacheMutex);
+
+#ifdef DEBUG_DNS_CACHE
+    LOG_I(MODULE_PREFIX, "handleLookupResult %s %s waiters %d", hostname, success ? "OK" : "FAILED", (int)waiters.size());
+#endif
+
+    // Inform waiters
+    for (DNSLookupResultCB& waiterCB : waiters)
+        waiterCB(hostname, success, addr);
+}
@@ -0,0 +1,144 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DNSResolverCache.h
+// Shared cache of resolved hostnames with TTL, negative caching and stale-while-revalidate
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <list>
+#include <vector>
+#include "RaftArduino.h"
+#include "RaftThreading.h"
+#include "DNSTransportIF.h"
+
+/// @brief DNS resolver cache
+/// Resolved addresses are reused until their TTL expires. For a further stale period the old address is
+/// still returned while a revalidation lookup runs in the background so callers never wait on a refresh.
+/// Failed lookups are cached for the negative TTL to limit the rate of retries. Lookups for different
+/// hostnames run concurrently and any number of callers can wait on the same outstanding lookup.
+class DNSResolverCache
+{
+public:
+    DNSResolverCache(DNSTransportIF* pTransport = nullptr);
+    virtual ~DNSResolverCache();
+
+    /// @brief Set the transport used for lookups
+    /// @param pTransport transport (not owned)
+    void setTransport(DNSTransportIF* pTransport);
+
+    /// @brief Configure cache timing and size
+    /// @param ttlMs time a resolved address is used without revalidation
+    /// @param staleMs time after the TTL that the old address is still returned while revalidating
+    /// @param negativeTTLMs time a failed lookup is cached before it is retried
+    /// @param maxEntries maximum number of hostnames cached (least recently used are evicted)
+    /// @param lookupTimeoutMs time after which a lookup the transport hasn't completed is abandoned
+    void setConfig(uint32_t ttlMs, uint32_t staleMs, uint32_t negativeTTLMs, uint32_t maxEntries,
+                uint32_t lookupTimeoutMs = LOOKUP_TIMEOUT_MS);
+
+    enum ResolveResult
+    {
+        RESOLVE_OK,
+        RESOLVE_PENDING,
+        RESOLVE_FAILED
+    };
+
+    /// @brief Resolve a hostname
+    /// @param hostname hostname
+    /// @param addr (out) address if the result is RESOLVE_OK (this may be a stale address being revalidated)
+    /// @param resultCB callback when the lookup completes (only called if the result is RESOLVE_PENDING)
+    /// @return RESOLVE_OK, RESOLVE_PENDING (lookup outstanding) or RESOLVE_FAILED (recent lookup failed)
+    ResolveResult resolve(const char* hostname, DNSIPAddr& addr, DNSLookupResultCB resultCB = nullptr);
+
+    /// @brief Invalidate a hostname (e.g. after a connection to its address fails)
+    /// @param hostname hostname
+    void invalidate(const char* hostname);
+
+    /// @brief Clear the cache (outstanding lookups complete but their results are discarded)
+    void clear();
+
+    /// @brief Get number of cached hostnames
+    /// @return number of hostnames
+    uint32_t getNumEntries() const
+    {
+        return _entries.size();
+    }
+
+    // Stats
+    struct Stats
+    {
+        uint32_t hits;
+        uint32_t staleHits;
+        uint32_t negativeHits;
+        uint32_t misses;
+        uint32_t lookups;
+        uint32_t lookupFailures;
+    };
+
+    /// @brief Get stats
+    /// @return stats
+    Stats getStats() const
+    {
+        return _stats;
+    }
+
+    // Defaults
+    static const uint32_t DEFAULT_TTL_MS = 300000;
+    static const uint32_t DEFAULT_STALE_MS = 3600000;
+    static const uint32_t DEFAULT_NEGATIVE_TTL_MS = 5000;
+    static const uint32_t DEFAULT_MAX_ENTRIES = 8;
+    static const uint32_t LOOKUP_TIMEOUT_MS = 30000;
+
+private:
+    // Transport
+    DNSTransportIF* _pTransport = nullptr;
+
+    // Config
+    uint32_t _ttlMs = DEFAULT_TTL_MS;
+    uint32_t _staleMs = DEFAULT_STALE_MS;
+    uint32_t _negativeTTLMs = DEFAULT_NEGATIVE_TTL_MS;
+    uint32_t _maxEntries = DEFAULT_MAX_ENTRIES;
+    uint32_t _lookupTimeoutMs = LOOKUP_TIMEOUT_MS;
+
+    // Cache entry
+    class Entry
+    {
+    public:
+        Entry(const char* hostname) : hostname(hostname)
+        {
+        }
+        String hostname;
+        DNSIPAddr addr = {};
+        bool addrValid = false;
+        uint64_t resolvedMs = 0;
+        bool lookupInProgress = false;
+        uint32_t lookupID = 0;
+        uint64_t lookupStartMs = 0;
+        bool lastLookupFailed = false;
+        uint64_t lastFailedMs = 0;
+        uint64_t lastUsedMs = 0;
+        std::vector<DNSLookupResultCB> waiters;
+    };
+    std::list<Entry> _entries;
+
+    // ID of the next lookup (results from abandoned or discarded lookups don't match the entry's ID)
+    uint32_t _nextLookupID = 1;
+
+    // Stats
+    Stats _stats = {};
+
+    // Mutex (lookup results may arrive from a network stack task)
+    RaftMutex _cacheMutex;
+
+    // Helpers
+    Entry* findEntry(const char* hostname);
+    Entry* addEntry(const char* hostname);
+    void startLookup(const char* hostname, uint32_t lookupID);
+    void handleLookupResult(uint32_t lookupID, const char* hostname, bool success, const DNSIPAddr& addr);
+
+    // Debug
+    static constexpr const char* MODULE_PREFIX = "DNSCache";
+};
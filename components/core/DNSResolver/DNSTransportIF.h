@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DNSTransportIF.h
+// Interface to a DNS lookup transport (lwIP on ESP, stubs in tests)
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+
+#ifdef ESP_PLATFORM
+#include "lwip/ip_addr.h"
+typedef ip_addr_t DNSIPAddr;
+#else
+// IPv4 address (network byte order) where lwIP isn't available
+typedef struct
+{
+    uint32_t addr;
+} DNSIPAddr;
+#endif
+
+/// @brief Callback when an asynchronous lookup completes
+/// @param hostname hostname that was looked up
+/// @param success true if the address is valid
+/// @param addr resolved address (only valid if success)
+typedef std::function<void(const char* hostname, bool success, const DNSIPAddr& addr)> DNSLookupResultCB;
+
+/// @brief Callback when a transport lookup completes asynchronously
+/// @param lookupID ID passed to startLookup
+/// @param hostname hostname that was looked up
+/// @param success true if the address is valid
+/// @param addr resolved address (only valid if success)
+typedef std::function<void(uint32_t lookupID, const char* hostname, bool success, const DNSIPAddr& addr)> DNSTransportResultCB;
+
+/// @brief DNS transport interface
+/// A transport starts lookups and reports results - caching, retry limits and waiters are handled by DNSResolverCache
+class DNSTransportIF
+{
+public:
+    virtual ~DNSTransportIF()
+    {
+    }
+
+    enum LookupResult
+    {
+        LOOKUP_DONE,
+        LOOKUP_IN_PROGRESS,
+        LOOKUP_FAILED
+    };
+
+    /// @brief Set the callback for lookups which complete asynchronously
+    /// @param resultCB callback (may be called from a network stack task)
+    virtual void setResultCB(DNSTransportResultCB resultCB)
+    {
+        _resultCB = resultCB;
+    }
+
+    /// @brief Start a lookup
+    /// @param hostname hostname to resolve
+    /// @param lookupID ID reported with the result (identifies the lookup if the same hostname is looked up again)
+    /// @param addr (out) address if the result is LOOKUP_DONE
+    /// @return LOOKUP_DONE if addr is valid now, LOOKUP_IN_PROGRESS if the result callback will be called later
+    virtual LookupResult startLookup(const char* hostname, uint32_t lookupID, DNSIPAddr& addr) = 0;
+
+protected:
+    DNSTransportResultCB _resultCB = nullptr;
+};
@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DNSTransportLwIP.cpp
+// DNS lookups using the lwIP resolver
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DNSTransportLwIP.h"
+#include "NetworkSystem.h"
+#include "lwip/dns.h"
+
+#define WARN_DNS_LOOKUP_FAILED
+// #define DEBUG_DNS_LOOKUP
+// #define DEBUG_DNS_LOOKUP_WHEN_NOT_CONNECTED
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Start a lookup
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+DNSTransportIF::LookupResult DNSTransportLwIP::startLookup(const char* hostname, uint32_t lookupID, DNSIPAddr& addr)
+{
+    // Check IP is connected
+    if (!networkSystem.isIPConnected())
+    {
+#ifdef DEBUG_DNS_LOOKUP_WHEN_NOT_CONNECTED
+        ESP_LOGI(MODULE_PREFIX, "startLookup not connected %s", hostname);
+#endif
+        return LOOKUP_FAILED;
+    }
+
+    // Lookup address (use base ESP_LOGX functions to avoid recursion in logging modules like LogPapertrail)
+#ifdef DEBUG_DNS_LOOKUP
+    ESP_LOGI(MODULE_PREFIX, "startLookup dns_gethostbyname %s", hostname);
+#endif
+    IP_ADDR4(&addr, 0,0,0,0);
+    Lookup* pLookup = new Lookup{this, lookupID};
+    err_t dnsErr = dns_gethostbyname(hostname, &addr, dnsResultCallback, pLookup);
+
+    // ERR_INPROGRESS means the callback will carry the result (and free the lookup)
+    if (dnsErr == ERR_INPROGRESS)
+        return LOOKUP_IN_PROGRESS;
+    delete pLookup;
+
+    // ERR_OK means the address was in the lwIP table and is returned immediately
+    if (dnsErr == ERR_OK)
+    {
+#ifdef DEBUG_DNS_LOOKUP
+        ESP_LOGI(MODULE_PREFIX, "startLookup lookup OK %s addr %s", hostname, ipaddr_ntoa(&addr));
+#endif
+        return LOOKUP_DONE;
+    }
+
+    // Any other error is a failure
+#ifdef WARN_DNS_LOOKUP_FAILED
+    ESP_LOGW(MODULE_PREFIX, "startLookup lookup FAILED %s error %d", hostname, dnsErr);
+#endif
+    return LOOKUP_FAILED;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// DNS result callback
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DNSTransportLwIP::dnsResultCallback(const char *name, const ip_addr_t *ipaddr, void *callback_arg)
+{
+    Lookup* pLookup = (Lookup*)callback_arg;
+    if (!pLookup)
+        return;
+    DNSTransportLwIP* pTransport = pLookup->pTransport;
+    uint32_t lookupID = pLookup->lookupID;
+    delete pLookup;
+    if (!pTransport || !pTransport->_resultCB)
+        return;
+
+    // Check for error
+    if (ipaddr == nullptr)
+    {
+#ifdef WARN_DNS_LOOKUP_FAILED
+        ESP_LOGW(MODULE_PREFIX, "dnsResultCallback lookup failed for %s", name);
+#endif
+        DNSIPAddr noAddr = {};
+        pTransport->_resultCB(lookupID, name, false, noAddr);
+        return;
+    }
+#ifdef DEBUG_DNS_LOOKUP
+    ESP_LOGI(MODULE_PREFIX, "dnsResultCallback lookup OK for %s addr %s", name, ipaddr_ntoa(ipaddr));
+#endif
+    pTransport->_resultCB(lookupID, name, true, *ipaddr);
+}
@@ -0,0 +1,37 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DNSTransportLwIP.h
+// DNS lookups using the lwIP resolver
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "DNSTransportIF.h"
+
+class DNSTransportLwIP : public DNSTransportIF
+{
+public:
+    /// @brief Start a lookup (fails without a lookup if IP isn't connected)
+    /// @param hostname hostname to resolve
+    /// @param lookupID ID reported with the result
+    /// @param addr (out) address if the result is LOOKUP_DONE
+    /// @return LOOKUP_DONE if addr is valid now, LOOKUP_IN_PROGRESS if the result callback will be called later
+    virtual LookupResult startLookup(const char* hostname, uint32_t lookupID, DNSIPAddr& addr) override final;
+
+private:
+    // Outstanding lookup (lwIP callback arg - freed when the callback is made)
+    struct Lookup
+    {
+        DNSTransportLwIP* pTransport;
+        uint32_t lookupID;
+    };
+
+    // lwIP callback (called from the TCP/IP task)
+    static void dnsResultCallback(const char *name, const ip_addr_t *ipaddr, void *callback_arg);
+
+    // Debug
+    static constexpr const char* MODULE_PREFIX = "DNSTransportLwIP";
+};
@@ -7,11 +7,24 @@
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-#include "driver/gpio.h"
 #include "Logger.h"
 #include "DebounceButton.h"
 #include "RaftUtils.h"
 #include "RaftArduino.h"
+#ifdef ESP_PLATFORM
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#endif
+
+// Time for edge timestamps (callable from an ISR)
+static inline uint64_t IRAM_ATTR edgeTimeUs()
+{
+#ifdef ESP_PLATFORM
+    return esp_timer_get_time();
+#else
+    return micros();
+#endif
+}
 
 // Constructor
 DebounceButton::DebounceButton()
@@ -26,25 +39,37 @@ DebounceButton::DebounceButton()
     _debounceMs = DEFAULT_PIN_DEBOUNCE_MS;
     _callback = nullptr;
     _repeatCount = 0;
+    RaftAtomicUint32_init(_edgePutCount, 0);
+    RaftAtomicUint32_init(_edgeGetCount, 0);
+    RaftAtomicBool_init(_edgeOverflow, false);
 }
 
 DebounceButton::~DebounceButton()
 {
     if (_buttonPin >= 0)
     {
+        if (_useEdgeInterrupts)
+            detachInterrupt(_buttonPin);
+#ifdef ESP_PLATFORM
         gpio_reset_pin((gpio_num_t)_buttonPin);
+#endif
     }
 }
 
 // Setup
 void DebounceButton::setup(int pin, bool pullup, bool activeLevel, 
-        DebounceButtonCallback cb, uint32_t debounceMs, uint16_t activeRepeatTimeMs)
+        DebounceButtonCallback cb, uint32_t debounceMs, uint16_t activeRepeatTimeMs, bool useEdgeInterrupts)
 {
+    // Stop any previous edge interrupts
+    if ((_buttonPin >= 0) && _useEdgeInterrupts)
+        detachInterrupt(_buttonPin);
+
     // Settings
     _buttonPin = pin;
     _buttonActiveLevel = activeLevel;
     _debounceMs = debounceMs;
     _activeRepeatTimeMs = activeRepeatTimeMs;
+    _useEdgeInterrupts = useEdgeInterrupts;
 
     // State
     _lastCheckMs = millis();
@@ -52,27 +77,54 @@ void DebounceButton::setup(int pin, bool pullup, bool activeLevel,
     _lastStableVal = 0;
     _timeInPresentStateMs = 0;
     _callback = cb;
+    _repeatCount = 0;
 
     // Setup the input pin
     if (_buttonPin >= 0)
     {
-        // GPIO config
-        gpio_config_t io_conf;
-        io_conf.intr_type = GPIO_INTR_DISABLE;
-        io_conf.mode = GPIO_MODE_INPUT;
-        io_conf.pin_bit_mask = (1ULL << _buttonPin);
-        io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-        io_conf.pull_up_en = pullup ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE;
-        gpio_config(&io_conf);
+        pinMode(_buttonPin, pullup ? INPUT_PULLUP : INPUT);
+
+        // Edge interrupts - the initial level is taken as stable (as on the first pass when polling)
+        if (_useEdgeInterrupts)
+        {
+            RaftAtomicUint32_store(_edgePutCount, 0, RAFT_ATOMIC_RELEASE);
+            RaftAtomicUint32_store(_edgeGetCount, 0, RAFT_ATOMIC_RELEASE);
+            RaftAtomicBool_set(_edgeOverflow, false);
+            _edgeOverflowCount = 0;
+            _rawVal = readPin();
+            _lastStableVal = _rawVal;
+            _rawChangeUs = _stableChangeUs = edgeTimeUs();
+            _firstPass = false;
+            attachInterruptArg(_buttonPin, edgeISR, this, CHANGE);
+        }
     }
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Service - must be called frequently to check button state
 void DebounceButton::loop()
 {
     // Pin valid check
     if (_buttonPin < 0)
         return;
+    if (_useEdgeInterrupts)
+        loopEdges();
+    else
+        loopPolled();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Read the pin
+/// @return true if at the active level
+bool DebounceButton::readPin() const
+{
+    return (digitalRead(_buttonPin) != 0) == _buttonActiveLevel;
+}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Polled mode - sample the pin every PIN_CHECK_MS
+void DebounceButton::loopPolled()
+{
     // Check time for check
     uint64_t curMs = millis();
     if (Raft::isTimeout(curMs, _lastCheckMs, PIN_CHECK_MS))
@@ -86,13 +138,13 @@ void DebounceButton::loop()
         // Check first time we've monitored
         if (_firstPass)
         {
-            _lastStableVal = (gpio_get_level((gpio_num_t)_buttonPin) != 0) == _buttonActiveLevel;
+            _lastStableVal = readPin();
             _firstPass = false;
             return;
         }
 
         // Check for change of state
-        bool curVal = (gpio_get_level((gpio_num_t)_buttonPin) != 0) == _buttonActiveLevel;
+        bool curVal = readPin();
 
         // Check if changed
         if (curVal != _lastStableVal)
@@ -130,3 +182,107 @@ void DebounceButton::loop()
         }
     }
 }
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Edge interrupt handler - record the time and level
+/// @param pArg DebounceButton
+void IRAM_ATTR DebounceButton::edgeISR(void* pArg)
+{
+    DebounceButton* pButton = (DebounceButton*)pArg;
+    uint32_t putCount = RaftAtomicUint32_load(pButton->_edgePutCount, RAFT_ATOMIC_RELAXED);
+    uint32_t getCount = RaftAtomicUint32_load(pButton->_edgeGetCount, RAFT_ATOMIC_ACQUIRE);
+    if (putCount - getCount >= EDGE_BUF_LEN)
+    {
+        RaftAtomicBool_set(pButton->_edgeOverflow, true);
+        return;
+    }
+    EdgeEvent& edge = pButton->_edgeBuf[putCount % EDGE_BUF_LEN];
+    edge.timeUs = edgeTimeUs();
+    edge.level = (digitalRead(pButton->_buttonPin) != 0) == pButton->_buttonActiveLevel;
+    RaftAtomicUint32_store(pButton->_edgePutCount, putCount + 1, RAFT_ATOMIC_RELEASE);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Edge interrupt mode - debounce from the recorded edges
+void DebounceButton::loopEdges()
+{
+    // Process edges up to now in order
+    uint64_t nowUs = edgeTimeUs();
+    uint32_t putCount = RaftAtomicUint32_load(_edgePutCount, RAFT_ATOMIC_ACQUIRE);
+    uint32_t getCount = RaftAtomicUint32_load(_edgeGetCount, RAFT_ATOMIC_RELAXED);
+    while (getCount != putCount)
+    {
+        const EdgeEvent& edge = _edgeBuf[getCount % EDGE_BUF_LEN];
+        if (edge.timeUs > nowUs)
+            break;
+        settlePending(edge.timeUs);
+        if (edge.level != _rawVal)
+        {
+            _rawVal = edge.level;
+            _rawChangeUs = edge.timeUs;
+        }
+        settlePending(edge.timeUs);
+        getCount++;
+        RaftAtomicUint32_store(_edgeGetCount, getCount, RAFT_ATOMIC_RELEASE);
+    }
+
+    // If edges were lost resynchronise with the pin
+    if (RaftAtomicBool_get(_edgeOverflow) && (getCount == putCount))
+    {
+        RaftAtomicBool_set(_edgeOverflow, false);
+        _edgeOverflowCount++;
+        bool curVal = readPin();
+        if (curVal != _rawVal)
+        {
+            _rawVal = curVal;
+            _rawChangeUs = nowUs;
+        }
+    }
+    settlePending(nowUs);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Generate debounced changes and repeats up to a time
+/// @param timeUs time (us)
+/// @note A change of level is accepted once the new level has lasted the debounce time (so pulses and bounces
+///       shorter than the debounce time are ignored) and is reported at the time the level settled
+void DebounceButton::settlePending(uint64_t timeUs)
+{
+    // Time at which a pending change of level is accepted
+    bool isPending = _rawVal != _lastStableVal;
+    uint64_t pendingUs = isPending ? _rawChangeUs + (uint64_t)_debounceMs * 1000 : UINT64_MAX;
+
+    // Repeats while active (up to any pending change)
+    for (int pass = 0; pass < 2; pass++)
+    {
+        uint64_t repeatsToUs = isPending && (_rawChangeUs < timeUs) ? _rawChangeUs : timeUs;
+        if (_lastStableVal && (_activeRepeatTimeMs != 0))
+        {
+            while (_stableChangeUs + (uint64_t)(_repeatCount + 1) * _activeRepeatTimeMs * 1000 <= repeatsToUs)
+            {
+                _repeatCount++;
+                if (_callback)
+                    _callback(true, (uint32_t)_repeatCount * _activeRepeatTimeMs, _repeatCount);
+            }
+        }
+        if (pendingUs > timeUs)
+            break;
+        setStable(_rawVal, _rawChangeUs);
+        isPending = false;
+        pendingUs = UINT64_MAX;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Accept a debounced change of level
+/// @param val new level
+/// @param timeUs time of the change (us)
+void DebounceButton::setStable(bool val, uint64_t timeUs)
+{
+    uint32_t msSinceLastChange = (uint32_t)((timeUs - _stableChangeUs) / 1000);
+    _lastStableVal = val;
+    _stableChangeUs = timeUs;
+    _repeatCount = 0;
+    if (_callback)
+        _callback(val, msSinceLastChange, 0);
+}
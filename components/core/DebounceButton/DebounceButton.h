@@ -10,6 +10,7 @@
 #pragma once
 
 #include <functional>
+#include "RaftThreading.h"
 
 typedef std::function<void(bool val, uint32_t msSinceLastChange, uint16_t repeatCount)> DebounceButtonCallback;
 
@@ -24,10 +25,13 @@ public:
     static const uint16_t DEFAULT_ACTIVE_REPEAT_MS = 500;
 
     // Setup
-    void setup(int pin, bool pullup, bool activeLevel, 
-                DebounceButtonCallback cb, 
+    // In edge interrupt mode pin transitions are timestamped by an interrupt handler and debounced from those
+    // timestamps in loop() - so reported durations don't depend on how often loop() is called
+    void setup(int pin, bool pullup, bool activeLevel,
+                DebounceButtonCallback cb,
                 uint32_t debounceMs = DEFAULT_PIN_DEBOUNCE_MS,
-                uint16_t activeRepeatTimeMs = DEFAULT_ACTIVE_REPEAT_MS);
+                uint16_t activeRepeatTimeMs = DEFAULT_ACTIVE_REPEAT_MS,
+                bool useEdgeInterrupts = false);
 
     // Service - must be called frequently to check button state
     void loop();
@@ -38,12 +42,19 @@ public:
         return _lastStableVal;
     }
 
+    // Get count of edges lost because the edge buffer overflowed
+    uint32_t getEdgeOverflowCount() const
+    {
+        return _edgeOverflowCount;
+    }
+
 private:
     // Settings
     int16_t _buttonPin;
     bool _buttonActiveLevel;
     uint32_t _debounceMs;
     uint16_t _activeRepeatTimeMs;
+    bool _useEdgeInterrupts = false;
 
     // State
     uint64_t _lastCheckMs;
@@ -56,4 +67,30 @@ private:
 
     // Callback
     DebounceButtonCallback _callback;
+
+    // Edge events recorded by the interrupt handler (single producer, single consumer)
+    struct EdgeEvent
+    {
+        uint64_t timeUs;
+        bool level;
+    };
+    static const uint32_t EDGE_BUF_LEN = 32;
+    EdgeEvent _edgeBuf[EDGE_BUF_LEN];
+    RaftAtomicUint32 _edgePutCount;
+    RaftAtomicUint32 _edgeGetCount;
+    RaftAtomicBool _edgeOverflow;
+    uint32_t _edgeOverflowCount = 0;
+
+    // Edge debounce state (times in us from the edge timestamps)
+    bool _rawVal = false;
+    uint64_t _rawChangeUs = 0;
+    uint64_t _stableChangeUs = 0;
+
+    // Helpers
+    bool readPin() const;
+    void loopPolled();
+    void loopEdges();
+    void setStable(bool val, uint64_t timeUs);
+    void settlePending(uint64_t timeUs);
+    static void edgeISR(void* pArg);
 };
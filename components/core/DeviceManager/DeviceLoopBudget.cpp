@@ -0,0 +1,90 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DeviceLoopBudget
+// Time budgeting for DeviceManager loop with resumable round-robin servicing of buses and devices
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "DeviceLoopBudget.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Start a pass
+void DeviceLoopBudget::startPass()
+{
+    _passStartUs = micros();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Service items in round-robin order starting from the cursor position until the budget is used
+/// @param cursor cursor for the list of items (updated so the next pass resumes after the last item serviced)
+/// @param numItems number of items in the list
+/// @param serviceFn function called to service an item (with the index of the item)
+/// @return number of items serviced
+uint32_t DeviceLoopBudget::serviceItems(Cursor& cursor, uint32_t numItems,
+            const std::function<void(uint32_t itemIdx)>& serviceFn)
+{
+    if (numItems == 0)
+    {
+        cursor.nextIdx = 0;
+        cursor.lastSkipped = 0;
+        cursor.lastLateStarts = 0;
+        return 0;
+    }
+
+    // The list may have changed size since the last pass
+    uint32_t startIdx = cursor.nextIdx < numItems ? cursor.nextIdx : 0;
+
+    // Service at least one item then continue while there is budget
+    uint32_t numServiced = 0;
+    uint32_t numLateStarts = 0;
+    while (numServiced < numItems)
+    {
+        if (isExhausted())
+        {
+            if (numServiced > 0)
+                break;
+            numLateStarts++;
+        }
+        uint32_t itemIdx = startIdx + numServiced;
+        if (itemIdx >= numItems)
+            itemIdx -= numItems;
+        serviceFn(itemIdx);
+        numServiced++;
+    }
+
+    // Resume point and skip stats
+    cursor.nextIdx = (startIdx + numServiced) % numItems;
+    cursor.lastSkipped = numItems - numServiced;
+    cursor.totalSkipped += cursor.lastSkipped;
+    if (cursor.maxSkipped < cursor.lastSkipped)
+        cursor.maxSkipped = cursor.lastSkipped;
+    cursor.lastLateStarts = numLateStarts;
+    if (cursor.maxLateStarts < cursor.lastLateStarts)
+        cursor.maxLateStarts = cursor.lastLateStarts;
+    return numServiced;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief End a pass (updates pass time statistics)
+void DeviceLoopBudget::endPass()
+{
+    uint64_t passUs = micros() - _passStartUs;
+    _lastPassUs = passUs > UINT32_MAX ? UINT32_MAX : passUs;
+    if (_maxPassUs < _lastPassUs)
+        _maxPassUs = _lastPassUs;
+    _numPasses++;
+    if ((_budgetUs != 0) && (_lastPassUs > _budgetUs))
+        _numOverBudget++;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Check if the budget for the current pass is used up
+/// @return true if used up
+bool DeviceLoopBudget::isExhausted() const
+{
+    if (_budgetUs == 0)
+        return false;
+    return micros() - _passStartUs >= _budgetUs;
+}
@@ -0,0 +1,120 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// DeviceLoopBudget
+// Time budgeting for DeviceManager loop with resumable round-robin servicing of buses and devices
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+#include "RaftArduino.h"
+
+/// @brief Loop time budget
+/// Each pass of the loop services items (buses, devices) in round-robin order until the budget for the pass is
+/// used up. The next pass resumes from the first item not serviced so every item is eventually serviced even when
+/// one item is consistently slow. At least one item of each list is serviced per pass to guarantee progress.
+class DeviceLoopBudget
+{
+public:
+    /// @brief Resumable position in a list of items, skip statistics and count of items started after the
+    /// budget was used up (at most one per pass)
+    class Cursor
+    {
+    public:
+        uint32_t nextIdx = 0;
+        uint32_t lastSkipped = 0;
+        uint32_t maxSkipped = 0;
+        uint32_t totalSkipped = 0;
+        uint32_t lastLateStarts = 0;
+        uint32_t maxLateStarts = 0;
+        void clearStats()
+        {
+            lastSkipped = 0;
+            maxSkipped = 0;
+            totalSkipped = 0;
+            lastLateStarts = 0;
+            maxLateStarts = 0;
+        }
+    };
+
+    /// @brief Setup
+    /// @param budgetUs time budget per pass (us) - 0 for no limit (all items serviced on every pass)
+    void setup(uint32_t budgetUs)
+    {
+        _budgetUs = budgetUs;
+    }
+
+    /// @brief Get budget
+    /// @return budget per pass (us)
+    uint32_t getBudgetUs() const
+    {
+        return _budgetUs;
+    }
+
+    /// @brief Start a pass
+    void startPass();
+
+    /// @brief Service items in round-robin order starting from the cursor position until the budget is used
+    /// @param cursor cursor for the list of items (updated so the next pass resumes after the last item serviced)
+    /// @param numItems number of items in the list
+    /// @param serviceFn function called to service an item (with the index of the item)
+    /// @return number of items serviced
+    uint32_t serviceItems(Cursor& cursor, uint32_t numItems, const std::function<void(uint32_t itemIdx)>& serviceFn);
+
+    /// @brief End a pass (updates pass time statistics)
+    void endPass();
+
+    /// @brief Check if the budget for the current pass is used up
+    /// @return true if used up
+    bool isExhausted() const;
+
+    /// @brief Get time of last pass (us)
+    uint32_t getLastPassUs() const
+    {
+        return _lastPassUs;
+    }
+
+    /// @brief Get worst-case pass time (us)
+    uint32_t getMaxPassUs() const
+    {
+        return _maxPassUs;
+    }
+
+    /// @brief Get number of passes
+    uint32_t getNumPasses() const
+    {
+        return _numPasses;
+    }
+
+    /// @brief Get number of passes which exceeded the budget
+    uint32_t getNumOverBudget() const
+    {
+        return _numOverBudget;
+    }
+
+    /// @brief Clear pass statistics
+    void clearStats()
+    {
+        _lastPassUs = 0;
+        _maxPassUs = 0;
+        _numPasses = 0;
+        _numOverBudget = 0;
+    }
+
+private:
+    // Budget per pass (0 for no limit)
+    uint32_t _budgetUs = 0;
+
+    // Current pass
+    uint64_t _passStartUs = 0;
+
+    // Stats
+    uint32_t _lastPassUs = 0;
+    uint32_t _maxPassUs = 0;
+    uint32_t _numPasses = 0;
+    uint32_t _numOverBudget = 0;
+};
@@ -15,6 +15,8 @@
 #include "RestAPIEndpointManager.h"
 #include "DemoDevice.h"
 #include "BusAddrStatus.h"
+#include "RaftProfileZones.h"
+#include "RaftJsonNumbers.h"
 
 // Warnings
 #define WARN_ON_DEVICE_CLASS_NOT_FOUND
@@ -37,6 +39,7 @@
 // #define DEBUG_API_CMDRAW
 // #define DEBUG_SYSMOD_GET_NAMED_VALUE
 // #define DEBUG_SYSMOD_RECV_CMD_JSON
+// #define DEBUG_TIME_SERIES_SETUP
 #define DEBUG_LOOP_SHOW_DEVICES_INTERVAL_MS 1000
 #define DEBUG_DEVICE_CONFIG_API
 
@@ -69,6 +72,12 @@ void DeviceManager::setup()
 
     // Setup device classes (these are the keys into the device factory)
     setupStaticDevices("Devices", modConfig());
+
+    // Setup time-series history
+    setupTimeSeries("TimeSeries", modConfig());
+
+    // Loop time budget (0 to service all buses and devices on every loop)
+    _loopBudget.setup(configGetLong("loopBudgetUs", LOOP_BUDGET_US_DEFAULT));
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -124,6 +133,14 @@ void DeviceManager::postSetup()
         );
     }
 
+    // Resolve devices for time-series history
+    for (auto& tsRec : _timeSeriesList)
+    {
+        tsRec.pDevice = getDeviceByStringLookup(tsRec.deviceName);
+        if (!tsRec.pDevice)
+            LOG_W(MODULE_PREFIX, "postSetup time-series device %s not found", tsRec.deviceName.c_str());
+    }
+
     // Debug
 #ifdef DEBUG_DEVICE_SETUP
     LOG_I(MODULE_PREFIX, "postSetup %d devices registered %d CBs", numDevices, numDevCBsRegistered);
@@ -134,18 +151,35 @@ void DeviceManager::postSetup()
 /// @brief Loop (called frequently to handle device and bus servicing)
 void DeviceManager::loop()
 {
+    RAFT_PROFILE_ZONE("DevMan::loop");
+
+    // Buses and devices are serviced within a time budget - servicing resumes on the next loop from where
+    // it stopped so a bus with a large backlog or a slow device doesn't stall other SysMods
+    _loopBudget.startPass();
+
     // Service the buses (which will handle device status changes and data updates via callbacks)
-    raftBusSystem.loop();
+    {
+        RAFT_PROFILE_ZONE("DevMan::busLoop");
+        _loopBudget.serviceItems(_loopBusCursor, raftBusSystem.getNumBuses(), 
+                [](uint32_t busIdx) { raftBusSystem.loopBus(busIdx); });
+    }
 
     // Get a frozen copy of the static device list for online devices
     RaftDevice* pStaticDeviceListFrozen[DEVICE_LIST_MAX_SIZE];
     uint32_t numDevices = getStaticDeviceListFrozen(pStaticDeviceListFrozen, DEVICE_LIST_MAX_SIZE, true);
 
     // Loop through the devices
-    for (uint32_t devIdx = 0; devIdx < numDevices; devIdx++)
     {
-        // Handle device loop
-        pStaticDeviceListFrozen[devIdx]->loop();
+        RAFT_PROFILE_ZONE("DevMan::deviceLoops");
+        _loopBudget.serviceItems(_loopDeviceCursor, numDevices, 
+                [&pStaticDeviceListFrozen](uint32_t devIdx) { pStaticDeviceListFrozen[devIdx]->loop(); });
+    }
+    _loopBudget.endPass();
+
+    // Service time-series history
+    {
+        RAFT_PROFILE_ZONE("DevMan::timeSeries");
+        serviceTimeSeries();
     }
 
 #if defined(DEBUG_LOOP_SHOW_DEVICES_INTERVAL_MS)
@@ -306,12 +340,74 @@ void DeviceManager::setupStaticDevices(const char* pConfigPrefix, RaftJsonIF& de
 #endif
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Setup time-series history for device fields
+/// @param pConfigPrefix prefix for the time-series configuration
+/// @param devManConfig configuration for the device manager
+/// @note Config is of the form {"maxBytes":8192,"blockBytes":256,"series":[{"device":"<name>","field":"<param>"}]}
+///       and fields are read using the device's getNamedValue() whenever the device state hash changes
+void DeviceManager::setupTimeSeries(const char* pConfigPrefix, RaftJsonIF& devManConfig)
+{
+    _timeSeriesList.clear();
+    String prefix = pConfigPrefix;
+    uint32_t maxBytes = devManConfig.getLong((prefix + "/maxBytes").c_str(), RaftTimeSeries::DEFAULT_MAX_BYTES);
+    uint32_t blockBytes = devManConfig.getLong((prefix + "/blockBytes").c_str(), RaftTimeSeries::DEFAULT_BLOCK_SIZE_BYTES);
+    std::vector<String> seriesConfigs;
+    devManConfig.getArrayElems((prefix + "/series").c_str(), seriesConfigs);
+    for (RaftJson seriesConf : seriesConfigs)
+    {
+        String deviceName = seriesConf.getString("device", "");
+        String fieldName = seriesConf.getString("field", "");
+        if ((deviceName.length() == 0) || (fieldName.length() == 0))
+            continue;
+        _timeSeriesList.emplace_back();
+        TimeSeriesRec& tsRec = _timeSeriesList.back();
+        tsRec.deviceName = deviceName;
+        tsRec.fieldName = fieldName;
+        tsRec.series.setup(seriesConf.getLong("maxBytes", maxBytes), blockBytes);
+
+#ifdef DEBUG_TIME_SERIES_SETUP
+        LOG_I(MODULE_PREFIX, "setupTimeSeries device %s field %s maxBytes %d", 
+                    deviceName.c_str(), fieldName.c_str(), (int)seriesConf.getLong("maxBytes", maxBytes));
+#endif
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Service time-series history
+void DeviceManager::serviceTimeSeries()
+{
+    if (_timeSeriesList.empty())
+        return;
+    if (!RaftMutex_lock(_accessMutex, 5))
+        return;
+    uint64_t timeNowUs = micros();
+    for (auto& tsRec : _timeSeriesList)
+    {
+        if (!tsRec.pDevice)
+            continue;
+
+        // Only sample when the device state has changed
+        uint64_t stateHash = tsRec.pDevice->getDeviceStateHash64();
+        if (stateHash == tsRec.lastStateHash)
+            continue;
+        tsRec.lastStateHash = stateHash;
+        bool isValid = false;
+        double value = tsRec.pDevice->getNamedValue(tsRec.fieldName.c_str(), isValid);
+        if (isValid)
+            tsRec.series.add(timeNowUs, value);
+    }
+    RaftMutex_unlock(_accessMutex);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Get devices' data as JSON
 /// @param topicIndex Topic index (embedded as integer _t field)
 /// @return JSON string
 String DeviceManager::getDevicesDataJSON(uint16_t topicIndex) const
 {
+    RAFT_PROFILE_ZONE("DevMan::dataJSON");
+
     // Pre-allocate string capacity to avoid multiple reallocations
     // Estimate: ~200 bytes per device/bus element
     String jsonStr;
@@ -385,6 +481,8 @@ String DeviceManager::getDevicesDataJSON(uint16_t topicIndex) const
 /// @return Binary data vector
 std::vector<uint8_t> DeviceManager::getDevicesDataBinary(uint16_t topicIndex) const
 {
+    RAFT_PROFILE_ZONE("DevMan::dataBinary");
+
     std::vector<uint8_t> binaryData;
     binaryData.reserve(502);
 
@@ -428,11 +526,11 @@ std::vector<uint8_t> DeviceManager::getDevicesDataBinary(uint16_t topicIndex) co
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Check for change of devices' data
-/// @param stateHash hash of the currently available data
+/// @param stateHash hash of the currently available data (64-bit little-endian)
+/// @note Each bus maintains its own hash incrementally so only buses and static devices are combined here
 void DeviceManager::getDevicesHash(std::vector<uint8_t>& stateHash) const
 {
-    // Initialize hash to two bytes
-    stateHash.assign(2, 0);
+    RaftStateHashSet hashSet;
 
     // Check all buses for data
     for (RaftBus* pBus : raftBusSystem.getBusList())
@@ -440,14 +538,13 @@ void DeviceManager::getDevicesHash(std::vector<uint8_t>& stateHash) const
         // Check bus
         if (pBus)
         {
-            // Check bus status
-            uint32_t identPollLastMs = pBus->getDeviceInfoTimestampMs(true, true);
-            stateHash[0] ^= (identPollLastMs & 0xff);
-            stateHash[1] ^= ((identPollLastMs >> 8) & 0xff);
+            // Combine bus state hash
+            uint64_t busStateHash = pBus->getDevicesStateHash();
+            hashSet.add(RaftStateHashSet::elemHash(RaftDeviceID(pBus->getBusNum(), 0).toUint64(), busStateHash));
 
 #ifdef DEBUG_JSON_DEVICE_HASH_DETAIL
-            LOG_I(MODULE_PREFIX, "getDevicesHash %s ms %d %02x%02x", 
-                    pBus->getBusName().c_str(), (int)identPollLastMs, stateHash[0], stateHash[1]);
+            LOG_I(MODULE_PREFIX, "getDevicesHash %s hash %016llx set %016llx", 
+                    pBus->getBusName().c_str(), (unsigned long long)busStateHash, (unsigned long long)hashSet.get());
 #endif
         }
     }
@@ -461,19 +558,22 @@ void DeviceManager::getDevicesHash(std::vector<uint8_t>& stateHash) const
     {
         // Check device status
         RaftDevice* pDevice = pStaticDeviceListFrozen[devIdx];
-        uint32_t deviceStateHash = pDevice->getDeviceStateHash();
-        stateHash[0] ^= (deviceStateHash & 0xff);
-        stateHash[1] ^= ((deviceStateHash >> 8) & 0xff);
+        uint64_t deviceStateHash = pDevice->getDeviceStateHash64();
+        hashSet.add(RaftStateHashSet::elemHash(pDevice->getDeviceID().toUint64(), deviceStateHash));
 
 #ifdef DEBUG_JSON_DEVICE_HASH_DETAIL
-        LOG_I(MODULE_PREFIX, "getDevicesHash %s hash %08x %02x%02x", 
-                pDevice->getDeviceName().c_str(), deviceStateHash, stateHash[0], stateHash[1]);
+        LOG_I(MODULE_PREFIX, "getDevicesHash %s hash %016llx set %016llx", 
+                pDevice->getDeviceID().toString().c_str(), (unsigned long long)deviceStateHash, (unsigned long long)hashSet.get());
 #endif
     }
 
+    // Return hash as bytes
+    stateHash.clear();
+    RaftStateHash::appendToBytes(stateHash, hashSet.get());
+
     // Debug
 #ifdef DEBUG_JSON_DEVICE_HASH
-    LOG_I(MODULE_PREFIX, "getDevicesHash => %02x%02x", stateHash[0], stateHash[1]);
+    LOG_I(MODULE_PREFIX, "getDevicesHash => %016llx", (unsigned long long)hashSet.get());
 #endif
 }
 
@@ -522,7 +622,43 @@ String DeviceManager::getDebugJSON() const
         }
     }
 
-    return "{" + (jsonStrBus.length() == 0 ? (jsonStrDev.length() == 0 ? "" : jsonStrDev) : (jsonStrDev.length() == 0 ? jsonStrBus : jsonStrBus + "," + jsonStrDev)) + "}";
+    String jsonStr = getLoopBacklogJSON();
+    if (jsonStrBus.length() > 0)
+        jsonStr += "," + jsonStrBus;
+    if (jsonStrDev.length() > 0)
+        jsonStr += "," + jsonStrDev;
+    return "{" + jsonStr + "}";
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get loop budget and backlog info JSON
+/// @return JSON string ("loop" key and object)
+String DeviceManager::getLoopBacklogJSON() const
+{
+    // Backlog on buses
+    uint32_t numPendingPollResults = 0;
+    uint32_t numQueuedRequests = 0;
+    for (RaftBus* pBus : raftBusSystem.getBusList())
+    {
+        if (!pBus)
+            continue;
+        numPendingPollResults += pBus->getPendingPollResultCount();
+        numQueuedRequests += pBus->getQueuedRequestCount();
+    }
+
+    // Format
+    char jsonStr[300];
+    snprintf(jsonStr, sizeof(jsonStr), 
+                R"("loop":{"budgetUs":%u,"lastUs":%u,"maxUs":%u,"passes":%u,"overBudget":%u,)"
+                R"("busSkip":%u,"busSkipMax":%u,"devSkip":%u,"devSkipMax":%u,"devSkipTot":%u,"pollRslts":%u,"queuedReqs":%u})",
+                (unsigned)_loopBudget.getBudgetUs(), (unsigned)_loopBudget.getLastPassUs(),
+                (unsigned)_loopBudget.getMaxPassUs(), (unsigned)_loopBudget.getNumPasses(),
+                (unsigned)_loopBudget.getNumOverBudget(),
+                (unsigned)_loopBusCursor.lastSkipped, (unsigned)_loopBusCursor.maxSkipped,
+                (unsigned)_loopDeviceCursor.lastSkipped, (unsigned)_loopDeviceCursor.maxSkipped,
+                (unsigned)_loopDeviceCursor.totalSkipped,
+                (unsigned)numPendingPollResults, (unsigned)numQueuedRequests);
+    return jsonStr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -681,6 +817,21 @@ RaftRetCode DeviceManager::receiveCmdJSON(const char* cmdJSON)
     return RAFT_INVALID_OPERATION;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Receive binary command and route to device
+/// @param deviceID Device identifier
+/// @param formatCode Format code for the command
+/// @param pData Pointer to the command data
+/// @param dataLen Length of the command data
+/// @return RaftRetCode
+RaftRetCode DeviceManager::receiveCmdBinary(RaftDeviceID deviceID, uint32_t formatCode, const uint8_t* pData, uint32_t dataLen)
+{
+    RaftDevice* pDevice = getDevice(deviceID);
+    if (!pDevice)
+        return RAFT_INVALID_OBJECT;
+    return pDevice->sendCmdBinary(formatCode, pData, dataLen);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Add REST API endpoints for device manager
 /// @param endpointManager reference to the REST API endpoint manager to add endpoints to
@@ -694,6 +845,7 @@ void DeviceManager::addRestAPIEndpoints(RestAPIEndpointManager &endpointManager)
                             " devman/cmdjson?body=<jsonCommand> - Send JSON command to device (requires 'device' field in JSON),"
                             " devman/devconfig?deviceid=<deviceId>&intervalUs=<microseconds>&numSamples=<count> - device configuration,"
                             " devman/busname?busnum=<busNumber> - Get bus name from bus number,"
+                            " devman/history?device=<name>&field=<field>&startMs=<ms>&endMs=<ms>&bucketMs=<ms> - Get field history (bucketMs=0 for raw samples, no device to list series),"
                             " devman/demo?type=<deviceType>&rate=<sampleRateMs>&duration=<durationMs>&offlineIntvS=<N>&offlineDurS=<M> - Start demo device"
                             " Note: typeName can be either a device type name or a device type index"
                             " Note: deviceId=<deviceId> can be replaced with bus=<busNameOrNumber>&addr=<addr>");
@@ -735,6 +887,8 @@ RaftRetCode DeviceManager::apiDevMan(const String &reqStr, String &respStr, cons
         return apiDevManDevConfig(reqStr, respStr, jsonParams);
     if (cmdName.equalsIgnoreCase("busname"))
         return apiDevManBusName(reqStr, respStr, jsonParams);
+    if (cmdName.equalsIgnoreCase("history"))
+        return apiDevManHistory(reqStr, respStr, jsonParams);
 
     return Raft::setJsonErrorResult(reqStr.c_str(), respStr, "failUnknownCmd");
 }
@@ -1048,6 +1202,101 @@ RaftRetCode DeviceManager::apiDevManBusName(const String &reqStr, String &respSt
                                    ("\"busName\":\"" + busName + "\"").c_str());
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief REST API endpoint for getting the history of a device field
+/// @param reqStr request string containing the command and parameters
+/// @param respStr (out) response string to be filled with the result
+/// @param jsonParams JSON object containing the parameters for the command, expected to have fields "device", "field" and
+///        optionally "startMs", "endMs" (time since boot), "bucketMs" (0 for raw samples) and "maxPts"
+/// @return RaftRetCode indicating success or failure of the operation
+/// @note buckets are returned as [timeMs,count,min,max,mean] and raw samples as [timeMs,value]
+RaftRetCode DeviceManager::apiDevManHistory(const String &reqStr, String &respStr, const RaftJson& jsonParams)
+{
+    String deviceName = jsonParams.getString("device", "");
+    String fieldName = jsonParams.getString("field", "");
+    if (!RaftMutex_lock(_accessMutex, 50))
+        return Raft::setJsonErrorResult(reqStr.c_str(), respStr, "failBusy");
+
+    // List series if no device specified
+    if (deviceName.length() == 0)
+    {
+        String seriesJson;
+        for (auto& tsRec : _timeSeriesList)
+        {
+            char tsInfo[100];
+            snprintf(tsInfo, sizeof(tsInfo), "\",\"n\":%u,\"bytes\":%u,\"t0\":%llu,\"t1\":%llu}",
+                    (unsigned)tsRec.series.count(), (unsigned)tsRec.series.getBytesUsed(),
+                    (unsigned long long)(tsRec.series.getFirstTimeUs() / 1000), 
+                    (unsigned long long)(tsRec.series.getLastTimeUs() / 1000));
+            seriesJson += (seriesJson.length() == 0 ? "{\"device\":\"" : ",{\"device\":\"") + tsRec.deviceName + 
+                        "\",\"field\":\"" + tsRec.fieldName + tsInfo;
+        }
+        RaftMutex_unlock(_accessMutex);
+        return Raft::setJsonBoolResult(reqStr.c_str(), respStr, true, ("\"series\":[" + seriesJson + "]").c_str());
+    }
+
+    // Find series
+    TimeSeriesRec* pTsRec = nullptr;
+    for (auto& tsRec : _timeSeriesList)
+    {
+        if (tsRec.deviceName.equalsIgnoreCase(deviceName) && tsRec.fieldName.equals(fieldName))
+        {
+            pTsRec = &tsRec;
+            break;
+        }
+    }
+    if (!pTsRec)
+    {
+        RaftMutex_unlock(_accessMutex);
+        return Raft::setJsonErrorResult(reqStr.c_str(), respStr, "failSeriesNotFound");
+    }
+
+    // Range
+    uint64_t startUs = (uint64_t)jsonParams.getDouble("startMs", 0) * 1000;
+    uint64_t endUs = jsonParams.contains("endMs") ? (uint64_t)jsonParams.getDouble("endMs", 0) * 1000 : UINT64_MAX;
+    uint64_t bucketUs = (uint64_t)jsonParams.getDouble("bucketMs", 0) * 1000;
+    uint32_t maxPts = jsonParams.getLong("maxPts", RaftTimeSeries::DEFAULT_MAX_BUCKETS);
+    if ((maxPts == 0) || (maxPts > RaftTimeSeries::DEFAULT_MAX_BUCKETS))
+        maxPts = RaftTimeSeries::DEFAULT_MAX_BUCKETS;
+
+    // Query
+    String dataJson;
+    dataJson.reserve(maxPts * 20);
+    char ptStr[120];
+    if (bucketUs == 0)
+    {
+        uint32_t numPts = 0;
+        pTsRec->series.query(startUs, endUs, [&](uint64_t timeUs, double value) {
+            int pos = snprintf(ptStr, sizeof(ptStr), "%s[%llu,", numPts == 0 ? "" : ",",
+                        (unsigned long long)(timeUs / 1000));
+            pos += RaftJsonNumbers::formatDouble(value, ptStr + pos);
+            ptStr[pos++] = ']';
+            ptStr[pos] = 0;
+            dataJson += ptStr;
+            return ++numPts < maxPts;
+        });
+        RaftMutex_unlock(_accessMutex);
+        return Raft::setJsonBoolResult(reqStr.c_str(), respStr, true, ("\"samples\":[" + dataJson + "]").c_str());
+    }
+    std::vector<RaftTimeSeries::Bucket> buckets;
+    pTsRec->series.queryBuckets(startUs, endUs, bucketUs, buckets, maxPts);
+    RaftMutex_unlock(_accessMutex);
+    for (const auto& bucket : buckets)
+    {
+        int pos = snprintf(ptStr, sizeof(ptStr), "%s[%llu,%u,", dataJson.length() == 0 ? "" : ",",
+                    (unsigned long long)(bucket.startTimeUs / 1000), (unsigned)bucket.count);
+        pos += RaftJsonNumbers::formatDouble(bucket.minVal, ptStr + pos);
+        ptStr[pos++] = ',';
+        pos += RaftJsonNumbers::formatDouble(bucket.maxVal, ptStr + pos);
+        ptStr[pos++] = ',';
+        pos += RaftJsonNumbers::formatDouble(bucket.getMean(), ptStr + pos);
+        ptStr[pos++] = ']';
+        ptStr[pos] = 0;
+        dataJson += ptStr;
+    }
+    return Raft::setJsonBoolResult(reqStr.c_str(), respStr, true, ("\"buckets\":[" + dataJson + "]").c_str());
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Callback for command result reports
 /// @param reqResult Result of the bus request
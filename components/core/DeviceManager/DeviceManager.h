@@ -10,6 +10,8 @@
 #include "BusRequestResult.h"
 #include "RaftDeviceConsts.h"
 #include "RaftThreading.h"
+#include "RaftTimeSeries.h"
+#include "DeviceLoopBudget.h"
 
 class APISourceInfo;
 class RaftBus;
@@ -69,6 +71,9 @@ public:
     // JSON command routing (routes to device specified in "device" field)
     virtual RaftRetCode receiveCmdJSON(const char* cmdJSON) override;
 
+    // Binary command routing (routes to device by numeric ID - no string handling)
+    RaftRetCode receiveCmdBinary(RaftDeviceID deviceID, uint32_t formatCode, const uint8_t* pData, uint32_t dataLen);
+
 protected:
 
     /// @brief Setup
@@ -128,6 +133,17 @@ private:
 
     std::list<DeviceDataChangeRec> _deviceDataChangeCBList;
 
+    // Device field time-series record (optional history of named values)
+    struct TimeSeriesRec
+    {
+        String deviceName;
+        String fieldName;
+        RaftDevice* pDevice = nullptr;
+        uint64_t lastStateHash = 0;
+        RaftTimeSeries series;
+    };
+    std::list<TimeSeriesRec> _timeSeriesList;
+
     // Device status change callbacks
 
     // TODO does this contain callbacks for bus devices too?
@@ -145,6 +161,14 @@ private:
     // /// @return RaftDevice* pointer to the created device or nullptr if failed
     // RaftDevice* setupDevice(const char* pDeviceClass, RaftJsonIF& devConfig);
     
+    /// @brief Setup time-series history for device fields
+    /// @param pConfigPrefix Prefix for configuration
+    /// @param devManConfig Device manager configuration
+    void setupTimeSeries(const char* pConfigPrefix, RaftJsonIF& devManConfig);
+
+    /// @brief Service time-series history (samples fields of devices whose state has changed)
+    void serviceTimeSeries();
+
     /// @brief Bus element status callback
     /// @param bus a reference to the bus which has elements with changed status
     /// @param statusChanges - list of status changes
@@ -196,6 +220,9 @@ private:
     /// @brief Handle devman/busname
     RaftRetCode apiDevManBusName(const String &reqStr, String &respStr, const RaftJson& jsonParams);
 
+    /// @brief Handle devman/history
+    RaftRetCode apiDevManHistory(const String &reqStr, String &respStr, const RaftJson& jsonParams);
+
     /// @brief Resolve a RaftDeviceID and RaftBus pointer from API params.
     /// Accepts either a "deviceid" field (canonical busNum_hexaddr string) or
     /// both a "bus" field (bus name or number) and an "addr" field (hex address).
@@ -251,6 +278,16 @@ private:
     /// @param eventData Data associated with the event
     void deviceEventCB(RaftDevice& device, const char* eventName, const char* eventData);
 
+    // Loop time budget and resumable positions in the bus and device lists
+    DeviceLoopBudget _loopBudget;
+    DeviceLoopBudget::Cursor _loopBusCursor;
+    DeviceLoopBudget::Cursor _loopDeviceCursor;
+    static const uint32_t LOOP_BUDGET_US_DEFAULT = 5000;
+
+    /// @brief Get loop budget and backlog info JSON
+    /// @return JSON string
+    String getLoopBacklogJSON() const;
+
     // Last report time
     uint32_t _debugLastReportTimeMs = 0;
 
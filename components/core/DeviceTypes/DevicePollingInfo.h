@@ -22,7 +22,9 @@ public:
     void clear()
     {
         lastPollTimeUs = 0;
+        pollStartTimeUs = 0;
         pollIntervalUs = 0;
+        sampleDelayUs = 0;
         pollResultSizeIncTimestamp = 0;
         pollReqs.clear();
     }
@@ -47,15 +49,35 @@ public:
         return true;
     }
 
+    /// @brief Get the modelled time at which the device sampled the data for the current poll
+    /// @param completionTimeUs time the poll completed (used if the poll start time is unknown)
+    /// @param busLatencyUs bus latency compensation (time from request issue to the request reaching the device)
+    /// @return sample time in us (on the micros() timebase shared by all buses)
+    uint64_t getSampleTimeUs(uint64_t completionTimeUs, int32_t busLatencyUs) const
+    {
+        if ((pollStartTimeUs == 0) || (pollStartTimeUs > completionTimeUs))
+            return completionTimeUs;
+        int64_t sampleTimeUs = (int64_t)pollStartTimeUs + busLatencyUs + sampleDelayUs;
+        if (sampleTimeUs < (int64_t)pollStartTimeUs)
+            return pollStartTimeUs;
+        return (uint64_t)sampleTimeUs > completionTimeUs ? completionTimeUs : sampleTimeUs;
+    }
+
     // cmdId used for ident-polling
     static const uint32_t DEV_IDENT_POLL_CMD_ID = UINT32_MAX;
 
     // Last poll time
     uint64_t lastPollTimeUs = 0;
 
+    // Time the first request of the current poll was issued
+    uint64_t pollStartTimeUs = 0;
+
     // Poll interval
     uint32_t pollIntervalUs = 0;
 
+    // Delay from the poll request to the device sampling the data (e.g. conversion time)
+    uint32_t sampleDelayUs = 0;
+
     // Num poll results to store
     uint32_t numPollResultsToStore = 1;
 
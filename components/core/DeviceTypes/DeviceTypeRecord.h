@@ -24,6 +24,18 @@
 typedef uint32_t (*DeviceTypeRecordDecodeFn)(const uint8_t* pPollBuf, uint32_t pollBufLen, void* pStructOut, uint32_t structOutSize, 
             uint16_t maxRecCount, RaftBusDeviceDecodeState& decodeState);
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @class DeviceTypeRecordCompressedLoc
+/// @brief Location of a compressed device type record (detectionValues, initValues, pollInfo and devInfoJson
+///        as consecutive null terminated strings) in the generated compressed data
+class DeviceTypeRecordCompressedLoc
+{
+public:
+    uint32_t dataOffset;
+    uint16_t compLen;
+    uint16_t rawLen;
+};
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @class DeviceTypeRecord
 /// @brief Device Type Record
@@ -9,6 +9,7 @@
 #include "DeviceTypeRecords.h"
 #include "BusRequestInfo.h"
 #include "RaftJson.h"
+#include "RaftLZ4.h"
 
 // #define DEBUG_DEVICE_INFO_RECORDS
 // #define DEBUG_POLL_REQUEST_REQS
@@ -17,6 +18,7 @@
 // #define DEBUG_LOOKUP_DEVICE_TYPE_BY_INDEX
 // #define DEBUG_LOOKUP_DEVICE_TYPE_BY_NAME
 // #define DEBUG_ADD_EXTENDED_DEVICE_TYPE_RECORD
+// #define DEBUG_DEVICE_TYPE_DECOMPRESS
 
 // Global object
 DeviceTypeRecords deviceTypeRecords;
@@ -30,8 +32,9 @@ static const uint32_t BASE_DEV_TYPE_ARRAY_SIZE = sizeof(baseDevTypeRecords) / si
 /// @brief Constructor
 DeviceTypeRecords::DeviceTypeRecords()
 {
-    // Create mutex
+    // Create mutexes
     RaftMutex_init(_extDeviceTypeRecordsMutex);
+    RaftMutex_init(_decompressMutex);
 
     // Initialize atomic bool
     RaftAtomicBool_init(_extendedRecordsAdded, false);
@@ -42,8 +45,9 @@ DeviceTypeRecords::DeviceTypeRecords()
 
 DeviceTypeRecords::~DeviceTypeRecords()
 {
-    // Delete mutex
+    // Delete mutexes
     RaftMutex_destroy(_extDeviceTypeRecordsMutex);
+    RaftMutex_destroy(_decompressMutex);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -131,8 +135,7 @@ bool DeviceTypeRecords::getDeviceInfo(DeviceTypeIndexType deviceTypeIdx, DeviceT
     }
     else
     {
-        devTypeRec = baseDevTypeRecords[deviceTypeIdx];
-        isValid = true;
+        isValid = getBaseDevTypeRecord(deviceTypeIdx, devTypeRec);
     }
 #ifdef DEBUG_LOOKUP_DEVICE_TYPE_BY_INDEX
     LOG_I(MODULE_PREFIX, "getDeviceInfo %d %s %s", deviceTypeIdx, 
@@ -175,9 +178,8 @@ bool DeviceTypeRecords::getDeviceInfo(const String& deviceTypeName, DeviceTypeRe
         {
             if (deviceTypeName == baseDevTypeRecords[i].deviceType)
             {
-                devTypeRec = baseDevTypeRecords[i];
+                isValid = getBaseDevTypeRecord(i, devTypeRec);
                 deviceTypeIdx = i;
-                isValid = true;
                 break;
             }
         }
@@ -191,6 +193,70 @@ bool DeviceTypeRecords::getDeviceInfo(const String& deviceTypeName, DeviceTypeRe
     return isValid;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get base (generated) device type record - decompressing on first use if required
+/// @param deviceTypeIdx device type index (must be a base device type index)
+/// @param devTypeRec (out) device type record
+/// @return true if valid
+bool DeviceTypeRecords::getBaseDevTypeRecord(DeviceTypeIndexType deviceTypeIdx, DeviceTypeRecord& devTypeRec) const
+{
+    if (deviceTypeIdx >= BASE_DEV_TYPE_ARRAY_SIZE)
+        return false;
+    devTypeRec = baseDevTypeRecords[deviceTypeIdx];
+
+#ifdef DEV_TYPE_RECORDS_COMPRESSED
+    // Decompress if not already done
+    if (!RaftMutex_lock(_decompressMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return false;
+    if (_decompressedBaseRecs.size() != BASE_DEV_TYPE_ARRAY_SIZE)
+        _decompressedBaseRecs.resize(BASE_DEV_TYPE_ARRAY_SIZE);
+    SpiramAwareUint8Vector& rawRec = _decompressedBaseRecs[deviceTypeIdx];
+    if (rawRec.size() == 0)
+    {
+#ifdef DEBUG_DEVICE_TYPE_DECOMPRESS
+        uint64_t startTimeUs = micros();
+#endif
+        const DeviceTypeRecordCompressedLoc& compLoc = baseDevTypeRecCompLocs[deviceTypeIdx];
+        rawRec.resize(compLoc.rawLen);
+        int32_t rawLen = RaftLZ4::decompress(baseDevTypeRecCompData + compLoc.dataOffset, compLoc.compLen,
+                    rawRec.data(), rawRec.size(), baseDevTypeRecDict, sizeof(baseDevTypeRecDict));
+        if (rawLen != compLoc.rawLen)
+        {
+            rawRec.clear();
+            RaftMutex_unlock(_decompressMutex);
+            LOG_W(MODULE_PREFIX, "getBaseDevTypeRecord decompress failed idx %d", deviceTypeIdx);
+            return false;
+        }
+#ifdef DEBUG_DEVICE_TYPE_DECOMPRESS
+        LOG_I(MODULE_PREFIX, "getBaseDevTypeRecord decompressed idx %d %s compLen %d rawLen %d in %lld us", 
+                    deviceTypeIdx, devTypeRec.deviceType, compLoc.compLen, rawLen, micros() - startTimeUs);
+#endif
+    }
+
+    // Record is detectionValues, initValues, pollInfo and devInfoJson as consecutive null terminated strings
+    const char* pFields[4] = {};
+    const char* pStr = (const char*)rawRec.data();
+    const char* pEnd = pStr + rawRec.size();
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        const char* pNull = (const char*)memchr(pStr, 0, pEnd - pStr);
+        if (!pNull)
+        {
+            RaftMutex_unlock(_decompressMutex);
+            return false;
+        }
+        pFields[i] = pStr;
+        pStr = pNull + 1;
+    }
+    devTypeRec.detectionValues = pFields[0];
+    devTypeRec.initValues = pFields[1];
+    devTypeRec.pollInfo = pFields[2];
+    devTypeRec.devInfoJson = pFields[3][0] ? pFields[3] : nullptr;
+    RaftMutex_unlock(_decompressMutex);
+#endif
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Get device polling info
 /// @param addr address
@@ -217,6 +283,7 @@ void DeviceTypeRecords::getPollInfo(BusElemAddrType addr, const DeviceTypeRecord
 
     // Create a polling request for each pair
     uint16_t pollResultDataSize = 0;
+    uint32_t totalPauseAfterSendMs = 0;
     for (const auto& pollWriteReadPair : pollWriteReadPairs)
     {
         std::vector<uint8_t> writeData;
@@ -265,6 +332,7 @@ void DeviceTypeRecords::getPollInfo(BusElemAddrType addr, const DeviceTypeRecord
 
         // Keep track of poll result size
         pollResultDataSize += readData.size();
+        totalPauseAfterSendMs += pauseAfterSendMs;
     }
 
     // Get number of polling results to store
@@ -273,6 +341,10 @@ void DeviceTypeRecords::getPollInfo(BusElemAddrType addr, const DeviceTypeRecord
     // Get polling interval
     pollingInfo.pollIntervalUs = pollInfo.getLong("i", 0) * 1000;
 
+    // Get delay from poll request to data sampling (us) - if not specified the pauses in the poll
+    // sequence are assumed to be conversion time (so the sample is taken at the end of the pauses)
+    pollingInfo.sampleDelayUs = pollInfo.getLong("sd", totalPauseAfterSendMs * 1000);
+
     // Set the poll result size
     pollingInfo.pollResultSizeIncTimestamp = pollResultDataSize + DevicePollingInfo::POLL_RESULT_TIMESTAMP_SIZE;
 }
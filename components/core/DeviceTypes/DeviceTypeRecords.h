@@ -13,6 +13,7 @@
 #include "DeviceTypeRecordDynamic.h"
 #include "DevicePollingInfo.h"
 #include "RaftThreading.h"
+#include "SpiramAwareAllocator.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @class DeviceTypeRecords
@@ -135,7 +136,13 @@ private:
     // be allocated in a way that does not move the instances
     std::vector<DeviceTypeRecordDynamic> _extendedDevTypeRecords;
 
+    // Base device type records generated with compression are decompressed on first use and then kept
+    // (pointers into them are returned in DeviceTypeRecord so they must not move or be freed)
+    mutable std::vector<SpiramAwareUint8Vector> _decompressedBaseRecs;
+    mutable RaftMutex _decompressMutex;
+
     // Helpers
+    bool getBaseDevTypeRecord(DeviceTypeIndexType deviceTypeIdx, DeviceTypeRecord& devTypeRec) const;
     static bool extractBufferDataFromHexStr(const String& writeStr, std::vector<uint8_t>& writeData);
     static bool extractMaskAndDataFromHexStr(const String& readStr, std::vector<uint8_t>& readDataMask, 
                 std::vector<uint8_t>& readDataCheck, bool maskToZeros, uint32_t& pauseAfterSendMs);
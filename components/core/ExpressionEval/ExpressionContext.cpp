@@ -44,7 +44,7 @@ void ExpressionContext::clear(bool includeGlobals)
     else
     {
         // Make a copy of the globals
-        std::map<String, double> mapGlobals;
+        std::map<String, VarRec> mapGlobals;
         for (auto it = _mapVars.begin(); it != _mapVars.end(); ++it)
         {
             if (it->first.startsWith(GLOBAL_VAR_PREFIX))
@@ -78,11 +78,13 @@ void ExpressionContext::clearTEVars()
 void ExpressionContext::addVariable(const char* name, double val, bool overwriteValue)
 {
     // Find existing variable
-    std::map<String, double>::iterator pos = _mapVars.find(name);
+    std::map<String, VarRec>::iterator pos = _mapVars.find(name);
     if (pos == _mapVars.end())
     {
         // Not found so add the value
-        _mapVars[name] = val;
+        VarRec& varRec = _mapVars[name];
+        varRec.val = val;
+        varRec.changeGen = ++_changeGen;
 
 #ifdef OPTIMIZE_ASSIGNMENT_REALLOC
         // Check if we need to update _teVars
@@ -90,7 +92,7 @@ void ExpressionContext::addVariable(const char* name, double val, bool overwrite
         {
             pos = _mapVars.find(name);
             if (pos != _mapVars.end())
-                setTEVar(name, &(pos->second));
+                setTEVar(name, &(pos->second.val));
         }
 #endif
 
@@ -99,7 +101,7 @@ void ExpressionContext::addVariable(const char* name, double val, bool overwrite
     {
         // Exists so just change the value if needed
         if (overwriteValue)
-            pos->second = val;
+            setVarVal(pos->second, val);
     }
 }
 
@@ -150,11 +152,37 @@ double ExpressionContext::getVal(const char* varName, bool& isValid)
     }
 
     // Get the value
-    std::map<String, double>::const_iterator pos = _mapVars.find(varName);
+    std::map<String, VarRec>::const_iterator pos = _mapVars.find(varName);
     if (pos == _mapVars.end())
         return retVal;
     isValid = true;
-    return pos->second;
+    return pos->second.val;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Get variable record
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ExpressionContext::VarRec* ExpressionContext::getVarRec(const char* varName)
+{
+    std::map<String, VarRec>::iterator pos = _mapVars.find(varName);
+    if (pos == _mapVars.end())
+        return nullptr;
+    return &(pos->second);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Get variable record from the address bound by tinyexpr
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const ExpressionContext::VarRec* ExpressionContext::getVarRecByAddress(const void* pAddress) const
+{
+    for (auto it = _mapVars.begin(); it != _mapVars.end(); ++it)
+    {
+        if (&(it->second.val) == pAddress)
+            return &(it->second);
+    }
+    return nullptr;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -182,8 +210,8 @@ void ExpressionContext::getTEVars(std::vector<te_variable>& vars)
     _teVars.resize(0);
     _teVars.reserve(numVarsAndFuncs + ADDITIONAL_TEVARS_TO_RESERVE);
     // Populate variables
-    for (std::map<String, double>::iterator itVar = _mapVars.begin(); itVar != _mapVars.end(); itVar++)
-        setTEVar(itVar->first.c_str(), &(itVar->second));
+    for (std::map<String, VarRec>::iterator itVar = _mapVars.begin(); itVar != _mapVars.end(); itVar++)
+        setTEVar(itVar->first.c_str(), &(itVar->second.val));
 
     // Populate functions
     for (std::map<String, FnDefStruct>::iterator itFunc = _mapFuncs.begin(); itFunc != _mapFuncs.end(); itFunc++)
@@ -207,10 +235,10 @@ void ExpressionContext::getTEVars(std::vector<te_variable>& vars)
 void ExpressionContext::debugLogVars()
 {
     // Dump vars
-    for (std::pair<String, double> el : _mapVars)
+    for (const std::pair<const String, VarRec>& el : _mapVars)
     {
         LOG_I(MODULE_PREFIX, "debugLogVars name %s val %f", 
-                    el.first.c_str(), el.second);
+                    el.first.c_str(), el.second.val);
     }
 
     // Dump funcs
@@ -11,6 +11,7 @@
 
 #include <vector>
 #include <map>
+#include <cmath>
 #include "tinyexpr.h"
 #include "RaftArduino.h"
 
@@ -23,12 +24,37 @@ public:
     // Global variable prefix
     static constexpr const char* GLOBAL_VAR_PREFIX = "$";
 
+    // Variable record - value must be the first member as tinyexpr binds to its address
+    // changeGen is the context change generation at which the value last changed
+    struct VarRec
+    {
+        double val = 0;
+        uint64_t changeGen = 0;
+    };
+
     // Add varibles and functions
     void addVariable(const char* name, double val, bool overwriteValue = true);
     void addFunction(const char* name, const void* pFn, uint32_t numFunctionParams);
 
     // Get
 	double getVal(const char* varName, bool& isValid);
+
+    // Change tracking - each change to a variable value increments the change generation and
+    // records it against the variable so dependants can be re-evaluated only when needed
+    uint64_t getChangeGen() const
+    {
+        return _changeGen;
+    }
+    void setVarVal(VarRec& varRec, double val)
+    {
+        // NaN is treated as equal to NaN so unset globals don't appear to change
+        if ((varRec.val == val) || (std::isnan(varRec.val) && std::isnan(val)))
+            return;
+        varRec.val = val;
+        varRec.changeGen = ++_changeGen;
+    }
+    VarRec* getVarRec(const char* varName);
+    const VarRec* getVarRecByAddress(const void* pAddress) const;
     
     // Get TE Vars (for tinyexpr)
     void getTEVars(std::vector<te_variable>& vars);
@@ -70,7 +96,10 @@ private:
     }
 
     // Variables map
-    std::map<String, double> _mapVars;
+    std::map<String, VarRec> _mapVars;
+
+    // Change generation
+    uint64_t _changeGen = 0;
 
     // Functions map
     struct FnDefStruct
@@ -42,9 +42,12 @@ ExpressionEval::~ExpressionEval()
 
 void ExpressionEval::addVariables(const char* pValsJsonStr, bool append)
 {
-    // Clear values if required
+    // Clear values if required (dependencies of compiled statements are then no longer valid)
     if (!append)
+    {
         _exprContext.clear();
+        _depsValid = _compiledStatements.empty();
+    }
 
     // Set the constants into the evaluator
     std::vector<String> initValNames;
@@ -67,9 +70,12 @@ void ExpressionEval::addVariables(const char* pValsJsonStr, bool append)
 
 void ExpressionEval::addVariables(std::vector<NameValuePairDouble>& nameValuePairs, bool append)
 {
-    // Clear values if required
+    // Clear values if required (dependencies of compiled statements are then no longer valid)
     if (!append)
+    {
         _exprContext.clear();
+        _depsValid = _compiledStatements.empty();
+    }
 
     // Set the constants into the evaluator
     for (NameValuePairDouble& nameValPair : nameValuePairs)
@@ -219,19 +225,70 @@ bool ExpressionEval::addExpressions(const char* pExpr, uint32_t& errorLine)
 
 void ExpressionEval::evalStatements(const char* pImmutableVarsJsonStr)
 {
-    // Get the names of immutable variables 
-    std::vector<String> immutableVarNames;
-    if (pImmutableVarsJsonStr)
-    {
-        RaftJson immutableVars(pImmutableVarsJsonStr, false);
-        immutableVars.getKeys("", immutableVarNames);
-    }
+    // Update the immutable variables if they have changed
+    updateImmutableVars(pImmutableVarsJsonStr);
 
 #ifdef DEBUG_EXPRESSION_EVAL
     // Debug
-    LOG_I(MODULE_PREFIX, "evalStatements numStatements %d", _compiledStatements.size());
+    LOG_I(MODULE_PREFIX, "evalStatements numStatements %d incremental %s", _compiledStatements.size(),
+                (_incrementalEval && !_hasFlowControl && _depsValid) ? "Y" : "N");
 #endif
 
+    // Straight-line statements can be evaluated incrementally
+    if (_incrementalEval && !_hasFlowControl && _depsValid)
+        evalStatementsIncremental();
+    else
+        evalStatementsAll();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Evaluate only statements whose dependencies have changed
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExpressionEval::evalStatementsIncremental()
+{
+    // Statements are evaluated in order so changes made by a statement are seen by later statements
+    // in the same pass (and by earlier statements on the next pass)
+    for (CompiledStatement& statement : _compiledStatements)
+    {
+        // Check if any dependency has changed since last evaluated
+        bool needsEval = !statement._evaluated || statement._alwaysEval;
+        for (uint32_t i = 0; !needsEval && (i < statement._depVars.size()); i++)
+            needsEval = statement._depVars[i]->changeGen > statement._lastEvalGen;
+        if (!needsEval)
+        {
+            _statsSkipped++;
+            continue;
+        }
+
+        // Evaluate - a statement which reads its own assigned variable (e.g. x = x + 1) must see its
+        // own change as a dependency change so the generation is recorded before assignment
+        double val = 0;
+        if (statement._pCompExpr)
+            val = te_eval(statement._pCompExpr);
+        if (statement._readsAssignedVar)
+            statement._lastEvalGen = _exprContext.getChangeGen();
+        if (statement._pAssignedVar && !statement._assignIsImmutable)
+            _exprContext.setVarVal(*statement._pAssignedVar, val);
+        if (!statement._readsAssignedVar)
+            statement._lastEvalGen = _exprContext.getChangeGen();
+        statement._evaluated = true;
+        _statsEvaluated++;
+
+#ifdef DEBUG_EXPRESSION_EVAL
+        LOG_I(MODULE_PREFIX, "evalStatementsIncremental eval %.3f assignVar %s%s", val,
+                    statement._assignedVarName.length() > 0 ? statement._assignedVarName.c_str() : "NONE",
+                    statement._assignIsImmutable ? " (IMMUTABLE)" : "");
+#endif
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Evaluate all statements (including flow control)
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExpressionEval::evalStatementsAll()
+{
     // Go through all the statements and evaluate
     uint32_t programCounter = 0;
     for (unsigned int evalCount = 0; evalCount < MAX_EXPRESSION_EVAL_PROC_LINES; evalCount++)
@@ -258,11 +315,11 @@ void ExpressionEval::evalStatements(const char* pImmutableVarsJsonStr)
 #endif
 
         // Check for assignment
+        uint64_t genBeforeAssign = _exprContext.getChangeGen();
         if (_compiledStatements[programCounter]._assignedVarName.length() != 0)
         {
             // Check if assigned variable name is in the list of immutable variables
-            if(std::find(immutableVarNames.begin(), immutableVarNames.end(), 
-                                _compiledStatements[programCounter]._assignedVarName) == immutableVarNames.end()) 
+            if (!_compiledStatements[programCounter]._assignIsImmutable)
             {
                 // If not set the value of the variable
                 _exprContext.addVariable(_compiledStatements[programCounter]._assignedVarName.c_str(), val, true);
@@ -282,6 +339,12 @@ void ExpressionEval::evalStatements(const char* pImmutableVarsJsonStr)
             }
         }
 
+        // Record evaluation
+        _compiledStatements[programCounter]._evaluated = true;
+        _compiledStatements[programCounter]._lastEvalGen = _compiledStatements[programCounter]._readsAssignedVar ?
+                    genBeforeAssign : _exprContext.getChangeGen();
+        _statsEvaluated++;
+
         // Check for flow control
         switch (_compiledStatements[programCounter]._flowType)
         {
@@ -337,6 +400,37 @@ void ExpressionEval::evalStatements(const char* pImmutableVarsJsonStr)
 #endif
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Update immutable variables
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExpressionEval::updateImmutableVars(const char* pImmutableVarsJsonStr)
+{
+    // Check if unchanged
+    const char* pJsonStr = pImmutableVarsJsonStr ? pImmutableVarsJsonStr : "";
+    if (_immutableVarsValid && _immutableVarsJSON.equals(pJsonStr))
+        return;
+    _immutableVarsJSON = pJsonStr;
+    _immutableVarsValid = true;
+
+    // Get the names of immutable variables
+    std::vector<String> immutableVarNames;
+    if (*pJsonStr)
+    {
+        RaftJson immutableVars(pJsonStr, false);
+        immutableVars.getKeys("", immutableVarNames);
+    }
+
+    // Update statements (and force re-evaluation as assignments may now differ)
+    for (CompiledStatement& statement : _compiledStatements)
+    {
+        statement._assignIsImmutable = (statement._assignedVarName.length() != 0) &&
+                    (std::find(immutableVarNames.begin(), immutableVarNames.end(), 
+                                statement._assignedVarName) != immutableVarNames.end());
+        statement._evaluated = false;
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Find matching flow unit
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -471,7 +565,25 @@ bool ExpressionEval::compileAndStore(String& expr, const String& varName,
         compiledStatement._pCompExpr = pCompiledExpr;
         compiledStatement._assignedVarName = varName;
         compiledStatement._flowType = flowType;
+
+        // Record dependencies - the assigned variable is included so that a value set externally
+        // is overwritten on the next evaluation
+        collectDependencies(pCompiledExpr, compiledStatement);
+        if (varName.length() > 0)
+        {
+            compiledStatement._pAssignedVar = _exprContext.getVarRec(varName.c_str());
+            std::vector<const ExpressionContext::VarRec*>& depVars = compiledStatement._depVars;
+            compiledStatement._readsAssignedVar = 
+                        std::find(depVars.begin(), depVars.end(), compiledStatement._pAssignedVar) != depVars.end();
+            if (!compiledStatement._pAssignedVar)
+                compiledStatement._alwaysEval = true;
+            else if (!compiledStatement._readsAssignedVar)
+                depVars.push_back(compiledStatement._pAssignedVar);
+        }
+        if (flowType != FLOW_TYPE_NONE)
+            _hasFlowControl = true;
         _compiledStatements.push_back(compiledStatement);
+        _immutableVarsValid = false;
 #ifdef DEBUG_EXPRESSION_EVAL
         LOG_I(MODULE_PREFIX, "compileAndStore line %d OK %s numVars %d compiledExprs %d", lineNum,
                 expr.c_str(), varsContext.size(), _compiledStatements.size());
@@ -498,6 +610,38 @@ void ExpressionEval::clear()
     for (unsigned int i = 0; i < _compiledStatements.size(); i++)
         te_free(_compiledStatements[i]._pCompExpr);
     _compiledStatements.clear();
+    _hasFlowControl = false;
+    _depsValid = true;
+    _immutableVarsValid = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Collect the variables read by an expression
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ExpressionEval::collectDependencies(const te_expr* pExpr, CompiledStatement& statement)
+{
+    if (!pExpr)
+        return;
+    int nodeType = pExpr->type & 0x1F;
+    if (nodeType == TE_VARIABLE)
+    {
+        // Variable read
+        const ExpressionContext::VarRec* pVarRec = _exprContext.getVarRecByAddress(pExpr->bound);
+        if (!pVarRec)
+            statement._alwaysEval = true;
+        else if (std::find(statement._depVars.begin(), statement._depVars.end(), pVarRec) == statement._depVars.end())
+            statement._depVars.push_back(pVarRec);
+    }
+    else if (nodeType >= TE_FUNCTION0)
+    {
+        // Functions which are not marked pure (custom functions) may return different values each call
+        if ((pExpr->type & TE_FLAG_PURE) == 0)
+            statement._alwaysEval = true;
+        int arity = nodeType & 0x07;
+        for (int i = 0; i < arity; i++)
+            collectDependencies((const te_expr*)pExpr->parameters[i], statement);
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
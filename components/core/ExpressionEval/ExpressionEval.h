@@ -49,6 +49,23 @@ public:
     bool addExpressions(const char* exprStr, uint32_t& errorLine);
     void evalStatements(const char* immutableVarsJSON);
 
+    // Incremental evaluation - when enabled (the default) and the statements contain no flow control
+    // only statements whose inputs have changed since they were last evaluated are re-evaluated
+    // (statements calling custom functions are always evaluated as they may not be pure)
+    void setIncrementalEval(bool enable)
+    {
+        _incrementalEval = enable;
+    }
+
+    // Get evaluation stats (counts of statements evaluated and skipped since last call)
+    void getEvalStats(uint32_t& numEvaluated, uint32_t& numSkipped)
+    {
+        numEvaluated = _statsEvaluated;
+        numSkipped = _statsSkipped;
+        _statsEvaluated = 0;
+        _statsSkipped = 0;
+    }
+
     // Access values
     double getVal(const char* varName, bool& isValid)
     {
@@ -114,6 +131,17 @@ private:
         te_expr* _pCompExpr;
         String _assignedVarName;
         StatementFlowType _flowType;
+
+        // Dependencies (variables read and the assigned variable)
+        std::vector<const ExpressionContext::VarRec*> _depVars;
+        ExpressionContext::VarRec* _pAssignedVar = nullptr;
+        bool _assignIsImmutable = false;
+        bool _alwaysEval = false;
+        bool _readsAssignedVar = false;
+
+        // Change generation when last evaluated
+        bool _evaluated = false;
+        uint64_t _lastEvalGen = 0;
     };
 
     // List of compiled expressions and assignments
@@ -126,11 +154,28 @@ private:
     // Vector of string constants
     std::vector<String> _stringConsts;
 
+    // Incremental evaluation
+    bool _incrementalEval = true;
+    bool _hasFlowControl = false;
+    bool _depsValid = true;
+
+    // Immutable variables (names cached while the JSON is unchanged)
+    String _immutableVarsJSON;
+    bool _immutableVarsValid = false;
+
+    // Stats
+    uint32_t _statsEvaluated = 0;
+    uint32_t _statsSkipped = 0;
+
     // Helpers
     void findAndReplaceStringConsts(String& exprStr);
     void handleExpressions(const char* pExpr, bool addVars, bool compileExprs);
     bool compileAndStore(String& expr, const String& varName, StatementFlowType flowType, uint32_t lineNum);
     uint32_t findMatchingFlowUnit(uint32_t pc);
+    void updateImmutableVars(const char* pImmutableVarsJsonStr);
+    void evalStatementsIncremental();
+    void evalStatementsAll();
+    void collectDependencies(const te_expr* pExpr, CompiledStatement& statement);
     void addAnyUndefinedGlobalVars(String& exprStr);
     const char* getFlowTypeStr(StatementFlowType flowType)
     {
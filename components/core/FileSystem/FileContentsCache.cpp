@@ -0,0 +1,190 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// FileContentsCache
+// Bounded LRU cache of small file contents (held in PSRAM where available)
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "FileContentsCache.h"
+#include "Logger.h"
+
+// #define DEBUG_FILE_CONTENTS_CACHE
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor
+FileContentsCache::FileContentsCache()
+{
+    RaftMutex_init(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Destructor
+FileContentsCache::~FileContentsCache()
+{
+    RaftMutex_destroy(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Contents constructor
+/// @param pData file data
+/// @param dataLen file length
+FileContentsCache::Contents::Contents(const uint8_t* pData, uint32_t dataLen)
+{
+    _data.resize(dataLen + 1);
+    if (dataLen > 0)
+        memcpy(_data.data(), pData, dataLen);
+    _data[dataLen] = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Set cache limits (contents are cleared)
+/// @param maxFileBytes largest file which will be cached (0 disables the cache)
+/// @param maxTotalBytes maximum total bytes of cached contents
+/// @param maxEntries maximum number of cached files
+void FileContentsCache::setLimits(uint32_t maxFileBytes, uint32_t maxTotalBytes, uint32_t maxEntries)
+{
+    clear();
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    _maxFileBytes = maxFileBytes;
+    _maxTotalBytes = maxTotalBytes;
+    _maxEntries = maxEntries;
+    RaftMutex_unlock(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get cached contents (and mark as most recently used)
+/// @param path full file path
+/// @return contents or nullptr if not cached
+FileContentsCache::ContentsPtr FileContentsCache::get(const String& path)
+{
+    if (_maxEntries == 0)
+        return nullptr;
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return nullptr;
+    for (auto it = _entries.begin(); it != _entries.end(); ++it)
+    {
+        if (it->path.equals(path))
+        {
+            // Move to front
+            if (it != _entries.begin())
+                _entries.splice(_entries.begin(), _entries, it);
+            ContentsPtr pContents = _entries.front().pContents;
+            _statsHits++;
+            RaftMutex_unlock(_cacheMutex);
+            return pContents;
+        }
+    }
+    _statsMisses++;
+    RaftMutex_unlock(_cacheMutex);
+    return nullptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add contents to the cache (evicting least recently used entries as required)
+/// @param path full file path
+/// @param pData file data
+/// @param dataLen file length
+/// @return contents (which may not have been cached if too large) or nullptr if allocation failed
+FileContentsCache::ContentsPtr FileContentsCache::put(const String& path, const uint8_t* pData, uint32_t dataLen)
+{
+    // Create contents
+    ContentsPtr pContents = std::make_shared<const Contents>(pData, dataLen);
+    if (!pContents)
+        return nullptr;
+    if (!isCacheable(dataLen))
+        return pContents;
+
+    // Lock
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return pContents;
+
+    // Remove any existing entry for this path
+    for (auto it = _entries.begin(); it != _entries.end(); ++it)
+    {
+        if (it->path.equals(path))
+        {
+            _totalBytes -= it->pContents->length();
+            _entries.erase(it);
+            break;
+        }
+    }
+
+    // Evict least recently used entries until there is space
+    while (!_entries.empty() && ((_entries.size() >= _maxEntries) || (_totalBytes + dataLen > _maxTotalBytes)))
+    {
+#ifdef DEBUG_FILE_CONTENTS_CACHE
+        LOG_I(MODULE_PREFIX, "put evict %s len %d", _entries.back().path.c_str(), _entries.back().pContents->length());
+#endif
+        _totalBytes -= _entries.back().pContents->length();
+        _entries.pop_back();
+        _statsEvictions++;
+    }
+
+    // Add at front
+    CacheEntry entry;
+    entry.path = path;
+    entry.pContents = pContents;
+    _entries.push_front(entry);
+    _totalBytes += dataLen;
+    RaftMutex_unlock(_cacheMutex);
+
+#ifdef DEBUG_FILE_CONTENTS_CACHE
+    LOG_I(MODULE_PREFIX, "put %s len %d entries %d totalBytes %d", path.c_str(), dataLen, _entries.size(), _totalBytes);
+#endif
+    return pContents;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Invalidate a cached file
+/// @param path full file path
+void FileContentsCache::invalidate(const String& path)
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    for (auto it = _entries.begin(); it != _entries.end(); ++it)
+    {
+        if (it->path.equals(path))
+        {
+#ifdef DEBUG_FILE_CONTENTS_CACHE
+            LOG_I(MODULE_PREFIX, "invalidate %s", path.c_str());
+#endif
+            _totalBytes -= it->pContents->length();
+            _entries.erase(it);
+            _statsInvalidations++;
+            break;
+        }
+    }
+    RaftMutex_unlock(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Clear the cache
+void FileContentsCache::clear()
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    _entries.clear();
+    _totalBytes = 0;
+    RaftMutex_unlock(_cacheMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get stats as JSON
+/// @return JSON string
+String FileContentsCache::getStatsJSON() const
+{
+    if (!RaftMutex_lock(_cacheMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return "{}";
+    uint32_t lookups = _statsHits + _statsMisses;
+    char jsonStr[200];
+    snprintf(jsonStr, sizeof(jsonStr),
+                R"({"n":%d,"bytes":%d,"maxBytes":%d,"hits":%d,"misses":%d,"hitPC":%.1f,"evict":%d,"inval":%d})",
+                (int)_entries.size(), (int)_totalBytes, (int)_maxTotalBytes, (int)_statsHits, (int)_statsMisses,
+                lookups == 0 ? 0.0 : 100.0 * _statsHits / lookups, (int)_statsEvictions, (int)_statsInvalidations);
+    RaftMutex_unlock(_cacheMutex);
+    return jsonStr;
+}
@@ -0,0 +1,117 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// FileContentsCache
+// Bounded LRU cache of small file contents (held in PSRAM where available)
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include "RaftArduino.h"
+#include "RaftThreading.h"
+#include "SpiramAwareAllocator.h"
+
+class FileContentsCache
+{
+public:
+    FileContentsCache();
+    virtual ~FileContentsCache();
+
+    // Immutable file contents - data is null terminated (the terminator is not included in the length)
+    class Contents
+    {
+    public:
+        Contents(const uint8_t* pData, uint32_t dataLen);
+        const uint8_t* data() const
+        {
+            return _data.data();
+        }
+        const char* c_str() const
+        {
+            return (const char*)_data.data();
+        }
+        uint32_t length() const
+        {
+            return _data.size() - 1;
+        }
+    private:
+        SpiramAwareUint8Vector _data;
+    };
+    typedef std::shared_ptr<const Contents> ContentsPtr;
+
+    /// @brief Set cache limits (contents are cleared)
+    /// @param maxFileBytes largest file which will be cached (0 disables the cache)
+    /// @param maxTotalBytes maximum total bytes of cached contents
+    /// @param maxEntries maximum number of cached files
+    void setLimits(uint32_t maxFileBytes, uint32_t maxTotalBytes, uint32_t maxEntries);
+
+    /// @brief Check if a file of the given size can be cached
+    /// @param fileLen file length
+    /// @return true if cacheable
+    bool isCacheable(uint32_t fileLen) const
+    {
+        return (fileLen <= _maxFileBytes) && (fileLen <= _maxTotalBytes) && (_maxEntries > 0);
+    }
+
+    /// @brief Get cached contents (and mark as most recently used)
+    /// @param path full file path
+    /// @return contents or nullptr if not cached
+    ContentsPtr get(const String& path);
+
+    /// @brief Add contents to the cache (evicting least recently used entries as required)
+    /// @param path full file path
+    /// @param pData file data
+    /// @param dataLen file length
+    /// @return contents (which may not have been cached if too large) or nullptr if allocation failed
+    ContentsPtr put(const String& path, const uint8_t* pData, uint32_t dataLen);
+
+    /// @brief Invalidate a cached file
+    /// @param path full file path
+    void invalidate(const String& path);
+
+    /// @brief Clear the cache
+    void clear();
+
+    /// @brief Get stats as JSON
+    /// @return JSON string
+    String getStatsJSON() const;
+
+    // Defaults
+    static const uint32_t MAX_FILE_BYTES_DEFAULT = 8192;
+    static const uint32_t MAX_TOTAL_BYTES_DEFAULT = 65536;
+    static const uint32_t MAX_ENTRIES_DEFAULT = 16;
+
+private:
+    // Cache entry
+    class CacheEntry
+    {
+    public:
+        String path;
+        ContentsPtr pContents;
+    };
+
+    // Entries with the most recently used first
+    std::list<CacheEntry> _entries;
+    uint32_t _totalBytes = 0;
+
+    // Limits
+    uint32_t _maxFileBytes = MAX_FILE_BYTES_DEFAULT;
+    uint32_t _maxTotalBytes = MAX_TOTAL_BYTES_DEFAULT;
+    uint32_t _maxEntries = MAX_ENTRIES_DEFAULT;
+
+    // Stats
+    uint32_t _statsHits = 0;
+    uint32_t _statsMisses = 0;
+    uint32_t _statsEvictions = 0;
+    uint32_t _statsInvalidations = 0;
+
+    // Mutex (separate from the file system mutex so cache hits don't wait for flash operations)
+    mutable RaftMutex _cacheMutex;
+
+    // Debug
+    static constexpr const char* MODULE_PREFIX = "FileCache";
+};
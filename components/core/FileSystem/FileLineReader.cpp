@@ -0,0 +1,331 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// FileLineReader
+// Buffered line-by-line reader with an optional sparse line index for random access
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "Logger.h"
+#include "FileLineReader.h"
+#include "FileSystem.h"
+
+// #define DEBUG_FILE_LINE_READER
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor
+/// @param readAheadLen size of the read-ahead buffer
+FileLineReader::FileLineReader(uint32_t readAheadLen)
+{
+    _buf.resize(readAheadLen > 0 ? readAheadLen : READ_AHEAD_LEN_DEFAULT);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Destructor
+FileLineReader::~FileLineReader()
+{
+    close();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Open a file for reading lines (the file is kept open until close())
+/// @param fileSystemStr file system string
+/// @param filename filename
+/// @param startFilePos start position in file (should be the start of a line)
+/// @return true if opened
+bool FileLineReader::open(const String& fileSystemStr, const String& filename, uint32_t startFilePos)
+{
+    // Close if already open
+    close();
+
+    // Open
+    _pFile = fileSystem.fileOpen(fileSystemStr, filename, false, startFilePos);
+    if (!_pFile)
+        return false;
+    _fileSystemStr = fileSystemStr;
+    _filename = filename;
+
+    // Buffer is empty
+    _bufFilePos = startFilePos;
+    _bufLen = 0;
+    _bufPos = 0;
+
+    // Line number is only known when starting at the beginning of the file
+    _lineNum = 0;
+    _lineNumValid = startFilePos == 0;
+
+#ifdef DEBUG_FILE_LINE_READER
+    LOG_I(MODULE_PREFIX, "open %s startFilePos %d", filename.c_str(), startFilePos);
+#endif
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Close
+void FileLineReader::close()
+{
+    if (_pFile)
+        fileSystem.fileClose(_pFile, _fileSystemStr, _filename, false);
+    _pFile = nullptr;
+    _bufLen = 0;
+    _bufPos = 0;
+    _lineIndex.clear();
+    _indexInterval = 0;
+    _numLines = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Read the next line passing runs of characters to appendFn
+/// @param maxChars maximum number of characters to append - the remainder of a longer line is left unread
+/// @param appendFn function called with each run of line characters
+/// @return true if a line (which may be empty) was read, false at end of file
+template<typename AppendFn> bool FileLineReader::readLineInto(uint32_t maxChars, AppendFn appendFn)
+{
+    if (!_pFile)
+        return false;
+    uint32_t numChars = 0;
+    bool dataConsumed = false;
+    while (true)
+    {
+        // Refill buffer if required
+        if ((_bufPos >= _bufLen) && !fillBuffer())
+        {
+            // End of file terminates a partial line
+            if (dataConsumed)
+                _lineNum++;
+            return dataConsumed;
+        }
+
+        // Find the end of the line (or buffer)
+        const uint8_t* pStart = _buf.data() + _bufPos;
+        uint32_t availLen = _bufLen - _bufPos;
+        const uint8_t* pNewline = (const uint8_t*)memchr(pStart, '\n', availLen);
+        uint32_t segLen = pNewline ? pNewline - pStart : availLen;
+
+        // Append runs of characters skipping '\r'
+        uint32_t segPos = 0;
+        while (segPos < segLen)
+        {
+            // Check for line too long
+            if ((numChars >= maxChars) && (pStart[segPos] != '\r'))
+            {
+                _bufPos += segPos;
+                return true;
+            }
+            const uint8_t* pRun = pStart + segPos;
+            const uint8_t* pCR = (const uint8_t*)memchr(pRun, '\r', segLen - segPos);
+            uint32_t runLen = pCR ? pCR - pRun : segLen - segPos;
+            if (runLen > maxChars - numChars)
+                runLen = maxChars - numChars;
+            if (runLen > 0)
+                appendFn(pRun, runLen);
+            numChars += runLen;
+            segPos += runLen;
+            if (pCR && (pRun + runLen == pCR))
+                segPos++;
+        }
+        dataConsumed = true;
+
+        // Check for end of line
+        _bufPos += segLen;
+        if (pNewline)
+        {
+            _bufPos++;
+            _lineNum++;
+            return true;
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Read next line ('\r' is discarded, '\n' terminates the line)
+/// @param pBuf buffer to read into (null terminated)
+/// @param lineMaxLen size of buffer (at least 2) - longer lines are returned in pieces
+/// @return true if a line (which may be empty) was read, false at end of file or if the buffer is too small
+bool FileLineReader::readLine(uint8_t* pBuf, uint32_t lineMaxLen)
+{
+    // A buffer with no room for a character would never consume input
+    if (!pBuf || (lineMaxLen < 2))
+    {
+        if (pBuf && (lineMaxLen == 1))
+            pBuf[0] = 0;
+        return false;
+    }
+    uint32_t lineLen = 0;
+    bool lineOk = readLineInto(lineMaxLen - 1, [pBuf, &lineLen](const uint8_t* pData, uint32_t dataLen) {
+        memcpy(pBuf + lineLen, pData, dataLen);
+        lineLen += dataLen;
+    });
+    pBuf[lineLen] = 0;
+    return lineOk;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Read next line ('\r' is discarded, '\n' terminates the line)
+/// @param line line read
+/// @param lineMaxLen maximum length of line plus one (at least 2) - longer lines are returned in pieces
+/// @return true if a line (which may be empty) was read, false at end of file or if lineMaxLen is too small
+bool FileLineReader::readLine(String& line, uint32_t lineMaxLen)
+{
+    line = "";
+    if (lineMaxLen < 2)
+        return false;
+    return readLineInto(lineMaxLen - 1, [&line](const uint8_t* pData, uint32_t dataLen) {
+        line.concat((const char*)pData, dataLen);
+    });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Seek to a file position (the line number is unknown after this until seekToLine() is used)
+/// @param filePos file position
+/// @return true if successful
+bool FileLineReader::seek(uint32_t filePos)
+{
+    if (!_pFile)
+        return false;
+    _lineNumValid = false;
+
+    // Check if position is within the buffer
+    if ((filePos >= _bufFilePos) && (filePos <= _bufFilePos + _bufLen))
+    {
+        _bufPos = filePos - _bufFilePos;
+        return true;
+    }
+
+    // Seek in the file and discard the buffer
+    if (!fileSystem.fileSeek(_pFile, filePos))
+        return false;
+    _bufFilePos = filePos;
+    _bufLen = 0;
+    _bufPos = 0;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Build a sparse index of line start positions (the reader is left at line 0)
+/// @param indexInterval number of lines between index entries
+/// @return true if successful
+bool FileLineReader::buildLineIndex(uint32_t indexInterval)
+{
+    // Start at the beginning
+    _lineIndex.clear();
+    _indexInterval = 0;
+    _numLines = 0;
+    if (!seek(0))
+        return false;
+    _lineNum = 0;
+    _lineNumValid = true;
+
+    // Scan all lines recording the position of every indexInterval'th line
+    if (indexInterval == 0)
+        indexInterval = 1;
+    while (true)
+    {
+        uint32_t lineStartPos = getFilePos();
+        uint32_t lineNum = _lineNum;
+        if (!skipLine())
+            break;
+        if (lineNum % indexInterval == 0)
+            _lineIndex.push_back(lineStartPos);
+    }
+    _numLines = _lineNum;
+    _indexInterval = indexInterval;
+
+#ifdef DEBUG_FILE_LINE_READER
+    LOG_I(MODULE_PREFIX, "buildLineIndex %s numLines %d indexEntries %d",
+                _filename.c_str(), _numLines, (int)_lineIndex.size());
+#endif
+
+    // Return to start
+    if (!seek(0))
+        return false;
+    _lineNum = 0;
+    _lineNumValid = true;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Seek to the start of a line (uses the line index if built, otherwise scans)
+/// @param lineNum line number (0 based)
+/// @return true if the line exists
+bool FileLineReader::seekToLine(uint32_t lineNum)
+{
+    if (!_pFile)
+        return false;
+
+    // Use the index if available
+    if (_indexInterval > 0)
+    {
+        if (lineNum >= _numLines)
+            return false;
+        uint32_t indexIdx = lineNum / _indexInterval;
+        if (indexIdx >= _lineIndex.size())
+            return false;
+        if (!_lineNumValid || (lineNum < _lineNum) || (lineNum - _lineNum > _indexInterval))
+        {
+            if (!seek(_lineIndex[indexIdx]))
+                return false;
+            _lineNum = indexIdx * _indexInterval;
+            _lineNumValid = true;
+        }
+    }
+    else if (!_lineNumValid || (lineNum < _lineNum))
+    {
+        // Scan from the start
+        if (!seek(0))
+            return false;
+        _lineNum = 0;
+        _lineNumValid = true;
+    }
+
+    // Skip forward to the line
+    while (_lineNum < lineNum)
+    {
+        if (!skipLine())
+            return false;
+    }
+
+    // Check the line exists
+    return (_bufPos < _bufLen) || fillBuffer();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Refill the read-ahead buffer (when it has been consumed)
+/// @return true if data is available
+bool FileLineReader::fillBuffer()
+{
+    _bufFilePos += _bufLen;
+    _bufPos = 0;
+    _bufLen = fileSystem.fileRead(_pFile, _buf.data(), _buf.size());
+    return _bufLen > 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Skip the next line
+/// @return true if a line was skipped, false at end of file
+bool FileLineReader::skipLine()
+{
+    bool dataConsumed = false;
+    while (true)
+    {
+        if ((_bufPos >= _bufLen) && !fillBuffer())
+        {
+            // End of file terminates a partial line
+            if (dataConsumed)
+                _lineNum++;
+            return dataConsumed;
+        }
+        const uint8_t* pStart = _buf.data() + _bufPos;
+        const uint8_t* pNewline = (const uint8_t*)memchr(pStart, '\n', _bufLen - _bufPos);
+        if (pNewline)
+        {
+            _bufPos += pNewline - pStart + 1;
+            _lineNum++;
+            return true;
+        }
+        _bufPos = _bufLen;
+        dataConsumed = true;
+    }
+}
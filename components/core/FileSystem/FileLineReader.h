@@ -0,0 +1,124 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// FileLineReader
+// Buffered line-by-line reader with an optional sparse line index for random access
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include "RaftArduino.h"
+#include "SpiramAwareAllocator.h"
+
+class FileLineReader
+{
+public:
+    /// @brief Constructor
+    /// @param readAheadLen size of the read-ahead buffer
+    FileLineReader(uint32_t readAheadLen = READ_AHEAD_LEN_DEFAULT);
+
+    // Destructor
+    virtual ~FileLineReader();
+
+    /// @brief Open a file for reading lines (the file is kept open until close())
+    /// @param fileSystemStr file system string
+    /// @param filename filename
+    /// @param startFilePos start position in file (should be the start of a line)
+    /// @return true if opened
+    bool open(const String& fileSystemStr, const String& filename, uint32_t startFilePos = 0);
+
+    // Close
+    void close();
+
+    // Check if open
+    bool isOpen() const
+    {
+        return _pFile != nullptr;
+    }
+
+    /// @brief Read next line ('\r' is discarded, '\n' terminates the line)
+    /// @param pBuf buffer to read into (null terminated)
+    /// @param lineMaxLen size of buffer (at least 2) - longer lines are returned in pieces
+    /// @return true if a line (which may be empty) was read, false at end of file or if the buffer is too small
+    bool readLine(uint8_t* pBuf, uint32_t lineMaxLen);
+
+    /// @brief Read next line ('\r' is discarded, '\n' terminates the line)
+    /// @param line line read
+    /// @param lineMaxLen maximum length of line plus one (at least 2) - longer lines are returned in pieces
+    /// @return true if a line (which may be empty) was read, false at end of file or if lineMaxLen is too small
+    bool readLine(String& line, uint32_t lineMaxLen);
+
+    /// @brief Get file position of the next line to be read
+    /// @return file position
+    uint32_t getFilePos() const
+    {
+        return _bufFilePos + _bufPos;
+    }
+
+    /// @brief Seek to a file position (the line number is unknown after this until seekToLine() is used)
+    /// @param filePos file position
+    /// @return true if successful
+    bool seek(uint32_t filePos);
+
+    /// @brief Build a sparse index of line start positions (the reader is left at line 0)
+    /// @param indexInterval number of lines between index entries
+    /// @return true if successful
+    bool buildLineIndex(uint32_t indexInterval = LINE_INDEX_INTERVAL_DEFAULT);
+
+    /// @brief Get number of lines (only valid once the line index has been built)
+    /// @return number of lines in the file
+    uint32_t getNumLines() const
+    {
+        return _numLines;
+    }
+
+    /// @brief Seek to the start of a line (uses the line index if built, otherwise scans)
+    /// @param lineNum line number (0 based)
+    /// @return true if the line exists
+    bool seekToLine(uint32_t lineNum);
+
+    /// @brief Get the line number of the next line to be read
+    /// @param lineNum line number (0 based)
+    /// @return true if the line number is known
+    bool getLineNum(uint32_t& lineNum) const
+    {
+        lineNum = _lineNum;
+        return _lineNumValid;
+    }
+
+    // Defaults
+    static const uint32_t READ_AHEAD_LEN_DEFAULT = 1024;
+    static const uint32_t LINE_INDEX_INTERVAL_DEFAULT = 64;
+
+private:
+    // File
+    String _fileSystemStr;
+    String _filename;
+    FILE* _pFile = nullptr;
+
+    // Read-ahead buffer, the file position of its first byte and the read position within it
+    SpiramAwareUint8Vector _buf;
+    uint32_t _bufLen = 0;
+    uint32_t _bufPos = 0;
+    uint32_t _bufFilePos = 0;
+
+    // Line number of the next line
+    uint32_t _lineNum = 0;
+    bool _lineNumValid = false;
+
+    // Sparse line index - file position of every _indexInterval'th line
+    std::vector<uint32_t> _lineIndex;
+    uint32_t _indexInterval = 0;
+    uint32_t _numLines = 0;
+
+    // Helpers
+    bool fillBuffer();
+    bool skipLine();
+    template<typename AppendFn> bool readLineInto(uint32_t maxChars, AppendFn appendFn);
+
+    // Debug
+    static constexpr const char* MODULE_PREFIX = "FileLineReader";
+};
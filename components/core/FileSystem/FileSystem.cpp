@@ -10,6 +10,7 @@
 #include "FileSystem.h"
 #include "RaftUtils.h"
 #include "Logger.h"
+#include "RestAPIRespSink.h"
 
 #include <sys/stat.h>
 #include <sys/unistd.h>
@@ -47,6 +48,7 @@ FileSystem fileSystem;
 // #define DEBUG_FILE_SYSTEM_MOUNT
 // #define DEBUG_CACHE_FS_INFO
 // #define DEBUG_FILE_SYSTEM_WRITE_PERFORMANCE
+// #define DEBUG_GET_FILES_JSON_TIMING
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor / Destructor
@@ -130,6 +132,9 @@ bool FileSystem::reformat(const String& fileSystemStr, String& respStr, bool for
         return false;
     }
 
+    // Cached contents will be invalid
+    _contentsCache.clear();
+
 #if !defined(__linux__)
 
     // TODO - check WDT maybe enabled
@@ -179,6 +184,15 @@ String FileSystem::getDefaultFSRoot() const
     return _localFsCache.fsName.c_str();
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Get debug JSON
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+String FileSystem::getDebugJSON() const
+{
+    return R"({"contentCache":)" + _contentsCache.getStatsJSON() + "}";
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Get file info
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -271,6 +285,77 @@ uint8_t* FileSystem::getFileContents(const String& fileSystemStr, const String&
     // Filename
     String rootFilename = getFilePath(nameOfFS, filename);
 
+    // Check contents cache (doesn't require the file system mutex)
+    FileContentsCache::ContentsPtr pContents = _contentsCache.get(rootFilename);
+    if (pContents)
+    {
+        if ((maxLen > 0) && (pContents->length() >= (uint32_t)maxLen-1))
+            return nullptr;
+        SpiramAwareAllocator<uint8_t> allocator;
+        uint8_t* pBuf = allocator.allocate(pContents->length()+1);
+        if (!pBuf)
+            return nullptr;
+        memcpy(pBuf, pContents->data(), pContents->length()+1);
+        return pBuf;
+    }
+
+    // Read from file system - returned buffer must be freed by caller
+    uint32_t fileLen = 0;
+    return readFileContents(rootFilename, maxLen, fileLen, nullptr);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Get file contents as a shared immutable buffer
+// Small files are served from (and added to) the contents cache so repeated reads don't touch flash
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FileContentsCache::ContentsPtr FileSystem::getFileContentsShared(const String& fileSystemStr, const String& filename, 
+                int maxLen)
+{
+    // Check file system supported
+    String nameOfFS;
+    if (!checkFileSystem(fileSystemStr, nameOfFS))
+    {
+#ifdef WARN_ON_INVALID_FILE_SYSTEM
+        LOG_W(MODULE_PREFIX, "getContentsShared %s invalid file system %s", filename.c_str(), fileSystemStr.c_str());
+#endif
+        return nullptr;
+    }
+
+    // Filename
+    String rootFilename = getFilePath(nameOfFS, filename);
+
+    // Check contents cache
+    FileContentsCache::ContentsPtr pContents = _contentsCache.get(rootFilename);
+    if (pContents)
+    {
+        if ((maxLen > 0) && (pContents->length() >= (uint32_t)maxLen-1))
+            return nullptr;
+        return pContents;
+    }
+
+    // Read from file system
+    uint32_t fileLen = 0;
+    uint8_t* pBuf = readFileContents(rootFilename, maxLen, fileLen, &pContents);
+    if (!pBuf)
+        return nullptr;
+
+    // Files too large to cache are wrapped in a shared buffer
+    if (!pContents)
+        pContents = std::make_shared<const FileContentsCache::Contents>(pBuf, fileLen);
+    SpiramAwareAllocator<uint8_t> allocator;
+    allocator.deallocate(pBuf, fileLen+1);
+    return pContents;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Read file contents into a newly allocated buffer (which must be freed by caller)
+// Small files are also added to the contents cache and returned in pCachedContents (if not null)
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uint8_t* FileSystem::readFileContents(const String& rootFilename, int maxLen, uint32_t& fileLen, 
+                FileContentsCache::ContentsPtr* pCachedContents)
+{
     // Take mutex
     if (!RaftMutex_lock(_fileSysMutex, RAFT_MUTEX_WAIT_FOREVER))
         return nullptr;
@@ -340,8 +425,18 @@ uint8_t* FileSystem::getFileContents(const String& fileSystemStr, const String&
     // Read
     size_t bytesRead = fread(pBuf, 1, fileSize, pFile);
     fclose(pFile);
-    RaftMutex_unlock(_fileSysMutex);
     pBuf[bytesRead] = 0;
+    fileLen = bytesRead;
+
+    // Add small files to the contents cache (while the file system is locked so a concurrent write
+    // can't invalidate before the stale contents are added)
+    if (_contentsCache.isCacheable(bytesRead))
+    {
+        FileContentsCache::ContentsPtr pContents = _contentsCache.put(rootFilename, pBuf, bytesRead);
+        if (pCachedContents)
+            *pCachedContents = pContents;
+    }
+    RaftMutex_unlock(_fileSysMutex);
 
 #ifdef DEBUG_GET_FILE_CONTENTS
     LOG_I(MODULE_PREFIX, "getContents preReadIntHeap %d postReadIntHeap %d fileSize %d filename %s", intMemPreAlloc, 
@@ -390,6 +485,7 @@ bool FileSystem::setFileContents(const String& fileSystemStr, const String& file
 #ifdef DEBUG_CACHE_FS_INFO
     LOG_I(MODULE_PREFIX, "setFileContents cache invalid");
 #endif
+    _contentsCache.invalidate(rootFilename);
 #if !defined(__linux__)
     markFileCacheDirty(nameOfFS, filename);
 #endif
@@ -425,6 +521,7 @@ bool FileSystem::deleteFile(const String& fileSystemStr, const String& filename)
 #ifdef DEBUG_CACHE_FS_INFO
     LOG_I(MODULE_PREFIX, "deleteFile cache invalid");
 #endif
+    _contentsCache.invalidate(rootFilename);
 #if !defined(__linux__)
     markFileCacheDirty(nameOfFS, filename);
 #endif
@@ -899,6 +996,7 @@ FILE* FileSystem::fileOpen(const String& fileSystemStr, const String& filename,
 #ifdef DEBUG_CACHE_FS_INFO
         LOG_I(MODULE_PREFIX, "fileOpen cache invalid");
 #endif
+        _contentsCache.invalidate(rootFilename);
     }
 
     // Return file 
@@ -922,6 +1020,7 @@ bool FileSystem::fileClose(FILE* pFile, const String& fileSystemStr, const Strin
     // Check if file modified
     if (fileModified)
     {
+        _contentsCache.invalidate(getFilePath(nameOfFS, filename));
 #if !defined(__linux__)
         markFileCacheDirty(nameOfFS, filename);
 #endif
@@ -1480,20 +1579,36 @@ bool FileSystem::fileInfoCacheToJSON(const char* req, CachedFileSystem& cachedFs
     {
         LOG_I(MODULE_PREFIX, "fileInfoCacheToJSON cached info valid");
 
+#ifdef DEBUG_GET_FILES_JSON_TIMING
         uint32_t debugStartMs = millis();
-        String fileListStr;
-        bool firstFile = true;
+#endif
         uint32_t fileCount = 0;
-        for (CachedFileInfo& cachedFileInfo : cachedFs.cachedRootFileList)
         {
-            fileListStr += String(firstFile ? R"({"name":")" : R"(,{"name":")") + cachedFileInfo.fileName.c_str() + R"(","size":)" + String(cachedFileInfo.fileSize) + "}";
-            firstFile = false;
-            fileCount++;
+            // Format response (a file list isn't limited in length)
+            RestAPIRespSink resp(respStr, FILE_LIST_RESP_RESERVE_LEN, RestAPIRespSink::MAX_LEN_UNLIMITED);
+            fileInfoJSONStart(resp, req, cachedFs, folderStr);
+            for (CachedFileInfo& cachedFileInfo : cachedFs.cachedRootFileList)
+            {
+                resp.objStart();
+                resp.addStr("name", cachedFileInfo.fileName.c_str(), cachedFileInfo.fileName.length());
+                resp.addUint("size", cachedFileInfo.fileSize);
+                resp.objEnd();
+                fileCount++;
+            }
+            resp.arrEnd();
+            resp.objEnd();
+            resp.flush();
+            if (resp.isOverflow())
+            {
+                Raft::setJsonErrorResult(req, respStr, "resptoolong");
+                return false;
+            }
         }
-        // Format response
-        respStr = formatJSONFileInfo(req, cachedFs, fileListStr, folderStr);
+#ifdef DEBUG_GET_FILES_JSON_TIMING
         uint32_t elapsedMs = millis() - debugStartMs;
         LOG_I(MODULE_PREFIX, "fileInfoCacheToJSON elapsed %dms fileCount %d", elapsedMs, fileCount);
+#endif
+        (void)fileCount;
         return true;
     }
 
@@ -1526,7 +1641,9 @@ bool FileSystem::fileInfoGenImmediate(const char* req, CachedFileSystem& cachedF
     }
 
     // Debug
+#ifdef DEBUG_GET_FILES_JSON_TIMING
     uint32_t debugStartMs = millis();
+#endif
 
     // Check file system is valid
     if (cachedFs.fsSizeBytes == 0)
@@ -1551,50 +1668,61 @@ bool FileSystem::fileInfoGenImmediate(const char* req, CachedFileSystem& cachedF
         return false;
     }
 
+    // Response is written directly as directory entries are read (a file list isn't limited in length)
+    RestAPIRespSink resp(respStr, FILE_LIST_RESP_RESERVE_LEN, RestAPIRespSink::MAX_LEN_UNLIMITED);
+    fileInfoJSONStart(resp, req, cachedFs, rootFolder);
+
+    // Path buffer for stat (folder part is written once)
+    char filePath[FILE_PATH_MAX_LEN];
+    uint32_t folderPathLen = snprintf(filePath, sizeof(filePath), "%s%s", rootFolder.c_str(), rootFolder.endsWith("/") ? "" : "/");
+    if (folderPathLen >= sizeof(filePath))
+        folderPathLen = sizeof(filePath) - 1;
+
     // Read directory entries
-    bool firstFile = true;
-    String fileListStr;
     struct dirent* ent = NULL;
     while ((ent = readdir(dir)) != NULL)
     {
         // Check for unwanted files
-        String fName = ent->d_name;
-        if (fName.equalsIgnoreCase("System Volume Information"))
+        if (strcasecmp(ent->d_name, "System Volume Information") == 0)
             continue;
-        if (fName.equalsIgnoreCase("thumbs.db"))
+        if (strcasecmp(ent->d_name, "thumbs.db") == 0)
             continue;
 
         // Get file info including size
         size_t fileSize = 0;
         struct stat st;
-        String filePath = (rootFolder.endsWith("/") ? rootFolder + fName : rootFolder + "/" + fName);
-        if (stat(filePath.c_str(), &st) == 0) 
+        strlcpy(filePath + folderPathLen, ent->d_name, sizeof(filePath) - folderPathLen);
+        if (stat(filePath, &st) == 0) 
         {
             fileSize = st.st_size;
         }
 
-        // Form the JSON list
-        if (!firstFile)
-            fileListStr += ",";
-        firstFile = false;
-        fileListStr += R"({"name":")";
-        fileListStr += ent->d_name;
-        fileListStr += R"(","size":)";
-        fileListStr += String(fileSize);
-        fileListStr += "}";
+        // Add to the JSON list
+        resp.objStart();
+        resp.addStr("name", ent->d_name);
+        resp.addUint("size", fileSize);
+        resp.objEnd();
     }
 
     // Finished with file list
     closedir(dir);
     RaftMutex_unlock(_fileSysMutex);
 
-    // Format response
-    respStr = formatJSONFileInfo(req, cachedFs, fileListStr, rootFolder);
+    // Complete response
+    resp.arrEnd();
+    resp.objEnd();
+    resp.flush();
+    if (resp.isOverflow())
+    {
+        Raft::setJsonErrorResult(req, respStr, "resptoolong");
+        return false;
+    }
 
     // Debug
+#ifdef DEBUG_GET_FILES_JSON_TIMING
     uint32_t debugGetFilesMs = millis() - debugStartMs;
     LOG_I(MODULE_PREFIX, "getFilesJSON timing fileList %dms", debugGetFilesMs);
-
+#endif
     return true;
 }
 
@@ -1855,12 +1983,16 @@ void FileSystem::fileSystemCacheService(CachedFileSystem& cachedFs)
 // Format JSON file info
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-String FileSystem::formatJSONFileInfo(const char* req, CachedFileSystem& cachedFs, 
-            const String& fileListStr, const String& rootFolder)
+void FileSystem::fileInfoJSONStart(RestAPIRespSink& resp, const char* req, CachedFileSystem& cachedFs, 
+            const String& rootFolder)
 {
-    // Start response JSON
-    return R"({"req":")" + String(req) + R"(","rslt":"ok","fsName":")" + String(cachedFs.fsName.c_str()) + 
-                R"(","fsBase":")" + String(cachedFs.fsBase.c_str()) + 
-                R"(","diskSize":)" + String(cachedFs.fsSizeBytes) + R"(,"diskUsed":)" + String(cachedFs.fsUsedBytes) +
-                R"(,"folder":")" + rootFolder + R"(","files":[)" + fileListStr + "]}";
+    // Start response JSON (the caller adds the file list and closes the array and object)
+    resp.startResponse(req);
+    resp.addStr("rslt", "ok");
+    resp.addStr("fsName", cachedFs.fsName.c_str(), cachedFs.fsName.length());
+    resp.addStr("fsBase", cachedFs.fsBase.c_str(), cachedFs.fsBase.length());
+    resp.addUint("diskSize", cachedFs.fsSizeBytes);
+    resp.addUint("diskUsed", cachedFs.fsUsedBytes);
+    resp.addStr("folder", rootFolder);
+    resp.arrStart("files");
 }
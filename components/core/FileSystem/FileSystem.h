@@ -15,6 +15,9 @@
 #include "RaftThreading.h"
 #include "FileStreamBlock.h"
 #include "SpiramAwareAllocator.h"
+#include "FileContentsCache.h"
+
+class RestAPIRespSink;
 
 #define FILE_SYSTEM_SUPPORTS_LITTLEFS
 
@@ -53,6 +56,18 @@ public:
     // If a non-null pointer is returned then it must be freed by caller
     uint8_t* getFileContents(const String& fileSystemStr, const String& filename, int maxLen=0);
 
+    // Get file contents as a shared immutable buffer (small files are served from the contents cache)
+    FileContentsCache::ContentsPtr getFileContentsShared(const String& fileSystemStr, const String& filename, int maxLen=0);
+
+    // Set limits of the contents cache (maxFileBytes 0 disables caching)
+    void setContentsCacheLimits(uint32_t maxFileBytes, uint32_t maxTotalBytes, uint32_t maxEntries)
+    {
+        _contentsCache.setLimits(maxFileBytes, maxTotalBytes, maxEntries);
+    }
+
+    // Get debug JSON
+    String getDebugJSON() const;
+
     // Set file contents from string
     bool setFileContents(const String& fileSystemStr, const String& filename, String& fileContents);
 
@@ -181,6 +196,9 @@ private:
     // Mutex controlling access to file system
     mutable RaftMutex _fileSysMutex;
 
+    // Cache of small file contents
+    FileContentsCache _contentsCache;
+
     // File system partition name
     String _fsPartitionName;
 
@@ -197,10 +215,16 @@ private:
     bool fileInfoGenImmediate(const char* req, CachedFileSystem& cachedFs, const String& folderStr, String& respStr);
     bool fileSysInfoUpdateCache(const char* req, CachedFileSystem& cachedFs, String& respStr);
     void markFileCacheDirty(const String& fsName, const String& filename);
+    uint8_t* readFileContents(const String& rootFilename, int maxLen, uint32_t& fileLen, 
+                FileContentsCache::ContentsPtr* pCachedContents);
     void fileSystemCacheService(CachedFileSystem& cachedFs);
-    String formatJSONFileInfo(const char* req, CachedFileSystem& cachedFs, const String& fileListStr, const String& rootFolder);
+    void fileInfoJSONStart(RestAPIRespSink& resp, const char* req, CachedFileSystem& cachedFs, const String& rootFolder);
     static const uint32_t SERVICE_COUNT_FOR_CACHE_PRIMING = 10;
 
+    // File list response (initial reservation and maximum path length for stat of each entry)
+    static const uint32_t FILE_LIST_RESP_RESERVE_LEN = 1024;
+    static const uint32_t FILE_PATH_MAX_LEN = 300;
+
     // File system name
     static constexpr const char* LOCAL_FILE_SYSTEM_NAME = "local";
     static constexpr const char* LOCAL_FILE_SYSTEM_BASE_PATH = "/local";
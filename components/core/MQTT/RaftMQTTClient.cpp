@@ -420,6 +420,9 @@ void RaftMQTTClient::socketConnect()
                 ESP_LOGW(MODULE_PREFIX, "sockConn connect error %d", errno);
             }
             close(_clientHandle);
+
+            // Address may be out of date so look it up again before the next attempt
+            _dnsResolver.invalidate();
             return;
         }
     }
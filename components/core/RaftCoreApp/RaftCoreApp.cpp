@@ -89,6 +89,13 @@ RaftCoreApp::RaftCoreApp() :
         }
     );
 
+    // Protocol exchange binary device command fn (routes directly to the device manager)
+    _protocolExchange.setDeviceCmdBinaryHook( [this](uint32_t busNum, uint32_t address, uint32_t formatCode, 
+                const uint8_t* pData, uint32_t dataLen) {
+            return _deviceManager.receiveCmdBinary(RaftDeviceID(busNum, address), formatCode, pData, dataLen);
+        }
+    );
+
     // Setup SysManager
     _sysManager.setRestAPIEndpoints(_restAPIEndpointManager);
     _sysManager.setCommsCore(&_commsChannelManager);
@@ -15,6 +15,7 @@
 #include "RaftDeviceConsts.h"
 #include "RaftBusConsts.h"
 #include "BusAddrStatus.h"
+#include "RaftStateHash.h"
 
 class RestAPIEndpointManager;
 class CommsCoreIF;
@@ -116,7 +117,7 @@ public:
     virtual uint32_t getDeviceInfoTimestampMs(bool includeElemOnlineStatusChanges, bool includePollDataUpdates) const;
 
     /// @brief Get a hash value representing the current device state for change detection
-    /// @return Hash value (only lower 16 bits are used by DeviceManager)
+    /// @return Hash value
     /// @note Default implementation returns getDeviceInfoTimestampMs(true, true)
     ///       Override this to provide custom state change detection based on device-specific data
     virtual uint32_t getDeviceStateHash() const
@@ -124,6 +125,15 @@ public:
         return getDeviceInfoTimestampMs(true, true);
     }
 
+    /// @brief Get a 64-bit hash value representing the current device state for change detection
+    /// @return 64-bit hash value
+    /// @note Default implementation hashes getDeviceStateHash() - override this to provide a full 64-bit
+    ///       hash (e.g. maintained incrementally with RaftStateHash as data is updated)
+    virtual uint64_t getDeviceStateHash64() const
+    {
+        return RaftStateHash::hashValue(getDeviceStateHash());
+    }
+
     /// @brief Get the device status as JSON
     /// @return JSON string
     virtual String getStatusJSON() const;
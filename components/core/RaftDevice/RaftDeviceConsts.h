@@ -122,6 +122,21 @@ public:
         return RaftDeviceID(busNum, address);
     }
 
+    /// @brief Convert to a single numeric value (bus number in upper 32 bits, address in lower 32 bits)
+    /// @return Numeric representation of the device ID
+    uint64_t toUint64() const
+    {
+        return ((uint64_t)busNum << 32) | address;
+    }
+
+    /// @brief Convert from numeric value
+    /// @param val Numeric representation (as returned by toUint64())
+    /// @return DeviceIDType object
+    static RaftDeviceID fromUint64(uint64_t val)
+    {
+        return RaftDeviceID((BusNumType)(val >> 32), (BusElemAddrType)(val & 0xffffffff));
+    }
+
     /// @brief Get bus number
     /// @return Bus number
     BusNumType getBusNum() const
@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <limits.h>
 #include "RaftJsonIF.h"
+#include "RaftJsonNumbers.h"
 
 // Accommodate usage standalone (outside RaftCore)
 #if __has_include("RaftArduino.h")
@@ -25,10 +26,6 @@
 // #define DEBUG_JSON_LOCATE_ELEMENT_BOUNDS
 // #define DEBUG_EXTRACT_NAME_VALUES
 // #define DEBUG_CHAINED_RAFT_JSON
-#ifdef ESP_PLATFORM
-#include "SpiramAwareAllocator.h"
-#define USE_RAFT_SPIRAM_AWARE_ALLOCATOR
-#endif
 #endif
 
 // Treat strings as numbers in JSON documents
@@ -120,6 +117,24 @@ public:
         return true;
     }
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Set new contents for the JSON document taking ownership of a buffer (avoids copying the document)
+    /// @param jsonDoc buffer containing the new JSON document - on return this holds the previous document if
+    ///        it was owned by this object (or is empty)
+    /// @return true
+    virtual bool takeJsonDoc(RaftJsonDocBuffer& jsonDoc) override
+    {
+        // Ensure null-terminated
+        if (jsonDoc.empty() || (jsonDoc.back() != 0))
+            jsonDoc.push_back(0);
+
+        // Swap buffers and reference the new document
+        _jsonStr.swap(jsonDoc);
+        _pSourceStr = _jsonStr.data();
+        _pSourceEnd = _pSourceStr + strlen(_pSourceStr);
+        return true;
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Get string value using the member variable JSON document
     /// @param pDataPath the path of the required variable in XPath-like syntax (e.g. "a/b/c[0]/d")
@@ -289,7 +304,7 @@ public:
         if ((*pJsonDocPos == '"') && RAFT_JSON_TREAT_STRINGS_AS_NUMBERS)
             pJsonDocPos++;
         // Convert to double
-        return strtod(pJsonDocPos, NULL);
+        return RaftJsonNumbers::parseDouble(pJsonDocPos);
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -321,7 +336,7 @@ public:
         if ((*pJsonDocPos == '"') && RAFT_JSON_TREAT_STRINGS_AS_NUMBERS)
             pJsonDocPos++;
         // Convert to long
-        return strtol(pJsonDocPos, NULL, 0);
+        return RaftJsonNumbers::parseLong(pJsonDocPos);
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -804,13 +819,8 @@ public:
         // Make copy if required
         if (makeCopy)
         {
-#ifdef USE_RAFT_SPIRAM_AWARE_ALLOCATOR
-            _jsonStr = std::vector<char, SpiramAwareAllocator<char>>(pSourceStr, pSourceEnd + 1);
-            _jsonStr[pSourceEnd - pSourceStr] = 0;
-#else
-            _jsonStr = std::vector<char>(pSourceStr, pSourceEnd + 1);
+            _jsonStr = RaftJsonDocBuffer(pSourceStr, pSourceEnd + 1);
             _jsonStr[pSourceEnd - pSourceStr] = 0;
-#endif
             // Reference the copy
             _pSourceStr = _jsonStr.data();
             _pSourceEnd = _pSourceStr + (_jsonStr.size() - 1);
@@ -1514,11 +1524,7 @@ private:
 
 private:
     // JSON document string
-#ifdef USE_RAFT_SPIRAM_AWARE_ALLOCATOR
-    std::vector<char, SpiramAwareAllocator<char>> _jsonStr;
-#else
-    std::vector<char> _jsonStr;
-#endif
+    RaftJsonDocBuffer _jsonStr;
 
     // Empty JSON document
     static constexpr const char* EMPTY_JSON_DOCUMENT = "{}";
@@ -0,0 +1,76 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftJsonChunkedDoc
+// Assembles a JSON document received in chunks (e.g. a POST body) validating each chunk as it arrives
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RaftJsonChunkedDoc.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add a chunk
+/// @param pData chunk data
+/// @param len chunk length
+/// @param index position of the chunk in the document
+/// @param total total document length
+/// @param maxLen maximum document length (0 for no limit)
+/// @return CHUNK_COMPLETE when the last chunk of a valid document has been added, CHUNK_ERROR if the document
+///         is invalid (and on any further chunks of the same document), otherwise CHUNK_OK
+RaftJsonChunkedDoc::ChunkResult RaftJsonChunkedDoc::addChunk(const uint8_t* pData, uint32_t len,
+            uint32_t index, uint32_t total, uint32_t maxLen)
+{
+    // First chunk starts a new document - allocate the whole buffer up front
+    if (index == 0)
+    {
+        clear();
+        _validator.reset(true);
+        if ((total == 0) || ((maxLen != 0) && (total > maxLen)))
+        {
+            _failed = true;
+            return CHUNK_ERROR;
+        }
+        _doc.reserve(total + 1);
+    }
+
+    // Chunks must be contiguous and within the total
+    if (_failed || (index != _received) || (index + len > total))
+    {
+        clear();
+        _failed = true;
+        return CHUNK_ERROR;
+    }
+
+    // Validate before storing
+    if (!_validator.addChunk(pData, len))
+    {
+        clear();
+        _failed = true;
+        return CHUNK_ERROR;
+    }
+    _doc.insert(_doc.end(), pData, pData + len);
+    _received += len;
+    if (_received < total)
+        return CHUNK_OK;
+
+    // Complete
+    if (!_validator.isComplete())
+    {
+        clear();
+        _failed = true;
+        return CHUNK_ERROR;
+    }
+    if (_doc.back() != 0)
+        _doc.push_back(0);
+    return CHUNK_COMPLETE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Clear (frees the buffer)
+void RaftJsonChunkedDoc::clear()
+{
+    RaftJsonDocBuffer().swap(_doc);
+    _received = 0;
+    _failed = false;
+}
@@ -0,0 +1,62 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftJsonChunkedDoc
+// Assembles a JSON document received in chunks (e.g. a POST body) validating each chunk as it arrives
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RaftJsonIF.h"
+#include "RaftJsonStreamValidator.h"
+
+/// @brief Chunked JSON document assembler
+/// The buffer is allocated once at the full document size when the first chunk arrives (so there is no
+/// geometric growth) and each chunk is syntax checked before it is stored - an invalid or out-of-order chunk
+/// frees the buffer immediately and the rest of the document is discarded. The completed buffer can be handed
+/// to RaftJsonIF::takeJsonDoc() without copying.
+class RaftJsonChunkedDoc
+{
+public:
+    enum ChunkResult
+    {
+        CHUNK_OK,
+        CHUNK_COMPLETE,
+        CHUNK_ERROR
+    };
+
+    /// @brief Add a chunk
+    /// @param pData chunk data
+    /// @param len chunk length
+    /// @param index position of the chunk in the document
+    /// @param total total document length
+    /// @param maxLen maximum document length (0 for no limit)
+    /// @return CHUNK_COMPLETE when the last chunk of a valid document has been added, CHUNK_ERROR if the document
+    ///         is invalid (and on any further chunks of the same document), otherwise CHUNK_OK
+    ChunkResult addChunk(const uint8_t* pData, uint32_t len, uint32_t index, uint32_t total, uint32_t maxLen = 0);
+
+    /// @brief Get the assembled document (null-terminated once complete)
+    /// @return document buffer (may be passed to RaftJsonIF::takeJsonDoc)
+    RaftJsonDocBuffer& getDoc()
+    {
+        return _doc;
+    }
+
+    /// @brief Clear (frees the buffer)
+    void clear();
+
+    /// @brief Get the position of the first invalid byte (if the document was invalid)
+    /// @return position
+    uint32_t getErrorPos() const
+    {
+        return _validator.getPos();
+    }
+
+private:
+    RaftJsonStreamValidator _validator;
+    RaftJsonDocBuffer _doc;
+    uint32_t _received = 0;
+    bool _failed = false;
+};
@@ -0,0 +1,344 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftJsonDiff
+// Structural difference between JSON documents and path-scoped change notification
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "RaftJsonDiff.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get paths of elements which differ between two JSON documents
+/// @param pOldDoc old document (null is treated as empty)
+/// @param pNewDoc new document (null is treated as empty)
+/// @param changedPaths (out) changed paths (a single empty path means the whole document changed)
+/// @param maxPaths maximum number of paths (if exceeded the whole document is reported as changed)
+/// @return true if there are any differences
+bool RaftJsonDiff::getChangedPaths(const char* pOldDoc, const char* pNewDoc, std::vector<String>& changedPaths,
+            uint32_t maxPaths)
+{
+    changedPaths.clear();
+    Span oldDoc, newDoc;
+    oldDoc.pStart = pOldDoc ? pOldDoc : "";
+    oldDoc.pEnd = oldDoc.pStart + strlen(oldDoc.pStart);
+    newDoc.pStart = pNewDoc ? pNewDoc : "";
+    newDoc.pEnd = newDoc.pStart + strlen(newDoc.pStart);
+    skipWhitespace(oldDoc.pStart, oldDoc.pEnd);
+    skipWhitespace(newDoc.pStart, newDoc.pEnd);
+    String path;
+    if (!diffValues(oldDoc, newDoc, path, 0, changedPaths, maxPaths))
+    {
+        // Too many changes - report the whole document
+        changedPaths.clear();
+        changedPaths.push_back("");
+    }
+    return !changedPaths.empty();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Check if a change at a path affects a path prefix
+/// @param pPathPrefix path prefix (empty matches everything)
+/// @param changedPath changed path
+/// @return true if the changed path is within the prefix or is a parent of it
+bool RaftJsonDiff::isPathAffected(const char* pPathPrefix, const String& changedPath)
+{
+    uint32_t prefixLen = pPathPrefix ? strlen(pPathPrefix) : 0;
+    uint32_t changedLen = changedPath.length();
+    if ((prefixLen == 0) || (changedLen == 0))
+        return true;
+
+    // One path must be the start of the other and end at a path element boundary
+    uint32_t cmpLen = prefixLen < changedLen ? prefixLen : changedLen;
+    if (strncmp(pPathPrefix, changedPath.c_str(), cmpLen) != 0)
+        return false;
+    if (prefixLen == changedLen)
+        return true;
+    char nextCh = prefixLen < changedLen ? changedPath.c_str()[cmpLen] : pPathPrefix[cmpLen];
+    return (nextCh == '/') || (nextCh == '[');
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Compare values recursively adding changed paths
+/// @return false if the maximum number of paths was exceeded
+bool RaftJsonDiff::diffValues(const Span& oldVal, const Span& newVal, String& path, uint32_t depth,
+            std::vector<String>& changedPaths, uint32_t maxPaths)
+{
+    // Identical text is by far the most common case
+    if (spansEqual(oldVal, newVal))
+        return true;
+
+    // Only objects and arrays of the same kind are compared element by element
+    char oldType = oldVal.pStart < oldVal.pEnd ? *oldVal.pStart : 0;
+    char newType = newVal.pStart < newVal.pEnd ? *newVal.pStart : 0;
+    if ((oldType != newType) || ((oldType != '{') && (oldType != '[')) || (depth >= MAX_DEPTH))
+        return addChangedPath(path, changedPaths, maxPaths);
+    uint32_t pathLen = path.length();
+
+    // Arrays
+    if (oldType == '[')
+    {
+        std::vector<Span> oldElems, newElems;
+        getElems(oldVal, oldElems);
+        getElems(newVal, newElems);
+        if (oldElems.size() != newElems.size())
+            return addChangedPath(path, changedPaths, maxPaths);
+        for (uint32_t i = 0; i < newElems.size(); i++)
+        {
+            char idxStr[16];
+            snprintf(idxStr, sizeof(idxStr), "[%u]", (unsigned)i);
+            path.concat(idxStr, strlen(idxStr));
+            bool rslt = diffValues(oldElems[i], newElems[i], path, depth + 1, changedPaths, maxPaths);
+            path.remove(pathLen);
+            if (!rslt)
+                return false;
+        }
+        return true;
+    }
+
+    // Objects
+    std::vector<std::pair<Span, Span>> oldMembers, newMembers;
+    getMembers(oldVal, oldMembers);
+    getMembers(newVal, newMembers);
+    std::vector<bool> oldMatched(oldMembers.size(), false);
+    for (uint32_t newIdx = 0; newIdx < newMembers.size(); newIdx++)
+    {
+        const std::pair<Span, Span>& newMember = newMembers[newIdx];
+
+        // Find key in old members (trying the same position first as key order rarely changes)
+        int32_t oldIdx = -1;
+        for (uint32_t i = 0; i < oldMembers.size(); i++)
+        {
+            uint32_t tryIdx = (newIdx + i) % oldMembers.size();
+            if (!oldMatched[tryIdx] && spansEqual(oldMembers[tryIdx].first, newMember.first))
+            {
+                oldIdx = tryIdx;
+                break;
+            }
+        }
+
+        // Path for this member
+        if (pathLen > 0)
+            path.concat("/", 1);
+        path.concat(newMember.first.pStart, newMember.first.pEnd - newMember.first.pStart);
+        bool rslt = true;
+        if (oldIdx < 0)
+        {
+            rslt = addChangedPath(path, changedPaths, maxPaths);
+        }
+        else
+        {
+            oldMatched[oldIdx] = true;
+            rslt = diffValues(oldMembers[oldIdx].second, newMember.second, path, depth + 1, changedPaths, maxPaths);
+        }
+        path.remove(pathLen);
+        if (!rslt)
+            return false;
+    }
+
+    // Removed keys
+    for (uint32_t oldIdx = 0; oldIdx < oldMembers.size(); oldIdx++)
+    {
+        if (oldMatched[oldIdx])
+            continue;
+        if (pathLen > 0)
+            path.concat("/", 1);
+        path.concat(oldMembers[oldIdx].first.pStart, oldMembers[oldIdx].first.pEnd - oldMembers[oldIdx].first.pStart);
+        bool rslt = addChangedPath(path, changedPaths, maxPaths);
+        path.remove(pathLen);
+        if (!rslt)
+            return false;
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add a changed path
+/// @return false if the maximum number of paths was exceeded
+bool RaftJsonDiff::addChangedPath(const String& path, std::vector<String>& changedPaths, uint32_t maxPaths)
+{
+    if (changedPaths.size() >= maxPaths)
+        return false;
+    changedPaths.push_back(path);
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Check if spans are equal
+bool RaftJsonDiff::spansEqual(const Span& a, const Span& b)
+{
+    uint32_t len = a.pEnd - a.pStart;
+    return (len == (uint32_t)(b.pEnd - b.pStart)) && (memcmp(a.pStart, b.pStart, len) == 0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get members of an object (keys are without quotes)
+void RaftJsonDiff::getMembers(const Span& obj, std::vector<std::pair<Span, Span>>& members)
+{
+    const char* pCur = obj.pStart + 1;
+    while (pCur < obj.pEnd)
+    {
+        skipWhitespace(pCur, obj.pEnd);
+        if ((pCur >= obj.pEnd) || (*pCur != '"'))
+            break;
+        Span key;
+        key.pStart = pCur + 1;
+        pCur = skipString(pCur, obj.pEnd);
+        key.pEnd = pCur - 1;
+        skipWhitespace(pCur, obj.pEnd);
+        if ((pCur >= obj.pEnd) || (*pCur != ':'))
+            break;
+        pCur++;
+        skipWhitespace(pCur, obj.pEnd);
+        Span val;
+        val.pStart = pCur;
+        pCur = skipValue(pCur, obj.pEnd);
+        val.pEnd = pCur;
+        members.push_back({key, val});
+        skipWhitespace(pCur, obj.pEnd);
+        if ((pCur >= obj.pEnd) || (*pCur != ','))
+            break;
+        pCur++;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get elements of an array
+void RaftJsonDiff::getElems(const Span& arr, std::vector<Span>& elems)
+{
+    const char* pCur = arr.pStart + 1;
+    while (pCur < arr.pEnd)
+    {
+        skipWhitespace(pCur, arr.pEnd);
+        if ((pCur >= arr.pEnd) || (*pCur == ']'))
+            break;
+        Span elem;
+        elem.pStart = pCur;
+        pCur = skipValue(pCur, arr.pEnd);
+        elem.pEnd = pCur;
+        elems.push_back(elem);
+        skipWhitespace(pCur, arr.pEnd);
+        if ((pCur >= arr.pEnd) || (*pCur != ','))
+            break;
+        pCur++;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Skip whitespace
+void RaftJsonDiff::skipWhitespace(const char*& pCur, const char* pEnd)
+{
+    while ((pCur < pEnd) && ((*pCur == ' ') || (*pCur == '\n') || (*pCur == '\r') || (*pCur == '\t')))
+        pCur++;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Skip a string (pCur is on the opening quote)
+/// @return position after the closing quote
+const char* RaftJsonDiff::skipString(const char* pCur, const char* pEnd)
+{
+    pCur++;
+    while (pCur < pEnd)
+    {
+        if (*pCur == '\\')
+            pCur++;
+        else if (*pCur == '"')
+            return pCur + 1;
+        pCur++;
+    }
+    return pEnd;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Skip a value (object, array, string or literal)
+/// @return position after the value
+const char* RaftJsonDiff::skipValue(const char* pCur, const char* pEnd)
+{
+    if (pCur >= pEnd)
+        return pEnd;
+    if (*pCur == '"')
+        return skipString(pCur, pEnd);
+    if ((*pCur == '{') || (*pCur == '['))
+    {
+        uint32_t depth = 0;
+        while (pCur < pEnd)
+        {
+            if (*pCur == '"')
+            {
+                pCur = skipString(pCur, pEnd);
+                continue;
+            }
+            if ((*pCur == '{') || (*pCur == '['))
+                depth++;
+            else if ((*pCur == '}') || (*pCur == ']'))
+            {
+                depth--;
+                if (depth == 0)
+                    return pCur + 1;
+            }
+            pCur++;
+        }
+        return pEnd;
+    }
+    while ((pCur < pEnd) && (*pCur != ',') && (*pCur != '}') && (*pCur != ']') && (*pCur > ' '))
+        pCur++;
+    return pCur;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Register a callback for any change
+/// @param changeCallback callback
+void RaftJsonChangeNotifier::registerChangeCallback(RaftJsonChangeCallbackType changeCallback)
+{
+    if (changeCallback)
+        _changeCallbacks.push_back(changeCallback);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Register a callback for changes within a path prefix
+/// @param pPathPrefix path prefix (e.g. "WiFi" or "Publish/pubList") - empty for the whole document
+/// @param pathChangeCallback callback (receives the changed paths within or containing the prefix)
+void RaftJsonChangeNotifier::registerPathChangeCallback(const char* pPathPrefix,
+            RaftJsonPathChangeCallbackType pathChangeCallback)
+{
+    if (!pathChangeCallback)
+        return;
+    PathChangeCallbackRec rec;
+    rec.pathPrefix = pPathPrefix ? pPathPrefix : "";
+    rec.callback = pathChangeCallback;
+    _pathChangeCallbacks.push_back(rec);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Notify callbacks of changes between documents
+/// @param pOldDoc old document
+/// @param pNewDoc new document
+/// @return number of changed paths
+uint32_t RaftJsonChangeNotifier::notify(const char* pOldDoc, const char* pNewDoc)
+{
+    // Nothing to do if nothing changed
+    std::vector<String> changedPaths;
+    if (!RaftJsonDiff::getChangedPaths(pOldDoc, pNewDoc, changedPaths))
+        return 0;
+
+    // Callbacks for any change
+    for (RaftJsonChangeCallbackType& changeCallback : _changeCallbacks)
+        changeCallback();
+
+    // Path-scoped callbacks with the changed paths which affect them
+    std::vector<String> affectedPaths;
+    for (PathChangeCallbackRec& rec : _pathChangeCallbacks)
+    {
+        affectedPaths.clear();
+        for (const String& changedPath : changedPaths)
+        {
+            if (RaftJsonDiff::isPathAffected(rec.pathPrefix.c_str(), changedPath))
+                affectedPaths.push_back(changedPath);
+        }
+        if (!affectedPaths.empty())
+            rec.callback(affectedPaths);
+    }
+    return changedPaths.size();
+}
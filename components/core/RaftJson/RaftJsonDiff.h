@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftJsonDiff
+// Structural difference between JSON documents and path-scoped change notification
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <list>
+#include "RaftJsonIF.h"
+
+/// @brief Structural JSON diff
+/// Paths are in the XPath-like syntax used by RaftJson (e.g. "a/b/c[0]/d"). For each difference the path of the
+/// outermost element which differs is reported - an added, removed or changed key, an array whose length has
+/// changed or an array element. Whitespace and key order within objects don't count as differences.
+class RaftJsonDiff
+{
+public:
+    /// @brief Get paths of elements which differ between two JSON documents
+    /// @param pOldDoc old document (null is treated as empty)
+    /// @param pNewDoc new document (null is treated as empty)
+    /// @param changedPaths (out) changed paths (a single empty path means the whole document changed)
+    /// @param maxPaths maximum number of paths (if exceeded the whole document is reported as changed)
+    /// @return true if there are any differences
+    static bool getChangedPaths(const char* pOldDoc, const char* pNewDoc, std::vector<String>& changedPaths,
+                uint32_t maxPaths = MAX_PATHS_DEFAULT);
+
+    /// @brief Check if a change at a path affects a path prefix
+    /// @param pPathPrefix path prefix (empty matches everything)
+    /// @param changedPath changed path
+    /// @return true if the changed path is within the prefix or is a parent of it
+    static bool isPathAffected(const char* pPathPrefix, const String& changedPath);
+
+    // Default maximum number of changed paths reported
+    static const uint32_t MAX_PATHS_DEFAULT = 50;
+
+private:
+    // Span of a JSON document
+    struct Span
+    {
+        const char* pStart = nullptr;
+        const char* pEnd = nullptr;
+    };
+    static const uint32_t MAX_DEPTH = 32;
+    static void skipWhitespace(const char*& pCur, const char* pEnd);
+    static const char* skipValue(const char* pCur, const char* pEnd);
+    static const char* skipString(const char* pCur, const char* pEnd);
+    static bool spansEqual(const Span& a, const Span& b);
+    static void getMembers(const Span& obj, std::vector<std::pair<Span, Span>>& members);
+    static void getElems(const Span& arr, std::vector<Span>& elems);
+    static bool diffValues(const Span& oldVal, const Span& newVal, String& path, uint32_t depth,
+                std::vector<String>& changedPaths, uint32_t maxPaths);
+    static bool addChangedPath(const String& path, std::vector<String>& changedPaths, uint32_t maxPaths);
+};
+
+/// @brief Change notifier for JSON documents
+/// Holds callbacks for any change and callbacks scoped to path prefixes. When the document is replaced the old
+/// and new documents are compared and each path-scoped callback is called (only) if something within its prefix
+/// changed - with the list of changed paths.
+class RaftJsonChangeNotifier
+{
+public:
+    /// @brief Register a callback for any change
+    /// @param changeCallback callback
+    void registerChangeCallback(RaftJsonChangeCallbackType changeCallback);
+
+    /// @brief Register a callback for changes within a path prefix
+    /// @param pPathPrefix path prefix (e.g. "WiFi" or "Publish/pubList") - empty for the whole document
+    /// @param pathChangeCallback callback (receives the changed paths within or containing the prefix)
+    void registerPathChangeCallback(const char* pPathPrefix, RaftJsonPathChangeCallbackType pathChangeCallback);
+
+    /// @brief Check if there are any callbacks (if not the old document needn't be kept for comparison)
+    /// @return true if callbacks are registered
+    bool hasCallbacks() const
+    {
+        return !_changeCallbacks.empty() || !_pathChangeCallbacks.empty();
+    }
+
+    /// @brief Notify callbacks of changes between documents
+    /// @param pOldDoc old document
+    /// @param pNewDoc new document
+    /// @return number of changed paths
+    uint32_t notify(const char* pOldDoc, const char* pNewDoc);
+
+private:
+    std::vector<RaftJsonChangeCallbackType> _changeCallbacks;
+    struct PathChangeCallbackRec
+    {
+        String pathPrefix;
+        RaftJsonPathChangeCallbackType callback;
+    };
+    std::list<PathChangeCallbackRec> _pathChangeCallbacks;
+};
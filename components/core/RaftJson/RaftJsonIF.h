@@ -16,11 +16,24 @@
 #include "WString.h"
 #endif
 
+// Owned JSON document storage (in SPIRAM where available)
+#if __has_include("RaftArduino.h") && defined(ESP_PLATFORM)
+#include "SpiramAwareAllocator.h"
+typedef std::vector<char, SpiramAwareAllocator<char>> RaftJsonDocBuffer;
+#else
+typedef std::vector<char> RaftJsonDocBuffer;
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Callback type for JSON change - used by RaftJsonIF implementations that support 
 ///        changes to the JSON document
 typedef std::function<void()> RaftJsonChangeCallbackType;
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Callback type for JSON change within a path prefix - receives the paths (in XPath-like syntax) of the
+///        elements which changed (an empty path means the whole document changed)
+typedef std::function<void(const std::vector<String>& changedPaths)> RaftJsonPathChangeCallbackType;
+
 class RaftJsonIF
 {
 public:
@@ -176,6 +189,16 @@ public:
     {
     }
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Register a callback for JSON change within a path prefix - used by RaftJsonIF implementations that
+    ///        support changes to the JSON document
+    /// @param pPathPrefix the path prefix in XPath-like syntax (e.g. "a/b") - empty for the whole document
+    /// @param pathChangeCallback the callback to be called (with the changed paths) when anything within the
+    ///        path prefix changes
+    virtual void registerPathChangeCallback(const char* pPathPrefix, RaftJsonPathChangeCallbackType pathChangeCallback)
+    {
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Set new contents for the JSON document
     /// @param pJsonDoc the new JSON document
@@ -187,6 +210,21 @@ public:
         return false;
     }
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Set new contents for the JSON document taking ownership of a buffer (avoids copying the document)
+    /// @param jsonDoc buffer containing the new JSON document (null-terminated) - on return this holds the
+    ///        previous document if it was owned by this object (or is empty)
+    /// @return true if the JSON document was successfully set
+    /// @note Implementations which don't own their document fall back to setJsonDoc (which copies)
+    virtual bool takeJsonDoc(RaftJsonDocBuffer& jsonDoc)
+    {
+        if (jsonDoc.empty() || (jsonDoc.back() != 0))
+            jsonDoc.push_back(0);
+        bool rslt = setJsonDoc(jsonDoc.data());
+        jsonDoc.clear();
+        return rslt;
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Locate an element in a JSON document using a path
     /// @param pPath the path of the required variable in XPath-like syntax (e.g. "a/b/c[0]/d")
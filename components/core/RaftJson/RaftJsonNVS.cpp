@@ -42,25 +42,52 @@ bool RaftJsonNVS::_nvsInitialised = RaftJsonNVS::initNVS(true);
 ///       Implementations that store to NVS or similar may persist the new JSON document
 bool RaftJsonNVS::setJsonDoc(const char* pJsonDoc)
 {
-    // Set json doc
+    // Check if the string is too long (before making a copy)
     uint32_t jsonDocStrLen = strlen(pJsonDoc);
+    if ((_jsonMaxlen > 0) && (jsonDocStrLen > _jsonMaxlen))
+    {
+#ifdef WARN_ON_NVS_JSON_DOC_TOO_LONG
+        LOG_W(MODULE_PREFIX, "setJsonDoc TOO_LONG namespace %s read: len(%d) maxlen %d", 
+                    _nvsNamespace.c_str(), jsonDocStrLen, _jsonMaxlen);
+#endif
+        return false;
+    }
 
-    // Check if a max length is set
-    if (_jsonMaxlen > 0)
+    // Copy and set
+    RaftJsonDocBuffer jsonDoc(pJsonDoc, pJsonDoc + jsonDocStrLen + 1);
+    return takeJsonDoc(jsonDoc);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Set new contents for the JSON document taking ownership of a buffer (avoids copying the document)
+/// @param jsonDoc buffer containing the new JSON document - on return this holds the previous document
+/// @return true if the JSON document was successfully set and persisted
+/// @note The document is written and committed to NVS before it replaces the current document so a failed
+///       write leaves both the NVS and in-memory documents unchanged
+bool RaftJsonNVS::takeJsonDoc(RaftJsonDocBuffer& jsonDoc)
+{
+    // Ensure null-terminated
+    if (jsonDoc.empty() || (jsonDoc.back() != 0))
+        jsonDoc.push_back(0);
+    uint32_t jsonDocStrLen = strlen(jsonDoc.data());
+
+    // Check length
+    if ((_jsonMaxlen > 0) && (jsonDocStrLen > _jsonMaxlen))
     {
-        // Check if the string is too long
-        if (jsonDocStrLen > _jsonMaxlen)
-        {
 #ifdef WARN_ON_NVS_JSON_DOC_TOO_LONG
-            LOG_W(MODULE_PREFIX, "setJsonDoc TOO_LONG namespace %s read: len(%d) maxlen %d", 
-                        _nvsNamespace.c_str(), jsonDocStrLen, _jsonMaxlen);
+        LOG_W(MODULE_PREFIX, "takeJsonDoc TOO_LONG namespace %s read: len(%d) maxlen %d", 
+                    _nvsNamespace.c_str(), jsonDocStrLen, _jsonMaxlen);
 #endif
-            return false;
-        }
+        return false;
     }
 
-    // Update the document
-    updateJsonDoc(pJsonDoc, jsonDocStrLen);
+    // Document must at least be "{}"
+    if (jsonDocStrLen < 2)
+    {
+        const char* pEmptyJsonDoc = "{}";
+        jsonDoc.assign(pEmptyJsonDoc, pEmptyJsonDoc + 3);
+        jsonDocStrLen = 2;
+    }
 
     // Write the value to NVS
     uint32_t nvsHandle = 0;
@@ -75,13 +102,14 @@ bool RaftJsonNVS::setJsonDoc(const char* pJsonDoc)
     }
 
     // Set the new string into the NVS handle
-    err = nvs_set_str(nvsHandle, KEY_NAME_FOR_JSON_DOC, pJsonDoc);
+    err = nvs_set_str(nvsHandle, KEY_NAME_FOR_JSON_DOC, jsonDoc.data());
     if (err != ESP_OK)
     {
 #ifdef WARN_ON_NVS_ACCESS_FAILURES
-        LOG_W(MODULE_PREFIX, "setJsonDoc nvs_set_str FAIL ns %s error %d", 
+        LOG_W(MODULE_PREFIX, "setJsonDoc nvs_set_str FAIL ns %s error %s", 
                         _nvsNamespace.c_str(), esp_err_to_name(err));
 #endif
+        nvs_close(nvsHandle);
         return false;
     }
 
@@ -93,20 +121,19 @@ bool RaftJsonNVS::setJsonDoc(const char* pJsonDoc)
         LOG_E(MODULE_PREFIX, "setJsonDoc nvs_commit FAIL ns %s error %s", 
                         _nvsNamespace.c_str(), esp_err_to_name(err));
 #endif
+        nvs_close(nvsHandle);
         return false;
     }
 
     // Close NVS
     nvs_close(nvsHandle);
 
-    // Call config change callbacks
-    for (int i = 0; i < _jsonChangeCallbacks.size(); i++)
-    {
-        if (_jsonChangeCallbacks[i])
-        {
-            (_jsonChangeCallbacks[i])();
-        }
-    }
+    // Replace the document (the previous document is swapped into jsonDoc)
+    RaftJson::takeJsonDoc(jsonDoc);
+
+    // Call config change callbacks (only for the parts of the document which changed)
+    if (_changeNotifier.hasCallbacks())
+        _changeNotifier.notify(jsonDoc.empty() ? "{}" : jsonDoc.data(), getJsonDoc());
 
 #ifdef DEBUG_NVS_READ_WRITE_OPERATIONS
     LOG_I(MODULE_PREFIX, "setJsonDoc OK namespace %s len %d maxlen %d",
@@ -117,11 +144,11 @@ bool RaftJsonNVS::setJsonDoc(const char* pJsonDoc)
         // Debug
         debugShowNVSInfo(true);
         // Show the NVS contents
-        std::vector<char, SpiramAwareAllocator<char>> jsonDoc;
-        if (RaftJsonNVS::getStrFromNVS(_nvsNamespace.c_str(), KEY_NAME_FOR_JSON_DOC, jsonDoc))
+        std::vector<char, SpiramAwareAllocator<char>> nvsJsonDoc;
+        if (RaftJsonNVS::getStrFromNVS(_nvsNamespace.c_str(), KEY_NAME_FOR_JSON_DOC, nvsJsonDoc))
         {
             LOG_I(MODULE_PREFIX, "setJsonDoc debug ns %s key %s value %s", 
-                        _nvsNamespace.c_str(), KEY_NAME_FOR_JSON_DOC, jsonDoc.data());
+                        _nvsNamespace.c_str(), KEY_NAME_FOR_JSON_DOC, nvsJsonDoc.data());
         }
     }
 #endif
@@ -12,6 +12,7 @@
 #include <vector>
 #include "Logger.h"
 #include "RaftJson.h"
+#include "RaftJsonDiff.h"
 
 #ifdef ESP_PLATFORM
 
@@ -44,13 +45,17 @@ public:
     /// @param jsonChangeCallback the callback to be called when the JSON document changes
     virtual void registerChangeCallback(RaftJsonChangeCallbackType configChangeCallback) override final
     {
-        // Save callback if valid and not already present
-        if (configChangeCallback)
-        {
-            // Would have been nice to check if the pointer is already in the list but for some reason
-            // == isn't implemented on two std::function objects
-            _jsonChangeCallbacks.push_back(configChangeCallback);
-        }
+        _changeNotifier.registerChangeCallback(configChangeCallback);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Register a callback for JSON change within a path prefix
+    /// @param pPathPrefix the path prefix in XPath-like syntax (e.g. "a/b") - empty for the whole document
+    /// @param pathChangeCallback the callback to be called (with the changed paths) when anything within the
+    ///        path prefix changes
+    virtual void registerPathChangeCallback(const char* pPathPrefix, RaftJsonPathChangeCallbackType pathChangeCallback) override final
+    {
+        _changeNotifier.registerPathChangeCallback(pPathPrefix, pathChangeCallback);
     }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -61,6 +66,12 @@ public:
     ///       Implementations that store to NVS or similar may persist the new JSON document
     virtual bool setJsonDoc(const char* pJsonDoc) override;
 
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Set new contents for the JSON document taking ownership of a buffer (avoids copying the document)
+    /// @param jsonDoc buffer containing the new JSON document - on return this holds the previous document
+    /// @return true if the JSON document was successfully set and persisted
+    virtual bool takeJsonDoc(RaftJsonDocBuffer& jsonDoc) override;
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Get max length of JSON document
     /// @return the maximum length of the JSON document (0 means no limit)
@@ -99,8 +110,8 @@ private:
     // Namespace used for NVS library
     String _nvsNamespace;
 
-    // List of callbacks on change of config
-    std::vector<RaftJsonChangeCallbackType> _jsonChangeCallbacks;
+    // Callbacks on change of config (notified with the paths which changed)
+    RaftJsonChangeNotifier _changeNotifier;
 
     // Non-volatile store valid
     bool _nonVolatileStoreValid = true;
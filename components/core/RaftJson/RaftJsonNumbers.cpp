@@ -0,0 +1,449 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftJsonNumbers - fast number parsing and round-trip formatting for JSON
+//
+// Formatting uses the Grisu2 algorithm (Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+// Accurately with Integers", PLDI 2010) which generates a digit string that always round-trips, using only
+// 64-bit integer arithmetic and a small table of cached powers of 10 - the output is shortest in most cases
+// but Grisu2 does not guarantee this and a small fraction of values have one more digit than necessary
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <cmath>
+#include <limits>
+#include "RaftJsonNumbers.h"
+
+namespace RaftJsonGrisu
+{
+    // Floating point value with 64-bit significand and binary exponent
+    struct DiyFp
+    {
+        uint64_t f = 0;
+        int32_t e = 0;
+        constexpr DiyFp(uint64_t f_, int32_t e_) : f(f_), e(e_) {}
+
+        // Subtract (both must have the same exponent and x.f >= y.f)
+        static DiyFp sub(const DiyFp& x, const DiyFp& y)
+        {
+            return DiyFp(x.f - y.f, x.e);
+        }
+
+        // Multiply returning the upper 64 bits of the 128-bit product (rounded)
+        static DiyFp mul(const DiyFp& x, const DiyFp& y)
+        {
+            const uint64_t u_lo = x.f & 0xFFFFFFFFu;
+            const uint64_t u_hi = x.f >> 32u;
+            const uint64_t v_lo = y.f & 0xFFFFFFFFu;
+            const uint64_t v_hi = y.f >> 32u;
+            const uint64_t p0 = u_lo * v_lo;
+            const uint64_t p1 = u_lo * v_hi;
+            const uint64_t p2 = u_hi * v_lo;
+            const uint64_t p3 = u_hi * v_hi;
+            const uint64_t p0_hi = p0 >> 32u;
+            const uint64_t p1_lo = p1 & 0xFFFFFFFFu;
+            const uint64_t p1_hi = p1 >> 32u;
+            const uint64_t p2_lo = p2 & 0xFFFFFFFFu;
+            const uint64_t p2_hi = p2 >> 32u;
+            uint64_t Q = p0_hi + p1_lo + p2_lo;
+            Q += uint64_t{1} << (64u - 32u - 1u);
+            const uint64_t h = p3 + p2_hi + p1_hi + (Q >> 32u);
+            return DiyFp(h, x.e + y.e + 64);
+        }
+
+        // Normalize so that the most significant bit of f is set
+        static DiyFp normalize(DiyFp x)
+        {
+            while ((x.f >> 63u) == 0)
+            {
+                x.f <<= 1u;
+                x.e--;
+            }
+            return x;
+        }
+
+        // Normalize to the given exponent (which must be <= x.e)
+        static DiyFp normalizeTo(const DiyFp& x, int32_t targetExp)
+        {
+            const int32_t delta = x.e - targetExp;
+            return DiyFp(x.f << delta, targetExp);
+        }
+    };
+
+    // Value and boundaries of the rounding interval
+    struct Boundaries
+    {
+        DiyFp w;
+        DiyFp minus;
+        DiyFp plus;
+    };
+
+    // Compute the normalized value and boundaries (m-, m+) for a positive finite value
+    template <typename FloatType>
+    static Boundaries computeBoundaries(FloatType value)
+    {
+        constexpr int32_t kPrecision = std::numeric_limits<FloatType>::digits;
+        constexpr int32_t kBias = std::numeric_limits<FloatType>::max_exponent - 1 + (kPrecision - 1);
+        constexpr int32_t kMinExp = 1 - kBias;
+        constexpr uint64_t kHiddenBit = uint64_t{1} << (kPrecision - 1);
+
+        // Extract bits (via memcpy to avoid aliasing issues)
+        uint64_t bits = 0;
+        if (sizeof(FloatType) == sizeof(uint32_t))
+        {
+            uint32_t bits32 = 0;
+            memcpy(&bits32, &value, sizeof(bits32));
+            bits = bits32;
+        }
+        else
+        {
+            memcpy(&bits, &value, sizeof(bits));
+        }
+        const uint64_t E = bits >> (kPrecision - 1);
+        const uint64_t F = bits & (kHiddenBit - 1);
+
+        const bool isDenormal = (E == 0);
+        const DiyFp v = isDenormal ? DiyFp(F, kMinExp) : DiyFp(F + kHiddenBit, static_cast<int32_t>(E) - kBias);
+
+        // The lower boundary is closer if the significand is a power of 2 (and not the smallest normal)
+        const bool lowerBoundaryIsCloser = (F == 0) && (E > 1);
+        const DiyFp mPlus = DiyFp(2 * v.f + 1, v.e - 1);
+        const DiyFp mMinus = lowerBoundaryIsCloser ? DiyFp(4 * v.f - 1, v.e - 2) : DiyFp(2 * v.f - 1, v.e - 1);
+
+        const DiyFp wPlus = DiyFp::normalize(mPlus);
+        const DiyFp wMinus = DiyFp::normalizeTo(mMinus, wPlus.e);
+        return { DiyFp::normalize(v), wMinus, wPlus };
+    }
+
+    // Range of binary exponents for the scaled value
+    static const int32_t kAlpha = -60;
+    static const int32_t kGamma = -32;
+
+    // Cached power of 10 (c = f * 2^e ~= 10^k)
+    struct CachedPower
+    {
+        uint64_t f;
+        int32_t e;
+        int32_t k;
+    };
+
+    // Find a cached power of 10 such that alpha <= e + c.e + 64 <= gamma
+    static CachedPower getCachedPowerForBinaryExponent(int32_t e)
+    {
+        static const int32_t kCachedPowersMinDecExp = -300;
+        static const int32_t kCachedPowersDecStep = 8;
+        static const CachedPower kCachedPowers[] = {
+        { 0xAB70FE17C79AC6CAULL, -1060, -300 },
+        { 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+        { 0xBE5691EF416BD60CULL, -1007, -284 },
+        { 0x8DD01FAD907FFC3CULL,  -980, -276 },
+        { 0xD3515C2831559A83ULL,  -954, -268 },
+        { 0x9D71AC8FADA6C9B5ULL,  -927, -260 },
+        { 0xEA9C227723EE8BCBULL,  -901, -252 },
+        { 0xAECC49914078536DULL,  -874, -244 },
+        { 0x823C12795DB6CE57ULL,  -847, -236 },
+        { 0xC21094364DFB5637ULL,  -821, -228 },
+        { 0x9096EA6F3848984FULL,  -794, -220 },
+        { 0xD77485CB25823AC7ULL,  -768, -212 },
+        { 0xA086CFCD97BF97F4ULL,  -741, -204 },
+        { 0xEF340A98172AACE5ULL,  -715, -196 },
+        { 0xB23867FB2A35B28EULL,  -688, -188 },
+        { 0x84C8D4DFD2C63F3BULL,  -661, -180 },
+        { 0xC5DD44271AD3CDBAULL,  -635, -172 },
+        { 0x936B9FCEBB25C996ULL,  -608, -164 },
+        { 0xDBAC6C247D62A584ULL,  -582, -156 },
+        { 0xA3AB66580D5FDAF6ULL,  -555, -148 },
+        { 0xF3E2F893DEC3F126ULL,  -529, -140 },
+        { 0xB5B5ADA8AAFF80B8ULL,  -502, -132 },
+        { 0x87625F056C7C4A8BULL,  -475, -124 },
+        { 0xC9BCFF6034C13053ULL,  -449, -116 },
+        { 0x964E858C91BA2655ULL,  -422, -108 },
+        { 0xDFF9772470297EBDULL,  -396, -100 },
+        { 0xA6DFBD9FB8E5B88FULL,  -369,  -92 },
+        { 0xF8A95FCF88747D94ULL,  -343,  -84 },
+        { 0xB94470938FA89BCFULL,  -316,  -76 },
+        { 0x8A08F0F8BF0F156BULL,  -289,  -68 },
+        { 0xCDB02555653131B6ULL,  -263,  -60 },
+        { 0x993FE2C6D07B7FACULL,  -236,  -52 },
+        { 0xE45C10C42A2B3B06ULL,  -210,  -44 },
+        { 0xAA242499697392D3ULL,  -183,  -36 },
+        { 0xFD87B5F28300CA0EULL,  -157,  -28 },
+        { 0xBCE5086492111AEBULL,  -130,  -20 },
+        { 0x8CBCCC096F5088CCULL,  -103,  -12 },
+        { 0xD1B71758E219652CULL,   -77,   -4 },
+        { 0x9C40000000000000ULL,   -50,    4 },
+        { 0xE8D4A51000000000ULL,   -24,   12 },
+        { 0xAD78EBC5AC620000ULL,     3,   20 },
+        { 0x813F3978F8940984ULL,    30,   28 },
+        { 0xC097CE7BC90715B3ULL,    56,   36 },
+        { 0x8F7E32CE7BEA5C70ULL,    83,   44 },
+        { 0xD5D238A4ABE98068ULL,   109,   52 },
+        { 0x9F4F2726179A2245ULL,   136,   60 },
+        { 0xED63A231D4C4FB27ULL,   162,   68 },
+        { 0xB0DE65388CC8ADA8ULL,   189,   76 },
+        { 0x83C7088E1AAB65DBULL,   216,   84 },
+        { 0xC45D1DF942711D9AULL,   242,   92 },
+        { 0x924D692CA61BE758ULL,   269,  100 },
+        { 0xDA01EE641A708DEAULL,   295,  108 },
+        { 0xA26DA3999AEF774AULL,   322,  116 },
+        { 0xF209787BB47D6B85ULL,   348,  124 },
+        { 0xB454E4A179DD1877ULL,   375,  132 },
+        { 0x865B86925B9BC5C2ULL,   402,  140 },
+        { 0xC83553C5C8965D3DULL,   428,  148 },
+        { 0x952AB45CFA97A0B3ULL,   455,  156 },
+        { 0xDE469FBD99A05FE3ULL,   481,  164 },
+        { 0xA59BC234DB398C25ULL,   508,  172 },
+        { 0xF6C69A72A3989F5CULL,   534,  180 },
+        { 0xB7DCBF5354E9BECEULL,   561,  188 },
+        { 0x88FCF317F22241E2ULL,   588,  196 },
+        { 0xCC20CE9BD35C78A5ULL,   614,  204 },
+        { 0x98165AF37B2153DFULL,   641,  212 },
+        { 0xE2A0B5DC971F303AULL,   667,  220 },
+        { 0xA8D9D1535CE3B396ULL,   694,  228 },
+        { 0xFB9B7CD9A4A7443CULL,   720,  236 },
+        { 0xBB764C4CA7A44410ULL,   747,  244 },
+        { 0x8BAB8EEFB6409C1AULL,   774,  252 },
+        { 0xD01FEF10A657842CULL,   800,  260 },
+        { 0x9B10A4E5E9913129ULL,   827,  268 },
+        { 0xE7109BFBA19C0C9DULL,   853,  276 },
+        { 0xAC2820D9623BF429ULL,   880,  284 },
+        { 0x80444B5E7AA7CF85ULL,   907,  292 },
+        { 0xBF21E44003ACDD2DULL,   933,  300 },
+        { 0x8E679C2F5E44FF8FULL,   960,  308 },
+        { 0xD433179D9C8CB841ULL,   986,  316 },
+        { 0x9E19DB92B4E31BA9ULL,  1013,  324 }
+        };
+
+        const int32_t f = kAlpha - e - 1;
+        const int32_t k = (f * 78913) / (1 << 18) + static_cast<int32_t>(f > 0);
+        const int32_t index = (-kCachedPowersMinDecExp + k + (kCachedPowersDecStep - 1)) / kCachedPowersDecStep;
+        return kCachedPowers[index];
+    }
+
+    // Find the largest power of 10 <= n (n < 10^10) returning the power and the number of digits
+    static int32_t findLargestPow10(uint32_t n, uint32_t& pow10)
+    {
+        static const uint32_t pow10Table[] = {
+            1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1
+        };
+        for (uint32_t i = 0; i < sizeof(pow10Table) / sizeof(pow10Table[0]); i++)
+        {
+            if (n >= pow10Table[i])
+            {
+                pow10 = pow10Table[i];
+                return 10 - i;
+            }
+        }
+        pow10 = 1;
+        return 1;
+    }
+
+    // Move the last digit closer to w while staying within the safe interval
+    static void grisu2Round(char* buf, int32_t len, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t tenK)
+    {
+        while ((rest < dist) && (delta - rest >= tenK) &&
+                    ((rest + tenK < dist) || (dist - rest > rest + tenK - dist)))
+        {
+            buf[len - 1]--;
+            rest += tenK;
+        }
+    }
+
+    // Generate digits of the value in the interval (M-, M+) - returns digits in buf, updates decimalExponent
+    static void grisu2DigitGen(char* buf, int32_t& len, int32_t& decimalExponent, DiyFp mMinus, DiyFp w, DiyFp mPlus)
+    {
+        uint64_t delta = DiyFp::sub(mPlus, mMinus).f;
+        uint64_t dist = DiyFp::sub(mPlus, w).f;
+
+        // Split M+ into integral part p1 and fractional part p2
+        const DiyFp one(uint64_t{1} << -mPlus.e, mPlus.e);
+        uint32_t p1 = static_cast<uint32_t>(mPlus.f >> -one.e);
+        uint64_t p2 = mPlus.f & (one.f - 1);
+
+        // Integral digits
+        uint32_t pow10 = 1;
+        int32_t n = findLargestPow10(p1, pow10);
+        while (n > 0)
+        {
+            const uint32_t d = p1 / pow10;
+            const uint32_t r = p1 % pow10;
+            buf[len++] = static_cast<char>('0' + d);
+            p1 = r;
+            n--;
+            const uint64_t rest = (uint64_t{p1} << -one.e) + p2;
+            if (rest <= delta)
+            {
+                decimalExponent += n;
+                grisu2Round(buf, len, dist, delta, rest, uint64_t{pow10} << -one.e);
+                return;
+            }
+            pow10 /= 10;
+        }
+
+        // Fractional digits
+        int32_t m = 0;
+        for (;;)
+        {
+            p2 *= 10;
+            const uint64_t d = p2 >> -one.e;
+            const uint64_t r = p2 & (one.f - 1);
+            buf[len++] = static_cast<char>('0' + d);
+            p2 = r;
+            m++;
+            delta *= 10;
+            dist *= 10;
+            if (p2 <= delta)
+                break;
+        }
+        decimalExponent -= m;
+        grisu2Round(buf, len, dist, delta, p2, one.f);
+    }
+
+    // Generate round-trip digits for a positive finite value - returns digit count and decimal exponent
+    template <typename FloatType>
+    static void grisu2(char* buf, int32_t& len, int32_t& decimalExponent, FloatType value)
+    {
+        const Boundaries w = computeBoundaries(value);
+        const CachedPower cached = getCachedPowerForBinaryExponent(w.plus.e);
+        const DiyFp cPow(cached.f, cached.e);
+        const DiyFp scaledW = DiyFp::mul(w.w, cPow);
+        const DiyFp scaledMinus = DiyFp::mul(w.minus, cPow);
+        const DiyFp scaledPlus = DiyFp::mul(w.plus, cPow);
+
+        // Shrink the interval by 1 ulp on each side to allow for the rounding in the multiplications
+        const DiyFp mMinus(scaledMinus.f + 1, scaledMinus.e);
+        const DiyFp mPlus(scaledPlus.f - 1, scaledPlus.e);
+        len = 0;
+        decimalExponent = -cached.k;
+        grisu2DigitGen(buf, len, decimalExponent, mMinus, scaledW, mPlus);
+    }
+
+    // Write an exponent (e+dd or e-dd style)
+    static char* appendExponent(char* buf, int32_t e)
+    {
+        *buf++ = 'e';
+        if (e < 0)
+        {
+            e = -e;
+            *buf++ = '-';
+        }
+        else
+        {
+            *buf++ = '+';
+        }
+        uint32_t k = static_cast<uint32_t>(e);
+        if (k >= 100)
+        {
+            *buf++ = static_cast<char>('0' + k / 100);
+            k %= 100;
+            *buf++ = static_cast<char>('0' + k / 10);
+            k %= 10;
+        }
+        else if (k >= 10)
+        {
+            *buf++ = static_cast<char>('0' + k / 10);
+            k %= 10;
+        }
+        *buf++ = static_cast<char>('0' + k);
+        return buf;
+    }
+
+    // Lay out digits d1..dn with decimal exponent so that the value is d1..dn * 10^decimalExponent
+    static uint32_t formatDigits(char* buf, int32_t len, int32_t decimalExponent)
+    {
+        // n is the position of the decimal point relative to the start of the digits
+        const int32_t k = len;
+        const int32_t n = len + decimalExponent;
+
+        if ((k <= n) && (n <= 21))
+        {
+            // Integer - digits followed by zeros
+            memset(buf + k, '0', n - k);
+            buf[n] = 0;
+            return n;
+        }
+        if ((0 < n) && (n <= 21))
+        {
+            // Decimal point within the digits
+            memmove(buf + n + 1, buf + n, k - n);
+            buf[n] = '.';
+            buf[k + 1] = 0;
+            return k + 1;
+        }
+        if ((-6 < n) && (n <= 0))
+        {
+            // Leading zeros after the decimal point
+            memmove(buf + 2 - n, buf, k);
+            buf[0] = '0';
+            buf[1] = '.';
+            memset(buf + 2, '0', -n);
+            buf[2 - n + k] = 0;
+            return 2 - n + k;
+        }
+
+        // Exponent notation
+        char* pEnd = nullptr;
+        if (k == 1)
+        {
+            pEnd = buf + 1;
+        }
+        else
+        {
+            memmove(buf + 2, buf + 1, k - 1);
+            buf[1] = '.';
+            pEnd = buf + 1 + k;
+        }
+        pEnd = appendExponent(pEnd, n - 1);
+        *pEnd = 0;
+        return pEnd - buf;
+    }
+
+    // Format a value
+    template <typename FloatType>
+    static uint32_t formatValue(FloatType value, char* pBuf)
+    {
+        if (!std::isfinite(value))
+        {
+            strcpy(pBuf, "null");
+            return 4;
+        }
+        char* pOut = pBuf;
+        if (std::signbit(value))
+        {
+            value = -value;
+            *pOut++ = '-';
+        }
+        if (value == 0)
+        {
+            *pOut++ = '0';
+            *pOut = 0;
+            return pOut - pBuf;
+        }
+        int32_t len = 0;
+        int32_t decimalExponent = 0;
+        grisu2(pOut, len, decimalExponent, value);
+        return (pOut - pBuf) + formatDigits(pOut, len, decimalExponent);
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Format a double as a short JSON number which parses back to the same value
+/// @param value value to format
+/// @param pBuf buffer (at least FORMAT_BUF_MIN_LEN bytes)
+/// @return number of characters written (excluding terminator)
+uint32_t RaftJsonNumbers::formatDouble(double value, char* pBuf)
+{
+    return RaftJsonGrisu::formatValue(value, pBuf);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Format a float as a short JSON number which parses back to the same float value
+/// @param value value to format
+/// @param pBuf buffer (at least FORMAT_BUF_MIN_LEN bytes)
+/// @return number of characters written (excluding terminator)
+uint32_t RaftJsonNumbers::formatFloat(float value, char* pBuf)
+{
+    return RaftJsonGrisu::formatValue(value, pBuf);
+}
@@ -0,0 +1,177 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftJsonNumbers - fast number parsing and round-trip formatting for JSON
+//
+// Parsing handles the common JSON forms (optional minus, decimal digits, fraction, exponent) directly and
+// falls back to strtol/strtod for anything else (hex, octal, inf/nan, leading whitespace, very long mantissas)
+// so results are always identical to the libc functions
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <float.h>
+
+class RaftJsonNumbers
+{
+public:
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse a long with the same result as strtol(pStr, NULL, 0)
+    /// @param pStr string to parse
+    /// @return parsed value
+    static inline long parseLong(const char* pStr)
+    {
+        const char* pCh = pStr;
+        bool isNeg = (*pCh == '-');
+        if (isNeg)
+            pCh++;
+
+        // Hex/octal prefixes and non-digits are handled by strtol
+        if (!isDigit(*pCh) || ((*pCh == '0') && (isDigit(pCh[1]) || (pCh[1] == 'x') || (pCh[1] == 'X'))))
+            return strtol(pStr, NULL, 0);
+
+        // Decimal digits
+        uint64_t val = 0;
+        uint32_t numDigits = 0;
+        while (isDigit(*pCh))
+        {
+            val = val * 10 + (*pCh++ - '0');
+            if (++numDigits > 18)
+                return strtol(pStr, NULL, 0);
+        }
+
+        // Out of range values saturate in strtol
+        if (val > (uint64_t)LONG_MAX + (isNeg ? 1 : 0))
+            return strtol(pStr, NULL, 0);
+        return isNeg ? (long)(0 - val) : (long)val;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Parse a double with the same result as strtod(pStr, NULL)
+    /// @param pStr string to parse
+    /// @return parsed value
+    /// @note Uses Clinger's fast path (exact when the mantissa fits in 53 bits and the power of 10 is exactly
+    ///       representable) which covers the vast majority of JSON values - other values use strtod
+    static inline double parseDouble(const char* pStr)
+    {
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)
+        const char* pCh = pStr;
+        bool isNeg = (*pCh == '-');
+        if (isNeg)
+            pCh++;
+
+        // Hex, inf, nan, etc are handled by strtod
+        if (!isDigit(*pCh) || ((*pCh == '0') && ((pCh[1] == 'x') || (pCh[1] == 'X'))))
+            return strtod(pStr, NULL);
+
+        // Mantissa (leading zeros are not significant)
+        uint64_t mantissa = 0;
+        uint32_t numSigDigits = 0;
+        int32_t exp10 = 0;
+        while (isDigit(*pCh))
+        {
+            if ((mantissa != 0) || (*pCh != '0'))
+            {
+                if (++numSigDigits > 19)
+                    return strtod(pStr, NULL);
+                mantissa = mantissa * 10 + (*pCh - '0');
+            }
+            pCh++;
+        }
+        if (*pCh == '.')
+        {
+            pCh++;
+            while (isDigit(*pCh))
+            {
+                if ((mantissa != 0) || (*pCh != '0'))
+                {
+                    if (++numSigDigits > 19)
+                        return strtod(pStr, NULL);
+                    mantissa = mantissa * 10 + (*pCh - '0');
+                }
+                exp10--;
+                pCh++;
+            }
+        }
+
+        // Exponent (only consumed if followed by digits)
+        if ((*pCh == 'e') || (*pCh == 'E'))
+        {
+            const char* pExp = pCh + 1;
+            bool isExpNeg = (*pExp == '-');
+            if ((*pExp == '-') || (*pExp == '+'))
+                pExp++;
+            if (isDigit(*pExp))
+            {
+                int32_t expVal = 0;
+                while (isDigit(*pExp))
+                {
+                    expVal = expVal * 10 + (*pExp++ - '0');
+                    if (expVal > 9999)
+                        return strtod(pStr, NULL);
+                }
+                exp10 += isExpNeg ? -expVal : expVal;
+            }
+        }
+
+        // Zero
+        if (mantissa == 0)
+            return isNeg ? -0.0 : 0.0;
+
+        // Clinger's fast path - both mantissa and power of 10 exactly representable so a single
+        // correctly rounded multiply or divide gives the correctly rounded result
+        static const uint64_t MAX_EXACT_MANTISSA = 1ULL << 53;
+        if (mantissa > MAX_EXACT_MANTISSA)
+            return strtod(pStr, NULL);
+        while ((exp10 > MAX_EXACT_POW10) && (mantissa * 10 <= MAX_EXACT_MANTISSA))
+        {
+            mantissa *= 10;
+            exp10--;
+        }
+        if ((exp10 < -MAX_EXACT_POW10) || (exp10 > MAX_EXACT_POW10))
+            return strtod(pStr, NULL);
+        static const double exactPow10[MAX_EXACT_POW10 + 1] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        double val = (double)mantissa;
+        val = exp10 < 0 ? val / exactPow10[-exp10] : val * exactPow10[exp10];
+        return isNeg ? -val : val;
+#else
+        return strtod(pStr, NULL);
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Format a double as a short JSON number which parses back to the same value
+    /// @param value value to format
+    /// @param pBuf buffer (at least FORMAT_BUF_MIN_LEN bytes)
+    /// @return number of characters written (excluding terminator)
+    /// @note Digits are generated with Grisu2 so round-tripping is guaranteed but the output is occasionally
+    ///       one digit longer than the shortest possible. Non-finite values are formatted as null. Exponent notation is used for values with a decimal
+    ///       exponent below -6 or above 20 (the same rules as JavaScript Number.toString)
+    static uint32_t formatDouble(double value, char* pBuf);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Format a float as a short JSON number which parses back to the same float value
+    /// @param value value to format
+    /// @param pBuf buffer (at least FORMAT_BUF_MIN_LEN bytes)
+    /// @return number of characters written (excluding terminator)
+    static uint32_t formatFloat(float value, char* pBuf);
+
+    // Minimum buffer length for formatting
+    static const uint32_t FORMAT_BUF_MIN_LEN = 32;
+
+private:
+    static const int32_t MAX_EXACT_POW10 = 22;
+
+    static inline bool isDigit(char ch)
+    {
+        return (ch >= '0') && (ch <= '9');
+    }
+};
@@ -24,6 +24,18 @@ public:
         _prefix(prefix + String("/"))
     {
     }
+    RaftJsonPrefixed(RaftJsonIF& raftJsonIF, const char* pPrefix) :
+        _raftJsonIF(raftJsonIF),
+        _pMutableRaftJsonIF(&raftJsonIF),
+        _prefix(pPrefix ? pPrefix + String("/") : "")
+    {
+    }
+    RaftJsonPrefixed(RaftJsonIF& raftJsonIF, const String& prefix) :
+        _raftJsonIF(raftJsonIF),
+        _pMutableRaftJsonIF(&raftJsonIF),
+        _prefix(prefix + String("/"))
+    {
+    }
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Get string value using the member variable JSON document
@@ -186,6 +198,41 @@ public:
         return _raftJsonIF.getChainedRaftJson();
     }
     
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Register a callback for JSON change - called only when something within the prefix changes
+    /// @param configChangeCallback the callback to be called when the JSON document changes
+    virtual void registerChangeCallback(RaftJsonChangeCallbackType configChangeCallback) override final
+    {
+        if (!configChangeCallback)
+            return;
+        registerPathChangeCallback("", [configChangeCallback](const std::vector<String>& changedPaths) {
+            configChangeCallback();
+        });
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Register a callback for JSON change within a path prefix (relative to this object's prefix)
+    /// @param pPathPrefix the path prefix in XPath-like syntax (e.g. "a/b") - empty for everything in this prefix
+    /// @param pathChangeCallback the callback to be called with the changed paths (relative to this object's
+    ///        prefix - an empty path means everything in the prefix changed)
+    virtual void registerPathChangeCallback(const char* pPathPrefix, RaftJsonPathChangeCallbackType pathChangeCallback) override final
+    {
+        if (!_pMutableRaftJsonIF || !pathChangeCallback)
+            return;
+        String fullPrefix = getPrefixedDataPath(pPathPrefix ? pPathPrefix : "");
+        if (fullPrefix.endsWith("/"))
+            fullPrefix.remove(fullPrefix.length() - 1);
+        String prefix = _prefix;
+        _pMutableRaftJsonIF->registerPathChangeCallback(fullPrefix.c_str(),
+            [prefix, pathChangeCallback](const std::vector<String>& changedPaths) {
+                // Make paths relative to the prefix (a change to a parent of the prefix affects all of it)
+                std::vector<String> relPaths;
+                for (const String& changedPath : changedPaths)
+                    relPaths.push_back(changedPath.startsWith(prefix) ? changedPath.substring(prefix.length()) : "");
+                pathChangeCallback(relPaths);
+            });
+    }
+
 private:
     // Get prefixed data path
     String getPrefixedDataPath(const char* pDataPath) const
@@ -199,6 +246,9 @@ private:
     // RaftJsonIF
     const RaftJsonIF& _raftJsonIF;
 
+    // Mutable RaftJsonIF (only if constructed from a non-const object - used for change callbacks)
+    RaftJsonIF* _pMutableRaftJsonIF = nullptr;
+
     // Prefix
     String _prefix;
 };
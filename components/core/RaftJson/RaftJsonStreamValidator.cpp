@@ -0,0 +1,292 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftJsonStreamValidator
+// Incremental JSON syntax checker - validates a document chunk by chunk as it arrives
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RaftJsonStreamValidator.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Reset to validate a new document
+/// @param topLevelObjectOnly true if the document must be an object
+void RaftJsonStreamValidator::reset(bool topLevelObjectOnly)
+{
+    _state = STATE_VALUE;
+    _topLevelObjectOnly = topLevelObjectOnly;
+    _stringIsKey = false;
+    _unicodeCount = 0;
+    _pLiteral = nullptr;
+    _depth = 0;
+    _pos = 0;
+    _nestIsObject = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Validate a chunk of the document
+/// @param pData chunk data
+/// @param len chunk length
+/// @return false if the document is invalid (further chunks are ignored until reset)
+bool RaftJsonStreamValidator::addChunk(const uint8_t* pData, uint32_t len)
+{
+    if (_state == STATE_ERROR)
+        return false;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        // Most of a document is string contents - skip runs of plain characters without per-character dispatch
+        if (_state == STATE_STRING)
+        {
+            uint32_t runStart = i;
+            while ((i < len) && (pData[i] != '"') && (pData[i] != '\\') && (pData[i] >= 0x20))
+                i++;
+            _pos += i - runStart;
+            if (i >= len)
+                break;
+        }
+        if (!processChar((char)pData[i]))
+        {
+            _state = STATE_ERROR;
+            return false;
+        }
+        _pos++;
+    }
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Check if a complete, valid document has been received
+/// @return true if complete
+bool RaftJsonStreamValidator::isComplete() const
+{
+    // A top-level number is only terminated by the end of the document
+    if (_depth == 0)
+    {
+        switch (_state)
+        {
+            case STATE_DONE:
+            case STATE_NUM_ZERO:
+            case STATE_NUM_INT:
+            case STATE_NUM_FRAC:
+            case STATE_NUM_EXP:
+                return true;
+            default:
+                break;
+        }
+    }
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Process a character
+/// @return false if invalid
+bool RaftJsonStreamValidator::processChar(char ch)
+{
+    switch (_state)
+    {
+        case STATE_VALUE:
+            if (isWhitespace(ch))
+                return true;
+            return startValue(ch);
+        case STATE_ARRAY_VALUE_OR_END:
+            if (isWhitespace(ch))
+                return true;
+            if (ch == ']')
+                return closeContainer(ch);
+            return startValue(ch);
+        case STATE_OBJECT_KEY_OR_END:
+            if (isWhitespace(ch))
+                return true;
+            if (ch == '}')
+                return closeContainer(ch);
+            // Fall through
+        case STATE_OBJECT_KEY:
+            if (isWhitespace(ch))
+                return true;
+            if (ch != '"')
+                return false;
+            _stringIsKey = true;
+            _state = STATE_STRING;
+            return true;
+        case STATE_COLON:
+            if (isWhitespace(ch))
+                return true;
+            if (ch != ':')
+                return false;
+            _state = STATE_VALUE;
+            return true;
+        case STATE_AFTER_VALUE:
+            if (isWhitespace(ch))
+                return true;
+            if ((ch == '}') || (ch == ']'))
+                return closeContainer(ch);
+            if (ch != ',')
+                return false;
+            _state = inObject() ? STATE_OBJECT_KEY : STATE_VALUE;
+            return true;
+        case STATE_STRING:
+            if (ch == '"')
+            {
+                if (_stringIsKey)
+                {
+                    _stringIsKey = false;
+                    _state = STATE_COLON;
+                    return true;
+                }
+                return endValue();
+            }
+            if (ch == '\\')
+                _state = STATE_STRING_ESCAPE;
+            return (uint8_t)ch >= 0x20;
+        case STATE_STRING_ESCAPE:
+            if (ch == 'u')
+            {
+                _unicodeCount = 0;
+                _state = STATE_STRING_UNICODE;
+                return true;
+            }
+            _state = STATE_STRING;
+            return (ch == '"') || (ch == '\\') || (ch == '/') || (ch == 'b') || (ch == 'f') ||
+                        (ch == 'n') || (ch == 'r') || (ch == 't');
+        case STATE_STRING_UNICODE:
+            if (!isHexDigit(ch))
+                return false;
+            if (++_unicodeCount == 4)
+                _state = STATE_STRING;
+            return true;
+        case STATE_NUM_MINUS:
+            if (ch == '0')
+                _state = STATE_NUM_ZERO;
+            else if (isDigit(ch))
+                _state = STATE_NUM_INT;
+            else
+                return false;
+            return true;
+        case STATE_NUM_INT:
+            if (isDigit(ch))
+                return true;
+            // Fall through
+        case STATE_NUM_ZERO:
+            if (ch == '.')
+                _state = STATE_NUM_FRAC_START;
+            else if ((ch == 'e') || (ch == 'E'))
+                _state = STATE_NUM_EXP_START;
+            else
+                return endValue() && processChar(ch);
+            return true;
+        case STATE_NUM_FRAC_START:
+            if (!isDigit(ch))
+                return false;
+            _state = STATE_NUM_FRAC;
+            return true;
+        case STATE_NUM_FRAC:
+            if (isDigit(ch))
+                return true;
+            if ((ch == 'e') || (ch == 'E'))
+            {
+                _state = STATE_NUM_EXP_START;
+                return true;
+            }
+            return endValue() && processChar(ch);
+        case STATE_NUM_EXP_START:
+            if ((ch == '+') || (ch == '-'))
+            {
+                _state = STATE_NUM_EXP_SIGN;
+                return true;
+            }
+            // Fall through
+        case STATE_NUM_EXP_SIGN:
+            if (!isDigit(ch))
+                return false;
+            _state = STATE_NUM_EXP;
+            return true;
+        case STATE_NUM_EXP:
+            if (isDigit(ch))
+                return true;
+            return endValue() && processChar(ch);
+        case STATE_LITERAL:
+            if (ch != *_pLiteral)
+                return false;
+            _pLiteral++;
+            if (*_pLiteral == 0)
+                return endValue();
+            return true;
+        case STATE_DONE:
+            return isWhitespace(ch) || (ch == 0);
+        case STATE_ERROR:
+            break;
+    }
+    return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Start a value
+/// @return false if invalid
+bool RaftJsonStreamValidator::startValue(char ch)
+{
+    if (_topLevelObjectOnly && (_depth == 0) && (ch != '{'))
+        return false;
+    switch (ch)
+    {
+        case '{':
+        case '[':
+            if (_depth >= MAX_DEPTH)
+                return false;
+            if (ch == '{')
+                _nestIsObject |= (1ULL << _depth);
+            else
+                _nestIsObject &= ~(1ULL << _depth);
+            _depth++;
+            _state = ch == '{' ? STATE_OBJECT_KEY_OR_END : STATE_ARRAY_VALUE_OR_END;
+            return true;
+        case '"':
+            _stringIsKey = false;
+            _state = STATE_STRING;
+            return true;
+        case '-':
+            _state = STATE_NUM_MINUS;
+            return true;
+        case '0':
+            _state = STATE_NUM_ZERO;
+            return true;
+        case 't':
+            _pLiteral = "rue";
+            _state = STATE_LITERAL;
+            return true;
+        case 'f':
+            _pLiteral = "alse";
+            _state = STATE_LITERAL;
+            return true;
+        case 'n':
+            _pLiteral = "ull";
+            _state = STATE_LITERAL;
+            return true;
+        default:
+            if (!isDigit(ch))
+                return false;
+            _state = STATE_NUM_INT;
+            return true;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief End of a value
+/// @return true
+bool RaftJsonStreamValidator::endValue()
+{
+    _state = _depth == 0 ? STATE_DONE : STATE_AFTER_VALUE;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Close an object or array
+/// @param ch closing character
+/// @return false if it doesn't match the open container
+bool RaftJsonStreamValidator::closeContainer(char ch)
+{
+    if ((_depth == 0) || (inObject() != (ch == '}')))
+        return false;
+    _depth--;
+    return endValue();
+}
@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftJsonStreamValidator
+// Incremental JSON syntax checker - validates a document chunk by chunk as it arrives
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+
+/// @brief Incremental JSON syntax checker
+/// State is a few bytes (nesting is held as a bit stack) so documents can be validated as they are received
+/// without being buffered. Chunks may split the document at any point (including within strings, escapes,
+/// numbers and literals). A NUL terminator after the top-level value is accepted.
+class RaftJsonStreamValidator
+{
+public:
+    /// @brief Reset to validate a new document
+    /// @param topLevelObjectOnly true if the document must be an object
+    void reset(bool topLevelObjectOnly = false);
+
+    /// @brief Validate a chunk of the document
+    /// @param pData chunk data
+    /// @param len chunk length
+    /// @return false if the document is invalid (further chunks are ignored until reset)
+    bool addChunk(const uint8_t* pData, uint32_t len);
+
+    /// @brief Check if a complete, valid document has been received
+    /// @return true if complete
+    bool isComplete() const;
+
+    /// @brief Check if an error has been found
+    /// @return true if invalid
+    bool isError() const
+    {
+        return _state == STATE_ERROR;
+    }
+
+    /// @brief Get the number of bytes validated (position of the error if invalid)
+    /// @return position
+    uint32_t getPos() const
+    {
+        return _pos;
+    }
+
+    // Maximum nesting depth
+    static const uint32_t MAX_DEPTH = 64;
+
+private:
+    enum State : uint8_t
+    {
+        STATE_VALUE,
+        STATE_ARRAY_VALUE_OR_END,
+        STATE_OBJECT_KEY_OR_END,
+        STATE_OBJECT_KEY,
+        STATE_COLON,
+        STATE_AFTER_VALUE,
+        STATE_STRING,
+        STATE_STRING_ESCAPE,
+        STATE_STRING_UNICODE,
+        STATE_NUM_MINUS,
+        STATE_NUM_ZERO,
+        STATE_NUM_INT,
+        STATE_NUM_FRAC_START,
+        STATE_NUM_FRAC,
+        STATE_NUM_EXP_START,
+        STATE_NUM_EXP_SIGN,
+        STATE_NUM_EXP,
+        STATE_LITERAL,
+        STATE_DONE,
+        STATE_ERROR
+    };
+
+    // State
+    State _state = STATE_VALUE;
+    bool _topLevelObjectOnly = false;
+    bool _stringIsKey = false;
+    uint8_t _unicodeCount = 0;
+    const char* _pLiteral = nullptr;
+    uint32_t _depth = 0;
+    uint32_t _pos = 0;
+
+    // Nesting stack (bit set for object, clear for array)
+    uint64_t _nestIsObject = 0;
+
+    // Helpers
+    bool processChar(char ch);
+    bool startValue(char ch);
+    bool endValue();
+    bool closeContainer(char ch);
+    bool inObject() const
+    {
+        return (_nestIsObject >> (_depth - 1)) & 1;
+    }
+    static bool isWhitespace(char ch)
+    {
+        return (ch == ' ') || (ch == '\n') || (ch == '\r') || (ch == '\t');
+    }
+    static bool isDigit(char ch)
+    {
+        return (ch >= '0') && (ch <= '9');
+    }
+    static bool isHexDigit(char ch)
+    {
+        return isDigit(ch) || ((ch >= 'a') && (ch <= 'f')) || ((ch >= 'A') && (ch <= 'F'));
+    }
+};
@@ -0,0 +1,185 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RestAPIBodyAccumulator
+// Assembles REST API request bodies received in chunks
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RestAPIBodyAccumulator.h"
+#include "RaftArduino.h"
+#include "RaftUtils.h"
+#include "Logger.h"
+
+#define WARN_ON_BODY_TIMEOUT
+// #define DEBUG_BODY_ACCUMULATOR
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor
+RestAPIBodyAccumulator::RestAPIBodyAccumulator()
+{
+    RaftMutex_init(_bodiesMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Destructor
+RestAPIBodyAccumulator::~RestAPIBodyAccumulator()
+{
+    RaftMutex_destroy(_bodiesMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add a chunk
+/// @param channelID source channel
+/// @param pData chunk data
+/// @param len chunk length
+/// @param index position of the chunk in the body
+/// @param total total body length
+/// @param maxLen maximum body length (0 for no limit)
+/// @param pBody (out) complete body when the result is BODY_COMPLETE (valid until release() is called)
+/// @param bodyLen (out) length of complete body
+/// @return BODY_COMPLETE when the body is complete, BODY_PARTIAL when more chunks are expected,
+///         BODY_TOO_LARGE or BODY_ERROR (out of order chunk) when the body is discarded
+RestAPIBodyAccumulator::BodyResult RestAPIBodyAccumulator::addChunk(uint32_t channelID, const uint8_t* pData,
+            uint32_t len, uint32_t index, uint32_t total, uint32_t maxLen, const uint8_t*& pBody, uint32_t& bodyLen)
+{
+    if (!RaftMutex_lock(_bodiesMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return BODY_ERROR;
+    purgeTimedOut(millis());
+    auto it = findBody(channelID);
+
+    // First chunk starts a new body (discarding any partial body from this channel)
+    if (index == 0)
+    {
+        if (it != _bodies.end())
+            eraseBody(it);
+        if ((maxLen != 0) && (total > maxLen))
+        {
+            _stats.rejected++;
+            RaftMutex_unlock(_bodiesMutex);
+            return BODY_TOO_LARGE;
+        }
+        if (len > total)
+        {
+            RaftMutex_unlock(_bodiesMutex);
+            return BODY_ERROR;
+        }
+
+        // Body in a single chunk is passed on without copying
+        if (len == total)
+        {
+            _stats.bodies++;
+            _stats.zeroCopyBodies++;
+            RaftMutex_unlock(_bodiesMutex);
+            pBody = pData;
+            bodyLen = len;
+            return BODY_COMPLETE;
+        }
+
+        // Reserve the whole body
+        _bodies.emplace_back(channelID);
+        it = std::prev(_bodies.end());
+        it->buf.reserve(total);
+        it->total = total;
+        _stats.reservations++;
+        _stats.bufferedBytes += total;
+        if (_stats.bufferedBytes > _stats.peakBufferedBytes)
+            _stats.peakBufferedBytes = _stats.bufferedBytes;
+    }
+    else if (it == _bodies.end())
+    {
+        // Body was rejected, timed out or never started
+        RaftMutex_unlock(_bodiesMutex);
+        return BODY_ERROR;
+    }
+
+    // Chunks must be contiguous and within the total
+    if ((total != it->total) || (index != it->buf.size()) || (index + len > total))
+    {
+#ifdef DEBUG_BODY_ACCUMULATOR
+        LOG_I(MODULE_PREFIX, "addChunk channel %d out of order index %d len %d total %d received %d",
+                    (int)channelID, (int)index, (int)len, (int)total, (int)it->buf.size());
+#endif
+        eraseBody(it);
+        RaftMutex_unlock(_bodiesMutex);
+        return BODY_ERROR;
+    }
+
+    // Store the chunk
+    it->buf.insert(it->buf.end(), pData, pData + len);
+    it->lastChunkMs = millis();
+    _stats.bytesCopied += len;
+    if (it->buf.size() < total)
+    {
+        RaftMutex_unlock(_bodiesMutex);
+        return BODY_PARTIAL;
+    }
+
+    // Complete - the body stays allocated until released
+    _stats.bodies++;
+    pBody = it->buf.data();
+    bodyLen = total;
+    RaftMutex_unlock(_bodiesMutex);
+    return BODY_COMPLETE;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Release the body for a channel (frees the buffer)
+/// @param channelID source channel
+void RestAPIBodyAccumulator::release(uint32_t channelID)
+{
+    if (!RaftMutex_lock(_bodiesMutex, RAFT_MUTEX_WAIT_FOREVER))
+        return;
+    auto it = findBody(channelID);
+    if (it != _bodies.end())
+        eraseBody(it);
+    RaftMutex_unlock(_bodiesMutex);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Find body for a channel (mutex must be held)
+/// @param channelID source channel
+/// @return iterator (end if not found)
+std::list<RestAPIBodyAccumulator::Body>::iterator RestAPIBodyAccumulator::findBody(uint32_t channelID)
+{
+    for (auto it = _bodies.begin(); it != _bodies.end(); ++it)
+    {
+        if (it->channelID == channelID)
+            return it;
+    }
+    return _bodies.end();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Erase a body (mutex must be held)
+/// @param it iterator
+void RestAPIBodyAccumulator::eraseBody(std::list<Body>::iterator it)
+{
+    _stats.bufferedBytes -= it->total;
+    _bodies.erase(it);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Free partial bodies which haven't received a chunk within the timeout (mutex must be held)
+/// @param nowMs current time
+void RestAPIBodyAccumulator::purgeTimedOut(uint64_t nowMs)
+{
+    for (auto it = _bodies.begin(); it != _bodies.end();)
+    {
+        if ((it->buf.size() < it->total) && Raft::isTimeout(nowMs, it->lastChunkMs, BODY_TIMEOUT_MS))
+        {
+#ifdef WARN_ON_BODY_TIMEOUT
+            LOG_W(MODULE_PREFIX, "purgeTimedOut channel %d received %d of %d",
+                        (int)it->channelID, (int)it->buf.size(), (int)it->total);
+#endif
+            _stats.timedOut++;
+            auto eraseIt = it++;
+            eraseBody(eraseIt);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RestAPIBodyAccumulator
+// Assembles REST API request bodies received in chunks
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <list>
+#include <vector>
+#include "RaftThreading.h"
+
+// Body storage (in SPIRAM where available)
+#ifdef ESP_PLATFORM
+#include "SpiramAwareAllocator.h"
+typedef std::vector<uint8_t, SpiramAwareAllocator<uint8_t>> RestAPIBodyBuffer;
+#else
+typedef std::vector<uint8_t> RestAPIBodyBuffer;
+#endif
+
+/// @brief Body accumulator
+/// One body is assembled per source channel. A body which arrives in a single chunk is returned as a view of
+/// that chunk without copying. Otherwise the buffer is reserved once at the total length when the first chunk
+/// arrives and each chunk is copied into place once. Bodies over the size limit are rejected before anything
+/// is allocated and partial bodies left by dropped connections are freed after a timeout.
+class RestAPIBodyAccumulator
+{
+public:
+    RestAPIBodyAccumulator();
+    virtual ~RestAPIBodyAccumulator();
+
+    enum BodyResult
+    {
+        BODY_PARTIAL,
+        BODY_COMPLETE,
+        BODY_TOO_LARGE,
+        BODY_ERROR
+    };
+
+    /// @brief Add a chunk
+    /// @param channelID source channel
+    /// @param pData chunk data
+    /// @param len chunk length
+    /// @param index position of the chunk in the body
+    /// @param total total body length
+    /// @param maxLen maximum body length (0 for no limit)
+    /// @param pBody (out) complete body when the result is BODY_COMPLETE (valid until release() is called)
+    /// @param bodyLen (out) length of complete body
+    /// @return BODY_COMPLETE when the body is complete, BODY_PARTIAL when more chunks are expected,
+    ///         BODY_TOO_LARGE or BODY_ERROR (out of order chunk) when the body is discarded
+    BodyResult addChunk(uint32_t channelID, const uint8_t* pData, uint32_t len, uint32_t index, uint32_t total,
+                uint32_t maxLen, const uint8_t*& pBody, uint32_t& bodyLen);
+
+    /// @brief Release the body for a channel (frees the buffer)
+    /// @param channelID source channel
+    void release(uint32_t channelID);
+
+    /// @brief Get number of bodies being assembled
+    /// @return number of bodies
+    uint32_t getNumInProgress() const
+    {
+        return _bodies.size();
+    }
+
+    // Stats
+    struct Stats
+    {
+        uint32_t bodies;
+        uint32_t zeroCopyBodies;
+        uint32_t rejected;
+        uint32_t timedOut;
+        uint32_t reservations;
+        uint64_t bytesCopied;
+        uint32_t bufferedBytes;
+        uint32_t peakBufferedBytes;
+    };
+
+    /// @brief Get stats
+    /// @return stats
+    Stats getStats() const
+    {
+        return _stats;
+    }
+
+    // Time after the last chunk before a partial body is freed
+    static const uint32_t BODY_TIMEOUT_MS = 10000;
+
+private:
+    // Body being assembled
+    class Body
+    {
+    public:
+        Body(uint32_t channelID) : channelID(channelID)
+        {
+        }
+        uint32_t channelID;
+        RestAPIBodyBuffer buf;
+        uint32_t total = 0;
+        uint64_t lastChunkMs = 0;
+    };
+    std::list<Body> _bodies;
+
+    // Stats
+    Stats _stats = {};
+
+    // Mutex
+    RaftMutex _bodiesMutex;
+
+    // Helpers
+    std::list<Body>::iterator findBody(uint32_t channelID);
+    void eraseBody(std::list<Body>::iterator it);
+    void purgeTimedOut(uint64_t nowMs);
+
+    // Debug
+    static constexpr const char* MODULE_PREFIX = "RestAPIBody";
+};
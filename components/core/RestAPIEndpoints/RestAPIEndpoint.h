@@ -19,6 +19,8 @@ typedef std::function<RaftRetCode(const String &reqStr, String &respStr, const A
 typedef std::function<RaftRetCode(const String &reqStr, const uint8_t *pData, size_t len, size_t index, 
             size_t total, const APISourceInfo& sourceInfo)> RestAPIFnBody;
 typedef std::function<RaftRetCode(const String &reqStr, FileStreamBlock& fileStreamBlock, const APISourceInfo& sourceInfo)> RestAPIFnChunk;
+typedef std::function<RaftRetCode(const String &reqStr, const uint8_t *pBody, size_t len,
+            const APISourceInfo& sourceInfo)> RestAPIFnBodyComplete;
 typedef std::function<bool(const APISourceInfo& sourceInfo)> RestAPIFnIsReady;
 
 class RestAPIEndpoint
@@ -88,6 +90,10 @@ public:
     EndpointCache_t _cacheControl;
     String _extraHeaders;
 
+    // Body handled by RestAPIEndpointManager (complete body callback and maximum body length - 0 for no limit)
+    RestAPIFnBodyComplete _callbackBodyComplete = nullptr;
+    uint32_t _maxBodyLen = 0;
+
     const char* getEndpointName()
     {
         return _endpointStr.c_str();
@@ -103,6 +109,8 @@ public:
     RaftRetCode callbackBody(String&req, const uint8_t *pData, size_t len, size_t bufferPos, 
                         size_t total, const APISourceInfo& sourceInfo)
     {
+        if ((_maxBodyLen != 0) && (total > _maxBodyLen))
+            return RAFT_INSUFFICIENT_RESOURCE;
         if (_callbackBody)
             return _callbackBody(req, pData, len, bufferPos, total, sourceInfo);
         return RAFT_NOT_IMPLEMENTED;
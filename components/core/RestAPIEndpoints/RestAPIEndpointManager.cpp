@@ -13,6 +13,7 @@
 
 // Warn
 #define WARN_ON_NON_MATCHING_ENDPOINTS
+#define WARN_ON_BODY_TOO_LARGE
 
 // Debug
 // #define DEBUG_REST_API_ENDPOINTS_ADD
@@ -96,6 +97,91 @@ void RestAPIEndpointManager::addEndpoint(const char *pEndpointStr,
 #endif
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add an endpoint whose request body is handled by the endpoint manager
+/// @param pEndpointStr Endpoint string
+/// @param endpointMethod Endpoint method (e.g. ENDPOINT_POST)
+/// @param callbackMain Main callback function (called after the body)
+/// @param pDescription Endpoint description
+/// @param maxBodyLen Maximum body length (0 for no limit)
+/// @param callbackBodyComplete Complete body callback function (nullptr if not required)
+/// @param callbackBodyStream Body chunk callback function (nullptr if not required)
+/// @param pContentType Content type
+void RestAPIEndpointManager::addBodyEndpoint(const char *pEndpointStr,
+                    RestAPIEndpoint::EndpointMethod endpointMethod,
+                    RestAPIFunction callbackMain,
+                    const char *pDescription,
+                    uint32_t maxBodyLen,
+                    RestAPIFnBodyComplete callbackBodyComplete,
+                    RestAPIFnBody callbackBodyStream,
+                    const char *pContentType)
+{
+    addEndpoint(pEndpointStr, RestAPIEndpoint::ENDPOINT_CALLBACK, endpointMethod, callbackMain,
+                    pDescription, pContentType);
+    RestAPIEndpoint* pEndpoint = &_endpointsList.back();
+    pEndpoint->_callbackBodyComplete = callbackBodyComplete;
+    pEndpoint->_maxBodyLen = maxBodyLen;
+
+    // Body chunks are routed through the manager (list elements don't move so the pointer remains valid)
+    pEndpoint->_callbackBody = [this, pEndpoint, callbackBodyStream](const String &reqStr, const uint8_t *pData,
+                    size_t len, size_t index, size_t total, const APISourceInfo& sourceInfo) {
+        return handleBodyChunk(*pEndpoint, callbackBodyStream, reqStr, pData, len, index, total, sourceInfo);
+    };
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Handle a chunk of a body for an endpoint added with addBodyEndpoint
+/// @param endpoint Endpoint
+/// @param callbackBodyStream Body chunk callback function (may be nullptr)
+/// @param reqStr Request string
+/// @param pData Chunk data
+/// @param len Chunk length
+/// @param index Position of the chunk in the body
+/// @param total Total body length
+/// @param sourceInfo Source of the request
+/// @return RaftRetCode
+RaftRetCode RestAPIEndpointManager::handleBodyChunk(RestAPIEndpoint& endpoint, const RestAPIFnBody& callbackBodyStream,
+                    const String& reqStr, const uint8_t *pData, size_t len, size_t index, size_t total,
+                    const APISourceInfo& sourceInfo)
+{
+    // Streaming consumer gets a view of each chunk
+    if (callbackBodyStream)
+    {
+        RaftRetCode retc = callbackBodyStream(reqStr, pData, len, index, total, sourceInfo);
+        if (retc != RAFT_OK)
+        {
+            _bodyAccumulator.release(sourceInfo.channelID);
+            return retc;
+        }
+    }
+    if (!endpoint._callbackBodyComplete)
+        return RAFT_OK;
+
+    // Assemble the body
+    const uint8_t* pBody = nullptr;
+    uint32_t bodyLen = 0;
+    switch (_bodyAccumulator.addChunk(sourceInfo.channelID, pData, len, index, total, endpoint._maxBodyLen, pBody, bodyLen))
+    {
+        case RestAPIBodyAccumulator::BODY_PARTIAL:
+            return RAFT_OK;
+        case RestAPIBodyAccumulator::BODY_TOO_LARGE:
+#ifdef WARN_ON_BODY_TOO_LARGE
+            LOG_W(MODULE_PREFIX, "handleBodyChunk %s body len %d exceeds max %d",
+                        endpoint.getEndpointName(), (int)total, (int)endpoint._maxBodyLen);
+#endif
+            return RAFT_INSUFFICIENT_RESOURCE;
+        case RestAPIBodyAccumulator::BODY_ERROR:
+            return RAFT_INVALID_DATA;
+        default:
+            break;
+    }
+
+    // Complete body is passed on and then freed
+    RaftRetCode retc = endpoint._callbackBodyComplete(reqStr, pBody, bodyLen, sourceInfo);
+    _bodyAccumulator.release(sourceInfo.channelID);
+    return retc;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Get the endpoint definition corresponding to a requested endpoint
 /// @param pEndpointStr Endpoint string
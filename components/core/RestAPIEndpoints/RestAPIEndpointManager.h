@@ -10,6 +10,7 @@
 #pragma once
 #include <list>
 #include "RestAPIEndpoint.h"
+#include "RestAPIBodyAccumulator.h"
 #include "RaftJson.h"
 
 // Collection of endpoints
@@ -57,6 +58,35 @@ public:
                     RestAPIFnChunk callbackChunk = nullptr,
                     RestAPIFnIsReady callbackIsReady = nullptr);
 
+    /// @brief Add an endpoint whose request body is handled by the endpoint manager
+    /// The body can be consumed as it arrives (callbackBodyStream receives a view of each chunk) and/or when
+    /// complete (callbackBodyComplete receives a view of the whole body which is only valid during the call).
+    /// Complete bodies are assembled by a shared accumulator which reserves the body once, doesn't copy bodies
+    /// which arrive in a single chunk and rejects bodies longer than maxBodyLen before allocating anything.
+    /// @param pEndpointStr Endpoint string
+    /// @param endpointMethod Endpoint method (e.g. ENDPOINT_POST)
+    /// @param callbackMain Main callback function (called after the body)
+    /// @param pDescription Endpoint description
+    /// @param maxBodyLen Maximum body length (0 for no limit)
+    /// @param callbackBodyComplete Complete body callback function (nullptr if not required)
+    /// @param callbackBodyStream Body chunk callback function (nullptr if not required)
+    /// @param pContentType Content type
+    void addBodyEndpoint(const char *pEndpointStr,
+                    RestAPIEndpoint::EndpointMethod endpointMethod,
+                    RestAPIFunction callbackMain,
+                    const char *pDescription,
+                    uint32_t maxBodyLen,
+                    RestAPIFnBodyComplete callbackBodyComplete,
+                    RestAPIFnBody callbackBodyStream = nullptr,
+                    const char *pContentType = "application/json");
+
+    /// @brief Get body handling stats
+    /// @return stats
+    RestAPIBodyAccumulator::Stats getBodyStats() const
+    {
+        return _bodyAccumulator.getStats();
+    }
+
     /// @brief Get the endpoint definition corresponding to a requested endpoint
     /// @param pEndpointStr Endpoint string
     /// @return Pointer to endpoint or NULL if not found
@@ -156,6 +186,14 @@ private:
     /// @brief List of endpoints
     std::list<RestAPIEndpoint> _endpointsList;
 
+    /// @brief Body accumulator for endpoints added with addBodyEndpoint
+    RestAPIBodyAccumulator _bodyAccumulator;
+
+    // Helpers
+    RaftRetCode handleBodyChunk(RestAPIEndpoint& endpoint, const RestAPIFnBody& callbackBodyStream,
+                    const String& reqStr, const uint8_t *pData, size_t len, size_t index, size_t total,
+                    const APISourceInfo& sourceInfo);
+
     // Debug
     static constexpr const char* MODULE_PREFIX = "RestAPI";
 };
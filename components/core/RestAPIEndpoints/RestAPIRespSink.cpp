@@ -0,0 +1,361 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RestAPIRespSink
+// Builds a JSON REST API response directly in the response string
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <ctype.h>
+#include "RestAPIRespSink.h"
+#include "RaftJsonNumbers.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor (the response string is cleared)
+/// @param respStr response string to write into
+/// @param reserveLen initial space to reserve
+/// @param maxLen maximum length of response (MAX_LEN_UNLIMITED for no limit)
+RestAPIRespSink::RestAPIRespSink(String& respStr, uint32_t reserveLen, uint32_t maxLen) :
+    _respStr(respStr), _maxLen(maxLen)
+{
+    _respStr = "";
+    if (isOverMaxLen(reserveLen))
+        reserveLen = maxLen;
+    if (_respStr.reserve(reserveLen))
+        _reservedLen = reserveLen;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Destructor (flushes)
+RestAPIRespSink::~RestAPIRespSink()
+{
+    flush();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Start a standard response object {"req":"..." (further elements are added by the caller)
+/// @param pReq request string
+void RestAPIRespSink::startResponse(const char* pReq)
+{
+    objStart();
+    addStr("req", pReq ? pReq : "");
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief End a standard response with "rslt" (and "error" on failure) and close the object
+/// @param rslt true if ok
+/// @param pErrorMsg error message (used on failure)
+/// @return true if rslt is ok and the response didn't overflow
+bool RestAPIRespSink::endResponse(bool rslt, const char* pErrorMsg)
+{
+    addStr("rslt", rslt ? "ok" : "fail");
+    if (!rslt)
+        addStr("error", pErrorMsg ? pErrorMsg : "Unknown error");
+    objEnd();
+    flush();
+    return rslt && !_isOverflow;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Start an object
+/// @param pKey key (nullptr when the object is an array element or the outermost value)
+void RestAPIRespSink::objStart(const char* pKey)
+{
+    startNested(pKey, '{');
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief End an object
+void RestAPIRespSink::objEnd()
+{
+    if (_depth > 0)
+        _depth--;
+    append("}", 1);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Start an array
+/// @param pKey key (nullptr when the array is an array element or the outermost value)
+void RestAPIRespSink::arrStart(const char* pKey)
+{
+    startNested(pKey, '[');
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief End an array
+void RestAPIRespSink::arrEnd()
+{
+    if (_depth > 0)
+        _depth--;
+    append("]", 1);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add a string value (escaped)
+/// @param pKey key (nullptr for an array element)
+/// @param pVal value
+/// @param valLen length of value (or 0 to use strlen)
+void RestAPIRespSink::addStr(const char* pKey, const char* pVal, uint32_t valLen)
+{
+    startElem(pKey);
+    append("\"", 1);
+    if (pVal)
+        appendEscaped(pVal, valLen > 0 ? valLen : strlen(pVal));
+    append("\"", 1);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add an integer value
+/// @param pKey key (nullptr for an array element)
+/// @param val value
+void RestAPIRespSink::addInt(const char* pKey, int64_t val)
+{
+    startElem(pKey);
+    char numStr[24];
+    uint32_t numLen = 0;
+    if (val < 0)
+        numStr[numLen++] = '-';
+    numLen += formatUint(val < 0 ? -(uint64_t)val : (uint64_t)val, numStr + numLen);
+    append(numStr, numLen);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add an unsigned integer value
+/// @param pKey key (nullptr for an array element)
+/// @param val value
+void RestAPIRespSink::addUint(const char* pKey, uint64_t val)
+{
+    startElem(pKey);
+    char numStr[24];
+    append(numStr, formatUint(val, numStr));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add a floating point value (round-trip format)
+/// @param pKey key (nullptr for an array element)
+/// @param val value
+void RestAPIRespSink::addDouble(const char* pKey, double val)
+{
+    startElem(pKey);
+    char numStr[RaftJsonNumbers::FORMAT_BUF_MIN_LEN];
+    uint32_t numLen = RaftJsonNumbers::formatDouble(val, numStr);
+    append(numStr, numLen);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add a value which is already valid JSON (object, array, number, etc)
+/// @param pKey key (nullptr for an array element)
+/// @param pJson JSON (an empty or null value is written as null)
+/// @param jsonLen length of JSON (or 0 to use strlen)
+void RestAPIRespSink::addRaw(const char* pKey, const char* pJson, uint32_t jsonLen)
+{
+    startElem(pKey);
+    if (pJson && (jsonLen == 0))
+        jsonLen = strlen(pJson);
+    if (!pJson || (jsonLen == 0))
+        append("null", 4);
+    else
+        append(pJson, jsonLen);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add the members of a JSON object which is already formatted (with or without braces)
+/// @param pJson JSON object
+/// @param jsonLen length of JSON (or 0 to use strlen)
+void RestAPIRespSink::addMembers(const char* pJson, uint32_t jsonLen)
+{
+    if (!pJson)
+        return;
+    if (jsonLen == 0)
+        jsonLen = strlen(pJson);
+
+    // Strip whitespace and braces
+    const char* pStart = pJson;
+    const char* pEnd = pJson + jsonLen;
+    while ((pStart < pEnd) && isspace((unsigned char)*pStart))
+        pStart++;
+    while ((pEnd > pStart) && isspace((unsigned char)pEnd[-1]))
+        pEnd--;
+    if ((pStart < pEnd) && (*pStart == '{') && (pEnd[-1] == '}'))
+    {
+        pStart++;
+        pEnd--;
+    }
+    while ((pStart < pEnd) && isspace((unsigned char)*pStart))
+        pStart++;
+    if (pStart >= pEnd)
+        return;
+    startElem(nullptr);
+    append(pStart, pEnd - pStart);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Append text unchanged (no comma handling)
+/// @param pStr text
+/// @param len length
+void RestAPIRespSink::append(const char* pStr, uint32_t len)
+{
+    if ((len == 0) || _isOverflow)
+        return;
+    if (isOverMaxLen(_respStr.length() + _stageLen + len))
+    {
+        _isOverflow = true;
+        return;
+    }
+
+    // Stage small writes
+    if (_stageLen + len <= STAGE_LEN)
+    {
+        memcpy(_stage + _stageLen, pStr, len);
+        _stageLen += len;
+        return;
+    }
+    flush();
+    if (len <= STAGE_LEN)
+    {
+        memcpy(_stage, pStr, len);
+        _stageLen = len;
+        return;
+    }
+    if (ensureSpace(len))
+        _respStr.concat(pStr, len);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Flush staged output to the response string
+void RestAPIRespSink::flush()
+{
+    if (_stageLen == 0)
+        return;
+    if (ensureSpace(_stageLen))
+        _respStr.concat(_stage, _stageLen);
+    _stageLen = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Ensure there is space for more characters (growing the reservation geometrically)
+/// @param len number of characters to be added
+/// @return true if there is space (false if the response would exceed the maximum length)
+bool RestAPIRespSink::ensureSpace(uint32_t len)
+{
+    if (_isOverflow)
+        return false;
+    uint32_t reqLen = _respStr.length() + len;
+    if (isOverMaxLen(reqLen))
+    {
+        _isOverflow = true;
+        return false;
+    }
+    if (reqLen <= _reservedLen)
+        return true;
+    uint32_t newReserveLen = _reservedLen * 2;
+    if (newReserveLen < reqLen)
+        newReserveLen = reqLen;
+    if (isOverMaxLen(newReserveLen))
+        newReserveLen = _maxLen;
+    if (!_respStr.reserve(newReserveLen))
+    {
+        // Doubling may exceed the String capacity (or memory) when the required length doesn't
+        newReserveLen = reqLen;
+        if (!_respStr.reserve(newReserveLen))
+        {
+            _isOverflow = true;
+            return false;
+        }
+    }
+    _reservedLen = newReserveLen;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Format unsigned integer (decimal)
+/// @param val value
+/// @param pBuf buffer (at least 21 bytes)
+/// @return number of characters written (not null terminated)
+uint32_t RestAPIRespSink::formatUint(uint64_t val, char* pBuf)
+{
+    char digits[20];
+    uint32_t numDigits = 0;
+    do
+    {
+        digits[numDigits++] = '0' + (val % 10);
+        val /= 10;
+    } while (val > 0);
+    for (uint32_t i = 0; i < numDigits; i++)
+        pBuf[i] = digits[numDigits - 1 - i];
+    return numDigits;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Start a nested object or array
+/// @param pKey key (nullptr when an array element or the outermost value)
+/// @param openChar opening character
+/// @note nesting beyond MAX_DEPTH can't be tracked so the response fails (as an overflow) rather than being
+///       written with incorrect commas
+void RestAPIRespSink::startNested(const char* pKey, char openChar)
+{
+    if (_depth >= MAX_DEPTH - 1)
+    {
+        _isOverflow = true;
+        return;
+    }
+    startElem(pKey);
+    append(&openChar, 1);
+    _depth++;
+    _elemWrittenBits &= ~(1u << _depth);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Start an element (comma if required and key if present)
+/// @param pKey key (nullptr for an array element)
+void RestAPIRespSink::startElem(const char* pKey)
+{
+    uint32_t depthBit = 1u << _depth;
+    if (_elemWrittenBits & depthBit)
+        append(",", 1);
+    _elemWrittenBits |= depthBit;
+    if (!pKey)
+        return;
+    append("\"", 1);
+    appendEscaped(pKey, strlen(pKey));
+    append("\":", 2);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Append a string escaped for JSON (runs of characters which don't need escaping are appended at once)
+/// @param pStr string
+/// @param len length
+void RestAPIRespSink::appendEscaped(const char* pStr, uint32_t len)
+{
+    const char* pEnd = pStr + len;
+    while (pStr < pEnd)
+    {
+        // Find run of characters not needing escape
+        const char* pRunEnd = pStr;
+        while ((pRunEnd < pEnd) && (*pRunEnd != '"') && (*pRunEnd != '\\') && ((uint8_t)*pRunEnd >= 0x20))
+            pRunEnd++;
+        append(pStr, pRunEnd - pStr);
+        if (pRunEnd >= pEnd)
+            break;
+
+        // Escape
+        char escStr[8];
+        uint32_t escLen = 2;
+        escStr[0] = '\\';
+        switch (*pRunEnd)
+        {
+            case '"': escStr[1] = '"'; break;
+            case '\\': escStr[1] = '\\'; break;
+            case '\n': escStr[1] = 'n'; break;
+            case '\r': escStr[1] = 'r'; break;
+            case '\t': escStr[1] = 't'; break;
+            default:
+                escLen = snprintf(escStr, sizeof(escStr), "\\u%04x", (uint8_t)*pRunEnd);
+                break;
+        }
+        append(escStr, escLen);
+        pStr = pRunEnd + 1;
+    }
+}
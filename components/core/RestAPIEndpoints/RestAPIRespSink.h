@@ -0,0 +1,157 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RestAPIRespSink
+// Builds a JSON REST API response directly in the response string
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "RaftArduino.h"
+
+/// @brief JSON response sink for REST API handlers
+/// Handlers write keys and values through a small staging buffer straight into the response string (which is
+/// reserved up-front and grown geometrically) rather than building temporary Strings and concatenating them.
+/// Commas between elements are handled automatically. The output is bounded - once maxLen would be exceeded
+/// (or nesting would exceed MAX_DEPTH) nothing further is written and isOverflow() returns true so the handler
+/// can report an error instead of a truncated or malformed response. The response string is complete after flush() or when the sink is destroyed.
+class RestAPIRespSink
+{
+public:
+    /// @brief Constructor (the response string is cleared)
+    /// @param respStr response string to write into
+    /// @param reserveLen initial space to reserve
+    /// @param maxLen maximum length of response (MAX_LEN_UNLIMITED for no limit other than String capacity)
+    RestAPIRespSink(String& respStr, uint32_t reserveLen = RESERVE_LEN_DEFAULT, uint32_t maxLen = MAX_LEN_DEFAULT);
+
+    /// @brief Destructor (flushes)
+    ~RestAPIRespSink();
+
+    /// @brief Start a standard response object {"req":"..." (further elements are added by the caller)
+    /// @param pReq request string
+    void startResponse(const char* pReq);
+
+    /// @brief End a standard response with "rslt" (and "error" on failure), close the object and flush
+    /// @param rslt true if ok
+    /// @param pErrorMsg error message (used on failure)
+    /// @return true if rslt is ok and the response didn't overflow
+    bool endResponse(bool rslt, const char* pErrorMsg = nullptr);
+
+    /// @brief Start an object
+    /// @param pKey key (nullptr when the object is an array element or the outermost value)
+    void objStart(const char* pKey = nullptr);
+
+    /// @brief End an object
+    void objEnd();
+
+    /// @brief Start an array
+    /// @param pKey key (nullptr when the array is an array element or the outermost value)
+    void arrStart(const char* pKey = nullptr);
+
+    /// @brief End an array
+    void arrEnd();
+
+    /// @brief Add a string value (escaped)
+    /// @param pKey key (nullptr for an array element)
+    /// @param pVal value
+    /// @param valLen length of value (or 0 to use strlen)
+    void addStr(const char* pKey, const char* pVal, uint32_t valLen = 0);
+    void addStr(const char* pKey, const String& val)
+    {
+        addStr(pKey, val.c_str(), val.length());
+    }
+
+    /// @brief Add an integer value
+    /// @param pKey key (nullptr for an array element)
+    /// @param val value
+    void addInt(const char* pKey, int64_t val);
+
+    /// @brief Add an unsigned integer value
+    /// @param pKey key (nullptr for an array element)
+    /// @param val value
+    void addUint(const char* pKey, uint64_t val);
+
+    /// @brief Add a floating point value (round-trip format)
+    /// @param pKey key (nullptr for an array element)
+    /// @param val value
+    void addDouble(const char* pKey, double val);
+
+    /// @brief Add a value which is already valid JSON (object, array, number, etc)
+    /// @param pKey key (nullptr for an array element)
+    /// @param pJson JSON (an empty or null value is written as null)
+    /// @param jsonLen length of JSON (or 0 to use strlen)
+    void addRaw(const char* pKey, const char* pJson, uint32_t jsonLen = 0);
+    void addRaw(const char* pKey, const String& json)
+    {
+        addRaw(pKey, json.c_str(), json.length());
+    }
+
+    /// @brief Add the members of a JSON object which is already formatted (with or without braces)
+    /// @param pJson JSON object
+    /// @param jsonLen length of JSON (or 0 to use strlen)
+    void addMembers(const char* pJson, uint32_t jsonLen = 0);
+
+    /// @brief Append text unchanged (no comma handling)
+    /// @param pStr text
+    /// @param len length
+    void append(const char* pStr, uint32_t len);
+
+    /// @brief Flush staged output to the response string
+    void flush();
+
+    /// @brief Check if the response overflowed maxLen or MAX_DEPTH
+    /// @return true if overflowed
+    bool isOverflow() const
+    {
+        return _isOverflow;
+    }
+
+    /// @brief Get length of response so far
+    /// @return length
+    uint32_t length() const
+    {
+        return _respStr.length() + _stageLen;
+    }
+
+    // Defaults
+    static const uint32_t RESERVE_LEN_DEFAULT = 256;
+    static const uint32_t MAX_LEN_DEFAULT = 60000;
+    static const uint32_t MAX_LEN_UNLIMITED = 0;
+
+    // Maximum nesting of objects and arrays
+    static const uint32_t MAX_DEPTH = 32;
+
+private:
+    String& _respStr;
+    uint32_t _reservedLen = 0;
+    uint32_t _maxLen = MAX_LEN_DEFAULT;
+    bool _isOverflow = false;
+
+    // Staging buffer (small writes are collected here to reduce the number of String operations)
+    static const uint32_t STAGE_LEN = 128;
+    char _stage[STAGE_LEN];
+    uint32_t _stageLen = 0;
+
+    // Nesting level and a bit per level set when an element has been written at that level (so a comma is needed)
+    uint32_t _depth = 0;
+    uint32_t _elemWrittenBits = 0;
+
+    // Helpers
+    bool ensureSpace(uint32_t len);
+    bool isOverMaxLen(uint32_t len) const
+    {
+        return (_maxLen != MAX_LEN_UNLIMITED) && (len > _maxLen);
+    }
+    void startNested(const char* pKey, char openChar);
+    static uint32_t formatUint(uint64_t val, char* pBuf);
+    void startElem(const char* pKey);
+    void appendEscaped(const char* pStr, uint32_t len);
+    void appendLiteral(const char* pStr)
+    {
+        append(pStr, strlen(pStr));
+    }
+};
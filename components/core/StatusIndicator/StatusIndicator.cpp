@@ -2,13 +2,17 @@
 //
 // Status indicator
 //
-// Rob Dobson 2018-2023
+// Rob Dobson 2018-2025
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "Logger.h"
 #include "StatusIndicator.h"
 #include "RaftUtils.h"
+#ifdef ESP_PLATFORM
+#include "driver/ledc.h"
+#include "esp_idf_version.h"
+#endif
 
 // Debug
 // #define DEBUG_STATUS_INDICATOR_SETUP
@@ -20,29 +24,44 @@
 
 StatusIndicator::StatusIndicator()
 {
+    RaftMutex_init(_playerMutex);
+#ifndef ESP_PLATFORM
+    RaftSemaphore_init(_timerWakeSem, 0, 1);
+    RaftAtomicBool_init(_timerThreadStop, false);
+#endif
+    _player.setOutputCB([this](uint8_t startLevel, uint8_t endLevel, uint32_t rampMs) {
+        writeLevel(startLevel, endLevel, rampMs);
+    });
 }
 
 StatusIndicator::~StatusIndicator()
 {
+    stopTimer();
+
     // Restore pin to input if setup
     if (_isSetup)
-    {
-        pinMode(_hwPin, INPUT);
-    }
+        releasePin();
+#ifndef ESP_PLATFORM
+    RaftSemaphore_destroy(_timerWakeSem);
+#endif
+    RaftMutex_destroy(_playerMutex);
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Setup
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void StatusIndicator::setup(const char *pName, int hwPin, bool onLevel, uint32_t onMs, 
-                uint32_t shortOffMs, uint32_t longOffMs)
+void StatusIndicator::setup(const char *pName, int hwPin, bool onLevel, uint32_t onMs,
+                uint32_t shortOffMs, uint32_t longOffMs, int pwmChannel)
 {
-    // Check if setup already - if so restore pin to input
+    // Check if setup already - if so stop the pattern and restore pin to input
     if (_isSetup)
     {
-        pinMode(_hwPin, INPUT);
+        RaftMutex_lock(_playerMutex, RAFT_MUTEX_WAIT_FOREVER);
+        _player.stop();
         _isSetup = false;
+        RaftMutex_unlock(_playerMutex);
+        releasePin();
     }
 
     // Save settings
@@ -52,25 +71,57 @@ void StatusIndicator::setup(const char *pName, int hwPin, bool onLevel, uint32_t
     _onMs = onMs;
     _shortOffMs = shortOffMs;
     _longOffMs = longOffMs;
+    _pwmChannel = pwmChannel;
 
 #ifdef DEBUG_STATUS_INDICATOR_SETUP
-    LOG_I(MODULE_PREFIX, "setup name %s pin %d onLevel %d onMs %d shortMs %d longMs %d",
-          _name.c_str(), _hwPin, _onLevel, (int)_onMs, (int)_shortOffMs, (int)_longOffMs);
+    LOG_I(MODULE_PREFIX, "setup name %s pin %d onLevel %d onMs %d shortMs %d longMs %d pwmChannel %d",
+          _name.c_str(), _hwPin, _onLevel, (int)_onMs, (int)_shortOffMs, (int)_longOffMs, _pwmChannel);
+#endif
+
+    // Reset state
+    _curCode = 0;
+    if (_hwPin < 0)
+        return;
+
+    // Setup PWM output
+#ifdef ESP_PLATFORM
+    if (_pwmChannel >= 0)
+    {
+        ledc_timer_config_t timerConfig = {};
+        timerConfig.speed_mode = LEDC_LOW_SPEED_MODE;
+        timerConfig.duty_resolution = LEDC_TIMER_8_BIT;
+        timerConfig.timer_num = (ledc_timer_t)PWM_LEDC_TIMER_NUM;
+        timerConfig.freq_hz = PWM_FREQ_HZ;
+        timerConfig.clk_cfg = LEDC_AUTO_CLK;
+        ledc_channel_config_t channelConfig = {};
+        channelConfig.gpio_num = _hwPin;
+        channelConfig.speed_mode = LEDC_LOW_SPEED_MODE;
+        channelConfig.channel = (ledc_channel_t)_pwmChannel;
+        channelConfig.timer_sel = (ledc_timer_t)PWM_LEDC_TIMER_NUM;
+        channelConfig.duty = _onLevel ? 0 : 255;
+        if ((ledc_timer_config(&timerConfig) != ESP_OK) || (ledc_channel_config(&channelConfig) != ESP_OK))
+        {
+            LOG_W(MODULE_PREFIX, "setup %s PWM channel %d setup failed - using pin on/off", _name.c_str(), _pwmChannel);
+            _pwmChannel = -1;
+        }
+        else
+        {
+            // Hardware fades (error if already installed is ignored)
+            ledc_fade_func_install(0);
+        }
+    }
+#else
+    _pwmChannel = -1;
 #endif
 
     // Setup pin
-    if (_hwPin >= 0)
+    if (_pwmChannel < 0)
     {
         pinMode(_hwPin, OUTPUT);
         digitalWrite(_hwPin, !_onLevel);
-        _isSetup = true;
     }
-
-    // Reset state
-    _isOn = false;
-    _curCodePos = 0;
-    _curCode = 0;
-    _changeLastMs = millis();
+    _isSetup = true;
+    startTimer();
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -80,30 +131,41 @@ void StatusIndicator::setup(const char *pName, int hwPin, bool onLevel, uint32_t
 
 void StatusIndicator::setStatusCode(int code, uint32_t timeoutMs)
 {
-    // Ignore if no change or not setup
-    if ((_curCode == code) || (!_isSetup))
+    // Ignore if not setup or no change (a code which has timed out can be set again)
+    if (!_isSetup)
+        return;
+    RaftMutex_lock(_playerMutex, RAFT_MUTEX_WAIT_FOREVER);
+    bool isActive = _player.isActive();
+    RaftMutex_unlock(_playerMutex);
+    if ((_curCode == code) && ((code == 0) || isActive))
         return;
 
 #ifdef DEBUG_STATUS_INDICATOR_CODE
-    LOG_I(MODULE_PREFIX, "setCode %d curCode %d isSetup %d timeoutMs %d", 
+    LOG_I(MODULE_PREFIX, "setCode %d curCode %d isSetup %d timeoutMs %d",
                 code, _curCode, _isSetup, (int)timeoutMs);
 #endif
 
     // Set new code
     _curCode = code;
-    _curCodePos = 0;
-    _changeLastMs = millis();
-    _timeoutMs = timeoutMs;
-    if (code == 0)
-    {
-        digitalWrite(_hwPin, !_onLevel);
-        _isOn = false;
-    }
-    else
-    {
-        digitalWrite(_hwPin, _onLevel);
-        _isOn = true;
-    }
+    setPattern(StatusIndicatorPattern::blinkCode(code > 0 ? code : 0, _onMs, _shortOffMs, _longOffMs), timeoutMs);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Set pattern
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StatusIndicator::setPattern(const StatusIndicatorPattern& pattern, uint32_t timeoutMs)
+{
+    if (!_isSetup)
+        return;
+    RaftMutex_lock(_playerMutex, RAFT_MUTEX_WAIT_FOREVER);
+    _player.start(pattern, millis(), timeoutMs);
+    RaftMutex_unlock(_playerMutex);
+    servicePlayer();
+#ifndef ESP_PLATFORM
+    // Wake the timer thread to wait for the new pattern's next change
+    RaftSemaphore_give(_timerWakeSem);
+#endif
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -112,42 +174,132 @@ void StatusIndicator::setStatusCode(int code, uint32_t timeoutMs)
 
 void StatusIndicator::loop()
 {
-    // Check if active
-    if (!_isSetup)
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Timer
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StatusIndicator::startTimer()
+{
+#ifdef ESP_PLATFORM
+    if (_timerHandle)
+        return;
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = timerCallback;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "StatusInd";
+    if (esp_timer_create(&timerArgs, &_timerHandle) != ESP_OK)
+    {
+        LOG_W(MODULE_PREFIX, "startTimer %s failed to create timer", _name.c_str());
+        _timerHandle = nullptr;
+    }
+#else
+    if (_timerThreadStarted)
         return;
+    RaftAtomicBool_set(_timerThreadStop, false);
+    _timerThreadStarted = RaftThread_start(_timerThread, timerThreadFn, this, 4096, "StatusInd");
+#endif
+}
 
-    // Code 0 means stay off
-    if (_curCode == 0)
+void StatusIndicator::stopTimer()
+{
+#ifdef ESP_PLATFORM
+    if (!_timerHandle)
+        return;
+    esp_timer_stop(_timerHandle);
+    esp_timer_delete(_timerHandle);
+    _timerHandle = nullptr;
+#else
+    if (!_timerThreadStarted)
         return;
+    RaftAtomicBool_set(_timerThreadStop, true);
+    RaftSemaphore_give(_timerWakeSem);
+    pthread_join(_timerThread, NULL);
+    _timerThread = RAFT_THREAD_HANDLE_INVALID;
+    _timerThreadStarted = false;
+#endif
+}
 
-    // Check for timeout
-    if ((_timeoutMs > 0) && (Raft::isTimeout(millis(), _changeLastMs, _timeoutMs)))
-    {
-        setStatusCode(0);
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Service the player and (on ESP) schedule the timer for the next change
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StatusIndicator::servicePlayer()
+{
+    if (!RaftMutex_lock(_playerMutex, RAFT_MUTEX_WAIT_FOREVER))
         return;
+    uint32_t untilNextMs = _player.service(millis());
+#ifdef ESP_PLATFORM
+    if (_timerHandle)
+    {
+        esp_timer_stop(_timerHandle);
+        if (untilNextMs != StatusIndicatorPlayer::NO_NEXT_CHANGE)
+            esp_timer_start_once(_timerHandle, (uint64_t)(untilNextMs > 0 ? untilNextMs : 1) * 1000);
     }
+#else
+    (void)untilNextMs;
+#endif
+    RaftMutex_unlock(_playerMutex);
+}
 
-    // Handle the code
-    if (_isOn)
+#ifdef ESP_PLATFORM
+void StatusIndicator::timerCallback(void* pArg)
+{
+    ((StatusIndicator*)pArg)->servicePlayer();
+}
+#else
+void StatusIndicator::timerThreadFn(void* pArg)
+{
+    StatusIndicator* pInd = (StatusIndicator*)pArg;
+    while (!RaftAtomicBool_get(pInd->_timerThreadStop))
     {
-        if (Raft::isTimeout(millis(), _changeLastMs, _onMs))
-        {
-            _isOn = false;
-            digitalWrite(_hwPin, !_onLevel);
-            _changeLastMs = millis();
-        }
+        RaftMutex_lock(pInd->_playerMutex, RAFT_MUTEX_WAIT_FOREVER);
+        uint32_t untilNextMs = pInd->_player.service(millis());
+        RaftMutex_unlock(pInd->_playerMutex);
+
+        // Sleep until the next change or until woken by a new pattern (NO_NEXT_CHANGE waits forever)
+        RaftSemaphore_take(pInd->_timerWakeSem, untilNextMs);
     }
-    else
+}
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Output
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StatusIndicator::writeLevel(uint8_t startLevel, uint8_t endLevel, uint32_t rampMs)
+{
+    if (_hwPin < 0)
+        return;
+
+#ifdef ESP_PLATFORM
+    // PWM output with ramps done by the LEDC fade hardware
+    if (_pwmChannel >= 0)
     {
-        if (Raft::isTimeout(millis(), _changeLastMs, 
-                (_curCodePos == _curCode-1) ? _longOffMs : _shortOffMs))
-        {
-            _isOn = true;
-            digitalWrite(_hwPin, _onLevel);
-            _changeLastMs = millis();
-            _curCodePos++;
-            if (_curCodePos >= _curCode)
-                _curCodePos = 0;
-        }
+        ledc_channel_t channel = (ledc_channel_t)_pwmChannel;
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+        ledc_fade_stop(LEDC_LOW_SPEED_MODE, channel);
+#endif
+        ledc_set_duty(LEDC_LOW_SPEED_MODE, channel, _onLevel ? startLevel : 255 - startLevel);
+        ledc_update_duty(LEDC_LOW_SPEED_MODE, channel);
+        if (rampMs > 0)
+            ledc_set_fade_time_and_start(LEDC_LOW_SPEED_MODE, channel, _onLevel ? endLevel : 255 - endLevel,
+                        rampMs, LEDC_FADE_NO_WAIT);
+        return;
     }
+#endif
+
+    // Pin on/off - a ramp shows as the level it ramps towards
+    digitalWrite(_hwPin, endLevel >= 128 ? _onLevel : !_onLevel);
+}
+
+void StatusIndicator::releasePin()
+{
+#ifdef ESP_PLATFORM
+    if (_pwmChannel >= 0)
+        ledc_stop(LEDC_LOW_SPEED_MODE, (ledc_channel_t)_pwmChannel, !_onLevel);
+#endif
+    pinMode(_hwPin, INPUT);
 }
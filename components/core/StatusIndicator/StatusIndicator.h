@@ -2,20 +2,30 @@
 //
 // Status indicator
 //
-// Rob Dobson 2018-2023
+// Rob Dobson 2018-2025
 //
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #pragma once
 
 #include "RaftArduino.h"
+#include "RaftThreading.h"
+#include "StatusIndicatorPattern.h"
+#ifdef ESP_PLATFORM
+#include "esp_timer.h"
+#endif
 
 class StatusIndicator
 {
 public:
     StatusIndicator();
     virtual ~StatusIndicator();
-    void setup(const char *pName, int hwPin, bool onLevel, uint32_t onMs, uint32_t shortOffMs, uint32_t longOffMs);
+
+    // Setup
+    // Patterns are played by a timer (esp_timer on ESP, a timer thread elsewhere) so loop() has nothing to do
+    // If pwmChannel is >= 0 (ESP only) the pin is driven by that LEDC channel and fades are done in hardware
+    void setup(const char *pName, int hwPin, bool onLevel, uint32_t onMs, uint32_t shortOffMs, uint32_t longOffMs,
+                int pwmChannel = -1);
 
     // Set status code
     // The indicator provides a series of pulses with short gaps between them followed by a long gap
@@ -26,6 +36,11 @@ public:
     // A code of 3 means three pulses (short gaps between) followed by a long gap, etc
     // The timeout returns to code of 0 after the specified time
     void setStatusCode(int code, uint32_t timeoutMs = 0);
+
+    // Set pattern (e.g. StatusIndicatorPattern::heartbeat()) - the timeout turns the indicator off
+    void setPattern(const StatusIndicatorPattern& pattern, uint32_t timeoutMs = 0);
+
+    // Service (nothing to do as patterns are timer driven - retained for compatibility)
     void loop();
 
 private:
@@ -36,16 +51,40 @@ private:
     uint32_t _onMs = 0;
     uint32_t _longOffMs = 0;
     uint32_t _shortOffMs = 0;
+    int _pwmChannel = -1;
 
     // Setup flag
     bool _isSetup = false;
 
     // State
     int _curCode = 0;
-    int _curCodePos = 0;
-    bool _isOn = false;
-    uint32_t _changeLastMs = 0;
-    uint32_t _timeoutMs = 0;
+
+    // Pattern player and mutex (the player is serviced from the timer)
+    StatusIndicatorPlayer _player;
+    RaftMutex _playerMutex;
+
+    // Timer
+#ifdef ESP_PLATFORM
+    esp_timer_handle_t _timerHandle = nullptr;
+    static void timerCallback(void* pArg);
+#else
+    RaftThreadHandle _timerThread = RAFT_THREAD_HANDLE_INVALID;
+    bool _timerThreadStarted = false;
+    RaftSemaphore _timerWakeSem;
+    RaftAtomicBool _timerThreadStop;
+    static void timerThreadFn(void* pArg);
+#endif
+
+    // PWM (LEDC) timer
+    static const int PWM_LEDC_TIMER_NUM = 3;
+    static const uint32_t PWM_FREQ_HZ = 5000;
+
+    // Helpers
+    void startTimer();
+    void stopTimer();
+    void servicePlayer();
+    void writeLevel(uint8_t startLevel, uint8_t endLevel, uint32_t rampMs);
+    void releasePin();
 
     // Debug
     static constexpr const char* MODULE_PREFIX = "StInd";
@@ -0,0 +1,155 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// StatusIndicatorPattern
+// Indicator patterns (blink codes, fades, heartbeat) as step sequences and a player to sequence them
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "StatusIndicatorPattern.h"
+
+// Steps are limited to 16 bit durations
+static uint16_t clampStepMs(uint32_t durationMs)
+{
+    return durationMs > UINT16_MAX ? UINT16_MAX : durationMs;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get total duration of one cycle
+/// @return duration in ms
+uint32_t StatusIndicatorPattern::getDurationMs() const
+{
+    uint32_t durationMs = 0;
+    for (const StatusIndicatorStep& step : steps)
+        durationMs += step.durationMs;
+    return durationMs;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Blink code - code pulses with short gaps between them followed by a long gap
+/// @param code number of pulses (0 for off)
+/// @param onMs pulse duration
+/// @param shortOffMs gap between pulses
+/// @param longOffMs gap after the last pulse
+/// @return pattern
+StatusIndicatorPattern StatusIndicatorPattern::blinkCode(uint32_t code, uint32_t onMs, uint32_t shortOffMs, uint32_t longOffMs)
+{
+    StatusIndicatorPattern pattern;
+    for (uint32_t i = 0; i < code; i++)
+    {
+        pattern.add(clampStepMs(onMs), 255, 255);
+        pattern.add(clampStepMs(i == code - 1 ? longOffMs : shortOffMs), 0, 0);
+    }
+    return pattern;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Heartbeat - two short pulses then a pause
+/// @param periodMs period of the heartbeat
+/// @return pattern
+StatusIndicatorPattern StatusIndicatorPattern::heartbeat(uint32_t periodMs)
+{
+    uint32_t pulseMs = periodMs / 10;
+    uint32_t gapMs = periodMs * 3 / 20;
+    StatusIndicatorPattern pattern;
+    pattern.add(clampStepMs(pulseMs), 255, 255)
+           .add(clampStepMs(gapMs), 0, 0)
+           .add(clampStepMs(pulseMs), 255, 255)
+           .add(clampStepMs(periodMs - 2 * pulseMs - gapMs), 0, 0);
+    return pattern;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Fade - ramps up and down continuously
+/// @param periodMs period of the fade cycle
+/// @param maxLevel maximum level
+/// @return pattern
+StatusIndicatorPattern StatusIndicatorPattern::fade(uint32_t periodMs, uint8_t maxLevel)
+{
+    StatusIndicatorPattern pattern;
+    pattern.add(clampStepMs(periodMs / 2), 0, maxLevel)
+           .add(clampStepMs(periodMs - periodMs / 2), maxLevel, 0);
+    return pattern;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Start a pattern
+/// @param pattern pattern (copied)
+/// @param nowMs current time
+/// @param timeoutMs time after which the output goes off (0 for no timeout)
+void StatusIndicatorPlayer::start(const StatusIndicatorPattern& pattern, uint64_t nowMs, uint32_t timeoutMs)
+{
+    _pattern = pattern;
+    _cycleMs = _pattern.getDurationMs();
+    _startMs = nowMs;
+    _timeoutMs = timeoutMs;
+    _lastCycle = 0;
+    _lastStepIdx = -1;
+    _isActive = _cycleMs > 0;
+    if (!_isActive)
+        output(0, 0, 0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Stop the pattern (the output goes off)
+void StatusIndicatorPlayer::stop()
+{
+    _isActive = false;
+    output(0, 0, 0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Service - outputs the current step if it has changed
+/// @param nowMs current time
+/// @return time in ms until the next change or NO_NEXT_CHANGE when the pattern has finished
+uint32_t StatusIndicatorPlayer::service(uint64_t nowMs)
+{
+    if (!_isActive)
+        return NO_NEXT_CHANGE;
+
+    // Check for timeout or end of a non-repeating pattern
+    uint64_t elapsedMs = nowMs > _startMs ? nowMs - _startMs : 0;
+    uint64_t cycle = elapsedMs / _cycleMs;
+    if (((_timeoutMs > 0) && (elapsedMs >= _timeoutMs)) || (!_pattern.repeat && (cycle > 0)))
+    {
+        stop();
+        return NO_NEXT_CHANGE;
+    }
+
+    // Find the current step
+    uint32_t offsetMs = elapsedMs % _cycleMs;
+    uint32_t stepStartMs = 0;
+    int32_t stepIdx = 0;
+    for (const StatusIndicatorStep& step : _pattern.steps)
+    {
+        if (offsetMs < stepStartMs + step.durationMs)
+            break;
+        stepStartMs += step.durationMs;
+        stepIdx++;
+    }
+    const StatusIndicatorStep& step = _pattern.steps[stepIdx];
+    uint32_t untilNextMs = stepStartMs + step.durationMs - offsetMs;
+
+    // Output on step change - a ramp entered late starts from its interpolated level
+    if ((stepIdx != _lastStepIdx) || (cycle != _lastCycle))
+    {
+        if (step.startLevel == step.endLevel)
+        {
+            output(step.startLevel, step.endLevel, 0);
+        }
+        else
+        {
+            uint32_t intoStepMs = offsetMs - stepStartMs;
+            int32_t levelNow = step.startLevel + ((int32_t)step.endLevel - step.startLevel) * (int32_t)intoStepMs / step.durationMs;
+            output(levelNow, step.endLevel, untilNextMs);
+        }
+        _lastStepIdx = stepIdx;
+        _lastCycle = cycle;
+    }
+
+    // Time to next change
+    if ((_timeoutMs > 0) && (_timeoutMs - elapsedMs < untilNextMs))
+        untilNextMs = _timeoutMs - elapsedMs;
+    return untilNextMs;
+}
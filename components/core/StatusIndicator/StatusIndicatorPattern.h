@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// StatusIndicatorPattern
+// Indicator patterns (blink codes, fades, heartbeat) as step sequences and a player to sequence them
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <functional>
+
+/// @brief Pattern step - the level ramps linearly from startLevel to endLevel over the duration
+/// (levels are 0 = off to 255 = fully on, a step with equal levels holds a fixed level)
+struct StatusIndicatorStep
+{
+    uint16_t durationMs;
+    uint8_t startLevel;
+    uint8_t endLevel;
+};
+
+/// @brief Indicator pattern
+class StatusIndicatorPattern
+{
+public:
+    std::vector<StatusIndicatorStep> steps;
+    bool repeat = true;
+
+    /// @brief Add a step
+    /// @param durationMs duration
+    /// @param startLevel level at start of step
+    /// @param endLevel level at end of step
+    StatusIndicatorPattern& add(uint16_t durationMs, uint8_t startLevel, uint8_t endLevel)
+    {
+        steps.push_back({durationMs, startLevel, endLevel});
+        return *this;
+    }
+
+    /// @brief Get total duration of one cycle
+    /// @return duration in ms
+    uint32_t getDurationMs() const;
+
+    /// @brief Blink code - code pulses with short gaps between them followed by a long gap
+    static StatusIndicatorPattern blinkCode(uint32_t code, uint32_t onMs, uint32_t shortOffMs, uint32_t longOffMs);
+
+    /// @brief Heartbeat - two short pulses then a pause
+    static StatusIndicatorPattern heartbeat(uint32_t periodMs);
+
+    /// @brief Fade - ramps up and down continuously (needs a PWM output, a plain pin shows a square wave)
+    static StatusIndicatorPattern fade(uint32_t periodMs, uint8_t maxLevel = 255);
+};
+
+/// @brief Pattern player
+/// Sequencing is relative to the pattern start time so a late service call doesn't shift later steps.
+/// Output is only generated when the step changes - between steps service() needn't be called.
+class StatusIndicatorPlayer
+{
+public:
+    /// @brief Output callback - go to startLevel now and ramp to endLevel over rampMs (0 for a fixed level)
+    typedef std::function<void(uint8_t startLevel, uint8_t endLevel, uint32_t rampMs)> OutputCB;
+
+    /// @brief Set the output callback
+    /// @param outputCB callback
+    void setOutputCB(OutputCB outputCB)
+    {
+        _outputCB = outputCB;
+    }
+
+    /// @brief Start a pattern
+    /// @param pattern pattern (copied)
+    /// @param nowMs current time
+    /// @param timeoutMs time after which the output goes off (0 for no timeout)
+    void start(const StatusIndicatorPattern& pattern, uint64_t nowMs, uint32_t timeoutMs = 0);
+
+    /// @brief Stop the pattern (the output goes off)
+    void stop();
+
+    /// @brief Check if a pattern is playing
+    /// @return true if active
+    bool isActive() const
+    {
+        return _isActive;
+    }
+
+    /// @brief Service - outputs the current step if it has changed
+    /// @param nowMs current time
+    /// @return time in ms until the next change or NO_NEXT_CHANGE when the pattern has finished
+    uint32_t service(uint64_t nowMs);
+
+    static const uint32_t NO_NEXT_CHANGE = UINT32_MAX;
+
+private:
+    StatusIndicatorPattern _pattern;
+    uint32_t _cycleMs = 0;
+    uint64_t _startMs = 0;
+    uint32_t _timeoutMs = 0;
+    bool _isActive = false;
+    uint64_t _lastCycle = 0;
+    int32_t _lastStepIdx = -1;
+    OutputCB _outputCB = nullptr;
+
+    // Helpers
+    void output(uint8_t startLevel, uint8_t endLevel, uint32_t rampMs)
+    {
+        if (_outputCB)
+            _outputCB(startLevel, endLevel, rampMs);
+    }
+};
@@ -20,6 +20,7 @@
 #include "PlatformUtils.h"
 #include "DebugGlobals.h"
 #include "RICRESTMsg.h"
+#include "RaftProfileZones.h"
 
 #ifdef ESP_PLATFORM
 #include "esp_system.h"
@@ -204,6 +205,11 @@ void SysManager::postSetup()
         _pRestAPIEndpointManager->addEndpoint("sysman", RestAPIEndpoint::ENDPOINT_CALLBACK, RestAPIEndpoint::ENDPOINT_GET,
                 std::bind(&SysManager::apiSysManSettings, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
                 "Set SysMan, e.g. sysman?interval=2&rxBuf=10240");
+#ifdef RAFT_PROFILE_ZONES_ENABLED
+        _pRestAPIEndpointManager->addEndpoint("profile", RestAPIEndpoint::ENDPOINT_CALLBACK, RestAPIEndpoint::ENDPOINT_GET,
+                std::bind(&SysManager::apiProfileZones, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3),
+                "Profiling zones, profile to get report, profile/clear to reset counters");
+#endif
     }
 
     // Short delay here to allow logging output to complete as some hardware configurations
@@ -1214,6 +1220,30 @@ RaftRetCode SysManager::apiSysManSettings(const String &reqStr, String& respStr,
     return Raft::setJsonBoolResult(reqStrWithoutQuotes.c_str(), respStr, true);
 }
 
+#ifdef RAFT_PROFILE_ZONES_ENABLED
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief API for profiling zones report
+/// @param reqStr
+/// @param respStr
+/// @param sourceInfo
+/// @return response code
+RaftRetCode SysManager::apiProfileZones(const String &reqStr, String& respStr, const APISourceInfo& sourceInfo)
+{
+    // Check for clear
+    String cmdStr = RestAPIEndpointManager::getNthArgStr(reqStr.c_str(), 1);
+    if (cmdStr.equalsIgnoreCase("clear"))
+    {
+        RaftProfileZones::clearAll();
+        return Raft::setJsonBoolResult(reqStr.c_str(), respStr, true);
+    }
+
+    // Report (strip the outer braces as the report is merged into the response object)
+    String reportJson = RaftProfileZones::getJSON();
+    reportJson = reportJson.substring(1, reportJson.length() - 1);
+    return Raft::setJsonBoolResult(reqStr.c_str(), respStr, true, reportJson.c_str());
+}
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief get mutable config JSON
 /// @return JSON string
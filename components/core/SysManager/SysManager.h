@@ -389,6 +389,11 @@ private:
     // Setup SysMan diagnostics
     RaftRetCode apiSysManSettings(const String &reqStr, String& respStr, const APISourceInfo& sourceInfo);
 
+#ifdef RAFT_PROFILE_ZONES_ENABLED
+    // Profiling zones report
+    RaftRetCode apiProfileZones(const String &reqStr, String& respStr, const APISourceInfo& sourceInfo);
+#endif
+
     // Clear status change callbacks
     void clearAllStatusChangeCBs();
 
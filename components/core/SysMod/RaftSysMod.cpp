@@ -159,6 +159,11 @@ void RaftSysMod::configRegisterChangeCallback(RaftJsonChangeCallbackType configC
     config.registerChangeCallback(configChangeCallback);
 }
 
+void RaftSysMod::configRegisterPathChangeCallback(const char* pPathPrefix, RaftJsonPathChangeCallbackType pathChangeCallback)
+{
+    config.registerPathChangeCallback(pPathPrefix, pathChangeCallback);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Save config data from JSON string
 /// @param configStr JSON string
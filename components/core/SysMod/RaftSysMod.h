@@ -134,6 +134,11 @@ public:
     virtual bool configGetArrayElems(const char *dataPath, std::vector<String>& strList) const;
     virtual void configRegisterChangeCallback(RaftJsonChangeCallbackType configChangeCallback);
 
+    /// @brief Register a callback for changes within a path of this module's configuration
+    /// @param pPathPrefix Path prefix relative to the module's config (e.g. "pubList") - empty for all of it
+    /// @param pathChangeCallback Callback receiving the changed paths (relative to the module's config)
+    virtual void configRegisterPathChangeCallback(const char* pPathPrefix, RaftJsonPathChangeCallbackType pathChangeCallback);
+
     /// @brief Get config interface
     /// @return Reference to the configuration interface
     virtual RaftJsonIF& configGetConfig()
@@ -231,6 +231,20 @@ bool SysTypeManager::setNonVolatileDocContents(const char* pJsonDoc)
     return rslt;
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Set the non-volatile document contents taking ownership of a buffer (avoids copying the document)
+/// @param jsonDoc buffer containing the JSON document (on return holds the previous document or is empty)
+bool SysTypeManager::setNonVolatileDocContents(RaftJsonDocBuffer& jsonDoc)
+{
+    // Set the non-volatile JSON document
+    bool rslt = _systemConfig.takeJsonDoc(jsonDoc);
+
+    // Select the best SysType because the non-volatile JSON document may have contained a SysType key
+    if (rslt)
+        selectBest();
+    return rslt;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// @brief Add REST API endpoints
 /// @param endpointManager endpoint manager
@@ -406,50 +420,31 @@ RaftRetCode SysTypeManager::apiSysTypePostSettings(const String &reqStr, String
 RaftRetCode SysTypeManager::apiSysTypePostSettingsBody(const String& reqStr, const uint8_t *pData, size_t len, 
                 size_t index, size_t total, const APISourceInfo& sourceInfo)
 {
-    if (len == total)
+    // Validate and assemble the document chunk by chunk (an invalid document is discarded at the first bad chunk)
+    RaftJsonChunkedDoc::ChunkResult chunkResult = _postSettingsDoc.addChunk(pData, len, index, total);
+    if (chunkResult == RaftJsonChunkedDoc::CHUNK_COMPLETE)
     {
-        // Form the JSON document
-        _postResultBuf.assign(pData, pData + len);
-        // Make sure it is null-terminated
-        if (_postResultBuf[_postResultBuf.size() - 1] != 0)
-            _postResultBuf.push_back(0);
-        // Store the settings from buffer and clear the buffer
-        _lastPostResultOk = setNonVolatileDocContents(_postResultBuf.data());
-        _postResultBuf.clear();
+        // Store the settings (the buffer is handed over without copying) and free the buffer
+        _lastPostResultOk = setNonVolatileDocContents(_postSettingsDoc.getDoc());
+        _postSettingsDoc.clear();
 #ifdef DEBUG_SYS_TYPE_MANAGER_API
-        LOG_I(MODULE_PREFIX, "apiSysTypePostSettingsBody oneblock rslt %s len %d index %d total %d curBufLen %d", 
-                    _lastPostResultOk ? "OK" : "FAIL", len, index, total, _postResultBuf.size());
+        LOG_I(MODULE_PREFIX, "apiSysTypePostSettingsBody complete rslt %s len %d index %d total %d", 
+                    _lastPostResultOk ? "OK" : "FAIL", len, index, total);
 #endif
-        return RAFT_OK;
     }
-
-    // Check if first block
-    if (index == 0)
-        _postResultBuf.clear();
-
-    // Append to the existing buffer
-    _postResultBuf.insert(_postResultBuf.end(), pData, pData+len);
-
-    // Check for complete
-    if (_postResultBuf.size() == total)
+    else if (chunkResult == RaftJsonChunkedDoc::CHUNK_ERROR)
     {
-        // Check the buffer is null-terminated
-        if (_postResultBuf[_postResultBuf.size() - 1] != 0)
-            _postResultBuf.push_back(0);
-
-        // Store the settings from buffer and clear the buffer
-        _lastPostResultOk = setNonVolatileDocContents(_postResultBuf.data());
-        _postResultBuf.clear();
+        _lastPostResultOk = false;
 #ifdef DEBUG_SYS_TYPE_MANAGER_API
-        LOG_I(MODULE_PREFIX, "apiSysTypePostSettingsBody multiblock rslt %s len %d index %d total %d", 
-                    _lastPostResultOk ? "OK" : "FAIL", len, index, total);
+        LOG_I(MODULE_PREFIX, "apiSysTypePostSettingsBody invalid JSON at pos %d len %d index %d total %d", 
+                    _postSettingsDoc.getErrorPos(), len, index, total);
 #endif
     }
     else
     {
 #ifdef DEBUG_SYS_TYPE_MANAGER_API
-        LOG_I(MODULE_PREFIX, "apiSysTypePostSettingsBody partial len %d index %d total %d curBufLen %d", 
-            len, index, total, _postResultBuf.size());
+        LOG_I(MODULE_PREFIX, "apiSysTypePostSettingsBody partial len %d index %d total %d", 
+                    len, index, total);
 #endif
     }
     return RAFT_OK;
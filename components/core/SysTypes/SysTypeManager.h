@@ -11,7 +11,7 @@
 
 #include "SysTypeInfoRec.h"
 #include "RaftJson.h"
-#include "SpiramAwareAllocator.h"
+#include "RaftJsonChunkedDoc.h"
 #include "RaftRetCode.h"
 
 class RestAPIEndpointManager;
@@ -96,6 +96,12 @@ public:
     ///       override configuration settings
     bool setNonVolatileDocContents(const char* pJsonDoc);
 
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// @brief Set the non-volatile document contents taking ownership of a buffer (avoids copying the document)
+    /// @param jsonDoc buffer containing the JSON document (on return holds the previous document or is empty)
+    /// @return bool true if the JSON document was successfully set
+    bool setNonVolatileDocContents(RaftJsonDocBuffer& jsonDoc);
+
     /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// @brief Add REST API endpoints
     /// @param endpointManager endpoint manager
@@ -120,7 +126,9 @@ private:
 
     // Last post result ok
     bool _lastPostResultOk = false;
-    std::vector<char, SpiramAwareAllocator<char>> _postResultBuf;
+
+    // Settings document being posted (validated as each chunk arrives)
+    RaftJsonChunkedDoc _postSettingsDoc;
 
     // System reset callback
     std::function<void()> _systemRestartCallback = nullptr;
@@ -11,6 +11,7 @@
 
 #include <queue>
 #include "RaftThreading.h"
+#include "RaftArduino.h"
 
 template<typename ElemT>
 class ThreadSafeQueue
@@ -25,6 +26,11 @@ public:
 
     virtual ~ThreadSafeQueue()
     {
+        if (_condVarsCreated)
+        {
+            RaftCondVar_destroy(_notFull);
+            RaftCondVar_destroy(_notEmpty);
+        }
         RaftMutex_destroy(_queueMutex);
     }
 
@@ -48,6 +54,8 @@ public:
 
             // Queue up the item
             _queue.push(elem);
+            if (_condVarsCreated)
+                RaftCondVar_signal(_notEmpty);
 
             // Return mutex
             RaftMutex_unlock(_queueMutex);
@@ -56,6 +64,30 @@ public:
         return false;
     }
 
+    /// @brief Put an element, blocking while the queue is full
+    /// @param elem element to put
+    /// @param maxMsToWait maximum time to wait for space (0 doesn't block, RAFT_WAIT_FOREVER waits indefinitely)
+    /// @return true if the element was queued
+    bool putBlocking(const ElemT& elem, uint32_t maxMsToWait)
+    {
+        if (!RaftMutex_lock(_queueMutex, maxMsToWait))
+            return false;
+        createCondVars();
+        uint32_t startMs = millis();
+        while (_queue.size() >= _maxLen)
+        {
+            if (!waitOn(_notFull, startMs, maxMsToWait))
+            {
+                RaftMutex_unlock(_queueMutex);
+                return false;
+            }
+        }
+        _queue.push(elem);
+        RaftCondVar_signal(_notEmpty);
+        RaftMutex_unlock(_queueMutex);
+        return true;
+    }
+
     bool get(ElemT& elem, uint32_t maxMsToWait = 0)
     {
         // Get Mutex
@@ -71,6 +103,8 @@ public:
             // read the item and remove
             elem = _queue.front();
             _queue.pop();
+            if (_condVarsCreated)
+                RaftCondVar_signal(_notFull);
 
             // Return mutex
             RaftMutex_unlock(_queueMutex);
@@ -79,6 +113,31 @@ public:
         return false;
     }
 
+    /// @brief Get an element, blocking while the queue is empty
+    /// @param elem element to receive
+    /// @param maxMsToWait maximum time to wait for an element (0 doesn't block, RAFT_WAIT_FOREVER waits indefinitely)
+    /// @return true if an element was received
+    bool getBlocking(ElemT& elem, uint32_t maxMsToWait)
+    {
+        if (!RaftMutex_lock(_queueMutex, maxMsToWait))
+            return false;
+        createCondVars();
+        uint32_t startMs = millis();
+        while (_queue.empty())
+        {
+            if (!waitOn(_notEmpty, startMs, maxMsToWait))
+            {
+                RaftMutex_unlock(_queueMutex);
+                return false;
+            }
+        }
+        elem = _queue.front();
+        _queue.pop();
+        RaftCondVar_signal(_notFull);
+        RaftMutex_unlock(_queueMutex);
+        return true;
+    }
+
     bool peek(ElemT& elem, uint32_t maxMsToWait = 0)
     {
         // Get Mutex
@@ -108,6 +167,8 @@ public:
             // Clear queue
             while(!_queue.empty())
                 _queue.pop();
+            if (_condVarsCreated)
+                RaftCondVar_broadcast(_notFull);
 
             // Return mutex
             RaftMutex_unlock(_queueMutex);
@@ -143,4 +204,35 @@ private:
     static const uint16_t DEFAULT_MAX_MS_TO_WAIT = 1;
     // Mutex for queue
     RaftMutex _queueMutex;
+
+    // Condition variables for blocking get/put (waited on with the mutex held) - only created when first
+    // needed as most queues are polled and each is a kernel object on FreeRTOS
+    RaftCondVar _notEmpty;
+    RaftCondVar _notFull;
+    bool _condVarsCreated = false;
+
+    // Create condition variables (mutex must be held)
+    void createCondVars()
+    {
+        if (_condVarsCreated)
+            return;
+        RaftCondVar_init(_notEmpty);
+        RaftCondVar_init(_notFull);
+        _condVarsCreated = true;
+    }
+
+    // Wait on a condition variable for the remainder of the timeout (false if the timeout has expired)
+    bool waitOn(RaftCondVar& condVar, uint32_t startMs, uint32_t maxMsToWait)
+    {
+        uint32_t waitMs = RAFT_WAIT_FOREVER;
+        if (maxMsToWait != RAFT_WAIT_FOREVER)
+        {
+            uint32_t elapsedMs = millis() - startMs;
+            if (elapsedMs >= maxMsToWait)
+                return false;
+            waitMs = maxMsToWait - elapsedMs;
+        }
+        RaftCondVar_wait(condVar, _queueMutex, waitMs);
+        return true;
+    }
 };
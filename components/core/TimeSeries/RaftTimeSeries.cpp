@@ -0,0 +1,449 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftTimeSeries
+// Compressed time-series storage with downsampling queries
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include "RaftTimeSeries.h"
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor
+/// @param maxBytes maximum memory used for compressed data
+/// @param blockSizeBytes size of each compressed block
+RaftTimeSeries::RaftTimeSeries(uint32_t maxBytes, uint32_t blockSizeBytes)
+{
+    setup(maxBytes, blockSizeBytes);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Setup (clears existing data)
+/// @param maxBytes maximum memory used for compressed data
+/// @param blockSizeBytes size of each compressed block
+void RaftTimeSeries::setup(uint32_t maxBytes, uint32_t blockSizeBytes)
+{
+    clear();
+    _blockSizeBytes = blockSizeBytes < MIN_BLOCK_SIZE_BYTES ? MIN_BLOCK_SIZE_BYTES : blockSizeBytes;
+    _maxBytes = maxBytes < _blockSizeBytes ? _blockSizeBytes : maxBytes;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Clear all data
+void RaftTimeSeries::clear()
+{
+    _blocks.clear();
+    _totalCount = 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Add a sample
+/// @param timeUs timestamp in us (must not be earlier than the previous sample)
+/// @param value value
+/// @return true if added
+bool RaftTimeSeries::add(uint64_t timeUs, double value)
+{
+    // Check time is monotonic
+    if (!_blocks.empty() && (timeUs < _blocks.back().lastTimeUs))
+        return false;
+
+    // Try to add to the current block
+    if (!_blocks.empty() && encodeSample(_blocks.back(), timeUs, value))
+    {
+        _totalCount++;
+        return true;
+    }
+
+    // Discard oldest blocks if needed to make space for a new one
+    while (!_blocks.empty() && ((_blocks.size() + 1) * _blockSizeBytes > _maxBytes))
+    {
+        _totalCount -= _blocks.front().count;
+        _blocks.pop_front();
+    }
+
+    // Start a new block
+    _blocks.emplace_back();
+    Block& block = _blocks.back();
+    block.data.resize(_blockSizeBytes);
+    if (!encodeSample(block, timeUs, value))
+    {
+        _blocks.pop_back();
+        return false;
+    }
+    _totalCount++;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Query raw samples in a time range (inclusive)
+/// @param startTimeUs start of range
+/// @param endTimeUs end of range
+/// @param sampleCB callback for each sample
+/// @return number of samples passed to the callback
+uint32_t RaftTimeSeries::query(uint64_t startTimeUs, uint64_t endTimeUs, SampleCB sampleCB) const
+{
+    uint32_t numSamples = 0;
+    bool stopped = false;
+    for (const Block& block : _blocks)
+    {
+        if ((block.lastTimeUs < startTimeUs) || (block.firstTimeUs > endTimeUs))
+            continue;
+        numSamples += decodeBlock(block, startTimeUs, endTimeUs,
+            [&](uint64_t timeUs, double value) {
+                if (!sampleCB(timeUs, value))
+                {
+                    stopped = true;
+                    return false;
+                }
+                return true;
+            });
+        if (stopped)
+            break;
+    }
+    return numSamples;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Query downsampled buckets (min/max/mean) in a time range (inclusive)
+/// @param startTimeUs start of range
+/// @param endTimeUs end of range
+/// @param bucketUs width of each bucket in us (0 for a single bucket covering the whole range)
+/// @param buckets (out) buckets - empty buckets are omitted
+/// @param maxBuckets maximum number of buckets (bucket width is increased if required)
+void RaftTimeSeries::queryBuckets(uint64_t startTimeUs, uint64_t endTimeUs, uint64_t bucketUs,
+            std::vector<Bucket>& buckets, uint32_t maxBuckets) const
+{
+    buckets.clear();
+    if ((endTimeUs < startTimeUs) || _blocks.empty())
+        return;
+
+    // Clamp range to the data held
+    if (startTimeUs < getFirstTimeUs())
+        startTimeUs = getFirstTimeUs();
+    if (endTimeUs > getLastTimeUs())
+        endTimeUs = getLastTimeUs();
+    if (endTimeUs < startTimeUs)
+        return;
+
+    // Bucket width
+    uint64_t rangeUs = endTimeUs - startTimeUs + 1;
+    if (maxBuckets == 0)
+        maxBuckets = 1;
+    if ((bucketUs == 0) || (bucketUs > rangeUs))
+        bucketUs = rangeUs;
+    if (rangeUs / bucketUs >= maxBuckets)
+        bucketUs = (rangeUs + maxBuckets - 1) / maxBuckets;
+
+    // Add a sample (or block summary) to the bucket containing timeUs
+    auto addToBuckets = [&](uint64_t timeUs, uint32_t count, double minVal, double maxVal, double sumVal) {
+        uint64_t bucketStartUs = startTimeUs + ((timeUs - startTimeUs) / bucketUs) * bucketUs;
+        if (buckets.empty() || (buckets.back().startTimeUs != bucketStartUs))
+        {
+            buckets.emplace_back();
+            buckets.back().startTimeUs = bucketStartUs;
+        }
+        addToBucket(buckets.back(), count, minVal, maxVal, sumVal);
+    };
+
+    for (const Block& block : _blocks)
+    {
+        if ((block.lastTimeUs < startTimeUs) || (block.firstTimeUs > endTimeUs))
+            continue;
+
+        // Use the block summary if the whole block is inside the range and in a single bucket
+        if ((block.firstTimeUs >= startTimeUs) && (block.lastTimeUs <= endTimeUs) &&
+                ((block.firstTimeUs - startTimeUs) / bucketUs == (block.lastTimeUs - startTimeUs) / bucketUs))
+        {
+            addToBuckets(block.firstTimeUs, block.count, block.minVal, block.maxVal, block.sumVal);
+            continue;
+        }
+
+        // Decode samples
+        decodeBlock(block, startTimeUs, endTimeUs,
+            [&](uint64_t timeUs, double value) {
+                addToBuckets(timeUs, 1, value, value, value);
+                return true;
+            });
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get memory used by compressed data (bytes)
+/// @return bytes used
+uint32_t RaftTimeSeries::getBytesUsed() const
+{
+    uint32_t bytesUsed = 0;
+    for (const Block& block : _blocks)
+        bytesUsed += block.data.size();
+    return bytesUsed;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Encode a sample into a block
+/// @param block block to add to
+/// @param timeUs timestamp in us
+/// @param value value
+/// @return true if encoded (false if the block is full or the timestamp delta is too large)
+bool RaftTimeSeries::encodeSample(Block& block, uint64_t timeUs, double value)
+{
+    // Check space for a worst case sample
+    if (block.bitPos + MAX_SAMPLE_BITS > block.data.size() * 8)
+        return false;
+
+    CodecState& state = block.encState;
+    uint64_t valBits = doubleToBits(value);
+
+    // First sample in block is stored uncompressed
+    if (block.count == 0)
+    {
+        writeBits(block, timeUs, 64);
+        writeBits(block, valBits, 64);
+        block.firstTimeUs = timeUs;
+        block.minVal = value;
+        block.maxVal = value;
+        block.sumVal = 0;
+    }
+    else
+    {
+        // Timestamp delta-of-delta
+        int64_t deltaUs = (int64_t)(timeUs - state.prevTimeUs);
+        int64_t dod = deltaUs - state.prevDeltaUs;
+        if ((dod < INT32_MIN) || (dod > INT32_MAX))
+            return false;
+        if (dod == 0)
+            writeBits(block, 0, 1);
+        else if ((dod >= -64) && (dod <= 63))
+        {
+            writeBits(block, 0b10, 2);
+            writeBits(block, dod, 7);
+        }
+        else if ((dod >= -256) && (dod <= 255))
+        {
+            writeBits(block, 0b110, 3);
+            writeBits(block, dod, 9);
+        }
+        else if ((dod >= -2048) && (dod <= 2047))
+        {
+            writeBits(block, 0b1110, 4);
+            writeBits(block, dod, 12);
+        }
+        else if ((dod >= -524288) && (dod <= 524287))
+        {
+            writeBits(block, 0b11110, 5);
+            writeBits(block, dod, 20);
+        }
+        else
+        {
+            writeBits(block, 0b11111, 5);
+            writeBits(block, dod, 32);
+        }
+        state.prevDeltaUs = deltaUs;
+
+        // Value XOR with previous
+        uint64_t xorVal = valBits ^ state.prevValBits;
+        if (xorVal == 0)
+        {
+            writeBits(block, 0, 1);
+        }
+        else
+        {
+            uint32_t leading = countLeadingZeros(xorVal);
+            uint32_t trailing = countTrailingZeros(xorVal);
+            if (leading > 31)
+                leading = 31;
+            if ((block.count > 1) && (leading >= state.prevLeading) && (trailing >= state.prevTrailing))
+            {
+                // Fits in previous window
+                writeBits(block, 0b10, 2);
+                uint32_t sigBits = 64 - state.prevLeading - state.prevTrailing;
+                writeBits(block, xorVal >> state.prevTrailing, sigBits);
+            }
+            else
+            {
+                // New window
+                uint32_t sigBits = 64 - leading - trailing;
+                writeBits(block, 0b11, 2);
+                writeBits(block, leading, 5);
+                writeBits(block, sigBits & 0x3f, 6);
+                writeBits(block, xorVal >> trailing, sigBits);
+                state.prevLeading = leading;
+                state.prevTrailing = trailing;
+            }
+        }
+
+        // Update summary
+        if (value < block.minVal)
+            block.minVal = value;
+        if (value > block.maxVal)
+            block.maxVal = value;
+    }
+
+    // Update state
+    state.prevTimeUs = timeUs;
+    state.prevValBits = valBits;
+    block.lastTimeUs = timeUs;
+    block.sumVal += value;
+    block.count++;
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Decode samples from a block
+/// @param block block to decode
+/// @param startTimeUs start of range
+/// @param endTimeUs end of range
+/// @param sampleCB callback for each sample in range
+/// @return number of samples passed to the callback
+uint32_t RaftTimeSeries::decodeBlock(const Block& block, uint64_t startTimeUs, uint64_t endTimeUs, SampleCB sampleCB) const
+{
+    if (block.count == 0)
+        return 0;
+    uint32_t bitPos = 0;
+    CodecState state;
+    uint32_t numSamples = 0;
+    for (uint32_t sampleIdx = 0; sampleIdx < block.count; sampleIdx++)
+    {
+        if (sampleIdx == 0)
+        {
+            state.prevTimeUs = readBits(block, bitPos, 64);
+            state.prevValBits = readBits(block, bitPos, 64);
+        }
+        else
+        {
+            // Timestamp
+            uint32_t prefixLen = 0;
+            while ((prefixLen < 5) && readBits(block, bitPos, 1))
+                prefixLen++;
+            static const uint8_t DOD_BITS[] = {0, 7, 9, 12, 20, 32};
+            int64_t dod = 0;
+            uint32_t dodBits = DOD_BITS[prefixLen];
+            if (dodBits > 0)
+            {
+                uint64_t raw = readBits(block, bitPos, dodBits);
+                // Sign extend
+                dod = (int64_t)(raw << (64 - dodBits)) >> (64 - dodBits);
+            }
+            state.prevDeltaUs += dod;
+            state.prevTimeUs += state.prevDeltaUs;
+
+            // Value
+            if (readBits(block, bitPos, 1))
+            {
+                if (readBits(block, bitPos, 1))
+                {
+                    state.prevLeading = readBits(block, bitPos, 5);
+                    uint32_t sigBits = readBits(block, bitPos, 6);
+                    if (sigBits == 0)
+                        sigBits = 64;
+                    state.prevTrailing = 64 - state.prevLeading - sigBits;
+                }
+                uint32_t sigBits = 64 - state.prevLeading - state.prevTrailing;
+                state.prevValBits ^= readBits(block, bitPos, sigBits) << state.prevTrailing;
+            }
+        }
+
+        // Check range
+        if (state.prevTimeUs > endTimeUs)
+            break;
+        if (state.prevTimeUs >= startTimeUs)
+        {
+            numSamples++;
+            if (!sampleCB(state.prevTimeUs, bitsToDouble(state.prevValBits)))
+                break;
+        }
+    }
+    return numSamples;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Write bits to a block (MSB first)
+/// @param block block to write to
+/// @param val value (lowest numBits are written)
+/// @param numBits number of bits (1..64)
+void RaftTimeSeries::writeBits(Block& block, uint64_t val, uint32_t numBits)
+{
+    uint8_t* pData = block.data.data();
+    while (numBits > 0)
+    {
+        uint32_t byteIdx = block.bitPos / 8;
+        uint32_t bitInByte = block.bitPos % 8;
+        uint32_t bitsFree = 8 - bitInByte;
+        uint32_t bitsToWrite = numBits < bitsFree ? numBits : bitsFree;
+        uint8_t chunk = (val >> (numBits - bitsToWrite)) & ((1u << bitsToWrite) - 1);
+        if (bitInByte == 0)
+            pData[byteIdx] = 0;
+        pData[byteIdx] |= chunk << (bitsFree - bitsToWrite);
+        block.bitPos += bitsToWrite;
+        numBits -= bitsToWrite;
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Read bits from a block (MSB first)
+/// @param block block to read from
+/// @param bitPos (in/out) bit position
+/// @param numBits number of bits (1..64)
+/// @return value
+uint64_t RaftTimeSeries::readBits(const Block& block, uint32_t& bitPos, uint32_t numBits)
+{
+    const uint8_t* pData = block.data.data();
+    uint64_t val = 0;
+    while (numBits > 0)
+    {
+        uint32_t byteIdx = bitPos / 8;
+        uint32_t bitInByte = bitPos % 8;
+        uint32_t bitsAvail = 8 - bitInByte;
+        uint32_t bitsToRead = numBits < bitsAvail ? numBits : bitsAvail;
+        uint8_t chunk = (pData[byteIdx] >> (bitsAvail - bitsToRead)) & ((1u << bitsToRead) - 1);
+        val = (val << bitsToRead) | chunk;
+        bitPos += bitsToRead;
+        numBits -= bitsToRead;
+    }
+    return val;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+uint64_t RaftTimeSeries::doubleToBits(double val)
+{
+    uint64_t bits = 0;
+    memcpy(&bits, &val, sizeof(bits));
+    return bits;
+}
+
+double RaftTimeSeries::bitsToDouble(uint64_t bits)
+{
+    double val = 0;
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+}
+
+uint32_t RaftTimeSeries::countLeadingZeros(uint64_t val)
+{
+    return val == 0 ? 64 : __builtin_clzll(val);
+}
+
+uint32_t RaftTimeSeries::countTrailingZeros(uint64_t val)
+{
+    return val == 0 ? 64 : __builtin_ctzll(val);
+}
+
+void RaftTimeSeries::addToBucket(Bucket& bucket, uint32_t count, double minVal, double maxVal, double sumVal)
+{
+    if (bucket.count == 0)
+    {
+        bucket.minVal = minVal;
+        bucket.maxVal = maxVal;
+    }
+    else
+    {
+        if (minVal < bucket.minVal)
+            bucket.minVal = minVal;
+        if (maxVal > bucket.maxVal)
+            bucket.maxVal = maxVal;
+    }
+    bucket.count += count;
+    bucket.sumVal += sumVal;
+}
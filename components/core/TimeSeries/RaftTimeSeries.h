@@ -0,0 +1,163 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftTimeSeries
+// Compressed time-series storage with downsampling queries
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <list>
+#include <vector>
+#include <functional>
+#include "RaftArduino.h"
+#include "SpiramAwareAllocator.h"
+
+/*
+ * RaftTimeSeries
+ *
+ * Stores (timestamp, value) samples in fixed size blocks using Gorilla-style compression:
+ * - timestamps are stored as delta-of-delta in variable length bit fields
+ * - values are stored as the XOR with the previous value using leading/trailing zero windows
+ * Block memory is allocated using the SpiramAwareAllocator so PSRAM is used when available
+ * When the maximum memory is reached the oldest block is discarded
+ *
+ * Each block also keeps a summary (count, min, max, sum) so that downsampling queries over
+ * long ranges don't need to decode every sample
+ */
+
+class RaftTimeSeries
+{
+public:
+    /// @brief Downsampled bucket result
+    struct Bucket
+    {
+        uint64_t startTimeUs = 0;
+        uint32_t count = 0;
+        double minVal = 0;
+        double maxVal = 0;
+        double sumVal = 0;
+        double getMean() const
+        {
+            return count == 0 ? 0 : sumVal / count;
+        }
+    };
+
+    /// @brief Sample callback type for raw queries
+    /// @return false to stop the query
+    typedef std::function<bool(uint64_t timeUs, double value)> SampleCB;
+
+    /// @brief Constructor
+    /// @param maxBytes maximum memory used for compressed data
+    /// @param blockSizeBytes size of each compressed block
+    RaftTimeSeries(uint32_t maxBytes = DEFAULT_MAX_BYTES, uint32_t blockSizeBytes = DEFAULT_BLOCK_SIZE_BYTES);
+
+    /// @brief Setup (clears existing data)
+    /// @param maxBytes maximum memory used for compressed data
+    /// @param blockSizeBytes size of each compressed block
+    void setup(uint32_t maxBytes, uint32_t blockSizeBytes);
+
+    /// @brief Clear all data
+    void clear();
+
+    /// @brief Add a sample
+    /// @param timeUs timestamp in us (must not be earlier than the previous sample)
+    /// @param value value
+    /// @return true if added
+    bool add(uint64_t timeUs, double value);
+
+    /// @brief Query raw samples in a time range (inclusive)
+    /// @param startTimeUs start of range
+    /// @param endTimeUs end of range
+    /// @param sampleCB callback for each sample
+    /// @return number of samples passed to the callback
+    uint32_t query(uint64_t startTimeUs, uint64_t endTimeUs, SampleCB sampleCB) const;
+
+    /// @brief Query downsampled buckets (min/max/mean) in a time range (inclusive)
+    /// @param startTimeUs start of range
+    /// @param endTimeUs end of range
+    /// @param bucketUs width of each bucket in us (0 for a single bucket covering the whole range)
+    /// @param buckets (out) buckets - empty buckets are omitted
+    /// @param maxBuckets maximum number of buckets (bucket width is increased if required)
+    void queryBuckets(uint64_t startTimeUs, uint64_t endTimeUs, uint64_t bucketUs,
+                std::vector<Bucket>& buckets, uint32_t maxBuckets = DEFAULT_MAX_BUCKETS) const;
+
+    /// @brief Get number of samples stored
+    uint32_t count() const
+    {
+        return _totalCount;
+    }
+
+    /// @brief Get memory used by compressed data (bytes)
+    uint32_t getBytesUsed() const;
+
+    /// @brief Get time of oldest sample
+    uint64_t getFirstTimeUs() const
+    {
+        return _blocks.empty() ? 0 : _blocks.front().firstTimeUs;
+    }
+
+    /// @brief Get time of newest sample
+    uint64_t getLastTimeUs() const
+    {
+        return _blocks.empty() ? 0 : _blocks.back().lastTimeUs;
+    }
+
+    // Defaults
+    static const uint32_t DEFAULT_MAX_BYTES = 8192;
+    static const uint32_t DEFAULT_BLOCK_SIZE_BYTES = 256;
+    static const uint32_t DEFAULT_MAX_BUCKETS = 500;
+    static const uint32_t MIN_BLOCK_SIZE_BYTES = 64;
+
+private:
+    // Compression state (shared by encoder and decoder)
+    struct CodecState
+    {
+        uint64_t prevTimeUs = 0;
+        int64_t prevDeltaUs = 0;
+        uint64_t prevValBits = 0;
+        uint8_t prevLeading = 0;
+        uint8_t prevTrailing = 0;
+    };
+
+    // Compressed block
+    struct Block
+    {
+        SpiramAwareUint8Vector data;
+        uint32_t bitPos = 0;
+        uint32_t count = 0;
+        uint64_t firstTimeUs = 0;
+        uint64_t lastTimeUs = 0;
+        double minVal = 0;
+        double maxVal = 0;
+        double sumVal = 0;
+        CodecState encState;
+    };
+
+    // Blocks (oldest first)
+    std::list<Block> _blocks;
+
+    // Settings
+    uint32_t _maxBytes = DEFAULT_MAX_BYTES;
+    uint32_t _blockSizeBytes = DEFAULT_BLOCK_SIZE_BYTES;
+
+    // Total sample count
+    uint32_t _totalCount = 0;
+
+    // Worst case size of a sample (bits) - 5 + 32 bits timestamp and 2 + 5 + 6 + 64 bits value
+    static const uint32_t MAX_SAMPLE_BITS = 114;
+
+    // Helpers
+    bool encodeSample(Block& block, uint64_t timeUs, double value);
+    uint32_t decodeBlock(const Block& block, uint64_t startTimeUs, uint64_t endTimeUs, SampleCB sampleCB) const;
+    static void writeBits(Block& block, uint64_t val, uint32_t numBits);
+    static uint64_t readBits(const Block& block, uint32_t& bitPos, uint32_t numBits);
+    static uint64_t doubleToBits(double val);
+    static double bitsToDouble(uint64_t bits);
+    static uint32_t countLeadingZeros(uint64_t val);
+    static uint32_t countTrailingZeros(uint64_t val);
+    static void addToBucket(Bucket& bucket, uint32_t count, double minVal, double maxVal, double sumVal);
+};
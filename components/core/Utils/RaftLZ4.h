@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftLZ4
+// Decompression of LZ4 block format data with an optional dictionary
+// (compressed data is produced by scripts/DevTypeRecordCompressor.py)
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+class RaftLZ4
+{
+public:
+    /// @brief Decompress a block
+    /// @param pSrc compressed data
+    /// @param srcLen compressed length
+    /// @param pDst output buffer
+    /// @param dstMaxLen size of output buffer
+    /// @param pDict dictionary (history preceding the block) - may be nullptr
+    /// @param dictLen dictionary length
+    /// @return decompressed length or -1 if the data is invalid or doesn't fit
+    static int32_t decompress(const uint8_t* pSrc, uint32_t srcLen, uint8_t* pDst, uint32_t dstMaxLen,
+                const uint8_t* pDict = nullptr, uint32_t dictLen = 0)
+    {
+        const uint8_t* pSrcEnd = pSrc + srcLen;
+        uint32_t dstPos = 0;
+        while (pSrc < pSrcEnd)
+        {
+            // Token
+            uint32_t token = *pSrc++;
+
+            // Literals
+            uint32_t litLen = token >> 4;
+            if ((litLen == 15) && !getExtLen(pSrc, pSrcEnd, litLen))
+                return -1;
+            if ((litLen > (uint32_t)(pSrcEnd - pSrc)) || (litLen > dstMaxLen - dstPos))
+                return -1;
+            memcpy(pDst + dstPos, pSrc, litLen);
+            pSrc += litLen;
+            dstPos += litLen;
+
+            // Last sequence has literals only
+            if (pSrc >= pSrcEnd)
+                break;
+
+            // Match offset and length
+            if (pSrcEnd - pSrc < 2)
+                return -1;
+            uint32_t offset = pSrc[0] | (pSrc[1] << 8);
+            pSrc += 2;
+            uint32_t matchLen = token & 0x0f;
+            if ((matchLen == 15) && !getExtLen(pSrc, pSrcEnd, matchLen))
+                return -1;
+            matchLen += MIN_MATCH;
+            if ((offset == 0) || (offset > dstPos + dictLen) || (matchLen > dstMaxLen - dstPos))
+                return -1;
+
+            // Copy from the dictionary if the match starts before the output
+            if (offset > dstPos)
+            {
+                uint32_t dictOffset = offset - dstPos;
+                uint32_t dictCopyLen = dictOffset < matchLen ? dictOffset : matchLen;
+                memcpy(pDst + dstPos, pDict + dictLen - dictOffset, dictCopyLen);
+                dstPos += dictCopyLen;
+                matchLen -= dictCopyLen;
+            }
+
+            // Copy from output (byte by byte as the match may overlap)
+            const uint8_t* pMatch = pDst + dstPos - offset;
+            for (uint32_t i = 0; i < matchLen; i++)
+                pDst[dstPos + i] = pMatch[i];
+            dstPos += matchLen;
+        }
+        return dstPos;
+    }
+
+private:
+    static const uint32_t MIN_MATCH = 4;
+
+    // Extended length bytes (each 255 means more follow)
+    static bool getExtLen(const uint8_t*& pSrc, const uint8_t* pSrcEnd, uint32_t& len)
+    {
+        while (pSrc < pSrcEnd)
+        {
+            uint32_t val = *pSrc++;
+            len += val;
+            if (val != 255)
+                return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,109 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftProfileZones
+// Low-overhead scoped profiling zones based on the CPU cycle counter
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "RaftProfileZones.h"
+
+#ifdef RAFT_PROFILE_ZONES_ENABLED
+
+#include "RaftUtils.h"
+#ifdef ESP_PLATFORM
+#include "esp_private/esp_clk.h"
+#endif
+
+std::atomic<RaftProfileZone*> RaftProfileZones::_pFirstZone(nullptr);
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Constructor
+RaftProfileZone::RaftProfileZone(const char* pName) :
+    _pName(pName)
+{
+    RaftProfileZones::registerZone(this);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Register a zone
+/// @param pZone zone to register
+/// @note lock-free push onto the head of the registry list - zones are function statics so may be
+///       constructed concurrently from different tasks
+void RaftProfileZones::registerZone(RaftProfileZone* pZone)
+{
+    RaftProfileZone* pHead = _pFirstZone.load(std::memory_order_relaxed);
+    do
+    {
+        pZone->_pNext = pHead;
+    } while (!_pFirstZone.compare_exchange_weak(pHead, pZone, std::memory_order_release, std::memory_order_relaxed));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get JSON report of all zones
+/// @return JSON string
+String RaftProfileZones::getJSON()
+{
+    uint32_t cyclesPerUs = getCyclesPerUs();
+    String jsonStr = "{\"cpuMHz\":" + String(cyclesPerUs) + ",\"zones\":[";
+    bool isFirst = true;
+    for (RaftProfileZone* pZone = _pFirstZone.load(std::memory_order_acquire); pZone; pZone = pZone->_pNext)
+    {
+        // Snapshot counters
+        uint32_t callCount = pZone->_callCount.load(std::memory_order_relaxed);
+        uint64_t totalCycles = pZone->getTotalCycles();
+        uint32_t maxCycles = pZone->_maxCycles.load(std::memory_order_relaxed);
+        char zoneJson[200];
+        snprintf(zoneJson, sizeof(zoneJson), R"(%s{"n":"%s","c":%u,"totUs":%llu,"avgUs":%.2f,"maxUs":%.2f})",
+                    isFirst ? "" : ",",
+                    pZone->_pName,
+                    (unsigned)callCount,
+                    (unsigned long long)(totalCycles / cyclesPerUs),
+                    callCount == 0 ? 0.0 : (double)totalCycles / cyclesPerUs / callCount,
+                    (double)maxCycles / cyclesPerUs);
+        jsonStr += zoneJson;
+        isFirst = false;
+    }
+    jsonStr += "]}";
+    return jsonStr;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Clear counters in all zones
+void RaftProfileZones::clearAll()
+{
+    for (RaftProfileZone* pZone = _pFirstZone.load(std::memory_order_acquire); pZone; pZone = pZone->_pNext)
+        pZone->clear();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// @brief Get the number of cycle counter ticks per microsecond
+/// @return ticks per microsecond
+uint32_t RaftProfileZones::getCyclesPerUs()
+{
+#ifdef ESP_PLATFORM
+    return esp_clk_cpu_freq() / 1000000;
+#elif defined(__x86_64__) || defined(__i386__)
+    // TSC rate is not directly available so calibrate once against the monotonic clock
+    static uint32_t cyclesPerUs = 0;
+    if (cyclesPerUs == 0)
+    {
+        uint64_t startUs = micros();
+        uint32_t startCycles = RaftProfileZone::getCycles();
+        while (micros() - startUs < 10000)
+            ;
+        uint32_t elapsedCycles = RaftProfileZone::getCycles() - startCycles;
+        uint64_t elapsedUs = micros() - startUs;
+        cyclesPerUs = elapsedUs == 0 ? 1 : (uint32_t)(elapsedCycles / elapsedUs);
+        if (cyclesPerUs == 0)
+            cyclesPerUs = 1;
+    }
+    return cyclesPerUs;
+#else
+    // Cycles are nanoseconds from clock_gettime
+    return 1000;
+#endif
+}
+
+#endif // RAFT_PROFILE_ZONES_ENABLED
@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftProfileZones
+// Low-overhead scoped profiling zones based on the CPU cycle counter
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include "RaftArduino.h"
+
+// Profiling zones are only compiled in when RAFT_PROFILE_ZONES_ENABLED is defined (e.g. by setting
+// RAFT_PROFILE_ZONES_ENABLED in the project CMakeLists.txt) - otherwise RAFT_PROFILE_ZONE() expands to nothing
+
+#ifdef RAFT_PROFILE_ZONES_ENABLED
+
+#include <atomic>
+#ifdef ESP_PLATFORM
+#include "esp_idf_version.h"
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#include "esp_cpu.h"
+#else
+#include <xtensa/hal.h>
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+/// @brief Profiling zone - statically allocated at the point of use and registered on first use
+class RaftProfileZone
+{
+public:
+    /// @brief Constructor
+    /// @param pName zone name (must be a string literal or otherwise have static lifetime)
+    RaftProfileZone(const char* pName);
+
+    /// @brief Read the CPU cycle counter
+    /// @return cycle count (on ESP32 this is a 32-bit counter so differences must be taken modulo 2^32)
+    static inline uint32_t getCycles()
+    {
+#ifdef ESP_PLATFORM
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+        return esp_cpu_get_cycle_count();
+#else
+        return xthal_get_ccount();
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+        return (uint32_t)__rdtsc();
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+#endif
+    }
+
+    /// @brief Record a completed call
+    /// @param elapsedCycles cycles spent in the zone
+    /// @note Zones may be entered concurrently from several tasks (and cores) so counters are relaxed atomics
+    inline void record(uint32_t elapsedCycles)
+    {
+        _callCount.fetch_add(1, std::memory_order_relaxed);
+        uint32_t prevCycles = _totalCyclesLow.fetch_add(elapsedCycles, std::memory_order_relaxed);
+        if ((uint32_t)(prevCycles + elapsedCycles) < prevCycles)
+            _totalCyclesHigh.fetch_add(1, std::memory_order_relaxed);
+        uint32_t maxCycles = _maxCycles.load(std::memory_order_relaxed);
+        while ((maxCycles < elapsedCycles) &&
+                    !_maxCycles.compare_exchange_weak(maxCycles, elapsedCycles, std::memory_order_relaxed))
+            ;
+    }
+
+    /// @brief Get total cycles recorded
+    /// @return 64-bit total
+    uint64_t getTotalCycles() const
+    {
+        // Retry if the low word wraps while reading
+        uint32_t high, low;
+        do
+        {
+            high = _totalCyclesHigh.load(std::memory_order_relaxed);
+            low = _totalCyclesLow.load(std::memory_order_relaxed);
+        } while (high != _totalCyclesHigh.load(std::memory_order_relaxed));
+        return ((uint64_t)high << 32) | low;
+    }
+
+    /// @brief Clear counters
+    void clear()
+    {
+        _callCount.store(0, std::memory_order_relaxed);
+        _totalCyclesLow.store(0, std::memory_order_relaxed);
+        _totalCyclesHigh.store(0, std::memory_order_relaxed);
+        _maxCycles.store(0, std::memory_order_relaxed);
+    }
+
+    // Zone name
+    const char* _pName;
+
+    // Counters - 64-bit atomics aren't lock-free on 32-bit ESP32 targets so the 64-bit total is kept as a
+    // 32-bit accumulator and a count of the times it wraps
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "profile zone counters must be lock-free");
+    std::atomic<uint32_t> _callCount{0};
+    std::atomic<uint32_t> _totalCyclesLow{0};
+    std::atomic<uint32_t> _totalCyclesHigh{0};
+    std::atomic<uint32_t> _maxCycles{0};
+
+    // Next zone in the registry (zones are never removed)
+    RaftProfileZone* _pNext = nullptr;
+};
+
+/// @brief Scope guard which records the cycles between construction and destruction
+class RaftProfileZoneScope
+{
+public:
+    RaftProfileZoneScope(RaftProfileZone& zone) : _zone(zone)
+    {
+        _startCycles = RaftProfileZone::getCycles();
+    }
+    ~RaftProfileZoneScope()
+    {
+        _zone.record(RaftProfileZone::getCycles() - _startCycles);
+    }
+private:
+    RaftProfileZone& _zone;
+    uint32_t _startCycles;
+};
+
+/// @brief Registry and reporting for profiling zones
+class RaftProfileZones
+{
+public:
+    /// @brief Register a zone (called by the zone constructor)
+    /// @param pZone zone to register
+    static void registerZone(RaftProfileZone* pZone);
+
+    /// @brief Get JSON report of all zones
+    /// @return JSON string {"cpuMHz":N,"zones":[{"n":"name","c":calls,"totUs":N,"avgUs":N,"maxUs":N},...]}
+    static String getJSON();
+
+    /// @brief Clear counters in all zones
+    static void clearAll();
+
+    /// @brief Get the number of cycle counter ticks per microsecond
+    /// @return ticks per microsecond
+    static uint32_t getCyclesPerUs();
+
+private:
+    static std::atomic<RaftProfileZone*> _pFirstZone;
+};
+
+#define RAFT_PROFILE_ZONE_CONCAT_INNER(a, b) a ## b
+#define RAFT_PROFILE_ZONE_CONCAT(a, b) RAFT_PROFILE_ZONE_CONCAT_INNER(a, b)
+
+/// @brief Profile the rest of the enclosing scope under the given zone name (string literal)
+#define RAFT_PROFILE_ZONE(zoneName) \
+    static RaftProfileZone RAFT_PROFILE_ZONE_CONCAT(__raftProfZone_, __LINE__)(zoneName); \
+    RaftProfileZoneScope RAFT_PROFILE_ZONE_CONCAT(__raftProfScope_, __LINE__)(RAFT_PROFILE_ZONE_CONCAT(__raftProfZone_, __LINE__))
+
+#else
+
+#define RAFT_PROFILE_ZONE(zoneName)
+
+#endif
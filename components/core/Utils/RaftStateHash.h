@@ -0,0 +1,215 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// RaftStateHash
+// 64-bit state hashing for change detection
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * RaftStateHash
+ *
+ * 64-bit hash (xxHash64 algorithm) used to detect changes in device state
+ * The per-element hashes are combined into a set hash using XOR so that a single element
+ * can be replaced in O(1) without rehashing all other elements - this allows a bus or
+ * device manager to maintain a hierarchical state hash which is only updated for
+ * elements that have actually changed
+ */
+class RaftStateHash
+{
+public:
+    /// @brief Compute 64-bit hash of a block of data
+    /// @param pData Pointer to data
+    /// @param dataLen Length of data
+    /// @param seed Seed value (can be used to chain hashes or include extra state)
+    /// @return 64-bit hash
+    static uint64_t hashBytes(const uint8_t* pData, uint32_t dataLen, uint64_t seed = 0)
+    {
+        const uint8_t* pEnd = pData + dataLen;
+        uint64_t hash = 0;
+        if (dataLen >= 32)
+        {
+            const uint8_t* pLimit = pEnd - 32;
+            uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+            uint64_t v2 = seed + PRIME64_2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - PRIME64_1;
+            do
+            {
+                v1 = mixRound(v1, readLE64(pData));
+                v2 = mixRound(v2, readLE64(pData + 8));
+                v3 = mixRound(v3, readLE64(pData + 16));
+                v4 = mixRound(v4, readLE64(pData + 24));
+                pData += 32;
+            } while (pData <= pLimit);
+            hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            hash = mergeRound(hash, v1);
+            hash = mergeRound(hash, v2);
+            hash = mergeRound(hash, v3);
+            hash = mergeRound(hash, v4);
+        }
+        else
+        {
+            hash = seed + PRIME64_5;
+        }
+        hash += dataLen;
+
+        // Remaining bytes
+        while (pData + 8 <= pEnd)
+        {
+            hash ^= mixRound(0, readLE64(pData));
+            hash = rotl(hash, 27) * PRIME64_1 + PRIME64_4;
+            pData += 8;
+        }
+        if (pData + 4 <= pEnd)
+        {
+            hash ^= (uint64_t)readLE32(pData) * PRIME64_1;
+            hash = rotl(hash, 23) * PRIME64_2 + PRIME64_3;
+            pData += 4;
+        }
+        while (pData < pEnd)
+        {
+            hash ^= (*pData) * PRIME64_5;
+            hash = rotl(hash, 11) * PRIME64_1;
+            pData++;
+        }
+        return avalanche(hash);
+    }
+
+    /// @brief Hash a single 64-bit value (e.g. a timestamp or counter)
+    /// @param val Value to hash
+    /// @return 64-bit hash
+    static uint64_t hashValue(uint64_t val)
+    {
+        return avalanche(val * PRIME64_2 + PRIME64_5);
+    }
+
+    /// @brief Combine a hash with another value (order dependent)
+    /// @param hash Existing hash
+    /// @param val Value to combine
+    /// @return Combined hash
+    static uint64_t combine(uint64_t hash, uint64_t val)
+    {
+        return avalanche(mergeRound(hash, val) + PRIME64_4);
+    }
+
+    /// @brief Append the hash to a byte vector-like container (little endian)
+    /// @param out Output container (must support push_back(uint8_t))
+    /// @param hash Hash value
+    template <typename T>
+    static void appendToBytes(T& out, uint64_t hash)
+    {
+        for (uint32_t i = 0; i < sizeof(hash); i++)
+            out.push_back((hash >> (i * 8)) & 0xff);
+    }
+
+    // Hash size in bytes
+    static constexpr uint32_t HASH_SIZE_BYTES = sizeof(uint64_t);
+
+private:
+    static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+    static constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    static inline uint64_t rotl(uint64_t val, uint32_t bits)
+    {
+        return (val << bits) | (val >> (64 - bits));
+    }
+    static inline uint64_t readLE64(const uint8_t* p)
+    {
+        uint64_t val = 0;
+        for (int i = 7; i >= 0; i--)
+            val = (val << 8) | p[i];
+        return val;
+    }
+    static inline uint32_t readLE32(const uint8_t* p)
+    {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+    static inline uint64_t mixRound(uint64_t acc, uint64_t input)
+    {
+        acc += input * PRIME64_2;
+        acc = rotl(acc, 31);
+        return acc * PRIME64_1;
+    }
+    static inline uint64_t mergeRound(uint64_t acc, uint64_t val)
+    {
+        acc ^= mixRound(0, val);
+        return acc * PRIME64_1 + PRIME64_4;
+    }
+    static inline uint64_t avalanche(uint64_t hash)
+    {
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+};
+
+/*
+ * RaftStateHashSet
+ *
+ * Order-independent combination of element hashes which can be updated incrementally
+ * when one element's hash changes - use elemHash() to bind each element's state hash to its
+ * identity so that elements with identical state do not cancel each other out
+ */
+class RaftStateHashSet
+{
+public:
+    /// @brief Form an element hash from element identity (e.g. address) and element state hash
+    /// @param elemID Element identity
+    /// @param stateHash Element state hash
+    /// @return Element hash suitable for adding to the set
+    static uint64_t elemHash(uint64_t elemID, uint64_t stateHash)
+    {
+        return RaftStateHash::combine(RaftStateHash::hashValue(elemID), stateHash);
+    }
+
+    /// @brief Clear the set
+    void clear()
+    {
+        _setHash = 0;
+    }
+
+    /// @brief Add an element hash to the set
+    /// @param elemHash Element hash
+    void add(uint64_t elemHash)
+    {
+        _setHash ^= elemHash;
+    }
+
+    /// @brief Remove an element hash from the set
+    /// @param elemHash Element hash (must have been previously added)
+    void remove(uint64_t elemHash)
+    {
+        _setHash ^= elemHash;
+    }
+
+    /// @brief Replace an element hash in the set
+    /// @param oldElemHash Previous element hash
+    /// @param newElemHash New element hash
+    void replace(uint64_t oldElemHash, uint64_t newElemHash)
+    {
+        _setHash ^= oldElemHash ^ newElemHash;
+    }
+
+    /// @brief Get the set hash
+    /// @return Set hash
+    uint64_t get() const
+    {
+        return _setHash;
+    }
+
+private:
+    uint64_t _setHash = 0;
+};
@@ -10,6 +10,18 @@
 #include <stdbool.h>
 #include "RaftThreading.h"
 
+// Count a lock event if counters are enabled
+static inline void raftLockStatInc(RaftLockStats* pStats, uint32_t RaftLockStats::*pCount)
+{
+    if (!pStats)
+        return;
+#if defined(ESP_PLATFORM) || defined(__linux__)
+    __atomic_fetch_add(&(pStats->*pCount), 1, __ATOMIC_RELAXED);
+#else
+    pStats->*pCount = pStats->*pCount + 1;
+#endif
+}
+
 // Platform-independent thread handle and mutex definitions
 #if defined(MICROPY_PY_THREAD)
 
@@ -51,6 +63,154 @@
         mp_hal_delay_ms(ms);
     }
 
+    // Time in ms (for timeouts)
+    static uint32_t raftNowMs()
+    {
+        return mp_hal_ticks_ms();
+    }
+
+    // Wait primitives - MicroPython has no blocking equivalents so waits poll each millisecond
+    static bool raftPollWait(uint32_t timeout_ms, bool (*pCheckFn)(void*), void* pArg)
+    {
+        for (uint32_t waitedMs = 0; ; waitedMs++)
+        {
+            if (pCheckFn(pArg))
+                return true;
+            if ((timeout_ms != RAFT_WAIT_FOREVER) && (waitedMs >= timeout_ms))
+                return false;
+            mp_hal_delay_ms(1);
+        }
+    }
+
+    // Semaphore functions
+    static bool raftSemaphoreTryTake(void* pArg)
+    {
+        RaftSemaphore& sem = *(RaftSemaphore*)pArg;
+        RaftMutex_lock(sem.lock, RAFT_MUTEX_WAIT_FOREVER);
+        bool taken = sem.count > 0;
+        if (taken)
+            sem.count--;
+        RaftMutex_unlock(sem.lock);
+        return taken;
+    }
+    bool RaftSemaphore_init(RaftSemaphore &sem, uint32_t initialCount, uint32_t maxCount)
+    {
+        RaftMutex_init(sem.lock);
+        sem.count = initialCount;
+        sem.maxCount = maxCount;
+        return true;
+    }
+    bool RaftSemaphore_take(RaftSemaphore &sem, uint32_t timeout_ms)
+    {
+        return raftPollWait(timeout_ms, raftSemaphoreTryTake, &sem);
+    }
+    bool RaftSemaphore_give(RaftSemaphore &sem)
+    {
+        RaftMutex_lock(sem.lock, RAFT_MUTEX_WAIT_FOREVER);
+        bool given = sem.count < sem.maxCount;
+        if (given)
+            sem.count++;
+        RaftMutex_unlock(sem.lock);
+        return given;
+    }
+    void RaftSemaphore_destroy(RaftSemaphore &sem)
+    {
+        RaftMutex_destroy(sem.lock);
+    }
+
+    // Condition variable functions
+    struct RaftCondVarPollArg
+    {
+        RaftCondVar* pCondVar;
+        uint32_t seq;
+    };
+    static bool raftCondVarChanged(void* pArg)
+    {
+        RaftCondVarPollArg* pPollArg = (RaftCondVarPollArg*)pArg;
+        return pPollArg->pCondVar->seq != pPollArg->seq;
+    }
+    void RaftCondVar_init(RaftCondVar &condVar)
+    {
+        condVar.seq = 0;
+    }
+    bool RaftCondVar_wait(RaftCondVar &condVar, RaftMutex &mutex, uint32_t timeout_ms)
+    {
+        RaftCondVarPollArg pollArg = { &condVar, condVar.seq };
+        RaftMutex_unlock(mutex);
+        bool signalled = raftPollWait(timeout_ms, raftCondVarChanged, &pollArg);
+        RaftMutex_lock(mutex, RAFT_MUTEX_WAIT_FOREVER);
+        return signalled;
+    }
+    void RaftCondVar_signal(RaftCondVar &condVar)
+    {
+        condVar.seq = condVar.seq + 1;
+    }
+    void RaftCondVar_broadcast(RaftCondVar &condVar)
+    {
+        condVar.seq = condVar.seq + 1;
+    }
+    void RaftCondVar_destroy(RaftCondVar &condVar)
+    {
+    }
+
+    // Event group functions
+    struct RaftEventGroupPollArg
+    {
+        RaftEventGroup* pEventGroup;
+        uint32_t bits;
+        bool clearOnExit;
+        bool waitForAll;
+        uint32_t bitsOnExit;
+    };
+    static bool raftEventGroupCheck(void* pArg)
+    {
+        RaftEventGroupPollArg* pPollArg = (RaftEventGroupPollArg*)pArg;
+        RaftEventGroup& eventGroup = *pPollArg->pEventGroup;
+        RaftMutex_lock(eventGroup.lock, RAFT_MUTEX_WAIT_FOREVER);
+        pPollArg->bitsOnExit = eventGroup.bits;
+        uint32_t matched = eventGroup.bits & pPollArg->bits;
+        bool done = pPollArg->waitForAll ? (matched == pPollArg->bits) : (matched != 0);
+        if (done && pPollArg->clearOnExit)
+            eventGroup.bits &= ~pPollArg->bits;
+        RaftMutex_unlock(eventGroup.lock);
+        return done;
+    }
+    void RaftEventGroup_init(RaftEventGroup &eventGroup)
+    {
+        RaftMutex_init(eventGroup.lock);
+        eventGroup.bits = 0;
+    }
+    uint32_t RaftEventGroup_setBits(RaftEventGroup &eventGroup, uint32_t bits)
+    {
+        RaftMutex_lock(eventGroup.lock, RAFT_MUTEX_WAIT_FOREVER);
+        eventGroup.bits |= bits;
+        uint32_t curBits = eventGroup.bits;
+        RaftMutex_unlock(eventGroup.lock);
+        return curBits;
+    }
+    uint32_t RaftEventGroup_clearBits(RaftEventGroup &eventGroup, uint32_t bits)
+    {
+        RaftMutex_lock(eventGroup.lock, RAFT_MUTEX_WAIT_FOREVER);
+        uint32_t prevBits = eventGroup.bits;
+        eventGroup.bits &= ~bits;
+        RaftMutex_unlock(eventGroup.lock);
+        return prevBits;
+    }
+    uint32_t RaftEventGroup_getBits(RaftEventGroup &eventGroup)
+    {
+        return eventGroup.bits;
+    }
+    uint32_t RaftEventGroup_waitBits(RaftEventGroup &eventGroup, uint32_t bits, bool clearOnExit, bool waitForAll, uint32_t timeout_ms)
+    {
+        RaftEventGroupPollArg pollArg = { &eventGroup, bits, clearOnExit, waitForAll, 0 };
+        raftPollWait(timeout_ms, raftEventGroupCheck, &pollArg);
+        return pollArg.bitsOnExit;
+    }
+    void RaftEventGroup_destroy(RaftEventGroup &eventGroup)
+    {
+        RaftMutex_destroy(eventGroup.lock);
+    }
+
 #elif defined(FREERTOS_CONFIG_H) || defined(FREERTOS_H) || defined(ESP_PLATFORM)
 
     // Mutex functions
@@ -110,6 +270,114 @@
         vTaskDelay(pdMS_TO_TICKS(ms));
     }
 
+    // Time in ms (for timeouts)
+    static uint32_t raftNowMs()
+    {
+        return pdTICKS_TO_MS(xTaskGetTickCount());
+    }
+
+    // Convert a timeout to ticks
+    static TickType_t raftTimeoutToTicks(uint32_t timeout_ms)
+    {
+        return timeout_ms == RAFT_WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    }
+
+    // Semaphore functions
+    bool RaftSemaphore_init(RaftSemaphore &sem, uint32_t initialCount, uint32_t maxCount)
+    {
+        sem.sem = xSemaphoreCreateCounting(maxCount, initialCount);
+        return sem.sem != nullptr;
+    }
+    bool RaftSemaphore_take(RaftSemaphore &sem, uint32_t timeout_ms)
+    {
+        return xSemaphoreTake(sem.sem, raftTimeoutToTicks(timeout_ms)) == pdTRUE;
+    }
+    bool RaftSemaphore_give(RaftSemaphore &sem)
+    {
+        return xSemaphoreGive(sem.sem) == pdTRUE;
+    }
+    void RaftSemaphore_destroy(RaftSemaphore &sem)
+    {
+        if (sem.sem)
+            vSemaphoreDelete(sem.sem);
+        sem.sem = nullptr;
+    }
+
+    // Condition variable functions
+    // Waiters are counted (under the mutex) and each signal gives the semaphore once for a counted waiter. A
+    // waiter which times out checks (under the mutex) whether a signal was given for it before uncounting itself
+    void RaftCondVar_init(RaftCondVar &condVar)
+    {
+        condVar.sem = xSemaphoreCreateCounting(UINT32_MAX, 0);
+        condVar.waiters = 0;
+    }
+    bool RaftCondVar_wait(RaftCondVar &condVar, RaftMutex &mutex, uint32_t timeout_ms)
+    {
+        condVar.waiters = condVar.waiters + 1;
+        RaftMutex_unlock(mutex);
+        bool signalled = xSemaphoreTake(condVar.sem, raftTimeoutToTicks(timeout_ms)) == pdTRUE;
+        RaftMutex_lock(mutex, RAFT_MUTEX_WAIT_FOREVER);
+        if (!signalled)
+        {
+            // A signal may have been given between the timeout and re-acquiring the mutex
+            signalled = xSemaphoreTake(condVar.sem, 0) == pdTRUE;
+            if (!signalled && (condVar.waiters > 0))
+                condVar.waiters = condVar.waiters - 1;
+        }
+        return signalled;
+    }
+    void RaftCondVar_signal(RaftCondVar &condVar)
+    {
+        if (condVar.waiters > 0)
+        {
+            condVar.waiters = condVar.waiters - 1;
+            xSemaphoreGive(condVar.sem);
+        }
+    }
+    void RaftCondVar_broadcast(RaftCondVar &condVar)
+    {
+        while (condVar.waiters > 0)
+        {
+            condVar.waiters = condVar.waiters - 1;
+            xSemaphoreGive(condVar.sem);
+        }
+    }
+    void RaftCondVar_destroy(RaftCondVar &condVar)
+    {
+        if (condVar.sem)
+            vSemaphoreDelete(condVar.sem);
+        condVar.sem = nullptr;
+    }
+
+    // Event group functions
+    void RaftEventGroup_init(RaftEventGroup &eventGroup)
+    {
+        eventGroup.eventGroup = xEventGroupCreate();
+    }
+    uint32_t RaftEventGroup_setBits(RaftEventGroup &eventGroup, uint32_t bits)
+    {
+        return xEventGroupSetBits(eventGroup.eventGroup, bits);
+    }
+    uint32_t RaftEventGroup_clearBits(RaftEventGroup &eventGroup, uint32_t bits)
+    {
+        return xEventGroupClearBits(eventGroup.eventGroup, bits);
+    }
+    uint32_t RaftEventGroup_getBits(RaftEventGroup &eventGroup)
+    {
+        return xEventGroupGetBits(eventGroup.eventGroup);
+    }
+    uint32_t RaftEventGroup_waitBits(RaftEventGroup &eventGroup, uint32_t bits, bool clearOnExit, bool waitForAll, uint32_t timeout_ms)
+    {
+        return xEventGroupWaitBits(eventGroup.eventGroup, bits, clearOnExit ? pdTRUE : pdFALSE,
+                    waitForAll ? pdTRUE : pdFALSE, raftTimeoutToTicks(timeout_ms));
+    }
+    void RaftEventGroup_destroy(RaftEventGroup &eventGroup)
+    {
+        if (eventGroup.eventGroup)
+            vEventGroupDelete(eventGroup.eventGroup);
+        eventGroup.eventGroup = nullptr;
+    }
+
 #elif defined(__linux__)
 
     // Mutex functions
@@ -163,8 +431,407 @@
         usleep(ms * 1000); // Convert milliseconds to microseconds
     }
 
+    // Initialise a condition variable to use the monotonic clock for timed waits
+    static void raftCondInit(pthread_cond_t& cond)
+    {
+        pthread_condattr_t condAttr;
+        pthread_condattr_init(&condAttr);
+        pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+        pthread_cond_init(&cond, &condAttr);
+        pthread_condattr_destroy(&condAttr);
+    }
+
+    // Get the absolute (monotonic) time at which a timeout expires
+    static struct timespec raftTimeoutToAbsTime(uint32_t timeout_ms)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        ts.tv_sec += timeout_ms / 1000;
+        ts.tv_nsec += (timeout_ms % 1000) * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        return ts;
+    }
+
+    // Wait on a condition variable until signalled or the deadline passes (false on timeout)
+    static bool raftCondWaitUntil(pthread_cond_t& cond, pthread_mutex_t& mutex, uint32_t timeout_ms, const struct timespec& deadline)
+    {
+        if (timeout_ms == RAFT_WAIT_FOREVER)
+            return pthread_cond_wait(&cond, &mutex) == 0;
+        return pthread_cond_timedwait(&cond, &mutex, &deadline) == 0;
+    }
+
+    // Semaphore functions
+    bool RaftSemaphore_init(RaftSemaphore &sem, uint32_t initialCount, uint32_t maxCount)
+    {
+        pthread_mutex_init(&sem.mutex, NULL);
+        raftCondInit(sem.cond);
+        sem.count = initialCount;
+        sem.maxCount = maxCount;
+        return true;
+    }
+    bool RaftSemaphore_take(RaftSemaphore &sem, uint32_t timeout_ms)
+    {
+        struct timespec deadline = raftTimeoutToAbsTime(timeout_ms == RAFT_WAIT_FOREVER ? 0 : timeout_ms);
+        pthread_mutex_lock(&sem.mutex);
+        while (sem.count == 0)
+        {
+            if ((timeout_ms == 0) || !raftCondWaitUntil(sem.cond, sem.mutex, timeout_ms, deadline))
+                break;
+        }
+        bool taken = sem.count > 0;
+        if (taken)
+            sem.count--;
+        pthread_mutex_unlock(&sem.mutex);
+        return taken;
+    }
+    bool RaftSemaphore_give(RaftSemaphore &sem)
+    {
+        pthread_mutex_lock(&sem.mutex);
+        bool given = sem.count < sem.maxCount;
+        if (given)
+        {
+            sem.count++;
+            pthread_cond_signal(&sem.cond);
+        }
+        pthread_mutex_unlock(&sem.mutex);
+        return given;
+    }
+    void RaftSemaphore_destroy(RaftSemaphore &sem)
+    {
+        pthread_cond_destroy(&sem.cond);
+        pthread_mutex_destroy(&sem.mutex);
+    }
+
+    // Condition variable functions
+    void RaftCondVar_init(RaftCondVar &condVar)
+    {
+        raftCondInit(condVar.cond);
+    }
+    bool RaftCondVar_wait(RaftCondVar &condVar, RaftMutex &mutex, uint32_t timeout_ms)
+    {
+        struct timespec deadline = raftTimeoutToAbsTime(timeout_ms == RAFT_WAIT_FOREVER ? 0 : timeout_ms);
+        return raftCondWaitUntil(condVar.cond, mutex.mutex, timeout_ms, deadline);
+    }
+    void RaftCondVar_signal(RaftCondVar &condVar)
+    {
+        pthread_cond_signal(&condVar.cond);
+    }
+    void RaftCondVar_broadcast(RaftCondVar &condVar)
+    {
+        pthread_cond_broadcast(&condVar.cond);
+    }
+    void RaftCondVar_destroy(RaftCondVar &condVar)
+    {
+        pthread_cond_destroy(&condVar.cond);
+    }
+
+    // Event group functions
+    void RaftEventGroup_init(RaftEventGroup &eventGroup)
+    {
+        pthread_mutex_init(&eventGroup.mutex, NULL);
+        raftCondInit(eventGroup.cond);
+        eventGroup.bits = 0;
+    }
+    uint32_t RaftEventGroup_setBits(RaftEventGroup &eventGroup, uint32_t bits)
+    {
+        pthread_mutex_lock(&eventGroup.mutex);
+        eventGroup.bits |= bits;
+        uint32_t curBits = eventGroup.bits;
+        pthread_cond_broadcast(&eventGroup.cond);
+        pthread_mutex_unlock(&eventGroup.mutex);
+        return curBits;
+    }
+    uint32_t RaftEventGroup_clearBits(RaftEventGroup &eventGroup, uint32_t bits)
+    {
+        pthread_mutex_lock(&eventGroup.mutex);
+        uint32_t prevBits = eventGroup.bits;
+        eventGroup.bits &= ~bits;
+        pthread_mutex_unlock(&eventGroup.mutex);
+        return prevBits;
+    }
+    uint32_t RaftEventGroup_getBits(RaftEventGroup &eventGroup)
+    {
+        pthread_mutex_lock(&eventGroup.mutex);
+        uint32_t curBits = eventGroup.bits;
+        pthread_mutex_unlock(&eventGroup.mutex);
+        return curBits;
+    }
+    uint32_t RaftEventGroup_waitBits(RaftEventGroup &eventGroup, uint32_t bits, bool clearOnExit, bool waitForAll, uint32_t timeout_ms)
+    {
+        struct timespec deadline = raftTimeoutToAbsTime(timeout_ms == RAFT_WAIT_FOREVER ? 0 : timeout_ms);
+        pthread_mutex_lock(&eventGroup.mutex);
+        bool done = false;
+        while (true)
+        {
+            uint32_t matched = eventGroup.bits & bits;
+            done = waitForAll ? (matched == bits) : (matched != 0);
+            if (done || (timeout_ms == 0) || !raftCondWaitUntil(eventGroup.cond, eventGroup.mutex, timeout_ms, deadline))
+                break;
+        }
+        uint32_t bitsOnExit = eventGroup.bits;
+        if (done && clearOnExit)
+            eventGroup.bits &= ~bits;
+        pthread_mutex_unlock(&eventGroup.mutex);
+        return bitsOnExit;
+    }
+    void RaftEventGroup_destroy(RaftEventGroup &eventGroup)
+    {
+        pthread_cond_destroy(&eventGroup.cond);
+        pthread_mutex_destroy(&eventGroup.mutex);
+    }
+
+    // Reader-writer lock functions
+    void RaftRWLock_init(RaftRWLock &rwLock, RaftLockStats* pStats)
+    {
+        // glibc prefers readers by default which can starve writers
+        pthread_rwlockattr_t rwLockAttr;
+        pthread_rwlockattr_init(&rwLockAttr);
+        pthread_rwlockattr_setkind_np(&rwLockAttr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+        pthread_rwlock_init(&rwLock.rwlock, &rwLockAttr);
+        pthread_rwlockattr_destroy(&rwLockAttr);
+        rwLock.pStats = pStats;
+    }
+    static bool raftRWLockAcquire(RaftRWLock &rwLock, bool write, uint32_t timeout_ms)
+    {
+        if ((write ? pthread_rwlock_trywrlock(&rwLock.rwlock) : pthread_rwlock_tryrdlock(&rwLock.rwlock)) == 0)
+        {
+            raftLockStatInc(rwLock.pStats, &RaftLockStats::acquisitions);
+            return true;
+        }
+        raftLockStatInc(rwLock.pStats, &RaftLockStats::contended);
+        int rslt = -1;
+        if (timeout_ms == RAFT_WAIT_FOREVER)
+        {
+            rslt = write ? pthread_rwlock_wrlock(&rwLock.rwlock) : pthread_rwlock_rdlock(&rwLock.rwlock);
+        }
+        else if (timeout_ms != 0)
+        {
+            // Monotonic deadline so that wall clock changes don't shorten or extend the wait
+            struct timespec deadline = raftTimeoutToAbsTime(timeout_ms);
+            rslt = write ? pthread_rwlock_clockwrlock(&rwLock.rwlock, CLOCK_MONOTONIC, &deadline) :
+                        pthread_rwlock_clockrdlock(&rwLock.rwlock, CLOCK_MONOTONIC, &deadline);
+        }
+        raftLockStatInc(rwLock.pStats, rslt == 0 ? &RaftLockStats::acquisitions : &RaftLockStats::timeouts);
+        return rslt == 0;
+    }
+    bool RaftRWLock_lockRead(RaftRWLock &rwLock, uint32_t timeout_ms)
+    {
+        return raftRWLockAcquire(rwLock, false, timeout_ms);
+    }
+    void RaftRWLock_unlockRead(RaftRWLock &rwLock)
+    {
+        pthread_rwlock_unlock(&rwLock.rwlock);
+    }
+    bool RaftRWLock_lockWrite(RaftRWLock &rwLock, uint32_t timeout_ms)
+    {
+        return raftRWLockAcquire(rwLock, true, timeout_ms);
+    }
+    void RaftRWLock_unlockWrite(RaftRWLock &rwLock)
+    {
+        pthread_rwlock_unlock(&rwLock.rwlock);
+    }
+    void RaftRWLock_destroy(RaftRWLock &rwLock)
+    {
+        pthread_rwlock_destroy(&rwLock.rwlock);
+    }
+
 #endif // Platform-specific threading
 
+#if defined(MICROPY_PY_THREAD) || defined(FREERTOS_CONFIG_H) || defined(FREERTOS_H) || defined(ESP_PLATFORM)
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reader-writer lock - built from a mutex and condition variables on platforms without a native one
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void RaftRWLock_init(RaftRWLock &rwLock, RaftLockStats* pStats)
+{
+    RaftMutex_init(rwLock.lock);
+    RaftCondVar_init(rwLock.canRead);
+    RaftCondVar_init(rwLock.canWrite);
+    rwLock.readers = 0;
+    rwLock.writersWaiting = 0;
+    rwLock.writing = false;
+    rwLock.pStats = pStats;
+}
+
+// Wait (with the mutex held) for the remainder of a timeout - false if it has expired
+static bool raftRWLockWait(RaftRWLock &rwLock, RaftCondVar &condVar, uint32_t startMs, uint32_t timeout_ms)
+{
+    uint32_t waitMs = RAFT_WAIT_FOREVER;
+    if (timeout_ms != RAFT_WAIT_FOREVER)
+    {
+        uint32_t elapsedMs = raftNowMs() - startMs;
+        if (elapsedMs >= timeout_ms)
+            return false;
+        waitMs = timeout_ms - elapsedMs;
+    }
+    RaftCondVar_wait(condVar, rwLock.lock, waitMs);
+    return true;
+}
+
+bool RaftRWLock_lockRead(RaftRWLock &rwLock, uint32_t timeout_ms)
+{
+    uint32_t startMs = raftNowMs();
+    if (!RaftMutex_lock(rwLock.lock, timeout_ms))
+    {
+        raftLockStatInc(rwLock.pStats, &RaftLockStats::timeouts);
+        return false;
+    }
+    // Readers wait for waiting writers too so that writers aren't starved
+    if (rwLock.writing || (rwLock.writersWaiting > 0))
+    {
+        raftLockStatInc(rwLock.pStats, &RaftLockStats::contended);
+        while (rwLock.writing || (rwLock.writersWaiting > 0))
+        {
+            if (!raftRWLockWait(rwLock, rwLock.canRead, startMs, timeout_ms))
+            {
+                RaftMutex_unlock(rwLock.lock);
+                raftLockStatInc(rwLock.pStats, &RaftLockStats::timeouts);
+                return false;
+            }
+        }
+    }
+    rwLock.readers++;
+    RaftMutex_unlock(rwLock.lock);
+    raftLockStatInc(rwLock.pStats, &RaftLockStats::acquisitions);
+    return true;
+}
+
+void RaftRWLock_unlockRead(RaftRWLock &rwLock)
+{
+    RaftMutex_lock(rwLock.lock, RAFT_MUTEX_WAIT_FOREVER);
+    if (rwLock.readers > 0)
+        rwLock.readers--;
+    if ((rwLock.readers == 0) && (rwLock.writersWaiting > 0))
+        RaftCondVar_signal(rwLock.canWrite);
+    RaftMutex_unlock(rwLock.lock);
+}
+
+bool RaftRWLock_lockWrite(RaftRWLock &rwLock, uint32_t timeout_ms)
+{
+    uint32_t startMs = raftNowMs();
+    if (!RaftMutex_lock(rwLock.lock, timeout_ms))
+    {
+        raftLockStatInc(rwLock.pStats, &RaftLockStats::timeouts);
+        return false;
+    }
+    if (rwLock.writing || (rwLock.readers > 0))
+    {
+        raftLockStatInc(rwLock.pStats, &RaftLockStats::contended);
+        rwLock.writersWaiting++;
+        while (rwLock.writing || (rwLock.readers > 0))
+        {
+            if (!raftRWLockWait(rwLock, rwLock.canWrite, startMs, timeout_ms))
+            {
+                // Readers held back for this writer may now proceed
+                rwLock.writersWaiting--;
+                if (rwLock.writersWaiting == 0)
+                    RaftCondVar_broadcast(rwLock.canRead);
+                RaftMutex_unlock(rwLock.lock);
+                raftLockStatInc(rwLock.pStats, &RaftLockStats::timeouts);
+                return false;
+            }
+        }
+        rwLock.writersWaiting--;
+    }
+    rwLock.writing = true;
+    RaftMutex_unlock(rwLock.lock);
+    raftLockStatInc(rwLock.pStats, &RaftLockStats::acquisitions);
+    return true;
+}
+
+void RaftRWLock_unlockWrite(RaftRWLock &rwLock)
+{
+    RaftMutex_lock(rwLock.lock, RAFT_MUTEX_WAIT_FOREVER);
+    rwLock.writing = false;
+    if (rwLock.writersWaiting > 0)
+        RaftCondVar_signal(rwLock.canWrite);
+    else
+        RaftCondVar_broadcast(rwLock.canRead);
+    RaftMutex_unlock(rwLock.lock);
+}
+
+void RaftRWLock_destroy(RaftRWLock &rwLock)
+{
+    RaftCondVar_destroy(rwLock.canWrite);
+    RaftCondVar_destroy(rwLock.canRead);
+    RaftMutex_destroy(rwLock.lock);
+}
+
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Adaptive mutex - platform independent
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Hint to the CPU that this is a spin-wait loop
+static inline void raftCpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+void RaftAdaptiveMutex_init(RaftAdaptiveMutex &mutex, uint32_t spinCount, RaftLockStats* pStats)
+{
+    RaftMutex_init(mutex.mutex);
+#if defined(portNUM_PROCESSORS) && (portNUM_PROCESSORS == 1)
+    spinCount = 0;
+#elif defined(__linux__)
+    if (sysconf(_SC_NPROCESSORS_ONLN) <= 1)
+        spinCount = 0;
+#endif
+    mutex.spinCount = spinCount;
+    mutex.pStats = pStats;
+}
+
+bool RaftAdaptiveMutex_lock(RaftAdaptiveMutex &mutex, uint32_t timeout_ms)
+{
+    if (RaftMutex_lock(mutex.mutex, 0))
+    {
+        raftLockStatInc(mutex.pStats, &RaftLockStats::acquisitions);
+        return true;
+    }
+    raftLockStatInc(mutex.pStats, &RaftLockStats::contended);
+
+    // Spin trying the lock as the holder is likely to release it soon
+    if (timeout_ms != 0)
+    {
+        for (uint32_t i = 0; i < mutex.spinCount; i++)
+        {
+            raftCpuRelax();
+            if (RaftMutex_lock(mutex.mutex, 0))
+            {
+                raftLockStatInc(mutex.pStats, &RaftLockStats::spinAcquired);
+                raftLockStatInc(mutex.pStats, &RaftLockStats::acquisitions);
+                return true;
+            }
+        }
+    }
+
+    // Block
+    if ((timeout_ms != 0) && RaftMutex_lock(mutex.mutex, timeout_ms))
+    {
+        raftLockStatInc(mutex.pStats, &RaftLockStats::acquisitions);
+        return true;
+    }
+    raftLockStatInc(mutex.pStats, &RaftLockStats::timeouts);
+    return false;
+}
+
+void RaftAdaptiveMutex_unlock(RaftAdaptiveMutex &mutex)
+{
+    RaftMutex_unlock(mutex.mutex);
+}
+
+void RaftAdaptiveMutex_destroy(RaftAdaptiveMutex &mutex)
+{
+    RaftMutex_destroy(mutex.mutex);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Atomic operations - platform independent
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
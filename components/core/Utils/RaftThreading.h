@@ -25,6 +25,14 @@ extern "C" {
 // Use this value to wait indefinitely for a mutex lock
 static const uint32_t RAFT_MUTEX_WAIT_FOREVER = 0xFFFFFFFF;
 
+// Optional lock contention counters (updated with relaxed atomics when a lock is given a pointer to them)
+typedef struct {
+    uint32_t acquisitions;      // Successful locks
+    uint32_t contended;         // Locks which found the lock held
+    uint32_t spinAcquired;      // Contended locks acquired while spinning (adaptive mutex only)
+    uint32_t timeouts;          // Locks which failed (timed out)
+} RaftLockStats;
+
 // Platform-independent thread handle and mutex definitions
 #if defined(MICROPY_PY_THREAD)
 
@@ -45,6 +53,31 @@ static const uint32_t RAFT_MUTEX_WAIT_FOREVER = 0xFFFFFFFF;
     void RaftMutex_unlock(RaftMutex &mutex);
     void RaftMutex_destroy(RaftMutex &mutex);
 
+    // Wait primitives (MicroPython has no native equivalents so waits poll)
+    typedef struct {
+        RaftMutex lock;
+        volatile uint32_t count RAFT_THREAD_CPP_INIT;
+        uint32_t maxCount RAFT_THREAD_CPP_INIT;
+    } RaftSemaphore;
+    typedef struct {
+        volatile uint32_t seq RAFT_THREAD_CPP_INIT;
+    } RaftCondVar;
+    typedef struct {
+        RaftMutex lock;
+        volatile uint32_t bits RAFT_THREAD_CPP_INIT;
+    } RaftEventGroup;
+
+    // Reader-writer lock (built from a mutex and condition variables, writers take priority)
+    typedef struct {
+        RaftMutex lock;
+        RaftCondVar canRead;
+        RaftCondVar canWrite;
+        uint32_t readers RAFT_THREAD_CPP_INIT;
+        uint32_t writersWaiting RAFT_THREAD_CPP_INIT;
+        bool writing RAFT_THREAD_CPP_INIT;
+        RaftLockStats* pStats RAFT_THREAD_CPP_INIT;
+    } RaftRWLock;
+
     // Thread handle
     static const mp_uint_t RAFT_THREAD_HANDLE_INVALID = 0;
     typedef mp_uint_t RaftThreadHandle;
@@ -67,10 +100,35 @@ static const uint32_t RAFT_MUTEX_WAIT_FOREVER = 0xFFFFFFFF;
     #include "freertos/FreeRTOS.h"
     #include "freertos/task.h"
     #include "freertos/semphr.h"
+    #include "freertos/event_groups.h"
     typedef struct {
         SemaphoreHandle_t mutex RAFT_THREAD_CPP_INIT;
     } RaftMutex;
 
+    // Wait primitives (FreeRTOS has no condition variable so one is built from a counting semaphore)
+    typedef struct {
+        SemaphoreHandle_t sem RAFT_THREAD_CPP_INIT;
+    } RaftSemaphore;
+    typedef struct {
+        SemaphoreHandle_t sem RAFT_THREAD_CPP_INIT;
+        volatile uint32_t waiters RAFT_THREAD_CPP_INIT;
+    } RaftCondVar;
+    typedef struct {
+        EventGroupHandle_t eventGroup RAFT_THREAD_CPP_INIT;
+    } RaftEventGroup;
+
+    // Reader-writer lock (FreeRTOS has none so it is built from a mutex and condition variables, writers
+    // take priority)
+    typedef struct {
+        RaftMutex lock;
+        RaftCondVar canRead;
+        RaftCondVar canWrite;
+        uint32_t readers RAFT_THREAD_CPP_INIT;
+        uint32_t writersWaiting RAFT_THREAD_CPP_INIT;
+        bool writing RAFT_THREAD_CPP_INIT;
+        RaftLockStats* pStats RAFT_THREAD_CPP_INIT;
+    } RaftRWLock;
+
     // Mutex functions
     void RaftMutex_init(RaftMutex &mutex);
     bool RaftMutex_lock(RaftMutex &mutex, uint32_t timeout_ms);
@@ -106,6 +164,28 @@ static const uint32_t RAFT_MUTEX_WAIT_FOREVER = 0xFFFFFFFF;
         pthread_mutex_t mutex RAFT_THREAD_CPP_INIT;
     } RaftMutex;
 
+    // Wait primitives (timed waits use CLOCK_MONOTONIC)
+    typedef struct {
+        pthread_mutex_t mutex RAFT_THREAD_CPP_INIT;
+        pthread_cond_t cond RAFT_THREAD_CPP_INIT;
+        uint32_t count RAFT_THREAD_CPP_INIT;
+        uint32_t maxCount RAFT_THREAD_CPP_INIT;
+    } RaftSemaphore;
+    typedef struct {
+        pthread_cond_t cond RAFT_THREAD_CPP_INIT;
+    } RaftCondVar;
+    typedef struct {
+        pthread_mutex_t mutex RAFT_THREAD_CPP_INIT;
+        pthread_cond_t cond RAFT_THREAD_CPP_INIT;
+        uint32_t bits RAFT_THREAD_CPP_INIT;
+    } RaftEventGroup;
+
+    // Reader-writer lock (configured so writers take priority)
+    typedef struct {
+        pthread_rwlock_t rwlock RAFT_THREAD_CPP_INIT;
+        RaftLockStats* pStats RAFT_THREAD_CPP_INIT;
+    } RaftRWLock;
+
     // Mutex functions
     void RaftMutex_init(RaftMutex &mutex);
     bool RaftMutex_lock(RaftMutex &mutex, uint32_t timeout_ms);
@@ -134,6 +214,58 @@ static const uint32_t RAFT_MUTEX_WAIT_FOREVER = 0xFFFFFFFF;
 
 #endif
 
+// Platform-independent wait timeout constant (waits with a timeout of 0 don't block)
+static const uint32_t RAFT_WAIT_FOREVER = RAFT_MUTEX_WAIT_FOREVER;
+
+// Maximum number of bits in an event group (FreeRTOS reserves the top byte)
+static const uint32_t RAFT_EVENT_GROUP_MAX_BITS = 24;
+
+// Semaphore functions (counting semaphore - use maxCount 1 for binary)
+bool RaftSemaphore_init(RaftSemaphore &sem, uint32_t initialCount, uint32_t maxCount);
+bool RaftSemaphore_take(RaftSemaphore &sem, uint32_t timeout_ms);
+bool RaftSemaphore_give(RaftSemaphore &sem);
+void RaftSemaphore_destroy(RaftSemaphore &sem);
+
+// Condition variable functions - the mutex must be held when waiting or signalling and waiters must
+// re-check their condition on return as wake-ups may be spurious
+void RaftCondVar_init(RaftCondVar &condVar);
+bool RaftCondVar_wait(RaftCondVar &condVar, RaftMutex &mutex, uint32_t timeout_ms);
+void RaftCondVar_signal(RaftCondVar &condVar);
+void RaftCondVar_broadcast(RaftCondVar &condVar);
+void RaftCondVar_destroy(RaftCondVar &condVar);
+
+// Event group functions - waitBits returns the bits set when the wait ended (before any clearing)
+void RaftEventGroup_init(RaftEventGroup &eventGroup);
+uint32_t RaftEventGroup_setBits(RaftEventGroup &eventGroup, uint32_t bits);
+uint32_t RaftEventGroup_clearBits(RaftEventGroup &eventGroup, uint32_t bits);
+uint32_t RaftEventGroup_getBits(RaftEventGroup &eventGroup);
+uint32_t RaftEventGroup_waitBits(RaftEventGroup &eventGroup, uint32_t bits, bool clearOnExit, bool waitForAll, uint32_t timeout_ms);
+void RaftEventGroup_destroy(RaftEventGroup &eventGroup);
+
+// Reader-writer lock functions - any number of readers or a single writer (pStats is optional)
+void RaftRWLock_init(RaftRWLock &rwLock, RaftLockStats* pStats = nullptr);
+bool RaftRWLock_lockRead(RaftRWLock &rwLock, uint32_t timeout_ms);
+void RaftRWLock_unlockRead(RaftRWLock &rwLock);
+bool RaftRWLock_lockWrite(RaftRWLock &rwLock, uint32_t timeout_ms);
+void RaftRWLock_unlockWrite(RaftRWLock &rwLock);
+void RaftRWLock_destroy(RaftRWLock &rwLock);
+
+// Adaptive mutex - spins briefly (trying the lock) before blocking, for short critical sections. Spinning is
+// disabled on single-core systems where the holder can't run while the waiter spins
+static const uint32_t RAFT_ADAPTIVE_MUTEX_DEFAULT_SPIN = 100;
+typedef struct {
+    RaftMutex mutex;
+    uint32_t spinCount RAFT_THREAD_CPP_INIT;
+    RaftLockStats* pStats RAFT_THREAD_CPP_INIT;
+} RaftAdaptiveMutex;
+
+// Adaptive mutex functions (pStats is optional)
+void RaftAdaptiveMutex_init(RaftAdaptiveMutex &mutex, uint32_t spinCount = RAFT_ADAPTIVE_MUTEX_DEFAULT_SPIN,
+            RaftLockStats* pStats = nullptr);
+bool RaftAdaptiveMutex_lock(RaftAdaptiveMutex &mutex, uint32_t timeout_ms);
+void RaftAdaptiveMutex_unlock(RaftAdaptiveMutex &mutex);
+void RaftAdaptiveMutex_destroy(RaftAdaptiveMutex &mutex);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stdio.h>
+#include "RaftArduino.h"
+#include "RaftJson.h"
+#include "ConfigPinMap.h"
+
+class ArduinoGPIOTest
+{
+public:
+    void loop()
+    {
+        printf("Running ArduinoGPIOTest...\n");
+
+        testMaskReadWrite();
+        testChangeLog();
+        testConfigMultiple();
+
+        if (_failCount > 0)
+            printf("ArduinoGPIOTest FAILED %d tests\n", _failCount);
+        else
+            printf("ArduinoGPIOTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  ArduinoGPIOTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    static const uint64_t TEST_PINS = (1ULL << 12) | (1ULL << 13) | (1ULL << 14) | (1ULL << 33);
+
+    void testMaskReadWrite()
+    {
+        digitalWriteMask(0, TEST_PINS);
+        check(digitalReadMask(TEST_PINS) == 0, "all clear");
+        digitalWriteMask((1ULL << 12) | (1ULL << 33), 0);
+        check(digitalReadMask(TEST_PINS) == ((1ULL << 12) | (1ULL << 33)), "set pins");
+        check((digitalRead(12) == HIGH) && (digitalRead(33) == HIGH) && (digitalRead(13) == LOW), "per-pin read matches");
+        digitalWriteMask(1ULL << 13, 1ULL << 12);
+        check(digitalReadMask(TEST_PINS) == ((1ULL << 13) | (1ULL << 33)), "set and clear together");
+        digitalWriteMask(1ULL << 14, 1ULL << 14);
+        check((digitalReadMask(1ULL << 14)) == 0, "pin in both masks cleared");
+        check(digitalReadMask(1ULL << 13) == (1ULL << 13), "read mask limits result");
+        digitalWriteMask(0, TEST_PINS);
+    }
+
+    void testChangeLog()
+    {
+        GPIOSimChange changes[10];
+        gpioSimSetChangeLogLen(8);
+
+        // Unchanged pins aren't logged and pins changed by one write share a write sequence number
+        digitalWrite(12, LOW);
+        digitalWriteMask((1ULL << 12) | (1ULL << 13) | (1ULL << 14), 0);
+        digitalWrite(13, LOW);
+        uint32_t numChanges = gpioSimGetChangeLog(changes, 10);
+        check(numChanges == 4, "changes logged");
+        if (numChanges == 4)
+        {
+            check((changes[0].pin == 12) && (changes[1].pin == 13) && (changes[2].pin == 14), "change pins");
+            check((changes[0].writeSeq == changes[1].writeSeq) && (changes[1].writeSeq == changes[2].writeSeq),
+                        "multi-pin write is one operation");
+            check((changes[3].pin == 13) && (changes[3].level == LOW) && (changes[3].writeSeq != changes[2].writeSeq),
+                        "single pin write");
+            check(changes[3].timeUs >= changes[0].timeUs, "change times");
+        }
+        check(gpioSimGetChangeLog(changes, 10) == 0, "log cleared when read");
+
+        // Log length limit
+        for (int i = 0; i < 10; i++)
+            digitalWrite(12, i % 2 == 0 ? LOW : HIGH);
+        check(gpioSimGetChangeLog(changes, 10) == 8, "log limited");
+        gpioSimSetChangeLogLen(0);
+        digitalWriteMask(0, TEST_PINS);
+    }
+
+    void testConfigMultiple()
+    {
+        RaftJson config(R"({"ledA":"21","ledB":"22","ledC":"23","button":"24","unused":""})");
+        int ledBPin = -1;
+        ConfigPinMap::PinDef pinDefs[] = {
+            ConfigPinMap::PinDef("ledA", ConfigPinMap::GPIO_OUTPUT, nullptr, true),
+            ConfigPinMap::PinDef("ledB", ConfigPinMap::GPIO_OUTPUT, &ledBPin, false),
+            ConfigPinMap::PinDef("ledC", ConfigPinMap::GPIO_OUTPUT, nullptr, true),
+            ConfigPinMap::PinDef("button", ConfigPinMap::GPIO_INPUT_PULLUP),
+            ConfigPinMap::PinDef("unused", ConfigPinMap::GPIO_OUTPUT),
+        };
+        digitalWriteMask(1ULL << 22, 0);
+        pinMode(21, INPUT);
+        pinMode(22, INPUT);
+        pinMode(23, INPUT);
+        pinMode(24, INPUT);
+        gpioSimSetChangeLogLen(10);
+        ConfigPinMap::configMultiple(config, pinDefs, sizeof(pinDefs) / sizeof(pinDefs[0]));
+        GPIOSimChange changes[10];
+        uint32_t numChanges = gpioSimGetChangeLog(changes, 10);
+        gpioSimSetChangeLogLen(0);
+
+        check((pinDefs[0]._pinNumber == 21) && (ledBPin == 22) && (pinDefs[4]._pinNumber == -1), "pin numbers");
+        check((gpioSimGetPinMode(21) == OUTPUT) && (gpioSimGetPinMode(24) == INPUT_PULLUP), "pin modes");
+        check(digitalReadMask((1ULL << 21) | (1ULL << 22) | (1ULL << 23) | (1ULL << 24)) ==
+                    ((1ULL << 21) | (1ULL << 23) | (1ULL << 24)), "initial levels");
+
+        // All output levels in a single write before the outputs are enabled then the pullup input
+        check(numChanges == 4, "config changes");
+        if (numChanges == 4)
+        {
+            check((changes[0].writeSeq == changes[1].writeSeq) && (changes[1].writeSeq == changes[2].writeSeq),
+                        "output levels set together");
+            check(changes[3].pin == 24, "pullup applied");
+        }
+
+        // No output changes level once its mode is output (it starts at its initial level)
+        bool outputLevelsSetFirst = true;
+        for (uint32_t i = 0; i < numChanges; i++)
+            if ((changes[i].pin != 24) && (changes[i].mode == OUTPUT))
+                outputLevelsSetFirst = false;
+        check(outputLevelsSetFirst, "output levels set before mode");
+        digitalWriteMask(0, (1ULL << 21) | (1ULL << 22) | (1ULL << 23) | (1ULL << 24));
+    }
+};
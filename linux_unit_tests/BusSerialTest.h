@@ -0,0 +1,422 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+#include "BusSerial.h"
+#include "BusSerialFramer.h"
+#include "BusRequestResult.h"
+#include "RaftJson.h"
+
+class BusSerialTest
+{
+public:
+    void loop()
+    {
+        printf("Running BusSerialTest...\n");
+
+        testFramerDelim();
+        testFramerLength();
+        testFramerIdle();
+        testPtyFramed();
+        testPtyBlankLines();
+        testFailedSend();
+        testLatency();
+
+        if (_failCount > 0)
+            printf("BusSerialTest FAILED %d tests\n", _failCount);
+        else
+            printf("BusSerialTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  BusSerialTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Framer
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    std::vector<std::vector<uint8_t>> _frames;
+    BusSerialFrameCB frameCollector()
+    {
+        return [this](const uint8_t* pFrame, uint32_t frameLen) {
+            _frames.push_back(std::vector<uint8_t>(pFrame, pFrame + frameLen));
+        };
+    }
+
+    void testFramerDelim()
+    {
+        BusSerialFramer framer;
+        framer.setup(RaftJson(R"({"type":"delim","delim":"0d0a","maxLen":8})"));
+        _frames.clear();
+        const char* pData = "AB\r\nCD";
+        framer.addBytes((const uint8_t*)pData, strlen(pData), 0, frameCollector());
+        check(_frames.size() == 1 && _frames[0].size() == 2 && _frames[0][1] == 'B', "delim first frame");
+        framer.addBytes((const uint8_t*)"E\r\n", 3, 0, frameCollector());
+        check(_frames.size() == 2 && _frames[1].size() == 3 && _frames[1][2] == 'E', "delim frame split across reads");
+        const char* pLong = "0123456789\r\nX\r\n";
+        framer.addBytes((const uint8_t*)pLong, strlen(pLong), 0, frameCollector());
+        check(framer.getDiscardCount() >= 1, "delim overlength discarded");
+        check(_frames.back().size() == 1 && _frames.back()[0] == 'X', "delim resync after overlength");
+
+        // Empty frames are discarded
+        BusSerialFramer lineFramer;
+        lineFramer.setup(RaftJson(R"({"type":"delim","delim":"0a"})"));
+        _frames.clear();
+        lineFramer.addBytes((const uint8_t*)"\n\nOK\n", 5, 0, frameCollector());
+        check(_frames.size() == 1 && _frames[0].size() == 2 && _frames[0][0] == 'O', "delim empty frames dropped");
+        check(lineFramer.getDiscardCount() == 2, "delim empty frames counted as discards");
+    }
+
+    void testFramerLength()
+    {
+        // Start byte 0xaa, length byte at position 1 giving payload length, 3 bytes overhead (start, len, checksum)
+        BusSerialFramer framer;
+        framer.setup(RaftJson(R"({"type":"len","start":"aa","lenPos":1,"lenBytes":1,"lenAdj":3})"));
+        _frames.clear();
+        uint8_t data[] = {0x00, 0x13, 0xaa, 0x02, 0x10, 0x20, 0x55, 0xaa, 0x00, 0x66};
+        framer.addBytes(data, sizeof(data), 0, frameCollector());
+        check(_frames.size() == 2, "len two frames");
+        check(_frames.size() > 0 && _frames[0].size() == 5 && _frames[0][2] == 0x10 && _frames[0][4] == 0x55, "len first frame");
+        check(_frames.size() > 1 && _frames[1].size() == 3 && _frames[1][2] == 0x66, "len empty payload frame");
+
+        // Little-endian 2-byte length including header
+        framer.setup(RaftJson(R"({"type":"len","lenPos":0,"lenBytes":2,"lenBE":0})"));
+        _frames.clear();
+        uint8_t data2[] = {0x04, 0x00, 0x01, 0x02, 0x05, 0x00, 0x03, 0x04, 0x05};
+        framer.addBytes(data2, sizeof(data2), 0, frameCollector());
+        check(_frames.size() == 2 && _frames[1].size() == 5 && _frames[1][4] == 0x05, "len LE 2-byte length");
+    }
+
+    void testFramerIdle()
+    {
+        BusSerialFramer framer;
+        framer.setup(RaftJson(R"({"type":"idle","idleMs":2})"));
+        _frames.clear();
+        framer.addBytes((const uint8_t*)"abc", 3, 1000, frameCollector());
+        framer.checkIdle(2000, frameCollector());
+        check(_frames.empty(), "idle frame not complete before gap");
+        framer.addBytes((const uint8_t*)"d", 1, 2500, frameCollector());
+        framer.checkIdle(5000, frameCollector());
+        check(_frames.size() == 1 && _frames[0].size() == 4, "idle frame completed by gap");
+
+        // Partial frame discarded after gap in delimited mode
+        framer.setup(RaftJson(R"({"type":"delim","delim":"0a","idleMs":2})"));
+        _frames.clear();
+        framer.addBytes((const uint8_t*)"xy", 2, 1000, frameCollector());
+        framer.addBytes((const uint8_t*)"z\n", 2, 10000, frameCollector());
+        check(_frames.size() == 1 && _frames[0].size() == 1 && _frames[0][0] == 'z', "stale partial frame discarded");
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Pseudo-terminal with a responder on the master side
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    class PtyResponder
+    {
+    public:
+        bool open()
+        {
+            _masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+            if ((_masterFd < 0) || (grantpt(_masterFd) != 0) || (unlockpt(_masterFd) != 0))
+                return false;
+            _slavePath = ptsname(_masterFd);
+            return true;
+        }
+        void start()
+        {
+            _stop = false;
+            _thread = std::thread([this]() { run(); });
+        }
+        void stop()
+        {
+            _stop = true;
+            if (_thread.joinable())
+                _thread.join();
+            if (_masterFd >= 0)
+                close(_masterFd);
+            _masterFd = -1;
+        }
+        const char* getSlavePath() const
+        {
+            return _slavePath.c_str();
+        }
+        void sendUnsolicited(const char* pStr)
+        {
+            write(_masterFd, pStr, strlen(pStr));
+        }
+
+    private:
+        // Respond to each line "Q<addr><payload>\n" with "R<addr><payload>\n" - requests with address 'z' are ignored
+        void run()
+        {
+            std::string line;
+            while (!_stop)
+            {
+                struct pollfd pfd = { _masterFd, POLLIN, 0 };
+                if (poll(&pfd, 1, 5) <= 0)
+                    continue;
+                char buf[256];
+                int len = read(_masterFd, buf, sizeof(buf));
+                for (int i = 0; i < len; i++)
+                {
+                    line += buf[i];
+                    if (buf[i] != '\n')
+                        continue;
+                    if ((line.size() > 2) && (line[0] == 'Q') && (line[1] != 'z'))
+                    {
+                        line[0] = 'R';
+                        write(_masterFd, line.c_str(), line.size());
+                    }
+                    line.clear();
+                }
+            }
+        }
+        int _masterFd = -1;
+        std::string _slavePath;
+        std::atomic<bool> _stop;
+        std::thread _thread;
+    };
+
+    class ResponseRecord
+    {
+    public:
+        std::atomic<uint32_t> count = 0;
+        std::atomic<uint32_t> timeouts = 0;
+        std::atomic<uint64_t> lastRxUs = 0;
+        String lastData;
+        uint32_t lastAddr = 0;
+    };
+
+    static void responseCB(void* pArg, BusRequestResult& result)
+    {
+        ResponseRecord* pRec = (ResponseRecord*)pArg;
+        if (result.getResult() == RAFT_BUS_SW_TIME_OUT)
+        {
+            pRec->timeouts++;
+            return;
+        }
+        pRec->lastData = String((const char*)result.getReadData(), result.getReadDataLen());
+        pRec->lastAddr = result.getAddress();
+        pRec->lastRxUs = micros();
+        pRec->count++;
+    }
+
+    static bool sendReq(BusSerial& bus, uint32_t addr, const String& payload, ResponseRecord* pRec)
+    {
+        String msg = "Q" + String((char)addr) + payload + "\n";
+        BusRequestInfo reqInfo(BUS_REQ_TYPE_STD, addr, 0, msg.length(), (const uint8_t*)msg.c_str(), 0, 0,
+                    pRec ? responseCB : nullptr, pRec);
+        return bus.addRequest(reqInfo);
+    }
+
+    static bool waitFor(std::atomic<uint32_t>& val, uint32_t target, uint32_t timeoutMs)
+    {
+        uint64_t startUs = micros();
+        while (val < target)
+        {
+            if (micros() - startUs > timeoutMs * 1000)
+                return false;
+            usleep(50);
+        }
+        return true;
+    }
+
+    void testPtyFramed()
+    {
+        PtyResponder responder;
+        if (!responder.open())
+        {
+            printf("  BusSerialTest pty not available - skipping\n");
+            return;
+        }
+        responder.start();
+        {
+            BusSerial bus(nullptr, nullptr);
+            String config = R"({"name":"ptyBus","dev":")" + String(responder.getSlavePath()) +
+                        R"(","frame":{"type":"delim","delim":"0a"},"respTimeoutMs":50,"matchAddrPos":1})";
+            check(bus.setup(0, RaftJson(config)), "pty bus setup");
+            check(bus.isFramed(), "pty bus framed");
+
+            // Request/response matched by address
+            ResponseRecord recA, recB;
+            check(sendReq(bus, 'a', "hello", &recA), "send a");
+            check(sendReq(bus, 'b', "world", &recB), "send b");
+            check(waitFor(recA.count, 1, 500) && waitFor(recB.count, 1, 500), "responses received");
+            check(recA.lastData.equals("Rahello") && recA.lastAddr == 'a', "response a matched");
+            check(recB.lastData.equals("Rbworld") && recB.lastAddr == 'b', "response b matched");
+
+            // Timeout
+            ResponseRecord recZ;
+            check(sendReq(bus, 'z', "nothing", &recZ), "send z");
+            check(waitFor(recZ.timeouts, 1, 500), "request times out");
+            check(recZ.count == 0, "no response for timed out request");
+
+            // Unsolicited frame
+            responder.sendUnsolicited("EVT:1\n");
+            uint64_t startUs = micros();
+            while ((bus.rxDataBytesAvailable() == 0) && (micros() - startUs < 500000))
+                usleep(100);
+            uint8_t buf[20];
+            uint32_t len = bus.rxDataGet(buf, sizeof(buf));
+            check(len == 5 && memcmp(buf, "EVT:1", 5) == 0, "unsolicited frame queued");
+
+            // Stats
+            RaftJson stats("{" + bus.getBusStatsJSON() + "}");
+            check(stats.getLong("ptyBus/rspOk", 0) == 2 && stats.getLong("ptyBus/rspTO", 0) == 1, "stats");
+        }
+        responder.stop();
+    }
+
+    void testPtyBlankLines()
+    {
+        PtyResponder responder;
+        if (!responder.open())
+            return;
+        responder.start();
+        {
+            // Responses are not matched by address so the first frame received completes the pending request
+            BusSerial bus(nullptr, nullptr);
+            String config = R"({"name":"ptyBlank","dev":")" + String(responder.getSlavePath()) +
+                        R"(","frame":{"type":"delim","delim":"0a"},"respTimeoutMs":500})";
+            check(bus.setup(0, RaftJson(config)), "blank bus setup");
+
+            // Blank lines before the response don't complete the request
+            ResponseRecord rec;
+            check(sendReq(bus, 'z', "waiting", &rec), "send pending request");
+            responder.sendUnsolicited("\n\nOK\n");
+            check(waitFor(rec.count, 1, 500), "response after blank lines");
+            check(rec.lastData.equals("OK") && (rec.timeouts == 0), "blank lines ignored");
+            check(bus.rxDataBytesAvailable() == 0, "no empty frames queued");
+        }
+        responder.stop();
+    }
+
+    void testFailedSend()
+    {
+        PtyResponder responder;
+        if (!responder.open())
+            return;
+        responder.start();
+        {
+            BusSerial bus(nullptr, nullptr);
+            String config = R"({"name":"ptyFail","dev":")" + String(responder.getSlavePath()) +
+                        R"(","frame":{"type":"delim","delim":"0a"},"respTimeoutMs":500,"matchAddrPos":1})";
+            check(bus.setup(0, RaftJson(config)), "fail bus setup");
+
+            // Request awaiting a response then a send which fails (the other end has closed)
+            ResponseRecord recZ, recFail;
+            check(sendReq(bus, 'z', "waiting", &recZ), "send waiting request");
+            responder.stop();
+            check(!sendReq(bus, 'y', "fails", &recFail), "send fails when closed");
+
+            // Only the failed request is removed - the earlier one remains and times out
+            check(bus.getQueuedRequestCount() == 1, "failed request removed");
+            check(waitFor(recZ.timeouts, 1, 1000), "earlier request still pending");
+            check(recFail.timeouts == 0 && recFail.count == 0, "no callback for failed send");
+        }
+    }
+
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Latency and throughput - framed (event-driven) vs polled from a simulated main loop
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+    void testLatency()
+    {
+        static const uint32_t NUM_REQS = 200;
+        static const uint32_t MAIN_LOOP_PERIOD_US = 1000;
+        PtyResponder responder;
+        if (!responder.open())
+            return;
+        responder.start();
+
+        // Framed - sequential requests for latency
+        double framedLatencyUs = 0;
+        double framedThroughput = 0;
+        {
+            BusSerial bus(nullptr, nullptr);
+            String config = R"({"name":"ptyFramed","dev":")" + String(responder.getSlavePath()) +
+                        R"(","frame":{"type":"delim","delim":"0a"},"respTimeoutMs":500})";
+            bus.setup(0, RaftJson(config));
+            ResponseRecord rec;
+            uint64_t totalUs = 0;
+            for (uint32_t i = 0; i < NUM_REQS; i++)
+            {
+                uint64_t sendUs = micros();
+                sendReq(bus, 'a', "ping", &rec);
+                if (!waitFor(rec.count, i + 1, 500))
+                    break;
+                totalUs += rec.lastRxUs - sendUs;
+            }
+            check(rec.count == NUM_REQS, "framed all responses");
+            framedLatencyUs = (double)totalUs / NUM_REQS;
+
+            // Pipelined requests for throughput (limited by the pending request queue)
+            rec.count = 0;
+            uint64_t startUs = micros();
+            uint32_t sent = 0;
+            while ((rec.count < NUM_REQS) && (micros() - startUs < 2000000))
+            {
+                if ((sent < NUM_REQS) && sendReq(bus, 'a', "ping", &rec))
+                    sent++;
+                else
+                    usleep(20);
+            }
+            check(rec.count == NUM_REQS, "framed pipelined responses");
+            framedThroughput = rec.count * 1e6 / (micros() - startUs);
+        }
+
+        // Polled - consumer services the bus from a main loop and does its own framing
+        double polledLatencyUs = 0;
+        {
+            BusSerial bus(nullptr, nullptr);
+            String config = R"({"name":"ptyPolled","dev":")" + String(responder.getSlavePath()) + R"("})";
+            bus.setup(0, RaftJson(config));
+            check(!bus.isFramed(), "polled bus not framed");
+            uint64_t totalUs = 0;
+            uint32_t numResps = 0;
+            for (uint32_t i = 0; i < NUM_REQS / 4; i++)
+            {
+                uint64_t sendUs = micros();
+                sendReq(bus, 'a', "ping", nullptr);
+                String line;
+                bool gotResp = false;
+                while (!gotResp && (micros() - sendUs < 500000))
+                {
+                    usleep(MAIN_LOOP_PERIOD_US);
+                    uint8_t buf[64];
+                    uint32_t len = bus.rxDataGet(buf, sizeof(buf));
+                    for (uint32_t j = 0; j < len; j++)
+                    {
+                        if (buf[j] == '\n')
+                            gotResp = true;
+                    }
+                }
+                if (!gotResp)
+                    break;
+                totalUs += micros() - sendUs;
+                numResps++;
+            }
+            check(numResps == NUM_REQS / 4, "polled all responses");
+            polledLatencyUs = numResps == 0 ? 0 : (double)totalUs / numResps;
+        }
+        responder.stop();
+
+        printf("  BusSerial latency: framed %.1f us, polled (%u us loop) %.1f us; framed throughput %.0f req/s\n",
+                    framedLatencyUs, (unsigned)MAIN_LOOP_PERIOD_US, polledLatencyUs, framedThroughput);
+        check(framedLatencyUs < polledLatencyUs, "framed latency lower than polled");
+    }
+};
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <map>
+#include "FileSystem.h"
+#include "BusTopologyCache.h"
+#include "BusDeviceScanner.h"
+#include "DeviceTypeRecords.h"
+
+class BusTopologyCacheTest
+{
+public:
+    void loop()
+    {
+        printf("Running BusTopologyCacheTest...\n");
+
+        fileSystem.setup(FileSystem::LOCAL_FS_SPIFFS, false, false, -1, -1, -1, -1, false, false);
+        fileSystem.deleteFile("local", TEST_FILE_NAME);
+
+        if (!findTestDevices())
+        {
+            check(false, "find test devices");
+        }
+        else
+        {
+            testColdAndWarmStart();
+            testChangedDevices();
+        }
+        testStatusChanges();
+        testInvalidTypeDropped();
+        testChangesBeforeLoad();
+
+        fileSystem.deleteFile("local", TEST_FILE_NAME);
+
+        if (_failCount > 0)
+            printf("BusTopologyCacheTest FAILED %d tests\n", _failCount);
+        else
+            printf("BusTopologyCacheTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+    static constexpr const char* TEST_FILE_NAME = "/tmp/raft_bus_topo_test.json";
+
+    // Simulated bus timing (us)
+    static const uint32_t SIM_PROBE_US = 200;
+    static const uint32_t SIM_IDENT_ATTEMPT_US = 1000;
+    static const uint32_t SIM_FIRST_POLL_US = 500;
+    static const BusElemAddrType SIM_ADDR_MIN = 0x08;
+    static const BusElemAddrType SIM_ADDR_MAX = 0x77;
+
+    // Addresses with device types (from the generated records) used as simulated devices
+    std::vector<std::pair<BusElemAddrType, DeviceTypeIndexType>> _testDevs;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  BusTopologyCacheTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    bool findTestDevices()
+    {
+        // Use the last candidate type at each address so cold identification has to try the others first
+        for (BusElemAddrType addr = SIM_ADDR_MAX; addr >= SIM_ADDR_MIN; addr--)
+        {
+            std::vector<DeviceTypeIndexType> typeIdxs = deviceTypeRecords.getDeviceTypeIdxsForAddr(addr);
+            if (typeIdxs.size() == 0)
+                continue;
+            _testDevs.push_back({addr, typeIdxs.back()});
+            if (_testDevs.size() >= 4)
+                break;
+        }
+        return _testDevs.size() >= 2;
+    }
+
+    /// @brief Simulated bus - the scanner probes and identifies simulated devices and the bus reports them
+    /// to the topology cache. Simulated time is only added for the bus operations the scanner performs.
+    class SimBus
+    {
+    public:
+        SimBus(const std::map<BusElemAddrType, DeviceTypeIndexType>& devices, BusTopologyCache& topoCache) :
+            _devices(devices), _topoCache(topoCache),
+            _scanner(topoCache,
+                [this](BusElemAddrType addr) {
+                    _timeUs += SIM_PROBE_US;
+                    return _devices.count(addr) > 0;
+                },
+                [this](BusElemAddrType addr, DeviceTypeIndexType devTypeIdx) {
+                    _timeUs += SIM_IDENT_ATTEMPT_US;
+                    auto it = _devices.find(addr);
+                    return (it != _devices.end()) && (it->second == devTypeIdx);
+                },
+                [this](BusElemAddrType addr, DeviceTypeIndexType devTypeIdx) {
+                    deviceIdentified(addr, devTypeIdx);
+                })
+        {
+            _scanner.setup(SIM_ADDR_MIN, SIM_ADDR_MAX);
+        }
+
+        // Service the scanner until complete
+        // Returns simulated time (us) at which every present device has produced its first data
+        uint64_t run()
+        {
+            while (_scanner.service())
+                ;
+            return _allFirstDataUs;
+        }
+
+        uint64_t getFirstDataUs() const
+        {
+            return _firstDataUs;
+        }
+
+        const std::map<BusElemAddrType, DeviceTypeIndexType>& getIdentified() const
+        {
+            return _identified;
+        }
+
+        const BusDeviceScanner& getScanner() const
+        {
+            return _scanner;
+        }
+
+    private:
+        const std::map<BusElemAddrType, DeviceTypeIndexType>& _devices;
+        BusTopologyCache& _topoCache;
+        BusDeviceScanner _scanner;
+        std::map<BusElemAddrType, DeviceTypeIndexType> _identified;
+        uint64_t _timeUs = 0;
+        uint64_t _firstDataUs = 0;
+        uint64_t _allFirstDataUs = 0;
+
+        void deviceIdentified(BusElemAddrType addr, DeviceTypeIndexType devTypeIdx)
+        {
+            _identified[addr] = devTypeIdx;
+            std::vector<BusAddrStatus> statusChanges = {BusAddrStatus(addr, DeviceOnlineState::ONLINE, true, true, devTypeIdx)};
+            _topoCache.handleStatusChanges(statusChanges);
+            uint64_t dataUs = _timeUs + SIM_FIRST_POLL_US;
+            if (_firstDataUs == 0)
+                _firstDataUs = dataUs;
+            if (_identified.size() == _devices.size())
+                _allFirstDataUs = dataUs;
+        }
+    };
+
+    std::map<BusElemAddrType, DeviceTypeIndexType> devicesFrom(uint32_t firstIdx, uint32_t count)
+    {
+        std::map<BusElemAddrType, DeviceTypeIndexType> devices;
+        for (uint32_t i = firstIdx; (i < firstIdx + count) && (i < _testDevs.size()); i++)
+            devices[_testDevs[i].first] = _testDevs[i].second;
+        return devices;
+    }
+
+    void testColdAndWarmStart()
+    {
+        std::map<BusElemAddrType, DeviceTypeIndexType> devices = devicesFrom(0, _testDevs.size());
+
+        // Cold start (nothing persisted)
+        BusTopologyCache coldCache;
+        coldCache.setup("local", TEST_FILE_NAME);
+        check(coldCache.getNumKnown() == 0, "cold start nothing known");
+        SimBus coldBus(devices, coldCache);
+        uint64_t coldUs = coldBus.run();
+        check(coldBus.getIdentified() == devices, "cold start identifies all");
+        check(coldCache.getNumKnown() == devices.size(), "cold start devices recorded");
+        check(coldCache.save(), "save");
+
+        // Warm start (new instance loads the persisted topology)
+        BusTopologyCache warmCache;
+        warmCache.setup("local", TEST_FILE_NAME);
+        check(warmCache.getNumKnown() == devices.size(), "warm start loads devices");
+        check(!warmCache.isVerifyComplete(), "warm start awaiting verify");
+        check(warmCache.isAwaitingVerify(devices.begin()->first), "address awaiting verify");
+        SimBus warmBus(devices, warmCache);
+        uint64_t warmUs = warmBus.run();
+        check(warmCache.isVerifyComplete(), "warm start verify complete");
+        check(warmBus.getIdentified() == devices, "warm start identifies all");
+        check(coldBus.getScanner().isComplete() && warmBus.getScanner().isComplete(), "scans complete");
+        check(warmBus.getScanner().getNumIdentAttempts() == devices.size(), "warm start one identification per device");
+        check(warmBus.getScanner().getNumIdentAttempts() <= coldBus.getScanner().getNumIdentAttempts(), "warm start no extra identifications");
+        check(warmBus.getScanner().getNumProbes() == coldBus.getScanner().getNumProbes(), "warm start scans each address once");
+        check(warmUs < coldUs, "warm start faster");
+        check(warmBus.getFirstDataUs() < coldBus.getFirstDataUs(), "warm start first data sooner");
+        printf("  BusTopologyCacheTest %d devices time-to-first-data cold %.1fms warm %.1fms (all devices) cold %.1fms warm %.1fms (first device)\n",
+                    (int)devices.size(), coldUs / 1000.0, warmUs / 1000.0,
+                    coldBus.getFirstDataUs() / 1000.0, warmBus.getFirstDataUs() / 1000.0);
+    }
+
+    void testChangedDevices()
+    {
+        // Persist the first devices
+        std::map<BusElemAddrType, DeviceTypeIndexType> oldDevices = devicesFrom(0, _testDevs.size() - 1);
+        {
+            BusTopologyCache cache;
+            cache.setup("local", TEST_FILE_NAME);
+            cache.clear();
+            SimBus bus(oldDevices, cache);
+            bus.run();
+            check(cache.save(), "save old devices");
+        }
+
+        // One device removed and another added
+        std::map<BusElemAddrType, DeviceTypeIndexType> newDevices = devicesFrom(1, _testDevs.size() - 1);
+        BusTopologyCache cache;
+        cache.setup("local", TEST_FILE_NAME);
+        check(cache.getNumKnown() == oldDevices.size(), "changed known count");
+        SimBus bus(newDevices, cache);
+        bus.run();
+        check(bus.getIdentified() == newDevices, "changed devices identified");
+        check(cache.getNumKnown() == newDevices.size(), "changed devices recorded");
+        check(!cache.isAwaitingVerify(_testDevs[0].first), "removed device not awaiting");
+        check(cache.save(), "save changed");
+
+        // Reload reflects the new devices
+        BusTopologyCache reloaded;
+        reloaded.setup("local", TEST_FILE_NAME);
+        check(reloaded.getNumKnown() == newDevices.size(), "reload changed count");
+        check(!reloaded.isAwaitingVerify(_testDevs[0].first) && reloaded.isAwaitingVerify(_testDevs.back().first), "reload changed devices");
+    }
+
+    void testStatusChanges()
+    {
+        fileSystem.deleteFile("local", TEST_FILE_NAME);
+        BusTopologyCache cache;
+        std::vector<BusAddrStatus> online = {BusAddrStatus(0x20, DeviceOnlineState::ONLINE, true, true, 0)};
+
+        // Disabled cache ignores changes
+        cache.handleStatusChanges(online);
+        check(cache.getNumKnown() == 0, "disabled ignores changes");
+
+        // Online with type recorded, unidentified and offline are not
+        cache.setup("local", TEST_FILE_NAME);
+        cache.handleStatusChanges(online);
+        std::vector<BusAddrStatus> others = {
+            BusAddrStatus(0x21, DeviceOnlineState::ONLINE, true, false),
+            BusAddrStatus(0x22, DeviceOnlineState::OFFLINE, true, false, 0)
+        };
+        cache.handleStatusChanges(others);
+        check(cache.getNumKnown() == 1, "only identified online recorded");
+
+        // Offline keeps the record, pending deletion removes it
+        std::vector<BusAddrStatus> offline = {BusAddrStatus(0x20, DeviceOnlineState::OFFLINE, true, false, 0)};
+        cache.handleStatusChanges(offline);
+        check(cache.getNumKnown() == 1, "offline kept");
+        std::vector<BusAddrStatus> deleted = {BusAddrStatus(0x20, DeviceOnlineState::PENDING_DELETION, true, false, 0)};
+        cache.handleStatusChanges(deleted);
+        check(cache.getNumKnown() == 0, "pending deletion removed");
+    }
+
+    void testInvalidTypeDropped()
+    {
+        String topoJson = R"({"devs":[{"a":32,"t":"NoSuchDeviceType"},{"a":33,"t":""}]})";
+        check(fileSystem.setFileContents("local", TEST_FILE_NAME, topoJson), "write invalid topology");
+        BusTopologyCache cache;
+        cache.setup("local", TEST_FILE_NAME);
+        check(cache.getNumKnown() == 0, "invalid types dropped");
+        check(cache.isVerifyComplete(), "nothing to verify");
+        check(cache.save(), "save after dropping");
+        BusTopologyCache reloaded;
+        reloaded.setup("local", TEST_FILE_NAME);
+        check(reloaded.getNumKnown() == 0, "reload after dropping");
+    }
+
+    void testChangesBeforeLoad()
+    {
+        // Persisted topology has a device at 0x20
+        String topoJson = String(R"({"devs":[{"a":32,"t":")") + deviceTypeNameAt(0x20) + R"("}]})";
+        fileSystem.deleteFile("local", TEST_FILE_NAME);
+        if (deviceTypeNameAt(0x20).length() == 0)
+            return;
+        check(fileSystem.setFileContents("local", TEST_FILE_NAME, topoJson), "write topology");
+        BusTopologyCache cache;
+        cache.setup("local", TEST_FILE_NAME);
+        check(cache.isAwaitingVerify(0x20), "loaded device awaiting verify");
+
+        // Device reported by the bus and then the cache is setup again - the reported device is kept
+        DeviceTypeIndexType devTypeIdx = deviceTypeRecords.getDeviceTypeIdxsForAddr(0x20).front();
+        std::vector<BusAddrStatus> online = {BusAddrStatus(0x20, DeviceOnlineState::ONLINE, true, true, devTypeIdx)};
+        cache.handleStatusChanges(online);
+        check(!cache.isAwaitingVerify(0x20), "reported device verified");
+        cache.setup("local", TEST_FILE_NAME);
+        check((cache.getNumKnown() == 1) && !cache.isAwaitingVerify(0x20), "reported device kept on load");
+    }
+
+    String deviceTypeNameAt(BusElemAddrType addr)
+    {
+        std::vector<DeviceTypeIndexType> typeIdxs = deviceTypeRecords.getDeviceTypeIdxsForAddr(addr);
+        if (typeIdxs.size() == 0)
+            return "";
+        DeviceTypeRecord devTypeRec;
+        if (!deviceTypeRecords.getDeviceInfo(typeIdxs.front(), devTypeRec) || !devTypeRec.deviceType)
+            return "";
+        return devTypeRec.deviceType;
+    }
+};
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include "DNSResolverCache.h"
+#include "RaftThreading.h"
+
+class DNSResolverCacheTest
+{
+public:
+    void loop()
+    {
+        printf("Running DNSResolverCacheTest...\n");
+
+        testMissAndCoalesce();
+        testTTLAndStale();
+        testNegative();
+        testConcurrentLookups();
+        testEviction();
+        testStaleResults();
+        testLookupLatency();
+
+        if (_failCount > 0)
+            printf("DNSResolverCacheTest FAILED %d tests\n", _failCount);
+        else
+            printf("DNSResolverCacheTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  DNSResolverCacheTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    static uint64_t nowUs()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    static DNSIPAddr makeAddr(uint32_t val)
+    {
+        DNSIPAddr addr;
+        addr.addr = val;
+        return addr;
+    }
+
+    // Stub transport - results are immediate, completed by the test or completed on a thread after a latency
+    class StubTransport : public DNSTransportIF
+    {
+    public:
+        enum Mode
+        {
+            MODE_MANUAL,
+            MODE_IMMEDIATE,
+            MODE_IMMEDIATE_FAIL,
+            MODE_THREADED
+        };
+        Mode mode = MODE_MANUAL;
+        uint32_t nextAddr = 1;
+        uint32_t latencyMs = 20;
+        std::vector<String> lookups;
+        std::vector<uint32_t> lookupIDs;
+
+        virtual ~StubTransport()
+        {
+            joinAll();
+        }
+
+        virtual LookupResult startLookup(const char* hostname, uint32_t lookupID, DNSIPAddr& addr) override
+        {
+            lookups.push_back(hostname);
+            lookupIDs.push_back(lookupID);
+            switch (mode)
+            {
+                case MODE_IMMEDIATE:
+                    addr = makeAddr(nextAddr);
+                    return LOOKUP_DONE;
+                case MODE_IMMEDIATE_FAIL:
+                    return LOOKUP_FAILED;
+                case MODE_THREADED:
+                {
+                    ThreadedLookup* pLookup = new ThreadedLookup{this, hostname, lookupID, nextAddr};
+                    RaftThreadHandle handle;
+                    RaftThread_start(handle, threadedLookupFn, pLookup);
+                    _threads.push_back(handle);
+                    return LOOKUP_IN_PROGRESS;
+                }
+                default:
+                    return LOOKUP_IN_PROGRESS;
+            }
+        }
+
+        // Complete the most recent lookup of a hostname
+        void complete(const char* hostname, bool success, uint32_t addrVal)
+        {
+            uint32_t lookupID = 0;
+            for (size_t i = 0; i < lookups.size(); i++)
+                if (lookups[i] == hostname)
+                    lookupID = lookupIDs[i];
+            completeLookup(lookupID, hostname, success, addrVal);
+        }
+
+        void completeLookup(uint32_t lookupID, const char* hostname, bool success, uint32_t addrVal)
+        {
+            if (_resultCB)
+                _resultCB(lookupID, hostname, success, makeAddr(addrVal));
+        }
+
+        void joinAll()
+        {
+            for (RaftThreadHandle& handle : _threads)
+                pthread_join(handle, NULL);
+            _threads.clear();
+        }
+
+    private:
+        struct ThreadedLookup
+        {
+            StubTransport* pTransport;
+            String hostname;
+            uint32_t lookupID;
+            uint32_t addrVal;
+        };
+        std::vector<RaftThreadHandle> _threads;
+
+        static void threadedLookupFn(void* pArg)
+        {
+            ThreadedLookup* pLookup = (ThreadedLookup*)pArg;
+            RaftThread_sleep(pLookup->pTransport->latencyMs);
+            pLookup->pTransport->completeLookup(pLookup->lookupID, pLookup->hostname.c_str(), true, pLookup->addrVal);
+            delete pLookup;
+        }
+    };
+
+    // Record of a result callback
+    struct CBResult
+    {
+        String hostname;
+        bool success;
+        uint32_t addrVal;
+    };
+
+    static DNSLookupResultCB recordCB(std::vector<CBResult>& results)
+    {
+        return [&results](const char* hostname, bool success, const DNSIPAddr& addr) {
+            results.push_back({hostname, success, addr.addr});
+        };
+    }
+
+    void testMissAndCoalesce()
+    {
+        StubTransport transport;
+        DNSResolverCache cache(&transport);
+        std::vector<CBResult> results;
+        DNSIPAddr addr = {};
+
+        // Two callers waiting on the same hostname share one lookup
+        check(cache.resolve("broker.local", addr, recordCB(results)) == DNSResolverCache::RESOLVE_PENDING, "first miss pending");
+        check(cache.resolve("broker.local", addr, recordCB(results)) == DNSResolverCache::RESOLVE_PENDING, "second miss pending");
+        check(transport.lookups.size() == 1, "lookups coalesced");
+        transport.complete("broker.local", true, 0x0a000001);
+        check(results.size() == 2, "all waiters called");
+        for (const CBResult& result : results)
+            check(result.success && (result.addrVal == 0x0a000001), "waiter result");
+
+        // Then served from the cache
+        results.clear();
+        check(cache.resolve("broker.local", addr, recordCB(results)) == DNSResolverCache::RESOLVE_OK, "hit");
+        check((addr.addr == 0x0a000001) && results.empty() && (transport.lookups.size() == 1), "hit address without lookup");
+
+        // Immediate transport results are returned directly without a callback
+        transport.mode = StubTransport::MODE_IMMEDIATE;
+        transport.nextAddr = 0x0a000002;
+        check(cache.resolve("other.local", addr, recordCB(results)) == DNSResolverCache::RESOLVE_OK, "immediate result");
+        check((addr.addr == 0x0a000002) && results.empty(), "immediate address");
+
+        DNSResolverCache::Stats stats = cache.getStats();
+        check((stats.hits == 1) && (stats.misses == 3) && (stats.lookups == 2), "stats");
+    }
+
+    void testTTLAndStale()
+    {
+        StubTransport transport;
+        DNSResolverCache cache(&transport);
+        cache.setConfig(40, 150, 40, 8);
+        DNSIPAddr addr = {};
+        transport.mode = StubTransport::MODE_IMMEDIATE;
+        transport.nextAddr = 0x0a000001;
+        check(cache.resolve("host", addr) == DNSResolverCache::RESOLVE_OK, "initial resolve");
+
+        // After the TTL the stale address is returned while a single revalidation runs
+        delay(60);
+        transport.mode = StubTransport::MODE_MANUAL;
+        addr = {};
+        check((cache.resolve("host", addr) == DNSResolverCache::RESOLVE_OK) && (addr.addr == 0x0a000001), "stale address returned");
+        check((cache.resolve("host", addr) == DNSResolverCache::RESOLVE_OK) && (transport.lookups.size() == 2), "one revalidation");
+        transport.complete("host", true, 0x0a000002);
+        check((cache.resolve("host", addr) == DNSResolverCache::RESOLVE_OK) && (addr.addr == 0x0a000002), "revalidated address");
+        check(cache.getStats().staleHits == 2, "stale hits counted");
+
+        // A failed revalidation keeps the stale address until the stale period ends
+        delay(60);
+        cache.resolve("host", addr);
+        transport.complete("host", false, 0);
+        check((cache.resolve("host", addr) == DNSResolverCache::RESOLVE_OK) && (addr.addr == 0x0a000002), "stale kept after failed revalidation");
+        delay(160);
+        check(cache.resolve("host", addr) == DNSResolverCache::RESOLVE_PENDING, "address discarded after stale period");
+
+        // Invalidate forces a lookup
+        transport.complete("host", true, 0x0a000003);
+        cache.invalidate("host");
+        check(cache.resolve("host", addr) == DNSResolverCache::RESOLVE_PENDING, "invalidated");
+    }
+
+    void testNegative()
+    {
+        StubTransport transport;
+        DNSResolverCache cache(&transport);
+        cache.setConfig(1000, 1000, 40, 8);
+        transport.mode = StubTransport::MODE_IMMEDIATE_FAIL;
+        DNSIPAddr addr = {};
+        check(cache.resolve("bad", addr) == DNSResolverCache::RESOLVE_FAILED, "failed lookup");
+        check(cache.resolve("bad", addr) == DNSResolverCache::RESOLVE_FAILED, "negative hit");
+        check((transport.lookups.size() == 1) && (cache.getStats().negativeHits == 1), "no lookup while negatively cached");
+        delay(60);
+        transport.mode = StubTransport::MODE_IMMEDIATE;
+        check(cache.resolve("bad", addr) == DNSResolverCache::RESOLVE_OK, "retried after negative TTL");
+        check(transport.lookups.size() == 2, "retry lookup");
+
+        // No transport
+        DNSResolverCache noTransportCache;
+        check(noTransportCache.resolve("x", addr) == DNSResolverCache::RESOLVE_FAILED, "no transport");
+        check(cache.resolve("", addr) == DNSResolverCache::RESOLVE_FAILED, "empty hostname");
+    }
+
+    void testConcurrentLookups()
+    {
+        StubTransport transport;
+        DNSResolverCache cache(&transport);
+        std::vector<CBResult> results;
+        DNSIPAddr addr = {};
+        const char* hostnames[] = {"a.local", "b.local", "c.local"};
+        for (const char* hostname : hostnames)
+            check(cache.resolve(hostname, addr, recordCB(results)) == DNSResolverCache::RESOLVE_PENDING, "concurrent pending");
+        check(transport.lookups.size() == 3, "concurrent lookups started");
+
+        // Complete out of order
+        transport.complete("c.local", true, 3);
+        transport.complete("a.local", true, 1);
+        transport.complete("b.local", false, 0);
+        check(results.size() == 3, "all completed");
+        for (const CBResult& result : results)
+        {
+            if (result.hostname == "a.local")
+                check(result.success && (result.addrVal == 1), "a result");
+            else if (result.hostname == "b.local")
+                check(!result.success, "b result");
+            else
+                check(result.success && (result.addrVal == 3), "c result");
+        }
+        check((cache.resolve("c.local", addr) == DNSResolverCache::RESOLVE_OK) && (addr.addr == 3), "c cached");
+
+        // Late result for an unknown hostname is ignored
+        transport.complete("unknown", true, 9);
+        check(cache.getNumEntries() == 3, "unknown result ignored");
+    }
+
+    void testEviction()
+    {
+        StubTransport transport;
+        DNSResolverCache cache(&transport);
+        cache.setConfig(1000, 1000, 1000, 2);
+        transport.mode = StubTransport::MODE_IMMEDIATE;
+        DNSIPAddr addr = {};
+        cache.resolve("a", addr);
+        delay(2);
+        cache.resolve("b", addr);
+        delay(2);
+        cache.resolve("a", addr);
+        delay(2);
+        cache.resolve("c", addr);
+        check(cache.getNumEntries() == 2, "size limited");
+        size_t numLookups = transport.lookups.size();
+        check(cache.resolve("a", addr) == DNSResolverCache::RESOLVE_OK && (transport.lookups.size() == numLookups), "recently used kept");
+        cache.resolve("b", addr);
+        check(transport.lookups.size() == numLookups + 1, "least recently used evicted");
+    }
+
+    void testStaleResults()
+    {
+        StubTransport transport;
+        DNSResolverCache cache(&transport);
+        cache.setConfig(1000, 1000, 20, 8, 30);
+        std::vector<CBResult> results;
+        DNSIPAddr addr = {};
+
+        // Lookup the transport doesn't complete is abandoned and its waiters fail
+        check(cache.resolve("late.local", addr, recordCB(results)) == DNSResolverCache::RESOLVE_PENDING, "lookup pending");
+        delay(40);
+        check(cache.resolve("late.local", addr) == DNSResolverCache::RESOLVE_FAILED, "lookup timed out");
+        check((results.size() == 1) && !results[0].success, "waiter failed on timeout");
+
+        // Late result of the abandoned lookup isn't taken as the result of a newer lookup
+        delay(30);
+        results.clear();
+        check(cache.resolve("late.local", addr, recordCB(results)) == DNSResolverCache::RESOLVE_PENDING, "new lookup pending");
+        check((transport.lookupIDs.size() == 2) && (transport.lookupIDs[0] != transport.lookupIDs[1]), "lookups have different IDs");
+        transport.completeLookup(transport.lookupIDs[0], "late.local", true, 0x0a000001);
+        check(results.empty() && (cache.resolve("late.local", addr) == DNSResolverCache::RESOLVE_PENDING), "stale result ignored");
+        transport.completeLookup(transport.lookupIDs[1], "late.local", true, 0x0a000002);
+        check((results.size() == 1) && results[0].success && (results[0].addrVal == 0x0a000002), "current result used");
+        check((cache.resolve("late.local", addr) == DNSResolverCache::RESOLVE_OK) && (addr.addr == 0x0a000002), "current address cached");
+
+        // Result of a lookup outstanding when the cache was cleared is discarded
+        check(cache.resolve("cleared.local", addr) == DNSResolverCache::RESOLVE_PENDING, "lookup before clear");
+        uint32_t clearedLookupID = transport.lookupIDs.back();
+        cache.clear();
+        check(cache.resolve("cleared.local", addr) == DNSResolverCache::RESOLVE_PENDING, "lookup after clear");
+        transport.completeLookup(clearedLookupID, "cleared.local", true, 0x0a000003);
+        check(cache.resolve("cleared.local", addr) == DNSResolverCache::RESOLVE_PENDING, "result from before clear discarded");
+    }
+
+    void testLookupLatency()
+    {
+        StubTransport transport;
+        transport.mode = StubTransport::MODE_THREADED;
+        transport.latencyMs = 20;
+        DNSResolverCache cache(&transport);
+        cache.setConfig(50, 1000, 1000, 8);
+        RaftSemaphore doneSem;
+        RaftSemaphore_init(doneSem, 0, 1);
+        DNSIPAddr addr = {};
+        DNSLookupResultCB doneCB = [&doneSem](const char* hostname, bool success, const DNSIPAddr& addr) {
+            RaftSemaphore_give(doneSem);
+        };
+
+        // Cold lookup waits for the transport
+        uint64_t startUs = nowUs();
+        check(cache.resolve("slow.local", addr, doneCB) == DNSResolverCache::RESOLVE_PENDING, "cold pending");
+        check(RaftSemaphore_take(doneSem, 1000), "cold completed");
+        uint64_t coldUs = nowUs() - startUs;
+
+        // Warm lookup from the cache
+        startUs = nowUs();
+        check(cache.resolve("slow.local", addr) == DNSResolverCache::RESOLVE_OK, "warm hit");
+        uint64_t warmUs = nowUs() - startUs;
+
+        // Expired lookup returns the stale address without waiting for revalidation
+        delay(60);
+        startUs = nowUs();
+        check(cache.resolve("slow.local", addr) == DNSResolverCache::RESOLVE_OK, "stale hit");
+        uint64_t staleUs = nowUs() - startUs;
+        transport.joinAll();
+        check(cache.getStats().lookups == 2, "revalidated in background");
+
+        printf("  DNS resolve latency: cold %lluus, cached %lluus, stale-while-revalidate %lluus\n",
+                    (unsigned long long)coldUs, (unsigned long long)warmUs, (unsigned long long)staleUs);
+        check(coldUs >= 19000, "cold lookup waits for transport");
+        check((warmUs < 5000) && (staleUs < 5000), "cached lookups don't wait");
+        RaftSemaphore_destroy(doneSem);
+    }
+};
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "DebounceButton.h"
+#include "RaftArduino.h"
+
+class DebounceButtonTest
+{
+public:
+    void loop()
+    {
+        printf("Running DebounceButtonTest...\n");
+
+        testEdgePressRelease();
+        testEdgeBounceSettle();
+        testEdgeOverflow();
+        testTimingVsPolled();
+
+        if (_failCount > 0)
+            printf("DebounceButtonTest FAILED %d tests\n", _failCount);
+        else
+            printf("DebounceButtonTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  DebounceButtonTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    static const int BUTTON_PIN = 5;
+    static const uint32_t DEBOUNCE_MS = 20;
+    static const uint16_t REPEAT_MS = 50;
+
+    struct ButtonEvent
+    {
+        bool val;
+        uint32_t msSinceLastChange;
+        uint16_t repeatCount;
+    };
+
+    // Button active low with pullup (released when the pin is high)
+    void setupButton(DebounceButton& button, std::vector<ButtonEvent>& events, bool useEdgeInterrupts)
+    {
+        gpioSimSetInputLevel(BUTTON_PIN, HIGH);
+        button.setup(BUTTON_PIN, true, false,
+            [&events](bool val, uint32_t msSinceLastChange, uint16_t repeatCount) {
+                events.push_back({val, msSinceLastChange, repeatCount});
+            },
+            DEBOUNCE_MS, REPEAT_MS, useEdgeInterrupts);
+    }
+
+    // Drive the pin and return the time of the last edge (when the level settled)
+    static uint64_t driveWithBounces(uint8_t finalLevel, uint32_t numBounces)
+    {
+        uint64_t edgeUs = micros();
+        gpioSimSetInputLevel(BUTTON_PIN, finalLevel);
+        for (uint32_t i = 0; i < numBounces; i++)
+        {
+            delayMicroseconds(300);
+            gpioSimSetInputLevel(BUTTON_PIN, !finalLevel);
+            delayMicroseconds(300);
+            edgeUs = micros();
+            gpioSimSetInputLevel(BUTTON_PIN, finalLevel);
+        }
+        return edgeUs;
+    }
+
+    static bool near(uint32_t actualMs, uint64_t expectedUs, uint32_t toleranceMs = 1)
+    {
+        return llabs((int64_t)actualMs * 1000 - (int64_t)expectedUs) <= (int64_t)toleranceMs * 1000;
+    }
+
+    void testEdgePressRelease()
+    {
+        DebounceButton button;
+        std::vector<ButtonEvent> events;
+        setupButton(button, events, true);
+        uint64_t setupUs = micros();
+        delay(30);
+
+        // Press with bounces then hold - loop() not called until long after (as if the main loop was busy)
+        uint64_t pressUs = driveWithBounces(LOW, 3);
+        delay(130);
+        button.loop();
+        check(button.isButtonPressed(), "pressed");
+        check(events.size() == 3, "press and two repeats");
+        if (events.size() == 3)
+        {
+            check(events[0].val && (events[0].repeatCount == 0), "press event");
+            check(near(events[0].msSinceLastChange, pressUs - setupUs), "time released before press");
+            check((events[1].repeatCount == 1) && (events[1].msSinceLastChange == REPEAT_MS), "first repeat");
+            check((events[2].repeatCount == 2) && (events[2].msSinceLastChange == 2 * REPEAT_MS), "second repeat");
+        }
+
+        // Release with bounces
+        events.clear();
+        uint64_t releaseUs = driveWithBounces(HIGH, 2);
+        delay(40);
+        button.loop();
+        check(!button.isButtonPressed(), "released");
+        check((events.size() == 1) && !events[0].val, "release event");
+        if (events.size() == 1)
+            check(near(events[0].msSinceLastChange, releaseUs - pressUs), "exact hold duration");
+
+        // No more events while idle
+        events.clear();
+        delay(10);
+        button.loop();
+        check(events.empty(), "idle");
+    }
+
+    void testEdgeBounceSettle()
+    {
+        // A pulse shorter than the debounce time is ignored
+        DebounceButton button;
+        std::vector<ButtonEvent> events;
+        setupButton(button, events, true);
+        delay(25);
+        driveWithBounces(LOW, 0);
+        delay(5);
+        driveWithBounces(HIGH, 0);
+        delay(40);
+        button.loop();
+        check(events.empty() && !button.isButtonPressed(), "short pulse ignored");
+
+        // A press is only accepted once it has lasted the debounce time
+        uint64_t pressUs = driveWithBounces(LOW, 0);
+        delay(DEBOUNCE_MS / 2);
+        button.loop();
+        check(events.empty() && !button.isButtonPressed(), "press not accepted within debounce time");
+        delay(DEBOUNCE_MS);
+        button.loop();
+        check((events.size() == 1) && events[0].val && button.isButtonPressed(), "press accepted after debounce time");
+        uint64_t releaseUs = driveWithBounces(HIGH, 0);
+        delay(DEBOUNCE_MS + 5);
+        button.loop();
+        check((events.size() == 2) && !events[1].val, "release accepted after debounce time");
+        if (events.size() == 2)
+            check(near(events[1].msSinceLastChange, releaseUs - pressUs), "press timed from settled edges");
+
+        // A glitch within the debounce time which returns to the pressed level is ignored
+        events.clear();
+        delay(25);
+        driveWithBounces(LOW, 0);
+        delay(5);
+        gpioSimSetInputLevel(BUTTON_PIN, HIGH);
+        delay(5);
+        gpioSimSetInputLevel(BUTTON_PIN, LOW);
+        delay(25);
+        button.loop();
+        check((events.size() == 1) && events[0].val && button.isButtonPressed(), "glitch ignored");
+        gpioSimSetInputLevel(BUTTON_PIN, HIGH);
+    }
+
+    void testEdgeOverflow()
+    {
+        DebounceButton button;
+        std::vector<ButtonEvent> events;
+        setupButton(button, events, true);
+        delay(25);
+        for (int i = 0; i < 40; i++)
+            gpioSimSetInputLevel(BUTTON_PIN, i % 2 == 0 ? LOW : HIGH);
+        gpioSimSetInputLevel(BUTTON_PIN, LOW);
+        button.loop();
+        delay(25);
+        button.loop();
+        check(button.getEdgeOverflowCount() == 1, "overflow counted");
+        check(button.isButtonPressed(), "resynchronised after overflow");
+        gpioSimSetInputLevel(BUTTON_PIN, HIGH);
+    }
+
+    // Hold duration reported in each mode when loop() is called late after the press but soon after the release
+    uint32_t holdDurationError(bool useEdgeInterrupts)
+    {
+        DebounceButton button;
+        std::vector<ButtonEvent> events;
+        setupButton(button, events, useEdgeInterrupts);
+        delay(15);
+        button.loop();
+        delay(15);
+        uint64_t pressUs = driveWithBounces(LOW, 0);
+        delay(35);
+        button.loop();
+        delay(30);
+        button.loop();
+        uint64_t releaseUs = driveWithBounces(HIGH, 0);
+        delay(DEBOUNCE_MS + 2);
+        button.loop();
+        for (const ButtonEvent& event : events)
+        {
+            if (!event.val)
+                return (uint32_t)llabs((int64_t)event.msSinceLastChange * 1000 - (int64_t)(releaseUs - pressUs)) / 1000;
+        }
+        return UINT32_MAX;
+    }
+
+    void testTimingVsPolled()
+    {
+        uint32_t edgeErrMs = holdDurationError(true);
+        uint32_t polledErrMs = holdDurationError(false);
+        printf("  Hold duration error with late loop() calls: edge interrupts %ums, polled %ums\n",
+                    (unsigned)edgeErrMs, (unsigned)polledErrMs);
+        check(edgeErrMs <= 1, "edge interrupt hold duration accurate");
+    }
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <stdio.h>
+#include <chrono>
+#include "ProtocolExchange.h"
+#include "RestAPIEndpointManager.h"
+#include "RICRESTMsg.h"
+#include "CommsChannelMsg.h"
+
+class DeviceCmdBinaryTest
+{
+public:
+    DeviceCmdBinaryTest() :
+        _protocolExchgConfig("{}"),
+        _protocolExchg("DeviceCmdBinaryTest", _protocolExchgConfig)
+    {
+        // Binary path - route by numeric ID and format code
+        _protocolExchg.setDeviceCmdBinaryHook(
+            [this](uint32_t busNum, uint32_t address, uint32_t formatCode, const uint8_t* pData, uint32_t dataLen) {
+                if ((busNum != TEST_BUS_NUM) || (address != TEST_ADDRESS))
+                    return RAFT_INVALID_OBJECT;
+                return _device.sendCmdBinary(formatCode, pData, dataLen);
+            });
+
+        // JSON path - emulates the devman/cmdjson endpoint
+        _restAPIEndpointManager.addEndpoint("devman", RestAPIEndpoint::ENDPOINT_CALLBACK, RestAPIEndpoint::ENDPOINT_GET,
+            [this](const String &reqStr, String &respStr, const APISourceInfo& sourceInfo) {
+                std::vector<String> params;
+                std::vector<RaftJson::NameValuePair> nameValues;
+                RestAPIEndpointManager::getParamsAndNameValues(reqStr.c_str(), params, nameValues);
+                RaftJson jsonParams = RaftJson::getJSONFromNVPairs(nameValues, true);
+                String cmdJSON = jsonParams.getString("body", "");
+                RaftJson json(cmdJSON);
+                String deviceName = json.getString("device", "");
+                if (!deviceName.equals("motor"))
+                    return Raft::setJsonErrorResult(reqStr.c_str(), respStr, "failDeviceNotFound");
+                RaftRetCode retc = _device.sendCmdJSON(cmdJSON.c_str());
+                return Raft::setJsonResult(reqStr.c_str(), respStr, retc == RAFT_OK);
+            },
+            "devman");
+    }
+
+    void loop()
+    {
+        printf("Running DeviceCmdBinaryTest...\n");
+
+        testEncodeDecode();
+        testRouting();
+        benchmark();
+
+        if (_failCount > 0)
+            printf("DeviceCmdBinaryTest FAILED %d tests\n", _failCount);
+        else
+            printf("DeviceCmdBinaryTest all tests passed\n");
+    }
+
+private:
+    static const uint32_t TEST_BUS_NUM = 0;
+    static const uint32_t TEST_ADDRESS = 0x1234;
+    static const uint32_t FORMAT_CODE_SET_POS = 7;
+
+    // Device which accepts a channel/position command in binary or JSON form
+    class TestDevice
+    {
+    public:
+        RaftRetCode sendCmdBinary(uint32_t formatCode, const uint8_t* pData, uint32_t dataLen)
+        {
+            if ((formatCode != FORMAT_CODE_SET_POS) || (dataLen < 5))
+                return RAFT_INVALID_DATA;
+            lastChannel = pData[0];
+            lastValue = (int32_t)((pData[1] << 24) | (pData[2] << 16) | (pData[3] << 8) | pData[4]);
+            numCmds++;
+            return RAFT_OK;
+        }
+        RaftRetCode sendCmdJSON(const char* jsonCmd)
+        {
+            RaftJson json(jsonCmd, false);
+            if (!json.getString("cmd", "").equals("pos"))
+                return RAFT_INVALID_DATA;
+            lastChannel = json.getInt("ch", 0);
+            lastValue = json.getInt("val", 0);
+            numCmds++;
+            return RAFT_OK;
+        }
+        uint32_t lastChannel = 0;
+        int32_t lastValue = 0;
+        uint32_t numCmds = 0;
+    };
+
+    RaftJson _protocolExchgConfig;
+    ProtocolExchange _protocolExchg;
+    RestAPIEndpointManager _restAPIEndpointManager;
+    TestDevice _device;
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  DeviceCmdBinaryTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    static void encodePosCmd(uint32_t address, uint8_t channel, int32_t value, CommsChannelMsg& msg)
+    {
+        uint8_t payload[] = {channel, (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value};
+        RICRESTMsg::encodeDeviceCmdBinary(TEST_BUS_NUM, address, FORMAT_CODE_SET_POS, payload, sizeof(payload), msg);
+    }
+
+    void testEncodeDecode()
+    {
+        CommsChannelMsg msg;
+        uint8_t payload[] = {1, 2, 3};
+        RICRESTMsg::encodeDeviceCmdBinary(5, 0xa1b2c3d4, 0x1234, payload, sizeof(payload), msg);
+        uint32_t busNum = 0, address = 0, formatCode = 0, payloadLen = 0;
+        const uint8_t* pPayload = nullptr;
+        check(RICRESTMsg::decodeDeviceCmdBinary(msg.getBuf(), msg.getBufLen(), busNum, address, formatCode, pPayload, payloadLen),
+                    "decode ok");
+        check(busNum == 5 && address == 0xa1b2c3d4 && formatCode == 0x1234, "decode header");
+        check(payloadLen == 3 && pPayload == msg.getBuf() + RICREST_DEVICE_CMD_PAYLOAD_POS && pPayload[2] == 3, "decode payload in place");
+        check(!RICRESTMsg::decodeDeviceCmdBinary(msg.getBuf(), RICREST_DEVICE_CMD_PAYLOAD_POS - 1, busNum, address, formatCode, pPayload, payloadLen),
+                    "decode short message fails");
+    }
+
+    void testRouting()
+    {
+        CommsChannelMsg msg;
+        encodePosCmd(TEST_ADDRESS, 3, -123456, msg);
+        check(_protocolExchg.processDeviceCmdBinary(msg.getBuf(), msg.getBufLen()) == RAFT_OK, "binary cmd ok");
+        check(_device.lastChannel == 3 && _device.lastValue == -123456, "binary cmd values");
+        encodePosCmd(TEST_ADDRESS + 1, 3, 0, msg);
+        check(_protocolExchg.processDeviceCmdBinary(msg.getBuf(), msg.getBufLen()) == RAFT_INVALID_OBJECT, "binary cmd unknown device");
+
+        // JSON path for comparison
+        String respStr;
+        _restAPIEndpointManager.handleApiRequest("devman/cmdjson?body={\"device\":\"motor\",\"cmd\":\"pos\",\"ch\":2,\"val\":-654}",
+                    respStr, APISourceInfo(0));
+        check(_device.lastChannel == 2 && _device.lastValue == -654, "json cmd values");
+    }
+
+    void benchmark()
+    {
+        static const uint32_t NUM_CMDS = 100000;
+
+        // Binary path - decode and route pre-encoded messages
+        std::vector<CommsChannelMsg> binMsgs(16);
+        for (uint32_t i = 0; i < binMsgs.size(); i++)
+            encodePosCmd(TEST_ADDRESS, i & 7, i * 1000, binMsgs[i]);
+        _device.numCmds = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < NUM_CMDS; i++)
+        {
+            CommsChannelMsg& msg = binMsgs[i % binMsgs.size()];
+            _protocolExchg.processDeviceCmdBinary(msg.getBuf(), msg.getBufLen());
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        double binUs = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        check(_device.numCmds == NUM_CMDS, "binary bench all cmds handled");
+
+        // JSON path - decode RICREST URL message and route through REST API and JSON parsing
+        std::vector<CommsChannelMsg> jsonMsgs(16);
+        for (uint32_t i = 0; i < jsonMsgs.size(); i++)
+        {
+            String req = "devman/cmdjson?body={\"device\":\"motor\",\"cmd\":\"pos\",\"ch\":" + String(i & 7) +
+                        ",\"val\":" + String(i * 1000) + "}";
+            RICRESTMsg::encode(req, jsonMsgs[i], RICRESTMsg::RICREST_ELEM_CODE_URL);
+        }
+        _device.numCmds = 0;
+        t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < NUM_CMDS; i++)
+        {
+            CommsChannelMsg& msg = jsonMsgs[i % jsonMsgs.size()];
+            RICRESTMsg ricRESTReqMsg;
+            ricRESTReqMsg.decode(msg.getBuf(), msg.getBufLen());
+            String respStr;
+            _restAPIEndpointManager.handleApiRequest(ricRESTReqMsg.getReq().c_str(), respStr, APISourceInfo(0));
+        }
+        t1 = std::chrono::steady_clock::now();
+        double jsonUs = std::chrono::duration<double, std::micro>(t1 - t0).count();
+        check(_device.numCmds == NUM_CMDS, "json bench all cmds handled");
+
+        printf("  DeviceCmd bench: binary %.3f us/cmd, JSON %.3f us/cmd (%.1fx)\n",
+                binUs / NUM_CMDS, jsonUs / NUM_CMDS, jsonUs / binUs);
+        check(binUs < jsonUs, "binary path faster than JSON");
+    }
+};
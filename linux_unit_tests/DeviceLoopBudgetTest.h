@@ -0,0 +1,270 @@
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include "DeviceLoopBudget.h"
+#include "DeviceManager.h"
+#include "RaftBusSystem.h"
+#include "RaftBus.h"
+#include "RaftJson.h"
+
+class DeviceLoopBudgetTest
+{
+public:
+    void loop()
+    {
+        printf("Running DeviceLoopBudgetTest...\n");
+
+        testUnlimited();
+        testResume();
+        testListSizeChange();
+        testSimulatedLoad();
+        testDeviceManagerResume();
+
+        if (_failCount > 0)
+            printf("DeviceLoopBudgetTest FAILED %d tests\n", _failCount);
+        else
+            printf("DeviceLoopBudgetTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  DeviceLoopBudgetTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    // Bus which records the order in which buses are serviced
+    class LoopTestBus : public RaftBus
+    {
+    public:
+        LoopTestBus(BusElemStatusCB busElemStatusCB, BusOperationStatusCB busOperationStatusCB) :
+            RaftBus(busElemStatusCB, busOperationStatusCB)
+        {
+        }
+        static RaftBus* create(BusElemStatusCB busElemStatusCB, BusOperationStatusCB busOperationStatusCB)
+        {
+            return new LoopTestBus(busElemStatusCB, busOperationStatusCB);
+        }
+        virtual bool setup(BusNumType busNum, const RaftJsonIF& config) override
+        {
+            _busName = config.getString("name", "");
+            _busIdx = config.getInt("idx", 0);
+            return true;
+        }
+        virtual void loop() override
+        {
+            loopCalls.push_back(_busIdx);
+            busyWaitUs(LOOP_US);
+        }
+        virtual String getBusName() const override
+        {
+            return _busName;
+        }
+        inline static std::vector<uint32_t> loopCalls;
+        static const uint32_t LOOP_US = 200;
+    private:
+        String _busName;
+        uint32_t _busIdx = 0;
+    };
+
+    static void busyWaitUs(uint32_t us)
+    {
+        uint64_t startUs = micros();
+        while (micros() - startUs < us)
+        {
+        }
+    }
+
+    void testUnlimited()
+    {
+        DeviceLoopBudget budget;
+        DeviceLoopBudget::Cursor cursor;
+        std::vector<uint32_t> serviced;
+        budget.setup(0);
+        budget.startPass();
+        uint32_t numServiced = budget.serviceItems(cursor, 5, [&](uint32_t idx) { serviced.push_back(idx); busyWaitUs(100); });
+        budget.endPass();
+        check(numServiced == 5, "unlimited services all");
+        check(serviced == std::vector<uint32_t>({0, 1, 2, 3, 4}), "unlimited order");
+        check((cursor.nextIdx == 0) && (cursor.lastSkipped == 0), "unlimited cursor");
+        check((budget.getNumPasses() == 1) && (budget.getNumOverBudget() == 0), "unlimited stats");
+
+        // Empty list
+        budget.startPass();
+        check(budget.serviceItems(cursor, 0, [&](uint32_t idx) { check(false, "empty list serviced"); }) == 0, "empty list");
+        budget.endPass();
+    }
+
+    void testResume()
+    {
+        // Each item uses more than the budget so one item is serviced per pass
+        DeviceLoopBudget budget;
+        DeviceLoopBudget::Cursor cursor;
+        std::vector<uint32_t> serviced;
+        budget.setup(50);
+        for (int pass = 0; pass < 7; pass++)
+        {
+            budget.startPass();
+            uint32_t numServiced = budget.serviceItems(cursor, 3, [&](uint32_t idx) { serviced.push_back(idx); busyWaitUs(100); });
+            budget.endPass();
+            check(numServiced == 1, "one item per pass when over budget");
+        }
+        check(serviced == std::vector<uint32_t>({0, 1, 2, 0, 1, 2, 0}), "round-robin resume");
+        check((cursor.lastSkipped == 2) && (cursor.maxSkipped == 2) && (cursor.totalSkipped == 14), "skip stats");
+        check(budget.getNumOverBudget() == 7, "over budget count");
+        check(budget.getMaxPassUs() >= 100, "max pass time");
+    }
+
+    void testListSizeChange()
+    {
+        DeviceLoopBudget budget;
+        DeviceLoopBudget::Cursor cursor;
+        cursor.nextIdx = 4;
+        std::vector<uint32_t> serviced;
+        budget.setup(0);
+        budget.startPass();
+        budget.serviceItems(cursor, 3, [&](uint32_t idx) { serviced.push_back(idx); });
+        budget.endPass();
+        check(serviced == std::vector<uint32_t>({0, 1, 2}), "cursor beyond shrunk list");
+    }
+
+    // Simulated load - a bus with a backlog (each loop call takes a long time while the backlog drains) and
+    // devices including one slow device
+    class SimLoad
+    {
+    public:
+        static const uint32_t NUM_DEVICES = 40;
+        static const uint32_t DEVICE_LOOP_US = 200;
+        static const uint32_t SLOW_DEVICE_IDX = 7;
+        static const uint32_t SLOW_DEVICE_LOOP_US = 2000;
+        static const uint32_t BUS_BACKLOG_LOOP_US = 3000;
+        static const uint32_t BUS_IDLE_LOOP_US = 50;
+        uint32_t busBacklog = 10;
+        std::vector<uint32_t> deviceServiceCount = std::vector<uint32_t>(NUM_DEVICES, 0);
+
+        void busLoop(uint32_t busIdx)
+        {
+            if (busIdx == 0 && busBacklog > 0)
+            {
+                busyWaitUs(BUS_BACKLOG_LOOP_US);
+                busBacklog--;
+                return;
+            }
+            busyWaitUs(BUS_IDLE_LOOP_US);
+        }
+
+        void deviceLoop(uint32_t devIdx)
+        {
+            busyWaitUs(devIdx == SLOW_DEVICE_IDX ? SLOW_DEVICE_LOOP_US : DEVICE_LOOP_US);
+            deviceServiceCount[devIdx]++;
+        }
+    };
+
+    uint32_t runSimulatedLoad(uint32_t budgetUs, uint32_t numPasses, SimLoad& load, DeviceLoopBudget::Cursor& busCursor,
+                DeviceLoopBudget::Cursor& devCursor)
+    {
+        DeviceLoopBudget budget;
+        budget.setup(budgetUs);
+        for (uint32_t pass = 0; pass < numPasses; pass++)
+        {
+            budget.startPass();
+            budget.serviceItems(busCursor, 2, [&](uint32_t busIdx) { load.busLoop(busIdx); });
+            budget.serviceItems(devCursor, SimLoad::NUM_DEVICES, [&](uint32_t devIdx) { load.deviceLoop(devIdx); });
+            budget.endPass();
+        }
+        return budget.getMaxPassUs();
+    }
+
+    void testSimulatedLoad()
+    {
+        const uint32_t NUM_PASSES = 40;
+        const uint32_t BUDGET_US = 2000;
+
+        // Worst-case times are the best of a few runs so that the host being preempted doesn't cause failures
+        const uint32_t NUM_RUNS = 3;
+
+        // Unbudgeted - every pass services everything
+        uint32_t unbudgetedMaxUs = UINT32_MAX;
+        for (uint32_t run = 0; run < NUM_RUNS; run++)
+        {
+            SimLoad unbudgetedLoad;
+            DeviceLoopBudget::Cursor unbudgetedBusCursor, unbudgetedCursor;
+            uint32_t maxUs = runSimulatedLoad(0, NUM_PASSES, unbudgetedLoad, unbudgetedBusCursor, unbudgetedCursor);
+            unbudgetedMaxUs = maxUs < unbudgetedMaxUs ? maxUs : unbudgetedMaxUs;
+        }
+
+        // Budgeted
+        SimLoad budgetedLoad;
+        DeviceLoopBudget::Cursor budgetedBusCursor, budgetedCursor;
+        uint32_t budgetedMaxUs = UINT32_MAX;
+        uint32_t maxLateStarts = 0;
+        for (uint32_t run = 0; run < NUM_RUNS; run++)
+        {
+            budgetedLoad = SimLoad();
+            budgetedBusCursor = DeviceLoopBudget::Cursor();
+            budgetedCursor = DeviceLoopBudget::Cursor();
+            uint32_t maxUs = runSimulatedLoad(BUDGET_US, NUM_PASSES, budgetedLoad, budgetedBusCursor, budgetedCursor);
+            budgetedMaxUs = maxUs < budgetedMaxUs ? maxUs : budgetedMaxUs;
+            check((budgetedBusCursor.maxLateStarts <= 1) && (budgetedCursor.maxLateStarts <= 1),
+                        "at most one bus and one device started after budget used per pass");
+            if (maxLateStarts < budgetedCursor.maxLateStarts)
+                maxLateStarts = budgetedCursor.maxLateStarts;
+        }
+        check(maxLateStarts == 1, "device started after budget used when bus overruns");
+
+        // Worst case with a budget is the budget plus the slowest single bus and device call (with an allowance
+        // for the host preempting the test) which must be well below the unbudgeted worst case
+        const uint32_t HOST_SCHED_ALLOWANCE_US = 1000;
+        const uint32_t budgetedBoundUs = BUDGET_US + SimLoad::BUS_BACKLOG_LOOP_US + SimLoad::SLOW_DEVICE_LOOP_US +
+                    HOST_SCHED_ALLOWANCE_US;
+        check(budgetedBoundUs < unbudgetedMaxUs, "budgeted bound below unbudgeted worst-case");
+        check(budgetedMaxUs < budgetedBoundUs, "budgeted worst-case bounded");
+
+        // Backlog drained and every device still serviced (no starvation)
+        check(budgetedLoad.busBacklog == 0, "bus backlog drained");
+        uint32_t minServiced = UINT32_MAX;
+        for (uint32_t count : budgetedLoad.deviceServiceCount)
+            minServiced = count < minServiced ? count : minServiced;
+        check(minServiced > 0, "all devices serviced");
+        check(budgetedCursor.maxSkipped > 0, "devices skipped under load");
+
+        printf("  DeviceLoopBudgetTest worst-case loop time unbudgeted %.1fms budgeted (%.1fms) %.1fms min device services %u/%u\n",
+                    unbudgetedMaxUs / 1000.0, BUDGET_US / 1000.0, budgetedMaxUs / 1000.0,
+                    (unsigned)minServiced, (unsigned)NUM_PASSES);
+    }
+
+    // Run DeviceManager loops with buses from the bus system and return the order in which buses were serviced
+    std::vector<uint32_t> runDeviceManagerLoops(uint32_t budgetUs, uint32_t numLoops)
+    {
+        RaftJson sysConfig(String(R"({"DevMan":{"loopBudgetUs":)") + String(budgetUs) +
+                    R"(,"Buses":{"buslist":[{"type":"LoopTestBus","name":"B0","idx":0},)"
+                    R"({"type":"LoopTestBus","name":"B1","idx":1},{"type":"LoopTestBus","name":"B2","idx":2}]}}})");
+        raftBusSystem.registerBus("LoopTestBus", LoopTestBus::create);
+        DeviceManager devMan("DevMan", sysConfig);
+        RaftSysMod* pSysMod = &devMan;
+        pSysMod->setup();
+        LoopTestBus::loopCalls.clear();
+        for (uint32_t i = 0; i < numLoops; i++)
+            pSysMod->loop();
+        raftBusSystem.deinit();
+        return LoopTestBus::loopCalls;
+    }
+
+    void testDeviceManagerResume()
+    {
+        // Each bus loop uses more than the budget so each DeviceManager loop services one bus and the next
+        // loop resumes from the bus after it
+        std::vector<uint32_t> budgeted = runDeviceManagerLoops(LoopTestBus::LOOP_US / 4, 5);
+        check(budgeted == std::vector<uint32_t>({0, 1, 2, 0, 1}), "DeviceManager loop resumes from bus cursor");
+
+        // No budget - every bus serviced on each loop
+        std::vector<uint32_t> unbudgeted = runDeviceManagerLoops(0, 2);
+        check(unbudgeted == std::vector<uint32_t>({0, 1, 2, 0, 1, 2}), "DeviceManager loop services all buses");
+    }
+};
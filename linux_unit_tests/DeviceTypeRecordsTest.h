@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include "DeviceTypeRecords.h"
+#include "DevicePollRecords_generated.h"
+
+// Uncompressed and compressed generated records (for comparison and size measurement)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-variable"
+namespace RawDevTypeRecs
+{
+#include "DeviceTypeRecordsRaw_generated.h"
+}
+namespace CompDevTypeRecs
+{
+#include "DeviceTypeRecords_generated.h"
+}
+#pragma GCC diagnostic pop
+
+class DeviceTypeRecordsTest
+{
+public:
+    void loop()
+    {
+        printf("Running DeviceTypeRecordsTest...\n");
+
+        testSizes();
+        testRecordsMatch();
+        testNameLookup();
+
+        if (_failCount > 0)
+            printf("DeviceTypeRecordsTest FAILED %d tests\n", _failCount);
+        else
+            printf("DeviceTypeRecordsTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+    static const uint32_t NUM_RECS = sizeof(RawDevTypeRecs::baseDevTypeRecords) / sizeof(DeviceTypeRecord);
+
+    void check(bool cond, const char* msg, const char* pDetail = "")
+    {
+        if (!cond)
+        {
+            printf("  DeviceTypeRecordsTest failed: %s %s\n", msg, pDetail);
+            _failCount++;
+        }
+    }
+
+    static bool strMatch(const char* pA, const char* pB)
+    {
+        if (!pA || !pB)
+            return pA == pB;
+        return strcmp(pA, pB) == 0;
+    }
+
+    static uint32_t strSize(const char* pStr)
+    {
+        return pStr ? strlen(pStr) + 1 : 0;
+    }
+
+    void testSizes()
+    {
+        uint32_t rawBytes = 0;
+        for (const DeviceTypeRecord& rec : RawDevTypeRecs::baseDevTypeRecords)
+            rawBytes += strSize(rec.detectionValues) + strSize(rec.initValues) + strSize(rec.pollInfo) + strSize(rec.devInfoJson);
+        uint32_t compBytes = sizeof(CompDevTypeRecs::baseDevTypeRecCompData) + sizeof(CompDevTypeRecs::baseDevTypeRecCompLocs);
+        uint32_t dictBytes = sizeof(CompDevTypeRecs::baseDevTypeRecDict);
+        printf("  DeviceTypeRecordsTest %d records raw strings %d bytes compressed %d bytes + dictionary %d bytes (%.1f%%)\n",
+                (int)NUM_RECS, (int)rawBytes, (int)compBytes, (int)dictBytes, 100.0 * (compBytes + dictBytes) / rawBytes);
+        check(compBytes + dictBytes < rawBytes, "compressed smaller than raw");
+    }
+
+    void testRecordsMatch()
+    {
+        uint64_t firstUseUs = 0;
+        uint64_t cachedUs = 0;
+        for (uint32_t idx = 0; idx < NUM_RECS; idx++)
+        {
+            const DeviceTypeRecord& rawRec = RawDevTypeRecs::baseDevTypeRecords[idx];
+            DeviceTypeRecord rec;
+            uint64_t startUs = micros();
+            bool recOk = deviceTypeRecords.getDeviceInfo(idx, rec);
+            firstUseUs += micros() - startUs;
+            check(recOk, "getDeviceInfo by index", rawRec.deviceType);
+            if (!recOk)
+                continue;
+            check(strMatch(rec.deviceType, rawRec.deviceType), "deviceType", rawRec.deviceType);
+            check(strMatch(rec.addresses, rawRec.addresses), "addresses", rawRec.deviceType);
+            check(strMatch(rec.detectionValues, rawRec.detectionValues), "detectionValues", rawRec.deviceType);
+            check(strMatch(rec.initValues, rawRec.initValues), "initValues", rawRec.deviceType);
+            check(strMatch(rec.pollInfo, rawRec.pollInfo), "pollInfo", rawRec.deviceType);
+            check(strMatch(rec.devInfoJson, rawRec.devInfoJson), "devInfoJson", rawRec.deviceType);
+            check(rec.pollDataSizeBytes == rawRec.pollDataSizeBytes, "pollDataSizeBytes", rawRec.deviceType);
+            check(rec.pollResultDecodeFn != nullptr, "pollResultDecodeFn", rawRec.deviceType);
+
+            // Second lookup returns the same (resident) strings
+            DeviceTypeRecord rec2;
+            startUs = micros();
+            deviceTypeRecords.getDeviceInfo(idx, rec2);
+            cachedUs += micros() - startUs;
+            check((rec2.pollInfo == rec.pollInfo) && (rec2.devInfoJson == rec.devInfoJson), "pointers stable", rawRec.deviceType);
+
+            // JSON
+            check(deviceTypeRecords.getDevTypeInfoJsonByTypeIdx(idx, true) == rawRec.getJson(true), "getJson", rawRec.deviceType);
+        }
+        printf("  DeviceTypeRecordsTest lookup first use %.2fus cached %.2fus per record\n",
+                (double)firstUseUs / NUM_RECS, (double)cachedUs / NUM_RECS);
+        DeviceTypeRecord rec;
+        check(!deviceTypeRecords.getDeviceInfo(NUM_RECS, rec), "index out of range");
+    }
+
+    void testNameLookup()
+    {
+        for (uint32_t idx = 0; idx < NUM_RECS; idx++)
+        {
+            const DeviceTypeRecord& rawRec = RawDevTypeRecs::baseDevTypeRecords[idx];
+            DeviceTypeRecord rec;
+            DeviceTypeIndexType foundIdx = 0;
+            bool recOk = deviceTypeRecords.getDeviceInfo(String(rawRec.deviceType), rec, foundIdx);
+            check(recOk && strMatch(rec.pollInfo, rawRec.pollInfo), "getDeviceInfo by name", rawRec.deviceType);
+
+            // Names can be duplicated so the first match is returned
+            check(recOk && (foundIdx <= idx) && strMatch(RawDevTypeRecs::baseDevTypeRecords[foundIdx].deviceType, rawRec.deviceType),
+                        "name lookup index", rawRec.deviceType);
+        }
+        DeviceTypeRecord rec;
+        DeviceTypeIndexType foundIdx = 0;
+        check(!deviceTypeRecords.getDeviceInfo(String("NoSuchDeviceType"), rec, foundIdx), "unknown name");
+    }
+};
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "FileSystem.h"
+#include "FileLineReader.h"
+
+class FileLineReaderTest
+{
+public:
+    void loop()
+    {
+        printf("Running FileLineReaderTest...\n");
+
+        fileSystem.setup(FileSystem::LOCAL_FS_SPIFFS, false, false, -1, -1, -1, -1, false, false);
+
+        testSequential();
+        testLineEndings();
+        testLongLines();
+        testLineIndex();
+        testMatchesGetFileLine();
+
+        fileSystem.deleteFile("local", TEST_FILE_NAME);
+
+        if (_failCount > 0)
+            printf("FileLineReaderTest FAILED %d tests\n", _failCount);
+        else
+            printf("FileLineReaderTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+    static constexpr const char* TEST_FILE_NAME = "/tmp/raft_line_reader_test.txt";
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  FileLineReaderTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    bool writeFile(const String& contents)
+    {
+        String str = contents;
+        return fileSystem.setFileContents("local", TEST_FILE_NAME, str);
+    }
+
+    static String lineText(uint32_t lineNum)
+    {
+        return "line " + String(lineNum) + " " + String(lineNum * 7919 % 1000);
+    }
+
+    void writeNumberedFile(uint32_t numLines)
+    {
+        String contents;
+        for (uint32_t i = 0; i < numLines; i++)
+            contents += lineText(i) + "\n";
+        check(writeFile(contents), "write numbered file");
+    }
+
+    void testSequential()
+    {
+        // Small read-ahead buffer so lines span buffer refills
+        writeNumberedFile(500);
+        FileLineReader reader(16);
+        check(reader.open("local", TEST_FILE_NAME), "open");
+        String line;
+        uint32_t lineCount = 0;
+        bool allOk = true;
+        while (reader.readLine(line, 100))
+        {
+            if (line != lineText(lineCount))
+                allOk = false;
+            lineCount++;
+        }
+        check(allOk, "sequential lines match");
+        check(lineCount == 500, "sequential line count");
+        uint32_t lineNum = 0;
+        check(reader.getLineNum(lineNum) && (lineNum == 500), "line number at end");
+        check(!reader.readLine(line, 100), "read after end");
+    }
+
+    void testLineEndings()
+    {
+        check(writeFile("a\r\nb\n\nc\r\n\r\nlast"), "write line endings file");
+        FileLineReader reader(4);
+        check(reader.open("local", TEST_FILE_NAME), "open line endings");
+        const char* expected[] = {"a", "b", "", "c", "", "last"};
+        uint8_t buf[20];
+        for (uint32_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++)
+        {
+            check(reader.readLine(buf, sizeof(buf)), "read line ending line");
+            check(strcmp((const char*)buf, expected[i]) == 0, expected[i]);
+        }
+        check(!reader.readLine(buf, sizeof(buf)), "end of line endings file");
+    }
+
+    void testLongLines()
+    {
+        check(writeFile("0123456789abcdef\nxy\n"), "write long line file");
+        FileLineReader reader(8);
+        check(reader.open("local", TEST_FILE_NAME), "open long line");
+        uint8_t buf[7];
+        check(reader.readLine(buf, sizeof(buf)) && (strcmp((const char*)buf, "012345") == 0), "long line piece 1");
+        check(reader.readLine(buf, sizeof(buf)) && (strcmp((const char*)buf, "6789ab") == 0), "long line piece 2");
+        check(reader.readLine(buf, sizeof(buf)) && (strcmp((const char*)buf, "cdef") == 0), "long line piece 3");
+        check(reader.readLine(buf, sizeof(buf)) && (strcmp((const char*)buf, "xy") == 0), "line after long line");
+        check(!reader.readLine(buf, sizeof(buf)), "end of long line file");
+
+        // Buffers with no room for a character are rejected rather than returning empty lines forever
+        FileLineReader tinyReader(8);
+        check(tinyReader.open("local", TEST_FILE_NAME), "open tiny buffer");
+        buf[0] = 'x';
+        check(!tinyReader.readLine(buf, 1) && (buf[0] == 0), "one byte buffer rejected");
+        String line;
+        check(!tinyReader.readLine(line, 1), "one char string limit rejected");
+        check(tinyReader.readLine(buf, 2) && (strcmp((const char*)buf, "0") == 0), "two byte buffer reads");
+    }
+
+    void testLineIndex()
+    {
+        writeNumberedFile(1000);
+        FileLineReader reader(64);
+        check(reader.open("local", TEST_FILE_NAME), "open index");
+        check(reader.buildLineIndex(50), "build index");
+        check(reader.getNumLines() == 1000, "index line count");
+
+        // Random access in both directions
+        const uint32_t testLines[] = {0, 999, 500, 49, 50, 51, 3, 998, 777, 778, 100};
+        String line;
+        for (uint32_t lineNum : testLines)
+        {
+            check(reader.seekToLine(lineNum), "seekToLine");
+            check(reader.readLine(line, 100) && (line == lineText(lineNum)), lineText(lineNum).c_str());
+        }
+        check(!reader.seekToLine(1000), "seek beyond end");
+
+        // Without an index
+        FileLineReader readerNoIndex(64);
+        check(readerNoIndex.open("local", TEST_FILE_NAME), "open no index");
+        for (uint32_t lineNum : testLines)
+        {
+            check(readerNoIndex.seekToLine(lineNum), "seekToLine no index");
+            check(readerNoIndex.readLine(line, 100) && (line == lineText(lineNum)), "no index line");
+        }
+        check(!readerNoIndex.seekToLine(1000), "seek beyond end no index");
+
+        // Resume from a file position
+        check(reader.seekToLine(321), "seek for pos");
+        uint32_t filePos = reader.getFilePos();
+        FileLineReader readerFromPos;
+        check(readerFromPos.open("local", TEST_FILE_NAME, filePos), "open at pos");
+        check(readerFromPos.readLine(line, 100) && (line == lineText(321)), "line at pos");
+    }
+
+    void testMatchesGetFileLine()
+    {
+        check(writeFile("first\r\nsecond line\n\nfourth"), "write compare file");
+        FileLineReader reader(5);
+        check(reader.open("local", TEST_FILE_NAME), "open compare");
+        uint32_t filePos = 0;
+        while (true)
+        {
+            uint32_t nextFilePos = 0;
+            String expected = fileSystem.getFileLine("local", TEST_FILE_NAME, filePos, 100, nextFilePos);
+            String line;
+            bool lineOk = reader.readLine(line, 100);
+            if (nextFilePos == filePos)
+            {
+                check(!lineOk, "both at end");
+                break;
+            }
+            check(lineOk && (line == expected), "line matches getFileLine");
+            check(reader.getFilePos() == nextFilePos, "file pos matches getFileLine");
+            filePos = nextFilePos;
+        }
+    }
+};
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include "FileSystem.h"
+#include "RaftJson.h"
+
+class FileSystemCacheTest
+{
+public:
+    void loop()
+    {
+        printf("Running FileSystemCacheTest...\n");
+
+        _fs.setup(FileSystem::LOCAL_FS_SPIFFS, false, false, -1, -1, -1, -1, false, false);
+
+        testHitMiss();
+        testInvalidation();
+        testEviction();
+        testLargeFileNotCached();
+        testLatency();
+
+        // Tidy up
+        for (int i = 0; i < NUM_TEST_FILES; i++)
+            _fs.deleteFile("local", testFileName(i));
+
+        if (_failCount > 0)
+            printf("FileSystemCacheTest FAILED %d tests\n", _failCount);
+        else
+            printf("FileSystemCacheTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+    FileSystem _fs;
+    static const int NUM_TEST_FILES = 6;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  FileSystemCacheTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    static String testFileName(int idx)
+    {
+        return "/tmp/raft_fscache_test_" + String(idx) + ".txt";
+    }
+
+    bool writeFile(int idx, const String& contents)
+    {
+        String str = contents;
+        return _fs.setFileContents("local", testFileName(idx), str);
+    }
+
+    String readFile(int idx)
+    {
+        uint8_t* pBuf = _fs.getFileContents("local", testFileName(idx));
+        if (!pBuf)
+            return "";
+        String str = (const char*)pBuf;
+        free(pBuf);
+        return str;
+    }
+
+    int statsVal(const char* pName)
+    {
+        RaftJson stats(_fs.getDebugJSON());
+        return stats.getInt((String("contentCache/") + pName).c_str(), -1);
+    }
+
+    void testHitMiss()
+    {
+        _fs.setContentsCacheLimits(1024, 4096, 4);
+        check(writeFile(0, "hello cache"), "write file 0");
+        int misses = statsVal("misses");
+        int hits = statsVal("hits");
+        check(readFile(0) == "hello cache", "first read contents");
+        check(statsVal("misses") == misses + 1, "first read is a miss");
+        check(readFile(0) == "hello cache", "second read contents");
+        check(statsVal("hits") == hits + 1, "second read is a hit");
+        check(statsVal("n") == 1, "one entry cached");
+
+        // Shared buffer is the cached object
+        FileContentsCache::ContentsPtr p1 = _fs.getFileContentsShared("local", testFileName(0));
+        FileContentsCache::ContentsPtr p2 = _fs.getFileContentsShared("local", testFileName(0));
+        check(p1 && p2 && (p1.get() == p2.get()), "shared contents reused");
+        check(p1 && (strcmp(p1->c_str(), "hello cache") == 0) && (p1->length() == 11), "shared contents");
+
+        // maxLen still applies to cached contents
+        check(_fs.getFileContents("local", testFileName(0), 5) == nullptr, "maxLen on cached file");
+    }
+
+    void testInvalidation()
+    {
+        _fs.setContentsCacheLimits(1024, 4096, 4);
+        check(writeFile(1, "version 1"), "write file 1");
+        check(readFile(1) == "version 1", "read v1");
+        check(readFile(1) == "version 1", "read v1 cached");
+
+        // Overwrite must invalidate
+        FileContentsCache::ContentsPtr pOld = _fs.getFileContentsShared("local", testFileName(1));
+        check(writeFile(1, "version 2 longer"), "write file 1 v2");
+        check(readFile(1) == "version 2 longer", "read v2 after setFileContents");
+        check(pOld && (strcmp(pOld->c_str(), "version 1") == 0), "old shared contents unchanged");
+
+        // Write via fileOpen/fileClose must invalidate
+        FILE* pFile = _fs.fileOpen("local", testFileName(1), true, 0);
+        check(pFile != nullptr, "fileOpen write");
+        if (pFile)
+        {
+            _fs.fileWrite(pFile, (const uint8_t*)"version 3", 9);
+            _fs.fileClose(pFile, "local", testFileName(1), true);
+        }
+        check(readFile(1) == "version 3", "read v3 after fileClose");
+
+        // Delete must invalidate
+        _fs.deleteFile("local", testFileName(1));
+        check(_fs.getFileContents("local", testFileName(1)) == nullptr, "deleted file not served from cache");
+    }
+
+    void testEviction()
+    {
+        _fs.setContentsCacheLimits(1024, 4096, 3);
+        for (int i = 2; i < 6; i++)
+            check(writeFile(i, "file " + String(i)), "write eviction file");
+        int evictions = statsVal("evict");
+        readFile(2);
+        readFile(3);
+        readFile(4);
+        check(statsVal("n") == 3, "three entries cached");
+
+        // Touch 2 so 3 is least recently used, then read 5 to evict 3
+        readFile(2);
+        readFile(5);
+        check(statsVal("n") == 3, "still three entries");
+        check(statsVal("evict") == evictions + 1, "one eviction");
+        int hits = statsVal("hits");
+        readFile(2);
+        check(statsVal("hits") == hits + 1, "recently used entry kept");
+        int misses = statsVal("misses");
+        check(readFile(3) == "file 3", "evicted entry re-read");
+        check(statsVal("misses") == misses + 1, "evicted entry is a miss");
+
+        // Total bytes limit
+        _fs.setContentsCacheLimits(1024, 12, 8);
+        readFile(2);
+        readFile(3);
+        readFile(4);
+        check(statsVal("bytes") <= 12, "total bytes limit");
+    }
+
+    void testLargeFileNotCached()
+    {
+        _fs.setContentsCacheLimits(16, 4096, 4);
+        String bigStr;
+        for (int i = 0; i < 10; i++)
+            bigStr += "0123456789";
+        check(writeFile(0, bigStr), "write big file");
+        readFile(0);
+        readFile(0);
+        check(statsVal("n") == 0, "big file not cached");
+        FileContentsCache::ContentsPtr p = _fs.getFileContentsShared("local", testFileName(0));
+        check(p && (p->length() == bigStr.length()), "big file shared contents");
+    }
+
+    void testLatency()
+    {
+        const int NUM_READS = 200;
+        String contents;
+        for (int i = 0; i < 100; i++)
+            contents += "{\"key\":\"value\"},";
+        check(writeFile(0, contents), "write latency file");
+
+        // Uncached
+        _fs.setContentsCacheLimits(0, 0, 0);
+        uint64_t startUs = micros();
+        for (int i = 0; i < NUM_READS; i++)
+            readFile(0);
+        uint64_t uncachedUs = micros() - startUs;
+
+        // Cached
+        _fs.setContentsCacheLimits(8192, 65536, 16);
+        readFile(0);
+        startUs = micros();
+        for (int i = 0; i < NUM_READS; i++)
+            readFile(0);
+        uint64_t cachedUs = micros() - startUs;
+
+        printf("  FileSystemCacheTest read %d bytes x %d uncached %.2fus/read cached %.2fus/read\n",
+                (int)contents.length(), NUM_READS, (double)uncachedUs / NUM_READS, (double)cachedUs / NUM_READS);
+        check(readFile(0) == contents, "cached contents match");
+    }
+};
@@ -1,3 +1,4 @@
+#ifdef __cplusplus
 #include <chrono>
 
 #define LOG_E( tag, format, ... ) fprintf(stderr, "E (%ld) %s: " format "\n", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count(), tag, ##__VA_ARGS__);
@@ -5,3 +6,12 @@
 #define LOG_I( tag, format, ... ) fprintf(stderr, "I (%ld) %s: " format "\n", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count(), tag, ##__VA_ARGS__);
 #define LOG_D( tag, format, ... ) fprintf(stderr, "D (%ld) %s: " format "\n", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count(), tag, ##__VA_ARGS__);
 #define LOG_V( tag, format, ... ) fprintf(stderr, "V (%ld) %s: " format "\n", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count(), tag, ##__VA_ARGS__);
+#else
+// C compilation units (e.g. tinyexpr.c)
+#include <stdio.h>
+#define LOG_E( tag, format, ... ) fprintf(stderr, "E %s: " format "\n", tag, ##__VA_ARGS__);
+#define LOG_W( tag, format, ... ) fprintf(stderr, "W %s: " format "\n", tag, ##__VA_ARGS__);
+#define LOG_I( tag, format, ... ) fprintf(stderr, "I %s: " format "\n", tag, ##__VA_ARGS__);
+#define LOG_D( tag, format, ... ) fprintf(stderr, "D %s: " format "\n", tag, ##__VA_ARGS__);
+#define LOG_V( tag, format, ... ) fprintf(stderr, "V %s: " format "\n", tag, ##__VA_ARGS__);
+#endif
@@ -0,0 +1,118 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// PerfAllocHooks
+// Allocation counting for benchmarks - replaces operator new/delete and (on glibc) the malloc
+// family so that allocations made by String (which uses malloc/realloc) are also counted
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <new>
+#include "PerfBench.h"
+
+std::atomic<uint64_t> PerfAllocStats::numAllocs(0);
+std::atomic<uint64_t> PerfAllocStats::bytesAllocated(0);
+std::atomic<int64_t> PerfAllocStats::bytesInUse(0);
+std::atomic<int64_t> PerfAllocStats::peakBytesInUse(0);
+
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t num, size_t size);
+extern "C" void* __libc_realloc(void* p, size_t size);
+extern "C" void __libc_free(void* p);
+#define PERF_RAW_MALLOC __libc_malloc
+#define PERF_RAW_FREE __libc_free
+#else
+#define PERF_RAW_MALLOC malloc
+#define PERF_RAW_FREE free
+#endif
+
+static inline void perfRecordAlloc(void* p, size_t size)
+{
+    PerfAllocStats::numAllocs.fetch_add(1, std::memory_order_relaxed);
+    PerfAllocStats::bytesAllocated.fetch_add(size, std::memory_order_relaxed);
+    size_t usableSize = malloc_usable_size(p);
+    int64_t inUse = PerfAllocStats::bytesInUse.fetch_add(usableSize, std::memory_order_relaxed) + usableSize;
+    int64_t peak = PerfAllocStats::peakBytesInUse.load(std::memory_order_relaxed);
+    while ((peak < inUse) && !PerfAllocStats::peakBytesInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed))
+    {
+    }
+}
+
+static inline void perfRecordFree(void* p)
+{
+    PerfAllocStats::bytesInUse.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// malloc family (glibc only)
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __GLIBC__
+extern "C" void* malloc(size_t size)
+{
+    void* p = __libc_malloc(size);
+    if (p)
+        perfRecordAlloc(p, size);
+    return p;
+}
+
+extern "C" void* calloc(size_t num, size_t size)
+{
+    void* p = __libc_calloc(num, size);
+    if (p)
+        perfRecordAlloc(p, num * size);
+    return p;
+}
+
+extern "C" void* realloc(void* p, size_t size)
+{
+    if (p)
+        perfRecordFree(p);
+    void* pNew = __libc_realloc(p, size);
+    if (pNew)
+        perfRecordAlloc(pNew, size);
+    else if (p && size != 0)
+        PerfAllocStats::bytesInUse.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+    return pNew;
+}
+
+extern "C" void free(void* p)
+{
+    if (!p)
+        return;
+    perfRecordFree(p);
+    __libc_free(p);
+}
+#endif
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// operator new/delete
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void* perfNew(size_t size)
+{
+    void* p = PERF_RAW_MALLOC(size == 0 ? 1 : size);
+    if (!p)
+        throw std::bad_alloc();
+    perfRecordAlloc(p, size);
+    return p;
+}
+
+static void perfDelete(void* p)
+{
+    if (!p)
+        return;
+    perfRecordFree(p);
+    PERF_RAW_FREE(p);
+}
+
+void* operator new(size_t size) { return perfNew(size); }
+void* operator new[](size_t size) { return perfNew(size); }
+void operator delete(void* p) noexcept { perfDelete(p); }
+void operator delete[](void* p) noexcept { perfDelete(p); }
+void operator delete(void* p, size_t) noexcept { perfDelete(p); }
+void operator delete[](void* p, size_t) noexcept { perfDelete(p); }
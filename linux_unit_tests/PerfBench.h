@@ -0,0 +1,125 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// PerfBench
+// Portable timing and allocation counting for benchmarks
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <atomic>
+#include <vector>
+#include <string>
+
+/*
+ * PerfAllocStats
+ *
+ * Counters updated by the operator new/delete hooks in PerfAllocHooks.cpp - if the hooks are
+ * not linked then the counters remain zero and only timing is reported
+ */
+class PerfAllocStats
+{
+public:
+    static std::atomic<uint64_t> numAllocs;
+    static std::atomic<uint64_t> bytesAllocated;
+    static std::atomic<int64_t> bytesInUse;
+    static std::atomic<int64_t> peakBytesInUse;
+
+    /// @brief Restart peak tracking from the current level
+    static void resetPeak()
+    {
+        peakBytesInUse = bytesInUse.load();
+    }
+};
+
+/*
+ * PerfBenchResults
+ *
+ * Collects results from benchmarks and outputs them as JSON so that runs from different
+ * commits can be compared
+ */
+class PerfBenchResults
+{
+public:
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations = 0;
+        double nsPerOp = 0;
+        double allocsPerOp = 0;
+        double bytesPerOp = 0;
+    };
+
+    /// @brief Get monotonic time in ns
+    static uint64_t timeNowNs()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    }
+
+    /// @brief Add a result
+    /// @param name benchmark name
+    /// @param iterations number of iterations measured
+    /// @param elapsedNs total elapsed time
+    /// @param numAllocs total number of allocations
+    /// @param bytesAllocated total bytes allocated
+    void add(const char* name, uint64_t iterations, uint64_t elapsedNs, uint64_t numAllocs, uint64_t bytesAllocated)
+    {
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        if (iterations > 0)
+        {
+            result.nsPerOp = (double)elapsedNs / iterations;
+            result.allocsPerOp = (double)numAllocs / iterations;
+            result.bytesPerOp = (double)bytesAllocated / iterations;
+        }
+        _results.push_back(result);
+        printf("  %-36s %12.1f ns/op %8.2f allocs/op %10.1f bytes/op\n", name,
+                    result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+    }
+
+    /// @brief Get results as JSON
+    std::string toJSON() const
+    {
+        std::string json = "{\"results\":[";
+        char buf[300];
+        for (uint32_t i = 0; i < _results.size(); i++)
+        {
+            const Result& result = _results[i];
+            snprintf(buf, sizeof(buf), "%s{\"name\":\"%s\",\"iters\":%llu,\"nsPerOp\":%.2f,\"allocsPerOp\":%.3f,\"bytesPerOp\":%.1f}",
+                        i == 0 ? "" : ",", result.name.c_str(), (unsigned long long)result.iterations,
+                        result.nsPerOp, result.allocsPerOp, result.bytesPerOp);
+            json += buf;
+        }
+        json += "]}";
+        return json;
+    }
+
+    /// @brief Get results
+    const std::vector<Result>& getResults() const
+    {
+        return _results;
+    }
+
+private:
+    std::vector<Result> _results;
+};
+
+// Measure a block of code which executes NLoops iterations of the operation being benchmarked
+#define PERF_BENCH_START(SVar) \
+    uint64_t SVar ## _allocs1 = PerfAllocStats::numAllocs; \
+    uint64_t SVar ## _bytes1 = PerfAllocStats::bytesAllocated; \
+    uint64_t SVar ## _ns1 = PerfBenchResults::timeNowNs();
+#define PERF_BENCH_END(SVar, Results, SName, NLoops) \
+    { \
+        uint64_t SVar ## _ns = PerfBenchResults::timeNowNs() - SVar ## _ns1; \
+        (Results).add(SName, NLoops, SVar ## _ns, PerfAllocStats::numAllocs - SVar ## _allocs1, \
+                    PerfAllocStats::bytesAllocated - SVar ## _bytes1); \
+    }
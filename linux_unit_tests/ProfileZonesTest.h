@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stdio.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+#include "RaftProfileZones.h"
+#include "RaftJson.h"
+
+class ProfileZonesTest
+{
+public:
+    void loop()
+    {
+        printf("Running ProfileZonesTest...\n");
+
+        testCounting();
+        testReport();
+        testClear();
+        testTotalWrap();
+        testConcurrent();
+
+        if (_failCount > 0)
+            printf("ProfileZonesTest FAILED %d tests\n", _failCount);
+        else
+            printf("ProfileZonesTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  ProfileZonesTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    static void shortWork()
+    {
+        RAFT_PROFILE_ZONE("test::short");
+    }
+
+    static void longWork()
+    {
+        RAFT_PROFILE_ZONE("test::long");
+        usleep(2000);
+        shortWork();
+    }
+
+    // Find a zone in the report
+    static String getZone(RaftJson& report, const char* pName)
+    {
+        std::vector<String> zones;
+        report.getArrayElems("zones", zones);
+        for (const String& zoneJson : zones)
+        {
+            if (RaftJson(zoneJson).getString("n", "").equals(pName))
+                return zoneJson;
+        }
+        return "";
+    }
+
+    void testCounting()
+    {
+        RaftProfileZones::clearAll();
+        for (int i = 0; i < 10; i++)
+            shortWork();
+        for (int i = 0; i < 3; i++)
+            longWork();
+        RaftJson report(RaftProfileZones::getJSON());
+        RaftJson shortZone(getZone(report, "test::short"));
+        check(shortZone.getString("n", "").equals("test::short"), "short zone registered");
+        check(shortZone.getInt("c", 0) == 13, "short zone includes nested calls");
+        RaftJson zone(getZone(report, "test::long"));
+        check(zone.getString("n", "").equals("test::long"), "long zone registered");
+        check(zone.getInt("c", 0) == 3, "long zone call count");
+        check(zone.getDouble("maxUs", 0) >= 1500, "long zone max time");
+        check(zone.getDouble("avgUs", 0) >= 1500 && zone.getDouble("avgUs", 0) <= zone.getDouble("maxUs", 0), "long zone average");
+        check(zone.getInt("totUs", 0) >= 4500, "long zone total time");
+    }
+
+    void testReport()
+    {
+        RaftJson report(RaftProfileZones::getJSON());
+        check(report.getInt("cpuMHz", 0) > 0, "report cpu rate");
+        std::vector<String> zones;
+        check(report.getArrayElems("zones", zones) && zones.size() >= 2, "report zones array");
+    }
+
+    void testClear()
+    {
+        RaftProfileZones::clearAll();
+        RaftJson report(RaftProfileZones::getJSON());
+        RaftJson zone(getZone(report, "test::long"));
+        check(zone.getString("n", "").equals("test::long"), "zone remains registered after clear");
+        check(zone.getInt("c", -1) == 0 && zone.getInt("maxUs", -1) == 0, "zone counters cleared");
+    }
+
+    void testTotalWrap()
+    {
+        // Total keeps counting when the 32-bit accumulator wraps (zones are never unregistered so this is static)
+        static RaftProfileZone wrapZone("test::wrap");
+        wrapZone.clear();
+        for (int i = 0; i < 5; i++)
+            wrapZone.record(0xF0000000);
+        check(wrapZone.getTotalCycles() == 5 * 0xF0000000ULL, "total past 32 bits");
+        check(wrapZone._maxCycles.load() == 0xF0000000, "max of large call");
+        wrapZone.clear();
+    }
+
+    void testConcurrent()
+    {
+        // Counts are exact when a zone is entered from several threads at once
+        static const int NUM_THREADS = 4;
+        static const int CALLS_PER_THREAD = 20000;
+        RaftProfileZones::clearAll();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < NUM_THREADS; t++)
+        {
+            threads.emplace_back([]() {
+                for (int i = 0; i < CALLS_PER_THREAD; i++)
+                    shortWork();
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        RaftJson report(RaftProfileZones::getJSON());
+        RaftJson zone(getZone(report, "test::short"));
+        check(zone.getInt("c", 0) == NUM_THREADS * CALLS_PER_THREAD, "concurrent call count exact");
+    }
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <stdio.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include "RaftBusStats.h"
+#include "RaftThreading.h"
+#include "RaftJson.h"
+
+class RaftBusStatsTest
+{
+public:
+    void loop()
+    {
+        printf("Running RaftBusStatsTest...\n");
+
+        testCounters();
+        testMultiThreaded();
+        testRates();
+        testIncrementCost();
+
+        if (_failCount > 0)
+            printf("RaftBusStatsTest FAILED %d tests\n", _failCount);
+        else
+            printf("RaftBusStatsTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    static const uint32_t NUM_THREADS = 4;
+    static const uint32_t INCS_PER_THREAD = 1000000;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  RaftBusStatsTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    void testCounters()
+    {
+        RaftBusStats stats;
+        stats.activity();
+        stats.activity();
+        stats.pollComplete();
+        stats.cmdComplete();
+        stats.respLengthError();
+        stats.reqBufferFull();
+        stats.bytesTransferred(100);
+        stats.reqQueueCount(5);
+        stats.reqQueueCount(2);
+        stats.respQueueCount(3);
+        RaftJson json("{" + stats.getStatsJSON("bus1") + "}");
+        check(json.getInt("bus1/cnt", -1) == 2, "cnt");
+        check(json.getInt("bus1/poll", -1) == 1, "poll");
+        check(json.getInt("bus1/cmds", -1) == 1, "cmds");
+        check(json.getInt("bus1/rspE", -1) == 1, "rspE");
+        check(json.getInt("bus1/reqF", -1) == 1, "reqF");
+        check(json.getInt("bus1/bytes", -1) == 100, "bytes");
+        check((json.getInt("bus1/reqQ", -1) == 2) && (json.getInt("bus1/reqQPk", -1) == 5), "reqQ and peak");
+        check((json.getInt("bus1/rspQ", -1) == 3) && (json.getInt("bus1/rspQPk", -1) == 3), "rspQ and peak");
+        check(stats.getErrorCount() == 2, "error count");
+    }
+
+    void testMultiThreaded()
+    {
+        RaftBusStats stats;
+        std::vector<std::thread> threads;
+        for (uint32_t i = 0; i < NUM_THREADS; i++)
+        {
+            threads.emplace_back([&stats, i]() {
+                for (uint32_t j = 0; j < INCS_PER_THREAD; j++)
+                {
+                    stats.activity();
+                    stats.bytesTransferred(3);
+                    if ((j % 100) == 0)
+                        stats.respLengthError();
+                    stats.reqQueueCount((j % 1000) + i);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        check(stats.getCount(RaftBusStats::COUNT_ACTIVITY) == NUM_THREADS * INCS_PER_THREAD, "multi-threaded activity count");
+        check(stats.getCount(RaftBusStats::COUNT_BYTES) == NUM_THREADS * INCS_PER_THREAD * 3, "multi-threaded bytes count");
+        check(stats.getCount(RaftBusStats::COUNT_RESP_LENGTH_ERROR) == NUM_THREADS * INCS_PER_THREAD / 100, "multi-threaded error count");
+        RaftJson json("{" + stats.getStatsJSON("b") + "}");
+        check(json.getInt("b/reqQPk", -1) == (int)(999 + NUM_THREADS - 1), "multi-threaded queue peak");
+    }
+
+    void testRates()
+    {
+        RaftBusStats stats;
+        uint32_t timeMs = 100000;
+        stats.sampleRates(timeMs);
+        check(stats.getTxnPerSec() == 0, "no rate with one snapshot");
+
+        // 50 transactions (200 bytes) and 1 error per 100ms
+        for (uint32_t step = 0; step < 30; step++)
+        {
+            for (int i = 0; i < 50; i++)
+            {
+                stats.activity();
+                stats.bytesTransferred(4);
+            }
+            stats.respBufferFull();
+            timeMs += 100;
+            stats.sampleRates(timeMs);
+        }
+        check(stats.getTxnPerSec() == 500, "txn rate");
+        check(stats.getBytesPerSec() == 2000, "bytes rate");
+        check(stats.getErrPerSec() == 10, "error rate");
+
+        // Activity stops - rate falls as the window rolls on
+        for (uint32_t step = 0; step < RaftBusStats::RATE_WINDOW_SNAPSHOTS + 1; step++)
+        {
+            timeMs += RaftBusStats::RATE_SAMPLE_INTERVAL_MS;
+            stats.sampleRates(timeMs);
+        }
+        check((stats.getTxnPerSec() == 0) && (stats.getErrPerSec() == 0) && (stats.getBytesPerSec() == 0), "rates fall to zero");
+    }
+
+    // Time increments from several threads - sharded stats compared with a single shared atomic and a mutex
+    template<typename IncFn>
+    static double timeIncrementsNs(IncFn incFn)
+    {
+        std::vector<std::thread> threads;
+        auto startTime = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < NUM_THREADS; i++)
+        {
+            threads.emplace_back([&incFn]() {
+                for (uint32_t j = 0; j < INCS_PER_THREAD; j++)
+                    incFn();
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+        return (double)elapsedNs / INCS_PER_THREAD;
+    }
+
+    void testIncrementCost()
+    {
+        RaftBusStats stats;
+        double shardedNs = timeIncrementsNs([&stats]() { stats.activity(); });
+
+        std::atomic<uint32_t> sharedCount{0};
+        double sharedAtomicNs = timeIncrementsNs([&sharedCount]() { sharedCount.fetch_add(1, std::memory_order_relaxed); });
+
+        RaftMutex mutex;
+        RaftMutex_init(mutex);
+        uint32_t mutexCount = 0;
+        double mutexNs = timeIncrementsNs([&mutex, &mutexCount]() {
+            RaftMutex_lock(mutex, RAFT_MUTEX_WAIT_FOREVER);
+            mutexCount++;
+            RaftMutex_unlock(mutex);
+        });
+        RaftMutex_destroy(mutex);
+
+        check(stats.getCount(RaftBusStats::COUNT_ACTIVITY) == NUM_THREADS * INCS_PER_THREAD, "timed count");
+        check(mutexCount == NUM_THREADS * INCS_PER_THREAD, "mutex count");
+        printf("  RaftBusStatsTest %u threads increment cost sharded %.1fns shared atomic %.1fns mutex %.1fns\n",
+                    (unsigned)NUM_THREADS, shardedNs, sharedAtomicNs, mutexNs);
+    }
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "RaftJsonStreamValidator.h"
+#include "RaftJsonChunkedDoc.h"
+#include "RaftJson.h"
+
+class RaftJsonChunkedDocTest
+{
+public:
+    void loop()
+    {
+        printf("Running RaftJsonChunkedDocTest...\n");
+
+        testValidator();
+        testValidatorChunking();
+        testChunkedDoc();
+        testTakeJsonDoc();
+
+        if (_failCount > 0)
+            printf("RaftJsonChunkedDocTest FAILED %d tests\n", _failCount);
+        else
+            printf("RaftJsonChunkedDocTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  RaftJsonChunkedDocTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    static bool validate(const char* pDoc, uint32_t chunkLen = 0, bool objectOnly = false)
+    {
+        RaftJsonStreamValidator validator;
+        validator.reset(objectOnly);
+        uint32_t docLen = strlen(pDoc);
+        if (chunkLen == 0)
+            chunkLen = docLen;
+        for (uint32_t pos = 0; pos < docLen; pos += chunkLen)
+        {
+            uint32_t len = pos + chunkLen > docLen ? docLen - pos : chunkLen;
+            if (!validator.addChunk((const uint8_t*)pDoc + pos, len))
+                return false;
+        }
+        return validator.isComplete();
+    }
+
+    void testValidator()
+    {
+        const char* validDocs[] = {
+            "{}", " { } ", "[]", "0", "-1.5e+10", "12", "true", "null", "\"a\\u00e9\\n\"",
+            R"({"a":1,"b":[1,2,{"c":null}],"d":{"e":"f","g":-0.5E3},"h":false})",
+            "{\n  \"WiFi\": {\"ssid\": \"x\\\"y\"},\n  \"list\": [ ]\n}\n",
+        };
+        for (const char* pDoc : validDocs)
+        {
+            if (!validate(pDoc))
+                printf("  RaftJsonChunkedDocTest valid doc rejected: %s\n", pDoc);
+            check(validate(pDoc), "valid doc");
+        }
+        const char* invalidDocs[] = {
+            "", "{", "{\"a\":1,}", "[1,]", "{\"a\" 1}", "{a:1}", "[1 2]", "01", "1.", "-", "1e", "tru", "nul",
+            "{\"a\":1}}", "[}", "{]", "\"abc", "\"\\x\"", "\"\\u12g4\"", "{\"a\":1} x", "{'a':1}",
+        };
+        for (const char* pDoc : invalidDocs)
+        {
+            if (validate(pDoc))
+                printf("  RaftJsonChunkedDocTest invalid doc accepted: %s\n", pDoc);
+            check(!validate(pDoc), "invalid doc");
+        }
+        check(!validate("[1]", 0, true), "top-level object only");
+        check(validate("{\"a\":[1]}", 0, true), "top-level object accepted");
+
+        // Nesting limit
+        String deepDoc;
+        for (uint32_t i = 0; i < RaftJsonStreamValidator::MAX_DEPTH + 1; i++)
+            deepDoc += "[";
+        check(!validate(deepDoc.c_str()), "nesting limit");
+    }
+
+    void testValidatorChunking()
+    {
+        // Every chunk size (splitting strings, escapes, numbers and literals) gives the same result
+        const char* pDoc = R"({"k\"ey":"v\u0041l","n":-12.5e-3,"t":true,"f":false,"z":null,"a":[0,10,{"b":[]}]})";
+        bool allOk = true;
+        for (uint32_t chunkLen = 1; chunkLen <= strlen(pDoc); chunkLen++)
+            allOk = allOk && validate(pDoc, chunkLen);
+        check(allOk, "valid for all chunk sizes");
+        const char* pBadDoc = R"({"a":[1,2,{"b":tru}]})";
+        bool allRejected = true;
+        for (uint32_t chunkLen = 1; chunkLen <= strlen(pBadDoc); chunkLen++)
+            allRejected = allRejected && !validate(pBadDoc, chunkLen);
+        check(allRejected, "invalid for all chunk sizes");
+
+        // Error position
+        RaftJsonStreamValidator validator;
+        validator.reset();
+        validator.addChunk((const uint8_t*)"{\"a\":1,", 7);
+        check(!validator.addChunk((const uint8_t*)"}", 1) && validator.isError() && (validator.getPos() == 7), "error position");
+        check(!validator.addChunk((const uint8_t*)"\"b\":2}", 6), "chunks ignored after error");
+    }
+
+    // Post a document in chunks as the web server does
+    RaftJsonChunkedDoc::ChunkResult post(RaftJsonChunkedDoc& chunkedDoc, const char* pDoc, uint32_t chunkLen,
+                uint32_t& maxCapacity, uint32_t maxLen = 0)
+    {
+        uint32_t total = strlen(pDoc);
+        RaftJsonChunkedDoc::ChunkResult rslt = RaftJsonChunkedDoc::CHUNK_ERROR;
+        maxCapacity = 0;
+        for (uint32_t index = 0; index < total; index += chunkLen)
+        {
+            uint32_t len = index + chunkLen > total ? total - index : chunkLen;
+            rslt = chunkedDoc.addChunk((const uint8_t*)pDoc + index, len, index, total, maxLen);
+            if (chunkedDoc.getDoc().capacity() > maxCapacity)
+                maxCapacity = chunkedDoc.getDoc().capacity();
+        }
+        return rslt;
+    }
+
+    void testChunkedDoc()
+    {
+        // Settings document of a few KB
+        String doc = "{";
+        for (int i = 0; i < 100; i++)
+            doc += (i > 0 ? ",\"key" : "\"key") + String(i) + "\":{\"val\":" + String(i * 3) + ",\"name\":\"item" + String(i) + "\"}";
+        doc += "}";
+
+        // Valid document - buffer allocated once at the document size
+        RaftJsonChunkedDoc chunkedDoc;
+        uint32_t maxCapacity = 0;
+        check(post(chunkedDoc, doc.c_str(), 500, maxCapacity) == RaftJsonChunkedDoc::CHUNK_COMPLETE, "chunked complete");
+        check(strcmp(chunkedDoc.getDoc().data(), doc.c_str()) == 0, "chunked contents");
+        check(maxCapacity == doc.length() + 1, "buffer sized once");
+        check(post(chunkedDoc, doc.c_str(), doc.length(), maxCapacity) == RaftJsonChunkedDoc::CHUNK_COMPLETE, "single chunk complete");
+        chunkedDoc.clear();
+        check(chunkedDoc.getDoc().capacity() == 0, "clear frees buffer");
+
+        // Invalid document - buffer freed at the first bad chunk and later chunks rejected
+        String badDoc = doc;
+        badDoc.replace("\"key10\":{", "\"key10\":{,");
+        RaftJsonChunkedDoc::ChunkResult rslt = chunkedDoc.addChunk((const uint8_t*)badDoc.c_str(), 500, 0, badDoc.length());
+        check((rslt == RaftJsonChunkedDoc::CHUNK_ERROR) && (chunkedDoc.getDoc().capacity() == 0), "invalid chunk frees buffer");
+        rslt = chunkedDoc.addChunk((const uint8_t*)badDoc.c_str() + 500, 500, 500, badDoc.length());
+        check(rslt == RaftJsonChunkedDoc::CHUNK_ERROR, "later chunks rejected");
+
+        // A new post after a failure starts afresh
+        check(post(chunkedDoc, "{\"a\":1}", 3, maxCapacity) == RaftJsonChunkedDoc::CHUNK_COMPLETE, "new post after failure");
+
+        // Truncated, out-of-order, too long and non-object documents
+        check(post(chunkedDoc, "{\"a\":[1,2]", 4, maxCapacity) == RaftJsonChunkedDoc::CHUNK_ERROR, "truncated doc");
+        chunkedDoc.addChunk((const uint8_t*)"{\"a\":", 5, 0, 10);
+        check(chunkedDoc.addChunk((const uint8_t*)"1}", 2, 8, 10) == RaftJsonChunkedDoc::CHUNK_ERROR, "out of order chunk");
+        check(post(chunkedDoc, doc.c_str(), 500, maxCapacity, 1000) == RaftJsonChunkedDoc::CHUNK_ERROR, "too long");
+        check(maxCapacity == 0, "too long not allocated");
+        check(post(chunkedDoc, "[1,2]", 5, maxCapacity) == RaftJsonChunkedDoc::CHUNK_ERROR, "non-object rejected");
+
+        // Trailing NUL sent by the client
+        const uint8_t nulTerminated[] = "{\"a\":2}";
+        check(chunkedDoc.addChunk(nulTerminated, sizeof(nulTerminated), 0, sizeof(nulTerminated)) == RaftJsonChunkedDoc::CHUNK_COMPLETE,
+                    "NUL terminated");
+        check(chunkedDoc.getDoc().size() == sizeof(nulTerminated), "NUL not duplicated");
+    }
+
+    void testTakeJsonDoc()
+    {
+        RaftJson json(R"({"a":1})");
+        RaftJsonChunkedDoc chunkedDoc;
+        uint32_t maxCapacity = 0;
+        post(chunkedDoc, R"({"a":2,"b":"x"})", 4, maxCapacity);
+        const char* pBuf = chunkedDoc.getDoc().data();
+        check(json.takeJsonDoc(chunkedDoc.getDoc()), "take doc");
+        check((json.getInt("a", 0) == 2) && (json.getString("b", "") == "x"), "taken doc contents");
+        check(json.getJsonDoc() == pBuf, "taken without copy");
+        check(strcmp(chunkedDoc.getDoc().data(), R"({"a":1})") == 0, "previous doc returned");
+
+        // Unterminated buffer
+        RaftJsonDocBuffer buf = {'{', '}'};
+        json.takeJsonDoc(buf);
+        check(strcmp(json.getJsonDoc(), "{}") == 0, "unterminated buffer");
+    }
+};
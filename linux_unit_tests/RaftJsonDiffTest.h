@@ -0,0 +1,184 @@
+#pragma once
+
+#include <stdio.h>
+#include <vector>
+#include <chrono>
+#include "RaftJsonDiff.h"
+#include "RaftJson.h"
+#include "RaftJsonPrefixed.h"
+
+class RaftJsonDiffTest
+{
+public:
+    void loop()
+    {
+        printf("Running RaftJsonDiffTest...\n");
+
+        testDiff();
+        testPathAffected();
+        testNotifier();
+        testPrefixedRegistration();
+        testLargeDocTiming();
+
+        if (_failCount > 0)
+            printf("RaftJsonDiffTest FAILED %d tests\n", _failCount);
+        else
+            printf("RaftJsonDiffTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  RaftJsonDiffTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    static String joinPaths(const std::vector<String>& paths)
+    {
+        String joined;
+        for (const String& path : paths)
+            joined += (joined.length() > 0 ? "," : "") + path;
+        return joined;
+    }
+
+    String diff(const char* pOldDoc, const char* pNewDoc, uint32_t maxPaths = RaftJsonDiff::MAX_PATHS_DEFAULT)
+    {
+        std::vector<String> changedPaths;
+        RaftJsonDiff::getChangedPaths(pOldDoc, pNewDoc, changedPaths, maxPaths);
+        return joinPaths(changedPaths);
+    }
+
+    void checkDiff(const char* pOldDoc, const char* pNewDoc, const char* pExpected, const char* msg)
+    {
+        String rslt = diff(pOldDoc, pNewDoc);
+        if (rslt != pExpected)
+            printf("  RaftJsonDiffTest %s got \"%s\" expected \"%s\"\n", msg, rslt.c_str(), pExpected);
+        check(rslt == pExpected, msg);
+    }
+
+    void testDiff()
+    {
+        checkDiff(R"({"a":1,"b":{"c":"x"}})", R"({"a":1,"b":{"c":"x"}})", "", "identical");
+        checkDiff(R"({"a":1,"b":{"c":"x"}})", " { \"a\" : 1,\n \"b\":{ \"c\":\"x\" } }", "", "whitespace only");
+        checkDiff(R"({"a":1,"b":2})", R"({"b":2,"a":1})", "", "key order only");
+        checkDiff(R"({"a":1,"b":2})", R"({"a":1,"b":3})", "b", "scalar changed");
+        checkDiff(R"({"a":1})", R"({"a":1,"n":{"x":1}})", "n", "key added");
+        checkDiff(R"({"a":1,"r":[1]})", R"({"a":1})", "r", "key removed");
+        checkDiff(R"({"W":{"s":{"p":"a","q":1}},"M":{"e":true}})", R"({"W":{"s":{"p":"b","q":1}},"M":{"e":true}})",
+                    "W/s/p", "nested change");
+        checkDiff(R"({"L":[{"n":"a","r":1},{"n":"b","r":2}]})", R"({"L":[{"n":"a","r":1},{"n":"b","r":5}]})",
+                    "L[1]/r", "array element change");
+        checkDiff(R"({"L":[1,2]})", R"({"L":[1,2,3]})", "L", "array length change");
+        checkDiff(R"({"a":{"x":1}})", R"({"a":[1]})", "a", "type change");
+        checkDiff(R"({"a":"x,}]"})", R"({"a":"x,}]","b":"\"{"})", "b", "special chars in strings");
+        checkDiff(R"({"a":1,"b":2,"c":3})", R"({"a":5,"c":6,"d":7})", "a,c,d,b", "multiple changes");
+        checkDiff("", R"({"a":1})", "", "empty to doc");
+        checkDiff(nullptr, nullptr, "", "both null");
+        check(diff(R"({"a":1,"b":2,"c":3})", R"({"a":2,"b":3,"c":4})", 2) == "", "overflow collapses to root");
+    }
+
+    void testPathAffected()
+    {
+        check(RaftJsonDiff::isPathAffected("", "a/b"), "empty prefix");
+        check(RaftJsonDiff::isPathAffected("a", ""), "whole doc changed");
+        check(RaftJsonDiff::isPathAffected("WiFi", "WiFi/ssid"), "child of prefix");
+        check(RaftJsonDiff::isPathAffected("WiFi/ssid", "WiFi"), "parent of prefix");
+        check(RaftJsonDiff::isPathAffected("L", "L[2]/r"), "array element of prefix");
+        check(RaftJsonDiff::isPathAffected("WiFi", "WiFi"), "same path");
+        check(!RaftJsonDiff::isPathAffected("WiFi", "WiFiX/a"), "not a segment boundary");
+        check(!RaftJsonDiff::isPathAffected("WiFi", "MQTT/a"), "different path");
+    }
+
+    void testNotifier()
+    {
+        RaftJsonChangeNotifier notifier;
+        check(!notifier.hasCallbacks(), "no callbacks");
+        int anyCount = 0;
+        std::vector<String> wifiPaths;
+        int wifiCount = 0, mqttCount = 0;
+        notifier.registerChangeCallback([&anyCount]() { anyCount++; });
+        notifier.registerPathChangeCallback("WiFi", [&](const std::vector<String>& paths) { wifiCount++; wifiPaths = paths; });
+        notifier.registerPathChangeCallback("MQTT", [&](const std::vector<String>& paths) { mqttCount++; });
+        check(notifier.hasCallbacks(), "has callbacks");
+
+        const char* pDoc1 = R"({"WiFi":{"ssid":"a","pw":"x"},"MQTT":{"host":"h"},"Log":{"lev":1}})";
+        const char* pDoc2 = R"({"WiFi":{"ssid":"b","pw":"x"},"MQTT":{"host":"h"},"Log":{"lev":2}})";
+        check(notifier.notify(pDoc1, pDoc1) == 0, "no change no notify");
+        check((anyCount == 0) && (wifiCount == 0) && (mqttCount == 0), "no callbacks when unchanged");
+        check(notifier.notify(pDoc1, pDoc2) == 2, "two changed paths");
+        check((anyCount == 1) && (wifiCount == 1) && (mqttCount == 0), "only affected callbacks");
+        check(joinPaths(wifiPaths) == "WiFi/ssid", "wifi changed paths");
+    }
+
+    // Test RaftJsonIF implementation which notifies on setJsonDoc (as RaftJsonNVS does on ESP)
+    class NotifyingJson : public RaftJson
+    {
+    public:
+        NotifyingJson(const char* pJsonDoc) : RaftJson(pJsonDoc)
+        {
+        }
+        virtual void registerPathChangeCallback(const char* pPathPrefix, RaftJsonPathChangeCallbackType pathChangeCallback) override
+        {
+            _notifier.registerPathChangeCallback(pPathPrefix, pathChangeCallback);
+        }
+        virtual bool setJsonDoc(const char* pJsonDoc) override
+        {
+            String prevDoc = getJsonDoc();
+            RaftJson::setJsonDoc(pJsonDoc);
+            _notifier.notify(prevDoc.c_str(), getJsonDoc());
+            return true;
+        }
+    private:
+        RaftJsonChangeNotifier _notifier;
+    };
+
+    void testPrefixedRegistration()
+    {
+        NotifyingJson sysConfig(R"({"Pub":{"rate":1,"list":[{"n":"a"}]},"Other":{"x":1}})");
+        RaftJsonPrefixed modConfig(sysConfig, "Pub");
+        int anyCount = 0;
+        std::vector<String> listPaths;
+        modConfig.registerChangeCallback([&anyCount]() { anyCount++; });
+        modConfig.registerPathChangeCallback("list", [&listPaths](const std::vector<String>& paths) { listPaths = paths; });
+
+        sysConfig.setJsonDoc(R"({"Pub":{"rate":1,"list":[{"n":"a"}]},"Other":{"x":2}})");
+        check((anyCount == 0) && listPaths.empty(), "prefixed unaffected by other module");
+        sysConfig.setJsonDoc(R"({"Pub":{"rate":1,"list":[{"n":"b"}]},"Other":{"x":2}})");
+        check(anyCount == 1, "prefixed change callback");
+        check(joinPaths(listPaths) == "list[0]/n", "prefixed relative path");
+        sysConfig.setJsonDoc(R"({"Other":{"x":2}})");
+        check((anyCount == 2) && (joinPaths(listPaths) == ""), "prefix removed reports whole section");
+    }
+
+    void testLargeDocTiming()
+    {
+        // Synthetic SysType document - modules each with a set of settings and a list
+        const uint32_t NUM_MODULES = 50;
+        const uint32_t NUM_KEYS = 20;
+        String oldDoc = "{";
+        for (uint32_t modIdx = 0; modIdx < NUM_MODULES; modIdx++)
+        {
+            oldDoc += (modIdx > 0 ? ",\"Mod" : "\"Mod") + String(modIdx) + "\":{";
+            for (uint32_t keyIdx = 0; keyIdx < NUM_KEYS; keyIdx++)
+                oldDoc += "\"key" + String(keyIdx) + "\":\"value" + String(keyIdx) + "\",";
+            oldDoc += "\"list\":[{\"a\":1,\"b\":2},{\"a\":3,\"b\":4}]}";
+        }
+        oldDoc += "}";
+        String newDoc = oldDoc;
+        newDoc.replace("\"Mod37\":{\"key0\":\"value0\"", "\"Mod37\":{\"key0\":\"changed\"");
+
+        const uint32_t NUM_ITERATIONS = 200;
+        std::vector<String> changedPaths;
+        auto startTime = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < NUM_ITERATIONS; i++)
+            RaftJsonDiff::getChangedPaths(oldDoc.c_str(), newDoc.c_str(), changedPaths);
+        auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+        check(joinPaths(changedPaths) == "Mod37/key0", "large doc changed path");
+        printf("  RaftJsonDiffTest diff of %u byte document %.1fus\n", (unsigned)oldDoc.length(), (double)elapsedUs / NUM_ITERATIONS);
+    }
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <random>
+#include "RaftJsonNumbers.h"
+#include "RaftJson.h"
+
+class RaftJsonNumbersTest
+{
+public:
+    void loop()
+    {
+        printf("Running RaftJsonNumbersTest...\n");
+
+        testParseLong();
+        testParseDoubleEdges();
+        testParseDoubleRandom();
+        testFormatEdges();
+        testFormatRoundTrip();
+        testRaftJsonAccess();
+
+        if (_failCount > 0)
+            printf("RaftJsonNumbersTest FAILED %d tests\n", _failCount);
+        else
+            printf("RaftJsonNumbersTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+    std::mt19937_64 _rng{12345};
+
+    void check(bool cond, const char* msg, const char* pDetail = "")
+    {
+        if (!cond)
+        {
+            printf("  RaftJsonNumbersTest failed: %s %s\n", msg, pDetail);
+            _failCount++;
+        }
+    }
+
+    static bool sameBits(double a, double b)
+    {
+        return memcmp(&a, &b, sizeof(a)) == 0 || (std::isnan(a) && std::isnan(b));
+    }
+
+    void checkLong(const char* pStr)
+    {
+        check(RaftJsonNumbers::parseLong(pStr) == strtol(pStr, NULL, 0), "parseLong", pStr);
+    }
+
+    void checkDouble(const char* pStr)
+    {
+        check(sameBits(RaftJsonNumbers::parseDouble(pStr), strtod(pStr, NULL)), "parseDouble", pStr);
+    }
+
+    void testParseLong()
+    {
+        const char* testStrs[] = {
+            "0", "-0", "1", "-1", "123", "-123", "2147483647", "-2147483648", "2147483648", "-2147483649",
+            "9223372036854775807", "-9223372036854775808", "9223372036854775808", "99999999999999999999",
+            "0x1F", "0X7f", "-0x10", "010", "0", "00", "12abc", "12.5", "1e3", "", "-", "abc", " 42", "+5",
+            "123456789012345678", "1234567890123456789", "42,", "42}", "42]"
+        };
+        for (const char* pStr : testStrs)
+            checkLong(pStr);
+
+        std::uniform_int_distribution<int64_t> dist(INT64_MIN / 2, INT64_MAX / 2);
+        char buf[40];
+        for (int i = 0; i < 10000; i++)
+        {
+            snprintf(buf, sizeof(buf), "%lld", (long long)(dist(_rng) >> (i % 60)));
+            checkLong(buf);
+        }
+    }
+
+    void testParseDoubleEdges()
+    {
+        const char* testStrs[] = {
+            "0", "-0", "0.0", "-0.0", "1", "-1", "0.1", "0.2", "0.3", "1.5", "3.14159", "-2.5e-3", "1e22", "1e23",
+            "9007199254740992", "9007199254740993", "1.7976931348623157e308", "4.9e-324", "2.2250738585072014e-308",
+            "1e-22", "1e-23", "123456789012345678901234567890", "0.000000000000000000000000000001",
+            "1e", "1e+", "1e-", "1E5", "1e+5", ".5", "+1", "inf", "-inf", "nan", "0x1p3", " 12", "", "-", "abc",
+            "12,", "12}", "12]", "1.5\"", "00012.5", "0.000123", "1000000000000000000000", "12345678901234567890",
+            "1234567890123456789", "4503599627370497.5", "1e400", "1e-400", "123e20", "123e30", "9e22"
+        };
+        for (const char* pStr : testStrs)
+            checkDouble(pStr);
+    }
+
+    void testParseDoubleRandom()
+    {
+        char buf[40];
+        std::uniform_int_distribution<int> precDist(1, 17);
+        std::uniform_int_distribution<int> decDist(0, 8);
+        std::uniform_int_distribution<int> expDist(-30, 30);
+        std::uniform_real_distribution<double> valDist(-100000.0, 100000.0);
+        for (int i = 0; i < 20000; i++)
+        {
+            // Random bit patterns (finite)
+            double val = 0;
+            uint64_t bits = _rng();
+            memcpy(&val, &bits, sizeof(val));
+            if (std::isfinite(val))
+            {
+                snprintf(buf, sizeof(buf), "%.*g", precDist(_rng), val);
+                checkDouble(buf);
+            }
+
+            // Typical sensor-like values
+            snprintf(buf, sizeof(buf), "%.*f", decDist(_rng), valDist(_rng));
+            checkDouble(buf);
+            snprintf(buf, sizeof(buf), "%.*e", precDist(_rng), valDist(_rng) * pow(10, expDist(_rng)));
+            checkDouble(buf);
+        }
+    }
+
+    void testFormatEdges()
+    {
+        struct
+        {
+            double val;
+            const char* pExpected;
+        } testCases[] = {
+            { 0.0, "0" }, { -0.0, "-0" }, { 1.0, "1" }, { -1.0, "-1" }, { 0.1, "0.1" }, { 0.3, "0.3" },
+            { 1.5, "1.5" }, { 100.0, "100" }, { 123.456, "123.456" }, { 1e21, "1e+21" }, { 1e20, "100000000000000000000" },
+            { 1e-6, "0.000001" }, { 1e-7, "1e-7" }, { 1.5e-7, "1.5e-7" }, { 5e-324, "5e-324" },
+            { 1.7976931348623157e308, "1.7976931348623157e+308" }, { INFINITY, "null" }, { NAN, "null" },
+        };
+        char buf[RaftJsonNumbers::FORMAT_BUF_MIN_LEN];
+        for (const auto& testCase : testCases)
+        {
+            uint32_t len = RaftJsonNumbers::formatDouble(testCase.val, buf);
+            check((strcmp(buf, testCase.pExpected) == 0) && (len == strlen(buf)), "formatDouble", buf);
+        }
+
+        // Float formatting uses float precision
+        RaftJsonNumbers::formatFloat(0.1f, buf);
+        check(strcmp(buf, "0.1") == 0, "formatFloat 0.1", buf);
+        RaftJsonNumbers::formatFloat(23.45f, buf);
+        check(strcmp(buf, "23.45") == 0, "formatFloat 23.45", buf);
+        RaftJsonNumbers::formatFloat(3.4028235e38f, buf);
+        check(strcmp(buf, "3.4028235e+38") == 0, "formatFloat max", buf);
+    }
+
+    // Length of the shortest %.Ng representation which round-trips
+    static uint32_t shortestPrintfDigits(double val)
+    {
+        char buf[40];
+        for (int prec = 1; prec <= 17; prec++)
+        {
+            snprintf(buf, sizeof(buf), "%.*g", prec, val);
+            if (strtod(buf, NULL) == val)
+                return prec;
+        }
+        return 17;
+    }
+
+    // Number of significant digits in a formatted number
+    static uint32_t countDigits(const char* pStr)
+    {
+        uint32_t count = 0;
+        uint32_t trailingZeros = 0;
+        bool started = false;
+        for (const char* pCh = pStr; *pCh && (*pCh != 'e'); pCh++)
+        {
+            if ((*pCh < '0') || (*pCh > '9'))
+                continue;
+            if (!started && (*pCh == '0'))
+                continue;
+            started = true;
+            count++;
+            trailingZeros = (*pCh == '0') ? trailingZeros + 1 : 0;
+        }
+        return count - trailingZeros;
+    }
+
+    void testFormatRoundTrip()
+    {
+        char buf[RaftJsonNumbers::FORMAT_BUF_MIN_LEN];
+        uint32_t numTested = 0;
+        uint32_t numNotShortest = 0;
+        for (int i = 0; i < 50000; i++)
+        {
+            // Double round-trip
+            double val = 0;
+            uint64_t bits = _rng();
+            memcpy(&val, &bits, sizeof(val));
+            if (!std::isfinite(val))
+                continue;
+            uint32_t len = RaftJsonNumbers::formatDouble(val, buf);
+            check(len == strlen(buf) && len < sizeof(buf), "formatDouble len", buf);
+            check(sameBits(strtod(buf, NULL), val), "formatDouble round-trip", buf);
+            check(sameBits(RaftJsonNumbers::parseDouble(buf), val), "formatDouble parse round-trip", buf);
+            numTested++;
+            if (countDigits(buf) > shortestPrintfDigits(val))
+                numNotShortest++;
+
+            // Float round-trip
+            float fVal = 0;
+            uint32_t fBits = (uint32_t)bits;
+            memcpy(&fVal, &fBits, sizeof(fVal));
+            if (!std::isfinite(fVal))
+                continue;
+            RaftJsonNumbers::formatFloat(fVal, buf);
+            check(strtof(buf, NULL) == fVal, "formatFloat round-trip", buf);
+        }
+
+        // Grisu2 is shortest in the vast majority of cases (a small fraction gain one digit)
+        check(numNotShortest * 100 < numTested, "formatDouble mostly shortest");
+    }
+
+    void testRaftJsonAccess()
+    {
+        RaftJson json(R"({"a":1.25,"b":-42,"c":"17","d":0x10,"e":[1e3,2.5e-3],"f":true,"g":12345678901234567890})");
+        check(json.getDouble("a", 0) == 1.25, "RaftJson getDouble");
+        check(json.getLong("b", 0) == -42, "RaftJson getLong");
+        check(json.getLong("c", 0) == 17, "RaftJson getLong string");
+        check(json.getLong("d", 0) == 16, "RaftJson getLong hex");
+        check(json.getDouble("e[0]", 0) == 1000, "RaftJson getDouble array");
+        check(json.getDouble("e[1]", 0) == 0.0025, "RaftJson getDouble exp");
+        check(json.getLong("f", 0) == 1, "RaftJson getLong bool");
+        check(json.getDouble("g", 0) == 12345678901234567890.0, "RaftJson getDouble long mantissa");
+    }
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <stdio.h>
+#include "RaftThreading.h"
+#include "RaftArduino.h"
+
+class RaftLockTest
+{
+public:
+    void loop()
+    {
+        printf("Running RaftLockTest...\n");
+
+        testRWLock();
+        testRWLockThreads();
+        testAdaptiveMutex();
+
+        if (_failCount > 0)
+            printf("RaftLockTest FAILED %d tests\n", _failCount);
+        else
+            printf("RaftLockTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  RaftLockTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    void testRWLock()
+    {
+        RaftLockStats stats = {};
+        RaftRWLock rwLock;
+        RaftRWLock_init(rwLock, &stats);
+
+        // Readers share, writers exclude
+        check(RaftRWLock_lockRead(rwLock, 0) && RaftRWLock_lockRead(rwLock, 0), "multiple readers");
+        check(!RaftRWLock_lockWrite(rwLock, 0), "writer excluded by readers");
+
+        // Timed wait lasts for the timeout (deadline is on the monotonic clock)
+        uint64_t waitStartUs = micros();
+        check(!RaftRWLock_lockWrite(rwLock, 20), "timed writer excluded by readers");
+        uint64_t waitUs = micros() - waitStartUs;
+        check((waitUs >= 20000) && (waitUs < 200000), "timed writer waits for timeout");
+        RaftRWLock_unlockRead(rwLock);
+        RaftRWLock_unlockRead(rwLock);
+        check(RaftRWLock_lockWrite(rwLock, 0), "writer when free");
+        check(!RaftRWLock_lockRead(rwLock, 0), "reader excluded by writer");
+        check(!RaftRWLock_lockWrite(rwLock, 0), "writer excluded by writer");
+        RaftRWLock_unlockWrite(rwLock);
+        check(RaftRWLock_lockRead(rwLock, RAFT_WAIT_FOREVER), "reader after writer");
+        RaftRWLock_unlockRead(rwLock);
+
+        // Counters
+        check(stats.acquisitions == 4, "acquisitions counted");
+        check((stats.contended == 4) && (stats.timeouts == 4), "contention counted");
+        RaftRWLock_destroy(rwLock);
+    }
+
+    struct RWState
+    {
+        RaftRWLock rwLock;
+        uint32_t values[8] = {};
+        bool torn = false;
+        uint32_t writes = 0;
+    };
+
+    void testRWLockThreads()
+    {
+        // Writers keep all values equal - readers must never see them differ
+        RWState state;
+        RaftRWLock_init(state.rwLock);
+        auto threadFn = [](void* pArg) {
+            RWState& st = *(RWState*)pArg;
+            for (int i = 0; i < 20000; i++)
+            {
+                if (i % 10 == 0)
+                {
+                    RaftRWLock_lockWrite(st.rwLock, RAFT_WAIT_FOREVER);
+                    for (uint32_t& val : st.values)
+                        val++;
+                    st.writes++;
+                    RaftRWLock_unlockWrite(st.rwLock);
+                }
+                else
+                {
+                    RaftRWLock_lockRead(st.rwLock, RAFT_WAIT_FOREVER);
+                    for (uint32_t val : st.values)
+                        if (val != st.values[0])
+                            st.torn = true;
+                    RaftRWLock_unlockRead(st.rwLock);
+                }
+            }
+        };
+        static const int NUM_THREADS = 4;
+        RaftThreadHandle threads[NUM_THREADS];
+        for (RaftThreadHandle& thread : threads)
+            RaftThread_start(thread, threadFn, &state);
+        for (RaftThreadHandle& thread : threads)
+            pthread_join(thread, NULL);
+        check(!state.torn, "readers never see a partial write");
+        check((state.writes == NUM_THREADS * 2000) && (state.values[7] == state.writes), "all writes applied");
+        RaftRWLock_destroy(state.rwLock);
+    }
+
+    struct MutexState
+    {
+        RaftAdaptiveMutex mutex;
+        uint32_t count = 0;
+    };
+
+    void testAdaptiveMutex()
+    {
+        RaftLockStats stats = {};
+        MutexState state;
+        RaftAdaptiveMutex_init(state.mutex, RAFT_ADAPTIVE_MUTEX_DEFAULT_SPIN, &stats);
+        check(RaftAdaptiveMutex_lock(state.mutex, 0), "lock when free");
+        check(!RaftAdaptiveMutex_lock(state.mutex, 0), "trylock when held");
+        check(!RaftAdaptiveMutex_lock(state.mutex, 10), "timed lock when held");
+        RaftAdaptiveMutex_unlock(state.mutex);
+        check((stats.acquisitions == 1) && (stats.contended == 2) && (stats.timeouts == 2), "counters");
+
+        // Mutual exclusion across threads
+        auto threadFn = [](void* pArg) {
+            MutexState& st = *(MutexState*)pArg;
+            for (int i = 0; i < 50000; i++)
+            {
+                RaftAdaptiveMutex_lock(st.mutex, RAFT_WAIT_FOREVER);
+                st.count = st.count + 1;
+                RaftAdaptiveMutex_unlock(st.mutex);
+            }
+        };
+        static const int NUM_THREADS = 4;
+        RaftThreadHandle threads[NUM_THREADS];
+        for (RaftThreadHandle& thread : threads)
+            RaftThread_start(thread, threadFn, &state);
+        for (RaftThreadHandle& thread : threads)
+            pthread_join(thread, NULL);
+        check(state.count == NUM_THREADS * 50000, "adaptive mutex exclusion");
+        check(stats.acquisitions == 1 + NUM_THREADS * 50000, "acquisitions counted across threads");
+        RaftAdaptiveMutex_destroy(state.mutex);
+    }
+};
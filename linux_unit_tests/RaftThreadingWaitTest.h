@@ -0,0 +1,250 @@
+#pragma once
+
+#include <stdio.h>
+#include <time.h>
+#include "RaftThreading.h"
+#include "ThreadSafeQueue.h"
+
+class RaftThreadingWaitTest
+{
+public:
+    void loop()
+    {
+        printf("Running RaftThreadingWaitTest...\n");
+
+        testSemaphore();
+        testCondVar();
+        testEventGroup();
+        testQueueBlocking();
+        testWakeLatency();
+
+        if (_failCount > 0)
+            printf("RaftThreadingWaitTest FAILED %d tests\n", _failCount);
+        else
+            printf("RaftThreadingWaitTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  RaftThreadingWaitTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    static uint64_t nowUs()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    // Run a function on a thread and wait for it to finish
+    struct Worker
+    {
+        RaftThreadHandle handle = RAFT_THREAD_HANDLE_INVALID;
+        void start(void (*pFn)(void*), void* pArg)
+        {
+            RaftThread_start(handle, pFn, pArg);
+        }
+        void join()
+        {
+            pthread_join(handle, NULL);
+        }
+    };
+
+    void testSemaphore()
+    {
+        RaftSemaphore sem;
+        RaftSemaphore_init(sem, 1, 2);
+        check(RaftSemaphore_take(sem, 0), "take initial count");
+        check(!RaftSemaphore_take(sem, 0), "take when empty");
+        uint64_t startUs = nowUs();
+        check(!RaftSemaphore_take(sem, 20), "timed take times out");
+        uint64_t waitedUs = nowUs() - startUs;
+        check((waitedUs >= 19000) && (waitedUs < 500000), "timed take waits for timeout");
+        check(RaftSemaphore_give(sem) && RaftSemaphore_give(sem), "give up to max");
+        check(!RaftSemaphore_give(sem), "give beyond max");
+
+        // Give from another thread wakes a blocked taker
+        RaftSemaphore_take(sem, 0);
+        RaftSemaphore_take(sem, 0);
+        Worker worker;
+        worker.start([](void* pArg) {
+            RaftThread_sleep(10);
+            RaftSemaphore_give(*(RaftSemaphore*)pArg);
+        }, &sem);
+        check(RaftSemaphore_take(sem, RAFT_WAIT_FOREVER), "take woken by give");
+        worker.join();
+        RaftSemaphore_destroy(sem);
+    }
+
+    struct CondVarState
+    {
+        RaftMutex mutex;
+        RaftCondVar condVar;
+        int readyCount = 0;
+        int wokenCount = 0;
+        bool go = false;
+    };
+
+    void testCondVar()
+    {
+        CondVarState state;
+        RaftMutex_init(state.mutex);
+        RaftCondVar_init(state.condVar);
+
+        // Timeout
+        RaftMutex_lock(state.mutex, RAFT_MUTEX_WAIT_FOREVER);
+        check(!RaftCondVar_wait(state.condVar, state.mutex, 10), "condvar wait times out");
+        RaftMutex_unlock(state.mutex);
+
+        // Broadcast wakes all waiters
+        auto waiterFn = [](void* pArg) {
+            CondVarState& st = *(CondVarState*)pArg;
+            RaftMutex_lock(st.mutex, RAFT_MUTEX_WAIT_FOREVER);
+            st.readyCount++;
+            while (!st.go)
+                RaftCondVar_wait(st.condVar, st.mutex, RAFT_WAIT_FOREVER);
+            st.wokenCount++;
+            RaftMutex_unlock(st.mutex);
+        };
+        static const int NUM_WAITERS = 3;
+        Worker workers[NUM_WAITERS];
+        for (Worker& worker : workers)
+            worker.start(waiterFn, &state);
+        for (int i = 0; i < 1000; i++)
+        {
+            RaftMutex_lock(state.mutex, RAFT_MUTEX_WAIT_FOREVER);
+            bool allReady = state.readyCount == NUM_WAITERS;
+            RaftMutex_unlock(state.mutex);
+            if (allReady)
+                break;
+            RaftThread_sleep(1);
+        }
+        RaftMutex_lock(state.mutex, RAFT_MUTEX_WAIT_FOREVER);
+        state.go = true;
+        RaftCondVar_broadcast(state.condVar);
+        RaftMutex_unlock(state.mutex);
+        for (Worker& worker : workers)
+            worker.join();
+        check(state.wokenCount == NUM_WAITERS, "broadcast wakes all waiters");
+
+        RaftCondVar_destroy(state.condVar);
+        RaftMutex_destroy(state.mutex);
+    }
+
+    void testEventGroup()
+    {
+        RaftEventGroup eventGroup;
+        RaftEventGroup_init(eventGroup);
+        check(RaftEventGroup_setBits(eventGroup, 0x01) == 0x01, "set bits");
+        check(RaftEventGroup_waitBits(eventGroup, 0x03, false, false, 0) == 0x01, "wait for any");
+        check(RaftEventGroup_waitBits(eventGroup, 0x03, false, true, 10) == 0x01, "wait for all times out");
+        check(RaftEventGroup_getBits(eventGroup) == 0x01, "bits not cleared on timeout");
+        RaftEventGroup_setBits(eventGroup, 0x02);
+        check(RaftEventGroup_waitBits(eventGroup, 0x03, true, true, 0) == 0x03, "wait for all");
+        check(RaftEventGroup_getBits(eventGroup) == 0, "bits cleared on exit");
+        RaftEventGroup_setBits(eventGroup, 0x0c);
+        check(RaftEventGroup_clearBits(eventGroup, 0x04) == 0x0c, "clear returns previous bits");
+        RaftEventGroup_clearBits(eventGroup, 0xff);
+
+        // Bits set from another thread wake a waiter
+        Worker worker;
+        worker.start([](void* pArg) {
+            RaftThread_sleep(10);
+            RaftEventGroup_setBits(*(RaftEventGroup*)pArg, 0x10);
+        }, &eventGroup);
+        check(RaftEventGroup_waitBits(eventGroup, 0x10, true, false, RAFT_WAIT_FOREVER) == 0x10, "woken by set bits");
+        worker.join();
+        RaftEventGroup_destroy(eventGroup);
+    }
+
+    void testQueueBlocking()
+    {
+        ThreadSafeQueue<int> queue(2);
+        int val = 0;
+        check(!queue.getBlocking(val, 0), "get empty without blocking");
+        uint64_t startUs = nowUs();
+        check(!queue.getBlocking(val, 20), "timed get times out");
+        uint64_t waitedUs = nowUs() - startUs;
+        check((waitedUs >= 19000) && (waitedUs < 500000), "timed get waits for timeout");
+        check(queue.putBlocking(1, 0) && queue.putBlocking(2, 0), "put blocking");
+        check(!queue.putBlocking(3, 10), "timed put on full queue times out");
+
+        // A consumer frees space for a blocked producer
+        Worker worker;
+        worker.start([](void* pArg) {
+            RaftThread_sleep(10);
+            int elem = 0;
+            ((ThreadSafeQueue<int>*)pArg)->get(elem);
+        }, &queue);
+        check(queue.putBlocking(3, RAFT_WAIT_FOREVER), "put woken by get");
+        worker.join();
+        check(queue.getBlocking(val, 0) && (val == 2), "queue order 1");
+        check(queue.getBlocking(val, 0) && (val == 3), "queue order 2");
+
+        // Existing non-blocking get/put are unchanged
+        check(!queue.get(val), "get non-blocking");
+        check(queue.put(4) && queue.get(val) && (val == 4), "put/get non-blocking");
+    }
+
+    // Producer/consumer wake-up latency with blocking get vs polling with a 1ms sleep
+    static const int LATENCY_MSGS = 50;
+    struct LatencyState
+    {
+        ThreadSafeQueue<uint64_t> queue;
+        bool blocking = true;
+        uint64_t totalLatencyUs = 0;
+        uint64_t maxLatencyUs = 0;
+    };
+
+    void testWakeLatency()
+    {
+        uint64_t avgUs[2] = {};
+        uint64_t maxUs[2] = {};
+        for (int mode = 0; mode < 2; mode++)
+        {
+            LatencyState state;
+            state.blocking = mode == 0;
+            Worker consumer;
+            consumer.start([](void* pArg) {
+                LatencyState& st = *(LatencyState*)pArg;
+                for (int i = 0; i < LATENCY_MSGS; i++)
+                {
+                    uint64_t sentUs = 0;
+                    if (st.blocking)
+                    {
+                        st.queue.getBlocking(sentUs, RAFT_WAIT_FOREVER);
+                    }
+                    else
+                    {
+                        while (!st.queue.get(sentUs))
+                            RaftThread_sleep(1);
+                    }
+                    uint64_t latencyUs = nowUs() - sentUs;
+                    st.totalLatencyUs += latencyUs;
+                    if (latencyUs > st.maxLatencyUs)
+                        st.maxLatencyUs = latencyUs;
+                }
+            }, &state);
+            for (int i = 0; i < LATENCY_MSGS; i++)
+            {
+                // Stagger sends so the consumer is waiting when each message arrives
+                usleep(2000 + (i % 7) * 100);
+                state.queue.put(nowUs(), RAFT_MUTEX_WAIT_FOREVER);
+            }
+            consumer.join();
+            avgUs[mode] = state.totalLatencyUs / LATENCY_MSGS;
+            maxUs[mode] = state.maxLatencyUs;
+        }
+        printf("  Wake-up latency: blocking avg %lluus max %lluus, polling avg %lluus max %lluus\n",
+                    (unsigned long long)avgUs[0], (unsigned long long)maxUs[0],
+                    (unsigned long long)avgUs[1], (unsigned long long)maxUs[1]);
+        check(avgUs[0] < avgUs[1], "blocking wake-up faster than polling");
+    }
+};
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "RestAPIEndpointManager.h"
+
+class RestAPIBodyTest
+{
+public:
+    void loop()
+    {
+        printf("Running RestAPIBodyTest...\n");
+
+        testSingleChunkZeroCopy();
+        testMultiChunk();
+        testStreaming();
+        testSizeLimit();
+        testInterleavedChannels();
+
+        if (_failCount > 0)
+            printf("RestAPIBodyTest FAILED %d tests\n", _failCount);
+        else
+            printf("RestAPIBodyTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  RestAPIBodyTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    // Complete body record
+    struct BodyRecord
+    {
+        std::vector<uint8_t> body;
+        const uint8_t* pBody = nullptr;
+        uint32_t numCalls = 0;
+    };
+
+    static RaftRetCode mainCB(const String &reqStr, String &respStr, const APISourceInfo& sourceInfo)
+    {
+        return RAFT_OK;
+    }
+
+    static RestAPIFnBodyComplete recordCB(BodyRecord& record)
+    {
+        return [&record](const String &reqStr, const uint8_t *pBody, size_t len, const APISourceInfo& sourceInfo) {
+            record.body.assign(pBody, pBody + len);
+            record.pBody = pBody;
+            record.numCalls++;
+            return RAFT_OK;
+        };
+    }
+
+    static std::vector<uint8_t> makeBody(uint32_t len)
+    {
+        std::vector<uint8_t> body(len);
+        for (uint32_t i = 0; i < len; i++)
+            body[i] = (uint8_t)(i * 7 + 3);
+        return body;
+    }
+
+    // Send a body in chunks through the endpoint (as a web server does)
+    static RaftRetCode sendBody(RestAPIEndpoint* pEndpoint, const std::vector<uint8_t>& body, uint32_t chunkLen,
+                uint32_t channelID = 1)
+    {
+        String reqStr = pEndpoint->_endpointStr;
+        APISourceInfo sourceInfo(channelID);
+        RaftRetCode retc = RAFT_OK;
+        for (uint32_t pos = 0; pos < body.size(); pos += chunkLen)
+        {
+            uint32_t len = pos + chunkLen > body.size() ? body.size() - pos : chunkLen;
+            retc = pEndpoint->callbackBody(reqStr, body.data() + pos, len, pos, body.size(), sourceInfo);
+            if (retc != RAFT_OK)
+                break;
+        }
+        return retc;
+    }
+
+    void testSingleChunkZeroCopy()
+    {
+        RestAPIEndpointManager manager;
+        BodyRecord record;
+        manager.addBodyEndpoint("settings", RestAPIEndpoint::ENDPOINT_POST, mainCB, "settings", 1024, recordCB(record));
+        RestAPIEndpoint* pEndpoint = manager.getEndpoint("settings");
+        check(pEndpoint && (pEndpoint->_endpointMethod == RestAPIEndpoint::ENDPOINT_POST), "endpoint added");
+        if (!pEndpoint)
+            return;
+        std::vector<uint8_t> body = makeBody(500);
+        check(sendBody(pEndpoint, body, 500) == RAFT_OK, "single chunk body");
+        check((record.numCalls == 1) && (record.body == body), "single chunk body complete");
+        check(record.pBody == body.data(), "single chunk body not copied");
+        RestAPIBodyAccumulator::Stats stats = manager.getBodyStats();
+        check((stats.zeroCopyBodies == 1) && (stats.bytesCopied == 0) && (stats.reservations == 0), "zero copy stats");
+    }
+
+    void testMultiChunk()
+    {
+        RestAPIEndpointManager manager;
+        BodyRecord record;
+        manager.addBodyEndpoint("upload", RestAPIEndpoint::ENDPOINT_POST, mainCB, "upload", 0, recordCB(record));
+        RestAPIEndpoint* pEndpoint = manager.getEndpoint("upload");
+        if (!pEndpoint)
+            return;
+        static const uint32_t BODY_LEN = 10000, CHUNK_LEN = 700;
+        std::vector<uint8_t> body = makeBody(BODY_LEN);
+        check(sendBody(pEndpoint, body, CHUNK_LEN) == RAFT_OK, "multi chunk body");
+        check((record.numCalls == 1) && (record.body == body), "multi chunk body complete");
+        RestAPIBodyAccumulator::Stats stats = manager.getBodyStats();
+        check((stats.reservations == 1) && (stats.bytesCopied == BODY_LEN), "reserved once and copied once");
+        check((stats.peakBufferedBytes == BODY_LEN) && (stats.bufferedBytes == 0), "peak memory and freed");
+
+        // Compare with accumulating into a growing vector per endpoint
+        std::vector<uint8_t> naiveBuf;
+        uint64_t naiveCopied = 0;
+        uint32_t naiveAllocs = 0;
+        size_t naivePeak = 0;
+        for (uint32_t pos = 0; pos < BODY_LEN; pos += CHUNK_LEN)
+        {
+            uint32_t len = pos + CHUNK_LEN > BODY_LEN ? BODY_LEN - pos : CHUNK_LEN;
+            size_t oldSize = naiveBuf.size();
+            size_t oldCap = naiveBuf.capacity();
+            naiveBuf.insert(naiveBuf.end(), body.data() + pos, body.data() + pos + len);
+            naiveCopied += len;
+            if (naiveBuf.capacity() != oldCap)
+            {
+                // Reallocation moves the existing contents with both buffers allocated
+                naiveCopied += oldSize;
+                naiveAllocs++;
+                if (oldCap + naiveBuf.capacity() > naivePeak)
+                    naivePeak = oldCap + naiveBuf.capacity();
+            }
+        }
+        printf("  Body of %u bytes in %u byte chunks: accumulator %u alloc %u bytes peak %llu copied, "
+                    "growing vector %u allocs %u bytes peak %llu copied\n",
+                    (unsigned)BODY_LEN, (unsigned)CHUNK_LEN,
+                    (unsigned)stats.reservations, (unsigned)stats.peakBufferedBytes, (unsigned long long)stats.bytesCopied,
+                    (unsigned)naiveAllocs, (unsigned)naivePeak, (unsigned long long)naiveCopied);
+        check((stats.peakBufferedBytes < naivePeak) && (stats.bytesCopied < naiveCopied), "less memory and copying");
+    }
+
+    void testStreaming()
+    {
+        // Streaming consumer sees each chunk in place and nothing is buffered
+        RestAPIEndpointManager manager;
+        std::vector<const uint8_t*> chunkPtrs;
+        uint32_t bytesSeen = 0;
+        manager.addBodyEndpoint("stream", RestAPIEndpoint::ENDPOINT_PUT, mainCB, "stream", 0, nullptr,
+            [&chunkPtrs, &bytesSeen](const String &reqStr, const uint8_t *pData, size_t len, size_t index,
+                        size_t total, const APISourceInfo& sourceInfo) {
+                chunkPtrs.push_back(pData);
+                bytesSeen += len;
+                return RAFT_OK;
+            });
+        RestAPIEndpoint* pEndpoint = manager.getEndpoint("stream");
+        if (!pEndpoint)
+            return;
+        std::vector<uint8_t> body = makeBody(3000);
+        check(sendBody(pEndpoint, body, 1000) == RAFT_OK, "streamed body");
+        check((chunkPtrs.size() == 3) && (bytesSeen == 3000), "all chunks streamed");
+        if (chunkPtrs.size() == 3)
+            check((chunkPtrs[0] == body.data()) && (chunkPtrs[2] == body.data() + 2000), "chunks are views");
+        check(manager.getBodyStats().peakBufferedBytes == 0, "nothing buffered when streaming");
+
+        // Streaming and complete consumers together - a streaming error abandons the body
+        BodyRecord record;
+        bool failStream = false;
+        manager.addBodyEndpoint("both", RestAPIEndpoint::ENDPOINT_POST, mainCB, "both", 0, recordCB(record),
+            [&failStream](const String &reqStr, const uint8_t *pData, size_t len, size_t index,
+                        size_t total, const APISourceInfo& sourceInfo) {
+                return failStream && (index > 0) ? RAFT_INVALID_DATA : RAFT_OK;
+            });
+        pEndpoint = manager.getEndpoint("both");
+        check(sendBody(pEndpoint, body, 1000) == RAFT_OK, "stream and complete");
+        check((record.numCalls == 1) && (record.body == body), "complete after stream");
+        failStream = true;
+        check(sendBody(pEndpoint, body, 1000) == RAFT_INVALID_DATA, "stream error returned");
+        check((record.numCalls == 1) && (manager.getBodyStats().bufferedBytes == 0), "body abandoned on stream error");
+    }
+
+    void testSizeLimit()
+    {
+        RestAPIEndpointManager manager;
+        BodyRecord record;
+        manager.addBodyEndpoint("small", RestAPIEndpoint::ENDPOINT_POST, mainCB, "small", 1000, recordCB(record));
+        RestAPIEndpoint* pEndpoint = manager.getEndpoint("small");
+        if (!pEndpoint)
+            return;
+        check(sendBody(pEndpoint, makeBody(1000), 300) == RAFT_OK, "body at limit");
+        check(sendBody(pEndpoint, makeBody(1001), 300) == RAFT_INSUFFICIENT_RESOURCE, "body over limit rejected");
+        check((record.numCalls == 1) && (manager.getBodyStats().peakBufferedBytes == 1000), "nothing allocated for rejected body");
+
+        // Limit applies to endpoints with their own body callback
+        uint32_t bodyCalls = 0;
+        manager.addEndpoint("raw", RestAPIEndpoint::ENDPOINT_CALLBACK, RestAPIEndpoint::ENDPOINT_POST, mainCB, "raw",
+                    nullptr, nullptr, RestAPIEndpoint::ENDPOINT_CACHE_NEVER, nullptr,
+                    [&bodyCalls](const String &reqStr, const uint8_t *pData, size_t len, size_t index,
+                        size_t total, const APISourceInfo& sourceInfo) {
+                        bodyCalls++;
+                        return RAFT_OK;
+                    });
+        pEndpoint = manager.getEndpoint("raw");
+        pEndpoint->_maxBodyLen = 100;
+        check(sendBody(pEndpoint, makeBody(200), 50) == RAFT_INSUFFICIENT_RESOURCE, "raw body over limit");
+        check(sendBody(pEndpoint, makeBody(100), 50) == RAFT_OK && (bodyCalls == 2), "raw body within limit");
+    }
+
+    void testInterleavedChannels()
+    {
+        RestAPIEndpointManager manager;
+        std::vector<std::vector<uint8_t>> bodies;
+        manager.addBodyEndpoint("multi", RestAPIEndpoint::ENDPOINT_POST, mainCB, "multi", 0,
+            [&bodies](const String &reqStr, const uint8_t *pBody, size_t len, const APISourceInfo& sourceInfo) {
+                bodies.push_back(std::vector<uint8_t>(pBody, pBody + len));
+                return RAFT_OK;
+            });
+        RestAPIEndpoint* pEndpoint = manager.getEndpoint("multi");
+        if (!pEndpoint)
+            return;
+
+        // Two sources send bodies at the same time
+        std::vector<uint8_t> bodyA = makeBody(400);
+        std::vector<uint8_t> bodyB(600, 0x55);
+        String reqStr = "multi";
+        APISourceInfo srcA(1), srcB(2);
+        for (uint32_t pos = 0; pos < 600; pos += 200)
+        {
+            if (pos < 400)
+                pEndpoint->callbackBody(reqStr, bodyA.data() + pos, 200, pos, 400, srcA);
+            pEndpoint->callbackBody(reqStr, bodyB.data() + pos, 200, pos, 600, srcB);
+        }
+        check((bodies.size() == 2) && (bodies[0] == bodyA) && (bodies[1] == bodyB), "interleaved bodies assembled");
+        check(manager.getBodyStats().peakBufferedBytes == 1000, "both bodies buffered at once");
+
+        // Out of order chunk discards the body
+        check(pEndpoint->callbackBody(reqStr, bodyA.data(), 200, 0, 400, srcA) == RAFT_OK, "first chunk");
+        check(pEndpoint->callbackBody(reqStr, bodyA.data(), 100, 300, 400, srcA) == RAFT_INVALID_DATA, "gap rejected");
+        check(pEndpoint->callbackBody(reqStr, bodyA.data(), 100, 200, 400, srcA) == RAFT_INVALID_DATA, "rest discarded");
+        check(manager.getBodyStats().bufferedBytes == 0, "discarded body freed");
+    }
+};
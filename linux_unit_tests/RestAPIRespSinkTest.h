@@ -0,0 +1,190 @@
+#pragma once
+
+#include <stdio.h>
+#include "RestAPIRespSink.h"
+#include "RaftJson.h"
+
+class RestAPIRespSinkTest
+{
+public:
+    void loop()
+    {
+        printf("Running RestAPIRespSinkTest...\n");
+
+        testNesting();
+        testEscaping();
+        testNumbers();
+        testRawAndMembers();
+        testLargeResponse();
+        testOverflow();
+
+        if (_failCount > 0)
+            printf("RestAPIRespSinkTest FAILED %d tests\n", _failCount);
+        else
+            printf("RestAPIRespSinkTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  RestAPIRespSinkTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    void checkStr(const String& got, const char* expected, const char* msg)
+    {
+        if (!got.equals(expected))
+            printf("  RestAPIRespSinkTest got %s expected %s\n", got.c_str(), expected);
+        check(got.equals(expected), msg);
+    }
+
+    void testNesting()
+    {
+        String respStr = "previous contents";
+        {
+            RestAPIRespSink resp(respStr);
+            resp.startResponse("files");
+            resp.arrStart("list");
+            for (int i = 0; i < 3; i++)
+            {
+                resp.objStart();
+                resp.addStr("name", String("f") + String(i));
+                resp.arrStart("empty");
+                resp.arrEnd();
+                resp.objEnd();
+            }
+            resp.arrEnd();
+            resp.objStart("obj");
+            resp.objEnd();
+            check(resp.endResponse(true), "endResponse ok");
+        }
+        checkStr(respStr, R"({"req":"files","list":[{"name":"f0","empty":[]},{"name":"f1","empty":[]},{"name":"f2","empty":[]}],"obj":{},"rslt":"ok"})",
+                    "nesting");
+
+        // Failure response
+        {
+            RestAPIRespSink resp(respStr);
+            resp.startResponse("cmd");
+            check(!resp.endResponse(false, "busy"), "endResponse fail");
+        }
+        checkStr(respStr, R"({"req":"cmd","rslt":"fail","error":"busy"})", "fail response");
+    }
+
+    void testEscaping()
+    {
+        String respStr;
+        {
+            RestAPIRespSink resp(respStr);
+            resp.objStart();
+            resp.addStr("k\"1", "a\"b\\c\nd\te\x01");
+            resp.addStr("k2", nullptr);
+            resp.objEnd();
+        }
+        checkStr(respStr, R"({"k\"1":"a\"b\\c\nd\te\u0001","k2":""})", "escaping");
+        respStr = "";
+        {
+            RestAPIRespSink resp(respStr);
+            resp.objStart();
+            resp.addStr("k", "a\"b\\c\nd");
+            resp.objEnd();
+        }
+        RaftJson json(respStr);
+        checkStr(json.getString("k", ""), "a\"b\\c\nd", "escaped round trip");
+    }
+
+    void testNumbers()
+    {
+        String respStr;
+        {
+            RestAPIRespSink resp(respStr);
+            resp.arrStart();
+            resp.addInt(nullptr, 0);
+            resp.addInt(nullptr, -42);
+            resp.addInt(nullptr, INT64_MIN);
+            resp.addUint(nullptr, UINT64_MAX);
+            resp.addDouble(nullptr, 0.1);
+            resp.addDouble(nullptr, -2.5);
+            resp.arrEnd();
+        }
+        checkStr(respStr, "[0,-42,-9223372036854775808,18446744073709551615,0.1,-2.5]", "numbers");
+    }
+
+    void testRawAndMembers()
+    {
+        String respStr;
+        {
+            RestAPIRespSink resp(respStr);
+            resp.objStart();
+            resp.addRaw("a", R"({"x":[1,2]})");
+            resp.addRaw("b", "");
+            resp.addMembers(R"( {"c":1,"d":"e"} )");
+            resp.addMembers("{}");
+            resp.addMembers(R"("f":true)");
+            resp.objEnd();
+        }
+        checkStr(respStr, R"({"a":{"x":[1,2]},"b":null,"c":1,"d":"e","f":true})", "raw and members");
+    }
+
+    void testLargeResponse()
+    {
+        // Larger than the staging buffer and the initial reservation
+        String respStr;
+        String longStr;
+        for (int i = 0; i < 500; i++)
+            longStr += (char)('a' + (i % 26));
+        {
+            RestAPIRespSink resp(respStr, 16);
+            resp.arrStart();
+            for (int i = 0; i < 20; i++)
+                resp.addStr(nullptr, longStr);
+            resp.arrEnd();
+            check(resp.length() == 20 * (longStr.length() + 3) + 1, "length includes staged");
+        }
+        RaftJson json(respStr);
+        int arrayLen = 0;
+        json.getType("", arrayLen);
+        check(arrayLen == 20, "large array len");
+        checkStr(json.getString("[19]", ""), longStr.c_str(), "large array elem");
+    }
+
+    void testOverflow()
+    {
+        String respStr;
+        RestAPIRespSink resp(respStr, 16, 100);
+        resp.startResponse("big");
+        resp.arrStart("vals");
+        for (int i = 0; i < 100; i++)
+            resp.addUint(nullptr, 1000000 + i);
+        resp.arrEnd();
+        check(!resp.endResponse(true), "overflow fails response");
+        check(resp.isOverflow(), "overflow flagged");
+        check(respStr.length() <= 100, "overflow bounded");
+
+        // No length limit (other than the String capacity)
+        String unlimitedStr;
+        {
+            RestAPIRespSink unlimited(unlimitedStr, 16, RestAPIRespSink::MAX_LEN_UNLIMITED);
+            unlimited.arrStart();
+            for (int i = 0; i < 7800; i++)
+                unlimited.addUint(nullptr, 1000000 + i);
+            unlimited.arrEnd();
+            unlimited.flush();
+            check(!unlimited.isOverflow(), "unlimited not overflowed");
+        }
+        check(unlimitedStr.length() > RestAPIRespSink::MAX_LEN_DEFAULT, "unlimited longer than default max");
+
+        // Nesting beyond the maximum depth fails rather than producing malformed JSON
+        String deepStr;
+        RestAPIRespSink deep(deepStr);
+        for (uint32_t i = 0; i < RestAPIRespSink::MAX_DEPTH - 1; i++)
+            deep.arrStart();
+        check(!deep.isOverflow(), "max depth ok");
+        deep.arrStart();
+        check(deep.isOverflow(), "beyond max depth fails");
+    }
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <stdio.h>
+#include "DeviceStatus.h"
+#include "RaftBus.h"
+
+class SampleTimeTest
+{
+public:
+    void loop()
+    {
+        printf("Running SampleTimeTest...\n");
+
+        testSampleTimeModel();
+        testCrossBusAlignment();
+        testPartialPollAlignment();
+        testBusLatencyForwarded();
+
+        if (_failCount > 0)
+            printf("SampleTimeTest FAILED %d tests\n", _failCount);
+        else
+            printf("SampleTimeTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    // Aggregator which records the time and data of the last result
+    class TestAggregator : public PollDataAggregatorIF
+    {
+    public:
+        virtual void clear() override { _count = 0; }
+        virtual bool put(uint64_t timeNowUs, const std::vector<uint8_t>& data) override { _count++; lastTimeUs = timeNowUs; lastData = data; return true; }
+        virtual bool get(std::vector<uint8_t>& data) override { data = lastData; return _count > 0; }
+        virtual uint32_t get(std::vector<uint8_t>& data, uint32_t& responseSize, uint32_t maxResponsesToReturn) override
+        {
+            data = lastData;
+            responseSize = lastData.size();
+            return _count > 0 ? 1 : 0;
+        }
+        virtual uint32_t count() const override { return _count; }
+        virtual bool getLatestValue(uint64_t& dataTimeUs, std::vector<uint8_t>& data) override { data = lastData; return _count > 0; }
+        virtual bool resize(uint32_t numResultsToStore) override { return true; }
+        uint64_t lastTimeUs = 0;
+        std::vector<uint8_t> lastData;
+    private:
+        uint32_t _count = 0;
+    };
+
+    // Bus which creates device records
+    class TestBus : public RaftBus
+    {
+    public:
+        TestBus() : RaftBus(nullptr, nullptr)
+        {
+        }
+        void createDevice(DeviceStatus& devStatus)
+        {
+            initDeviceStatus(devStatus);
+        }
+    };
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  SampleTimeTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    // Setup a device status with a single poll request
+    static std::shared_ptr<TestAggregator> setupDevice(DeviceStatus& devStatus, uint32_t sampleDelayUs, int32_t latencyUs)
+    {
+        auto pAggregator = std::make_shared<TestAggregator>();
+        devStatus.setAndOwnPollDataAggregator(pAggregator);
+        devStatus.deviceIdentPolling.pollIntervalUs = 100000;
+        devStatus.deviceIdentPolling.sampleDelayUs = sampleDelayUs;
+        devStatus.deviceIdentPolling.pollResultSizeIncTimestamp = 6;
+        uint8_t writeData[] = {0x00};
+        devStatus.deviceIdentPolling.pollReqs.push_back(BusRequestInfo(BUS_REQ_TYPE_POLL, 0x40,
+                    DevicePollingInfo::DEV_IDENT_POLL_CMD_ID, 1, writeData, 4, 0, nullptr, nullptr));
+        devStatus.setSampleLatencyUs(latencyUs);
+        return pAggregator;
+    }
+
+    // Start a poll (the first call only initialises the poll timer)
+    static bool startPoll(DeviceStatus& devStatus, uint64_t timeUs)
+    {
+        DevicePollingInfo pollInfo;
+        devStatus.getPendingIdentPollInfo(timeUs - 200000, pollInfo);
+        return devStatus.getPendingIdentPollInfo(timeUs, pollInfo);
+    }
+
+    static uint16_t getTimestamp(const std::vector<uint8_t>& data)
+    {
+        return data.size() < 2 ? 0 : (data[0] << 8) | data[1];
+    }
+
+    void testSampleTimeModel()
+    {
+        DevicePollingInfo pollInfo;
+        pollInfo.sampleDelayUs = 5000;
+        check(pollInfo.getSampleTimeUs(20000, 0) == 20000, "no poll start uses completion time");
+        pollInfo.pollStartTimeUs = 10000;
+        check(pollInfo.getSampleTimeUs(20000, 0) == 15000, "sample time is request plus delay");
+        check(pollInfo.getSampleTimeUs(20000, 500) == 15500, "sample time includes latency");
+        check(pollInfo.getSampleTimeUs(12000, 0) == 12000, "sample time clamped to completion");
+        check(pollInfo.getSampleTimeUs(20000, -8000) == 10000, "sample time clamped to request");
+    }
+
+    void testCrossBusAlignment()
+    {
+        // Device A on a fast bus with a 5ms conversion, device B on a slow bus (300us latency) with no
+        // conversion delay - both sample at 1.005s but complete at different times
+        DeviceStatus devA, devB;
+        auto pAggA = setupDevice(devA, 5000, 0);
+        auto pAggB = setupDevice(devB, 0, 300);
+        check(startPoll(devA, 1000000), "poll A started");
+        check(startPoll(devB, 1004700), "poll B started");
+        std::vector<uint8_t> pollResult = {0xff, 0xff, 1, 2, 3, 4};
+        devA.storePollResults(0, 1007000, pollResult, nullptr, 0);
+        devB.storePollResults(0, 1009000, pollResult, nullptr, 0);
+        check(pAggA->lastTimeUs == 1005000, "device A aligned to sample time");
+        check(pAggB->lastTimeUs == 1005000, "device B aligned to sample time");
+        check(getTimestamp(pAggA->lastData) == 1005 && getTimestamp(pAggB->lastData) == 1005, "poll result timestamps aligned");
+        check(pAggA->lastData.size() == 6 && pAggA->lastData[2] == 1 && pAggA->lastData[5] == 4, "poll data unchanged");
+    }
+
+    void testPartialPollAlignment()
+    {
+        // Poll sequence with a pause - the sample time relates to the start of the sequence
+        DeviceStatus devStatus;
+        auto pAggregator = setupDevice(devStatus, 2000, 0);
+        check(startPoll(devStatus, 2000000), "partial poll started");
+        std::vector<uint8_t> firstPart = {0xff, 0xff, 1, 2};
+        std::vector<uint8_t> secondPart = {3, 4};
+        devStatus.storePollResults(1, 2000500, firstPart, nullptr, 3);
+        check(pAggregator->count() == 0, "partial result not stored");
+        DevicePollingInfo pollInfo;
+        check(devStatus.getPendingIdentPollInfo(2003600, pollInfo), "partial poll continued");
+        devStatus.storePollResults(0, 2004000, secondPart, nullptr, 0);
+        check(pAggregator->lastTimeUs == 2002000, "partial poll aligned to sequence start");
+        check(pAggregator->lastData.size() == 6 && getTimestamp(pAggregator->lastData) == 2002, "partial poll timestamp");
+    }
+
+    void testBusLatencyForwarded()
+    {
+        // Latency configured on the bus applies to the device records it creates
+        TestBus bus;
+        bus.setSampleLatencyUs(300);
+        DeviceStatus devStatus;
+        auto pAggregator = setupDevice(devStatus, 0, 0);
+        bus.createDevice(devStatus);
+        check(startPoll(devStatus, 1004700), "bus device poll started");
+        std::vector<uint8_t> pollResult = {0xff, 0xff, 1, 2, 3, 4};
+        devStatus.storePollResults(0, 1009000, pollResult, nullptr, 0);
+        check(pAggregator->lastTimeUs == 1005000, "bus latency applied to device");
+    }
+};
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <stdio.h>
+#include <random>
+#include "RaftStateHash.h"
+#include "DeviceStatus.h"
+#include "RaftBus.h"
+
+class StateHashTest
+{
+public:
+    void loop()
+    {
+        printf("Running StateHashTest...\n");
+
+        testKnownVectors();
+        testDeviceStatusHash();
+        testIncrementalSetMatchesFull();
+        testCollisionRateVsXOR();
+        testBusStateHash();
+
+        if (_failCount > 0)
+            printf("StateHashTest FAILED %d tests\n", _failCount);
+        else
+            printf("StateHashTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    // Minimal aggregator for storing poll results
+    class TestAggregator : public PollDataAggregatorIF
+    {
+    public:
+        virtual void clear() override { _count = 0; }
+        virtual bool put(uint64_t timeNowUs, const std::vector<uint8_t>& data) override { _count++; _last = data; return true; }
+        virtual bool get(std::vector<uint8_t>& data) override { data = _last; return _count > 0; }
+        virtual uint32_t get(std::vector<uint8_t>& data, uint32_t& responseSize, uint32_t maxResponsesToReturn) override
+        {
+            data = _last;
+            responseSize = _last.size();
+            return _count > 0 ? 1 : 0;
+        }
+        virtual uint32_t count() const override { return _count; }
+        virtual bool getLatestValue(uint64_t& dataTimeUs, std::vector<uint8_t>& data) override { data = _last; return _count > 0; }
+        virtual bool resize(uint32_t numResultsToStore) override { return true; }
+    private:
+        uint32_t _count = 0;
+        std::vector<uint8_t> _last;
+    };
+
+    // Bus owning device records which maintains its state hash incrementally
+    class TestBus : public RaftBus
+    {
+    public:
+        static const uint32_t NUM_DEVICES = 8;
+        TestBus() : RaftBus(nullptr, nullptr), devStatus(NUM_DEVICES), isOnline(NUM_DEVICES, true)
+        {
+            for (uint32_t i = 0; i < NUM_DEVICES; i++)
+            {
+                devStatus[i].setAndOwnPollDataAggregator(std::make_shared<TestAggregator>());
+                updateDeviceStateHash(i, devStatus[i], true);
+            }
+        }
+        void storeResult(uint32_t devIdx, uint64_t timeNowUs, const std::vector<uint8_t>& pollResult)
+        {
+            devStatus[devIdx].storePollResults(0, timeNowUs, pollResult, nullptr, 0);
+            updateDeviceStateHash(devIdx, devStatus[devIdx], isOnline[devIdx]);
+        }
+        void setOnline(uint32_t devIdx, bool online)
+        {
+            isOnline[devIdx] = online;
+            updateDeviceStateHash(devIdx, devStatus[devIdx], online);
+        }
+        void removeDevice(uint32_t devIdx)
+        {
+            removeDeviceStateHash(devStatus[devIdx]);
+        }
+        virtual uint32_t getDeviceInfoTimestampMs(bool includeElemOnlineStatusChanges, bool includeDeviceDataUpdates) const override
+        {
+            return 1234;
+        }
+        std::vector<DeviceStatus> devStatus;
+        std::vector<bool> isOnline;
+    };
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  StateHashTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    void testKnownVectors()
+    {
+        // Reference values for xxHash64 with seed 0
+        const uint8_t* pABC = (const uint8_t*)"abc";
+        check(RaftStateHash::hashBytes(nullptr, 0) == 0xEF46DB3751D8E999ULL, "xxh64 empty");
+        check(RaftStateHash::hashBytes(pABC, 3) == 0x44BC2CF5AD770999ULL, "xxh64 abc");
+        const char* pLong = "Nobody inspects the spammish repetition";
+        check(RaftStateHash::hashBytes((const uint8_t*)pLong, strlen(pLong)) == 0xFBCEA83C8A378BF1ULL, "xxh64 long");
+    }
+
+    void testDeviceStatusHash()
+    {
+        DeviceStatus devStatus;
+        devStatus.setAndOwnPollDataAggregator(std::make_shared<TestAggregator>());
+        std::vector<uint8_t> pollResult = {1, 2, 3, 4};
+        uint64_t hash0 = devStatus.getStateHash();
+        devStatus.storePollResults(0, 1000, pollResult, nullptr, 0);
+        uint64_t hash1 = devStatus.getStateHash();
+        check(hash1 != hash0, "device hash changes on first result");
+
+        // Same data at a later time is still a new result
+        devStatus.storePollResults(0, 2000, pollResult, nullptr, 0);
+        uint64_t hash2 = devStatus.getStateHash();
+        check(hash2 != hash1, "device hash changes on repeated data");
+
+        // Clear resets
+        devStatus.clear();
+        check(devStatus.getStateHash() == 0, "device hash cleared");
+    }
+
+    void testIncrementalSetMatchesFull()
+    {
+        static const uint32_t NUM_DEVICES = 50;
+        std::mt19937_64 rng(1234);
+        std::vector<uint64_t> devHashes(NUM_DEVICES);
+        RaftStateHashSet incSet;
+        for (uint32_t i = 0; i < NUM_DEVICES; i++)
+        {
+            devHashes[i] = rng();
+            incSet.add(RaftStateHashSet::elemHash(i, devHashes[i]));
+        }
+        bool allMatch = true;
+        for (uint32_t iter = 0; iter < 1000; iter++)
+        {
+            uint32_t devIdx = rng() % NUM_DEVICES;
+            uint64_t newHash = rng();
+            incSet.replace(RaftStateHashSet::elemHash(devIdx, devHashes[devIdx]), RaftStateHashSet::elemHash(devIdx, newHash));
+            devHashes[devIdx] = newHash;
+            RaftStateHashSet fullSet;
+            for (uint32_t i = 0; i < NUM_DEVICES; i++)
+                fullSet.add(RaftStateHashSet::elemHash(i, devHashes[i]));
+            if (fullSet.get() != incSet.get())
+                allMatch = false;
+        }
+        check(allMatch, "incremental set hash matches full recompute");
+
+        // Identical state on two devices must not cancel out
+        RaftStateHashSet dupSet;
+        dupSet.add(RaftStateHashSet::elemHash(1, 0x1234));
+        dupSet.add(RaftStateHashSet::elemHash(2, 0x1234));
+        check(dupSet.get() != 0, "identical device states do not cancel");
+    }
+
+    void testCollisionRateVsXOR()
+    {
+        // Fuzz: devices receive poll results at random times and the publisher checks the
+        // hash after each update - a collision is when the hash is unchanged despite new data
+        static const uint32_t NUM_DEVICES = 16;
+        static const uint32_t NUM_UPDATES = 200000;
+        std::mt19937 rng(5678);
+        std::vector<DeviceStatus> devStatus(NUM_DEVICES);
+        std::vector<uint32_t> lastUpdateMs(NUM_DEVICES, 0);
+        for (auto& dev : devStatus)
+            dev.setAndOwnPollDataAggregator(std::make_shared<TestAggregator>());
+
+        RaftStateHashSet busHashSet;
+        for (uint32_t i = 0; i < NUM_DEVICES; i++)
+            busHashSet.add(RaftStateHashSet::elemHash(i, devStatus[i].getStateHash()));
+
+        uint64_t timeNowUs = 0;
+        uint16_t prevXORHash = 0;
+        uint64_t prevStateHash = busHashSet.get();
+        uint32_t xorCollisions = 0;
+        uint32_t stateHashCollisions = 0;
+        std::vector<uint8_t> pollResult(6);
+        for (uint32_t upd = 0; upd < NUM_UPDATES; upd++)
+        {
+            // Advance time and update a random device
+            timeNowUs += (rng() % 20000) + 1;
+            uint32_t devIdx = rng() % NUM_DEVICES;
+            for (auto& b : pollResult)
+                b = rng() & 0xff;
+            uint64_t oldDevHash = RaftStateHashSet::elemHash(devIdx, devStatus[devIdx].getStateHash());
+            devStatus[devIdx].storePollResults(0, timeNowUs, pollResult, nullptr, 0);
+            busHashSet.replace(oldDevHash, RaftStateHashSet::elemHash(devIdx, devStatus[devIdx].getStateHash()));
+            lastUpdateMs[devIdx] = timeNowUs / 1000;
+
+            // Previous scheme - XOR of millisecond timestamps into two bytes
+            uint16_t xorHash = 0;
+            for (uint32_t i = 0; i < NUM_DEVICES; i++)
+                xorHash ^= lastUpdateMs[i] & 0xffff;
+            if (xorHash == prevXORHash)
+                xorCollisions++;
+            prevXORHash = xorHash;
+
+            // New scheme
+            if (busHashSet.get() == prevStateHash)
+                stateHashCollisions++;
+            prevStateHash = busHashSet.get();
+        }
+        printf("  Collision fuzz: %u updates, XOR16 suppressed %u (%.4f%%), 64-bit state hash suppressed %u\n",
+                NUM_UPDATES, xorCollisions, xorCollisions * 100.0 / NUM_UPDATES, stateHashCollisions);
+        check(stateHashCollisions == 0, "64-bit state hash has no collisions");
+        check(stateHashCollisions <= xorCollisions, "64-bit state hash no worse than XOR scheme");
+    }
+
+    void testBusStateHash()
+    {
+        // Bus without device records falls back to the info timestamp
+        RaftBus plainBus(nullptr, nullptr);
+        check(plainBus.getDevicesStateHash() == RaftStateHash::hashValue(0), "bus without records uses timestamp");
+
+        // Bus hash changes only with device updates and matches a full recompute
+        TestBus bus;
+        std::mt19937 rng(91);
+        std::vector<uint8_t> pollResult(6);
+        uint64_t prevHash = bus.getDevicesStateHash();
+        bool allChanged = true;
+        bool allMatch = true;
+        for (uint32_t upd = 0; upd < 1000; upd++)
+        {
+            for (auto& b : pollResult)
+                b = rng() & 0xff;
+            bus.storeResult(rng() % TestBus::NUM_DEVICES, (upd + 1) * 1000, pollResult);
+            uint64_t busHash = bus.getDevicesStateHash();
+            if (busHash == prevHash)
+                allChanged = false;
+            prevHash = busHash;
+            RaftStateHashSet fullSet;
+            for (uint32_t i = 0; i < TestBus::NUM_DEVICES; i++)
+                fullSet.add(RaftStateHashSet::elemHash(i, RaftStateHash::combine(bus.devStatus[i].getStateHash(), 1)));
+            if (fullSet.get() != busHash)
+                allMatch = false;
+        }
+        check(allChanged, "bus hash changes on every device update");
+        check(allMatch, "bus hash matches full recompute");
+
+        // Online state changes and removal change the hash, restoring online state restores it
+        uint64_t onlineHash = bus.getDevicesStateHash();
+        bus.setOnline(3, false);
+        check(bus.getDevicesStateHash() != onlineHash, "bus hash changes when device offline");
+        bus.setOnline(3, true);
+        check(bus.getDevicesStateHash() == onlineHash, "bus hash restored when device online");
+        bus.removeDevice(5);
+        check(bus.getDevicesStateHash() != onlineHash, "bus hash changes when device removed");
+    }
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "StatusIndicator.h"
+#include "RaftArduino.h"
+
+class StatusIndicatorTest
+{
+public:
+    void loop()
+    {
+        printf("Running StatusIndicatorTest...\n");
+
+        testBlinkCodeSequence();
+        testLateService();
+        testFadeAndHeartbeat();
+        testTimeoutAndOneShot();
+        testTimerDriven();
+
+        if (_failCount > 0)
+            printf("StatusIndicatorTest FAILED %d tests\n", _failCount);
+        else
+            printf("StatusIndicatorTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  StatusIndicatorTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    struct Output
+    {
+        uint64_t timeMs;
+        uint8_t startLevel;
+        uint8_t endLevel;
+        uint32_t rampMs;
+    };
+
+    // Player with outputs recorded against a simulated time
+    struct RecordingPlayer
+    {
+        StatusIndicatorPlayer player;
+        std::vector<Output> outputs;
+        uint64_t nowMs = 0;
+        RecordingPlayer()
+        {
+            player.setOutputCB([this](uint8_t startLevel, uint8_t endLevel, uint32_t rampMs) {
+                outputs.push_back({nowMs, startLevel, endLevel, rampMs});
+            });
+        }
+        uint32_t serviceAt(uint64_t timeMs)
+        {
+            nowMs = timeMs;
+            return player.service(timeMs);
+        }
+        // Service exactly when requested until endMs
+        void runUntil(uint64_t endMs)
+        {
+            while (true)
+            {
+                uint32_t untilNextMs = serviceAt(nowMs);
+                if ((untilNextMs == StatusIndicatorPlayer::NO_NEXT_CHANGE) || (nowMs + untilNextMs > endMs))
+                    break;
+                nowMs += untilNextMs;
+            }
+        }
+    };
+
+    void testBlinkCodeSequence()
+    {
+        StatusIndicatorPattern pattern = StatusIndicatorPattern::blinkCode(3, 100, 200, 500);
+        check((pattern.steps.size() == 6) && (pattern.getDurationMs() == 1200), "blink code steps");
+
+        RecordingPlayer rec;
+        rec.nowMs = 1000;
+        rec.player.start(pattern, 1000);
+        rec.runUntil(1000 + 1300);
+        const uint64_t expTimes[] = {0, 100, 300, 400, 600, 700, 1200, 1300};
+        const uint8_t expLevels[] = {255, 0, 255, 0, 255, 0, 255, 0};
+        check(rec.outputs.size() == 8, "blink code outputs");
+        for (uint32_t i = 0; (i < rec.outputs.size()) && (i < 8); i++)
+        {
+            check(rec.outputs[i].timeMs - 1000 == expTimes[i], "blink code output time");
+            check((rec.outputs[i].endLevel == expLevels[i]) && (rec.outputs[i].rampMs == 0), "blink code output level");
+        }
+
+        // Code 0 is off
+        RecordingPlayer recOff;
+        recOff.player.start(StatusIndicatorPattern::blinkCode(0, 100, 200, 500), 0);
+        check(!recOff.player.isActive() && (recOff.outputs.size() == 1) && (recOff.outputs[0].endLevel == 0), "code 0 off");
+    }
+
+    void testLateService()
+    {
+        // Steps stay aligned to the start time when service is late
+        RecordingPlayer rec;
+        rec.player.start(StatusIndicatorPattern::blinkCode(3, 100, 200, 500), 0);
+        check(rec.serviceAt(0) == 100, "first change due");
+        check(rec.serviceAt(350) == 50, "late service keeps schedule");
+        check((rec.outputs.size() == 2) && (rec.outputs[1].endLevel == 255), "late service outputs current step");
+        check(rec.serviceAt(360) == 40, "no change within step");
+        check(rec.outputs.size() == 2, "no repeated output within step");
+        check(rec.serviceAt(1300) == 200, "step in next cycle");
+        check(rec.outputs.size() == 3 && (rec.outputs[2].endLevel == 0), "next cycle output");
+    }
+
+    void testFadeAndHeartbeat()
+    {
+        RecordingPlayer rec;
+        rec.player.start(StatusIndicatorPattern::fade(1000), 0);
+        check(rec.serviceAt(0) == 500, "fade up step");
+        check((rec.outputs.size() == 1) && (rec.outputs[0].startLevel == 0) && (rec.outputs[0].endLevel == 255) &&
+                    (rec.outputs[0].rampMs == 500), "fade up ramp");
+
+        // Entering a ramp late starts from the interpolated level
+        check(rec.serviceAt(750) == 250, "fade down step");
+        check((rec.outputs.size() == 2) && (rec.outputs[1].startLevel == 128) && (rec.outputs[1].endLevel == 0) &&
+                    (rec.outputs[1].rampMs == 250), "fade down ramp entered late");
+
+        StatusIndicatorPattern heartbeat = StatusIndicatorPattern::heartbeat(1000);
+        check((heartbeat.steps.size() == 4) && (heartbeat.getDurationMs() == 1000), "heartbeat period");
+        RecordingPlayer recHB;
+        recHB.player.start(heartbeat, 0);
+        recHB.runUntil(1999);
+        check(recHB.outputs.size() == 8, "heartbeat two pulses per period");
+    }
+
+    void testTimeoutAndOneShot()
+    {
+        RecordingPlayer rec;
+        rec.player.start(StatusIndicatorPattern::blinkCode(1, 100, 100, 300), 0, 250);
+        check(rec.serviceAt(200) == 50, "next change limited by timeout");
+        check(rec.serviceAt(250) == StatusIndicatorPlayer::NO_NEXT_CHANGE, "timed out");
+        check(!rec.player.isActive() && (rec.outputs.back().endLevel == 0), "off after timeout");
+
+        StatusIndicatorPattern oneShot;
+        oneShot.add(50, 255, 255);
+        oneShot.repeat = false;
+        RecordingPlayer recOneShot;
+        recOneShot.player.start(oneShot, 0);
+        check(recOneShot.serviceAt(0) == 50, "one shot on");
+        check(recOneShot.serviceAt(50) == StatusIndicatorPlayer::NO_NEXT_CHANGE, "one shot ends");
+        check((recOneShot.outputs.size() == 2) && (recOneShot.outputs[1].endLevel == 0), "one shot off at end");
+    }
+
+    // Blink code 2 played with loop() never called - returns the max change time error logged by the simulated GPIO
+    int64_t timerDrivenMaxErrUs(uint32_t& numChanges, bool& levelsOk)
+    {
+        static const int LED_PIN = 12;
+        static const uint32_t ON_MS = 20, SHORT_OFF_MS = 30, LONG_OFF_MS = 80;
+        static const uint32_t MAX_CHANGES = 64;
+
+        // Start with the LED off as a previous run may have ended with it on
+        pinMode(LED_PIN, OUTPUT);
+        digitalWrite(LED_PIN, LOW);
+        gpioSimSetChangeLogLen(MAX_CHANGES);
+        {
+            StatusIndicator indicator;
+            indicator.setup("test", LED_PIN, true, ON_MS, SHORT_OFF_MS, LONG_OFF_MS);
+            indicator.setStatusCode(2);
+            delay(470);
+        }
+        GPIOSimChange changes[MAX_CHANGES];
+        numChanges = gpioSimGetChangeLog(changes, MAX_CHANGES);
+        gpioSimSetChangeLogLen(0);
+
+        // Expected change times relative to the first on
+        const uint32_t stepMs[] = {ON_MS, SHORT_OFF_MS, ON_MS, LONG_OFF_MS};
+        levelsOk = numChanges > 0;
+        uint64_t expectedMs = 0;
+        int64_t maxErrUs = 0;
+        for (uint32_t i = 0; i < numChanges; i++)
+        {
+            if ((changes[i].pin != LED_PIN) || (changes[i].level != (i % 2 == 0 ? HIGH : LOW)))
+                levelsOk = false;
+            int64_t errUs = (int64_t)(changes[i].timeUs - changes[0].timeUs) - (int64_t)expectedMs * 1000;
+            if (llabs(errUs) > maxErrUs)
+                maxErrUs = llabs(errUs);
+            expectedMs += stepMs[i % 4];
+        }
+        return maxErrUs;
+    }
+
+    void testTimerDriven()
+    {
+        // Best of several runs as scheduling on a busy host can delay the timer thread
+        int64_t bestErrUs = INT64_MAX;
+        uint32_t numChanges = 0;
+        for (int run = 0; run < 3; run++)
+        {
+            bool levelsOk = false;
+            int64_t maxErrUs = timerDrivenMaxErrUs(numChanges, levelsOk);
+            check(levelsOk && (numChanges >= 12), "timer driven changes alternate");
+            if (maxErrUs < bestErrUs)
+                bestErrUs = maxErrUs;
+            if (bestErrUs < 5000)
+                break;
+        }
+        printf("  Timer driven blink code: %u changes, max timing error %lldus\n", (unsigned)numChanges, (long long)bestErrUs);
+        check(bestErrUs < 5000, "timer driven timing");
+    }
+};
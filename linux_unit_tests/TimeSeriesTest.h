@@ -0,0 +1,178 @@
+#pragma once
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include "RaftTimeSeries.h"
+
+class TimeSeriesTest
+{
+public:
+    void loop()
+    {
+        printf("Running TimeSeriesTest...\n");
+
+        testRoundTrip();
+        testEviction();
+        testBuckets();
+        benchmark();
+
+        if (_failCount > 0)
+            printf("TimeSeriesTest FAILED %d tests\n", _failCount);
+        else
+            printf("TimeSeriesTest all tests passed\n");
+    }
+
+private:
+    int _failCount = 0;
+
+    void check(bool cond, const char* msg)
+    {
+        if (!cond)
+        {
+            printf("  TimeSeriesTest failed: %s\n", msg);
+            _failCount++;
+        }
+    }
+
+    // Generate a sensor-like sample stream (regular interval with jitter, slowly varying value)
+    static void genSamples(uint32_t numSamples, std::vector<std::pair<uint64_t, double>>& samples, uint32_t seed = 42)
+    {
+        std::mt19937 rng(seed);
+        samples.clear();
+        uint64_t timeUs = 1000000;
+        for (uint32_t i = 0; i < numSamples; i++)
+        {
+            timeUs += 10000 + (rng() % 200) - 100;
+            double value = round(sin(i / 100.0) * 1000) / 100;
+            if (i % 50 == 0)
+                value = (double)(rng() % 100000) / 7.0;
+            samples.push_back({timeUs, value});
+        }
+    }
+
+    void testRoundTrip()
+    {
+        std::vector<std::pair<uint64_t, double>> samples;
+        genSamples(5000, samples);
+        RaftTimeSeries series(1000000, 256);
+        for (auto& s : samples)
+            series.add(s.first, s.second);
+        check(series.count() == samples.size(), "roundtrip count");
+
+        uint32_t idx = 0;
+        bool allMatch = true;
+        series.query(0, UINT64_MAX, [&](uint64_t timeUs, double value) {
+            if ((idx >= samples.size()) || (samples[idx].first != timeUs) || (samples[idx].second != value))
+                allMatch = false;
+            idx++;
+            return true;
+        });
+        check(allMatch && (idx == samples.size()), "roundtrip exact values");
+
+        // Range query
+        uint64_t startUs = samples[1000].first;
+        uint64_t endUs = samples[1999].first;
+        uint32_t numInRange = series.query(startUs, endUs, [](uint64_t, double) { return true; });
+        check(numInRange == 1000, "range query count");
+
+        // Timestamps must not go backwards
+        check(!series.add(samples[10].first, 1.0), "reject out of order sample");
+
+        // Large gaps and special values
+        RaftTimeSeries special;
+        check(special.add(0, 0.0), "add zero");
+        check(special.add(5000000000ULL, NAN), "add NaN after large gap");
+        check(special.add(5000000001ULL, -INFINITY), "add -inf");
+        check(special.add(5000000001ULL, 1e300), "add same time");
+        std::vector<double> vals;
+        special.query(0, UINT64_MAX, [&](uint64_t, double v) { vals.push_back(v); return true; });
+        check(vals.size() == 4 && std::isnan(vals[1]) && std::isinf(vals[2]) && vals[3] == 1e300, "special values");
+    }
+
+    void testEviction()
+    {
+        std::vector<std::pair<uint64_t, double>> samples;
+        genSamples(20000, samples);
+        RaftTimeSeries series(2048, 256);
+        for (auto& s : samples)
+            series.add(s.first, s.second);
+        check(series.getBytesUsed() <= 2048, "eviction keeps memory within limit");
+        check(series.getLastTimeUs() == samples.back().first, "eviction keeps newest");
+        check(series.getFirstTimeUs() > samples.front().first, "eviction discards oldest");
+        uint32_t numDecoded = series.query(0, UINT64_MAX, [](uint64_t, double) { return true; });
+        check(numDecoded == series.count(), "eviction count matches");
+    }
+
+    void testBuckets()
+    {
+        std::vector<std::pair<uint64_t, double>> samples;
+        genSamples(10000, samples);
+        RaftTimeSeries series(1000000, 256);
+        for (auto& s : samples)
+            series.add(s.first, s.second);
+
+        // Compare with brute force
+        uint64_t startUs = samples[123].first;
+        uint64_t endUs = samples[8765].first;
+        uint64_t bucketUs = 1000000;
+        std::vector<RaftTimeSeries::Bucket> buckets;
+        series.queryBuckets(startUs, endUs, bucketUs, buckets);
+        bool allMatch = true;
+        uint32_t totalCount = 0;
+        for (auto& bucket : buckets)
+        {
+            uint32_t count = 0;
+            double minVal = INFINITY, maxVal = -INFINITY, sumVal = 0;
+            for (auto& s : samples)
+            {
+                if ((s.first < bucket.startTimeUs) || (s.first >= bucket.startTimeUs + bucketUs) || (s.first > endUs))
+                    continue;
+                count++;
+                minVal = fmin(minVal, s.second);
+                maxVal = fmax(maxVal, s.second);
+                sumVal += s.second;
+            }
+            if ((count != bucket.count) || (minVal != bucket.minVal) || (maxVal != bucket.maxVal) ||
+                        (fabs(sumVal / count - bucket.getMean()) > 1e-6))
+                allMatch = false;
+            totalCount += bucket.count;
+        }
+        check(allMatch, "buckets match brute force");
+        check(totalCount == 8765 - 123 + 1, "buckets total count");
+
+        // Max buckets limit
+        series.queryBuckets(0, UINT64_MAX, 1, buckets, 50);
+        check(buckets.size() <= 50, "max buckets respected");
+    }
+
+    void benchmark()
+    {
+        static const uint32_t NUM_SAMPLES = 200000;
+        std::vector<std::pair<uint64_t, double>> samples;
+        genSamples(NUM_SAMPLES, samples);
+        RaftTimeSeries series(16 * 1024 * 1024, 1024);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (auto& s : samples)
+            series.add(s.first, s.second);
+        auto t1 = std::chrono::steady_clock::now();
+        double ingestUs = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+        uint32_t numQueries = 1000;
+        std::vector<RaftTimeSeries::Bucket> buckets;
+        t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < numQueries; i++)
+        {
+            uint64_t startUs = samples[(i * 97) % (NUM_SAMPLES / 2)].first;
+            series.queryBuckets(startUs, startUs + 60000000, 1000000, buckets);
+        }
+        t1 = std::chrono::steady_clock::now();
+        double queryUs = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+        printf("  TimeSeries bench: ingest %.2f Msamples/s, %.2f bytes/sample (raw 16), 60s/1s-bucket query %.1f us\n",
+                NUM_SAMPLES / ingestUs, (double)series.getBytesUsed() / series.count(), queryUs / numQueries);
+        check(series.getBytesUsed() < NUM_SAMPLES * 16, "compression reduces size");
+    }
+};
@@ -0,0 +1,728 @@
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Linux benchmarks
+// Hot-path performance benchmarks with machine-readable (JSON) output
+//
+// Usage: linux_benchmarks [output.json]
+//
+// Rob Dobson 2025
+//
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "PerfBench.h"
+#include "RaftJson.h"
+#include "RaftUtils.h"
+#include "MiniHDLC.h"
+#include "RICRESTMsg.h"
+#include "CommsChannelMsg.h"
+#include "ExpressionEval.h"
+#include "RingBufferSPSC.h"
+#include "DeviceStatus.h"
+#include "RaftProfileZones.h"
+#include "RaftJsonNumbers.h"
+#include "FileSystem.h"
+#include "FileLineReader.h"
+#include "RestAPIRespSink.h"
+#include "RaftJsonChunkedDoc.h"
+#include "RaftThreading.h"
+#include "JSON_test_data_large.h"
+
+// Prevent the optimiser removing benchmarked work
+static volatile uint64_t benchSink = 0;
+static inline void benchConsume(uint64_t val)
+{
+    benchSink = benchSink + val;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// RaftJson
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchRaftJson(PerfBenchResults& results)
+{
+    static const uint32_t NUM_LOOPS = 2000;
+    const char* pJsonEnd = JSON_test_data_large + strlen(JSON_test_data_large);
+
+    // Immediate access to deep paths in a large document
+    PERF_BENCH_START(jsonGetLongIm);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        benchConsume(RaftJson::getLongIm(JSON_test_data_large, pJsonEnd, "[0]/Robot/WorkMgr/WorkQ/maxLen[0]/__value__", 0));
+        benchConsume(RaftJson::getLongIm(JSON_test_data_large, pJsonEnd, "[0]/SysManager/monitorPeriodMs", 0));
+        benchConsume(RaftJson::getLongIm(JSON_test_data_large, pJsonEnd, "[0]/Robot/Safeties/maxMs", 0));
+    }
+    PERF_BENCH_END(jsonGetLongIm, results, "RaftJson/getLongIm_large_x3", NUM_LOOPS);
+
+    // Object access including string results
+    RaftJson jsonObj(JSON_test_data_large, false);
+    PERF_BENCH_START(jsonGetString);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+        benchConsume(jsonObj.getString("[0]/SysManager/monitorPeriodMs", "").length());
+    PERF_BENCH_END(jsonGetString, results, "RaftJson/getString_large", NUM_LOOPS);
+
+    // Small document built from name-value pairs (as used by REST API parameter handling)
+    std::vector<RaftJson::NameValuePair> nameValues = {{"device", "motor"}, {"cmd", "pos"}, {"ch", "3"}, {"val", "1234"}};
+    PERF_BENCH_START(jsonNVPairs);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        RaftJson jsonParams = RaftJson::getJSONFromNVPairs(nameValues, true);
+        benchConsume(jsonParams.getInt("val", 0));
+    }
+    PERF_BENCH_END(jsonNVPairs, results, "RaftJson/fromNVPairs_getInt", NUM_LOOPS);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// MiniHDLC
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchMiniHDLC(PerfBenchResults& results)
+{
+    static const uint32_t NUM_LOOPS = 20000;
+    uint32_t rxFrameCount = 0;
+    MiniHDLC hdlc(nullptr, [&rxFrameCount](const uint8_t* pFrame, unsigned frameLen) { rxFrameCount++; });
+
+    // Frame containing values which need escaping
+    uint8_t frame[200];
+    for (uint32_t i = 0; i < sizeof(frame); i++)
+        frame[i] = (i * 37) & 0xff;
+    std::vector<uint8_t> encoded(hdlc.maxEncodedLen(sizeof(frame)));
+
+    // Encode
+    uint32_t encodedLen = 0;
+    PERF_BENCH_START(hdlcEncode);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+        encodedLen = hdlc.encodeFrame(encoded.data(), encoded.size(), frame, sizeof(frame));
+    PERF_BENCH_END(hdlcEncode, results, "MiniHDLC/encode_200B", NUM_LOOPS);
+
+    // Decode
+    PERF_BENCH_START(hdlcDecode);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+        hdlc.handleBuffer(encoded.data(), encodedLen);
+    PERF_BENCH_END(hdlcDecode, results, "MiniHDLC/decode_200B", NUM_LOOPS);
+    benchConsume(rxFrameCount);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// RICREST
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchRICREST(PerfBenchResults& results)
+{
+    static const uint32_t NUM_LOOPS = 20000;
+
+    // Decode URL message
+    CommsChannelMsg urlMsg;
+    RICRESTMsg::encode("devman/cmdjson?body={\"device\":\"motor\",\"cmd\":\"pos\",\"val\":1234}", urlMsg,
+                RICRESTMsg::RICREST_ELEM_CODE_URL);
+    PERF_BENCH_START(ricrestDecodeURL);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        RICRESTMsg ricRESTReqMsg;
+        ricRESTReqMsg.decode(urlMsg.getBuf(), urlMsg.getBufLen());
+        benchConsume(ricRESTReqMsg.getReq().length());
+    }
+    PERF_BENCH_END(ricrestDecodeURL, results, "RICREST/decode_url", NUM_LOOPS);
+
+    // Encode response
+    String respStr;
+    Raft::setJsonBoolResult("devman/cmdjson", respStr, true);
+    PERF_BENCH_START(ricrestEncodeResp);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        CommsChannelMsg respMsg;
+        RICRESTMsg::encode(respStr, respMsg, RICRESTMsg::RICREST_ELEM_CODE_CMDRESPJSON);
+        benchConsume(respMsg.getBufLen());
+    }
+    PERF_BENCH_END(ricrestEncodeResp, results, "RICREST/encode_cmdrespjson", NUM_LOOPS);
+
+    // Decode binary device command
+    CommsChannelMsg devCmdMsg;
+    uint8_t payload[] = {1, 0, 0, 4, 210};
+    RICRESTMsg::encodeDeviceCmdBinary(0, 0x1234, 7, payload, sizeof(payload), devCmdMsg);
+    PERF_BENCH_START(ricrestDecodeDevCmd);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        uint32_t busNum = 0, address = 0, formatCode = 0, payloadLen = 0;
+        const uint8_t* pPayload = nullptr;
+        RICRESTMsg::decodeDeviceCmdBinary(devCmdMsg.getBuf(), devCmdMsg.getBufLen(), busNum, address, formatCode, pPayload, payloadLen);
+        benchConsume(address + payloadLen);
+    }
+    PERF_BENCH_END(ricrestDecodeDevCmd, results, "RICREST/decode_device_cmd_binary", NUM_LOOPS);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ExpressionEval
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchExpressionEval(PerfBenchResults& results)
+{
+    static const uint32_t NUM_LOOPS = 5000;
+    ExpressionEval evaluator;
+    evaluator.addVariables(R"({"moveTimeMin":400,"moveTime":1500,"stepLength":50,"leanAmount":30})", false);
+    uint32_t errorLine = 0;
+    evaluator.addExpressions("a = max(moveTimeMin, moveTime) * 2\n"
+                "b = stepLength * sin(leanAmount / 57.3) + a\n"
+                "c = (a + b) / 3", errorLine);
+    PERF_BENCH_START(exprEval);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+        evaluator.evalStatements("{}");
+    PERF_BENCH_END(exprEval, results, "ExpressionEval/eval_3_statements", NUM_LOOPS);
+    bool isValid = false;
+    benchConsume((uint64_t)evaluator.getVal("c", isValid));
+
+    // Large statement set (each statement reads two of 50 inputs) with 2 inputs changing per tick
+    static const uint32_t NUM_INPUTS = 50;
+    static const uint32_t NUM_STATEMENTS = 100;
+    String inputsJson = "{";
+    for (uint32_t i = 0; i < NUM_INPUTS; i++)
+        inputsJson += (i == 0 ? "\"in" : ",\"in") + String(i) + "\":" + String(i);
+    inputsJson += "}";
+    String statements;
+    for (uint32_t i = 0; i < NUM_STATEMENTS; i++)
+        statements += "out" + String(i) + " = sin(in" + String(i % NUM_INPUTS) + ") * in" + 
+                    String((i * 7 + 3) % NUM_INPUTS) + " + " + String(i) + "\n";
+    static const char* benchNames[] = { "ExpressionEval/eval_100_statements_full", "ExpressionEval/eval_100_statements_incremental" };
+    for (uint32_t mode = 0; mode < 2; mode++)
+    {
+        ExpressionEval largeEval;
+        largeEval.setIncrementalEval(mode == 1);
+        largeEval.addVariables(inputsJson.c_str(), false);
+        largeEval.addExpressions(statements.c_str(), errorLine);
+        largeEval.evalStatements(nullptr);
+        PERF_BENCH_START(exprLarge);
+        for (uint32_t i = 0; i < NUM_LOOPS; i++)
+        {
+            largeEval.addVariable("in3", i);
+            largeEval.addVariable("in17", i * 2);
+            largeEval.evalStatements(nullptr);
+        }
+        PERF_BENCH_END(exprLarge, results, benchNames[mode], NUM_LOOPS);
+        benchConsume((uint64_t)largeEval.getVal("out3", isValid));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Ring buffers
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchRingBuffer(PerfBenchResults& results)
+{
+    static const uint32_t NUM_LOOPS = 100000;
+    RingBufferSPSC<std::vector<uint8_t>, 32> ringBuffer;
+    std::vector<uint8_t> putElem(32, 0x55);
+    std::vector<uint8_t> getElem;
+    PERF_BENCH_START(ringPutGet);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        ringBuffer.put(putElem);
+        ringBuffer.get(getElem);
+        benchConsume(getElem.size());
+    }
+    PERF_BENCH_END(ringPutGet, results, "RingBufferSPSC/put_get_32B", NUM_LOOPS);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Device poll result store and decode
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Aggregator keeping the most recent results (equivalent to a bus's circular buffer aggregator)
+class BenchAggregator : public PollDataAggregatorIF
+{
+public:
+    BenchAggregator(uint32_t numResults) : _results(numResults) {}
+    virtual void clear() override { _count = 0; }
+    virtual bool put(uint64_t timeNowUs, const std::vector<uint8_t>& data) override
+    {
+        _results[_putPos] = data;
+        _putPos = (_putPos + 1) % _results.size();
+        if (_count < _results.size())
+            _count++;
+        return true;
+    }
+    virtual bool get(std::vector<uint8_t>& data) override { return false; }
+    virtual uint32_t get(std::vector<uint8_t>& data, uint32_t& responseSize, uint32_t maxResponsesToReturn) override
+    {
+        data.clear();
+        responseSize = _count > 0 ? _results[0].size() : 0;
+        uint32_t getPos = (_putPos + _results.size() - _count) % _results.size();
+        for (uint32_t i = 0; i < _count; i++)
+        {
+            data.insert(data.end(), _results[getPos].begin(), _results[getPos].end());
+            getPos = (getPos + 1) % _results.size();
+        }
+        uint32_t numResults = _count;
+        _count = 0;
+        return numResults;
+    }
+    virtual uint32_t count() const override { return _count; }
+    virtual bool getLatestValue(uint64_t& dataTimeUs, std::vector<uint8_t>& data) override { return false; }
+    virtual bool resize(uint32_t numResultsToStore) override { return false; }
+private:
+    std::vector<std::vector<uint8_t>> _results;
+    uint32_t _putPos = 0;
+    uint32_t _count = 0;
+};
+
+static void benchDeviceDecode(PerfBenchResults& results)
+{
+    static const uint32_t NUM_LOOPS = 50000;
+    static const uint32_t RESULTS_PER_READ = 10;
+    DeviceStatus devStatus;
+    devStatus.setAndOwnPollDataAggregator(std::make_shared<BenchAggregator>(RESULTS_PER_READ));
+
+    // Poll result: timestamp + 3 x int16 (e.g. accelerometer)
+    std::vector<uint8_t> pollResult = {0, 0, 0x01, 0x02, 0xff, 0xfe, 0x10, 0x20};
+    std::vector<uint8_t> respData;
+    uint32_t responseSize = 0;
+    PERF_BENCH_START(devStoreDecode);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        // Store result
+        devStatus.storePollResults(0, 1000000 + i * 1000, pollResult, nullptr, 0);
+
+        // Periodically read and decode the stored results
+        if ((i % RESULTS_PER_READ) != RESULTS_PER_READ - 1)
+            continue;
+        uint32_t numResults = devStatus.getPollResponses(respData, responseSize, 0);
+        const uint8_t* pData = respData.data();
+        const uint8_t* pEnd = pData + respData.size();
+        for (uint32_t resIdx = 0; resIdx < numResults; resIdx++)
+        {
+            benchConsume(Raft::getBEUInt16AndInc(pData, pEnd));
+            for (uint32_t valIdx = 0; valIdx < 3; valIdx++)
+                benchConsume((int16_t)Raft::getBEUInt16AndInc(pData, pEnd));
+        }
+    }
+    PERF_BENCH_END(devStoreDecode, results, "DeviceStatus/store_and_decode_poll", NUM_LOOPS);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Profiling zones
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchProfileZone(PerfBenchResults& results)
+{
+    static const uint32_t NUM_LOOPS = 1000000;
+    PERF_BENCH_START(profZone);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        RAFT_PROFILE_ZONE("bench");
+        benchConsume(i);
+    }
+    PERF_BENCH_END(profZone, results, "RaftProfileZones/empty_zone", NUM_LOOPS);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// JSON numbers
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchJsonNumbers(PerfBenchResults& results)
+{
+    static const uint32_t NUM_LOOPS = 100000;
+    static const char* testNums[] = { "23.45", "-0.0125", "1013.25", "65535", "3.14159265358979", "1.5e-3", "-40", "0.1" };
+    static const uint32_t NUM_TEST_NUMS = sizeof(testNums) / sizeof(testNums[0]);
+
+    // Parse with strtod (baseline)
+    PERF_BENCH_START(numStrtod);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+        benchConsume((uint64_t)strtod(testNums[i % NUM_TEST_NUMS], NULL));
+    PERF_BENCH_END(numStrtod, results, "JsonNumbers/parse_strtod", NUM_LOOPS);
+
+    // Parse fast path
+    PERF_BENCH_START(numParse);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+        benchConsume((uint64_t)RaftJsonNumbers::parseDouble(testNums[i % NUM_TEST_NUMS]));
+    PERF_BENCH_END(numParse, results, "JsonNumbers/parse_fast", NUM_LOOPS);
+
+    // Format with snprintf (baseline)
+    double testVals[NUM_TEST_NUMS];
+    for (uint32_t i = 0; i < NUM_TEST_NUMS; i++)
+        testVals[i] = strtod(testNums[i], NULL);
+    char buf[RaftJsonNumbers::FORMAT_BUF_MIN_LEN];
+    PERF_BENCH_START(numSnprintf);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+        benchConsume(snprintf(buf, sizeof(buf), "%.17g", testVals[i % NUM_TEST_NUMS]));
+    PERF_BENCH_END(numSnprintf, results, "JsonNumbers/format_snprintf_17g", NUM_LOOPS);
+
+    // Format round-trip
+    PERF_BENCH_START(numFormat);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+        benchConsume(RaftJsonNumbers::formatDouble(testVals[i % NUM_TEST_NUMS], buf));
+    PERF_BENCH_END(numFormat, results, "JsonNumbers/format_shortest", NUM_LOOPS);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// File line reading
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchFileLines(PerfBenchResults& results)
+{
+    static const uint32_t NUM_LINES = 20000;
+    static const char* TEST_FILE_NAME = "/tmp/raft_bench_lines.csv";
+    fileSystem.setup(FileSystem::LOCAL_FS_SPIFFS, false, false, -1, -1, -1, -1, false, false);
+    String contents;
+    for (uint32_t i = 0; i < NUM_LINES; i++)
+        contents += String(i) + "," + String(i * 37 % 1000) + ",23.45,-0.0125,1013.25\n";
+    fileSystem.setFileContents("local", TEST_FILE_NAME, contents);
+    char lineBuf[100];
+
+    // Line by line using getFileLine (open/seek/close per line)
+    uint32_t filePos = 0;
+    PERF_BENCH_START(fileGetLine);
+    for (uint32_t i = 0; i < NUM_LINES; i++)
+    {
+        fileSystem.getFileLine("local", TEST_FILE_NAME, filePos, (uint8_t*)lineBuf, sizeof(lineBuf), filePos);
+        benchConsume(lineBuf[0]);
+    }
+    PERF_BENCH_END(fileGetLine, results, "FileLines/getFileLine_20k", NUM_LINES);
+
+    // Buffered reader
+    PERF_BENCH_START(fileLineReader);
+    {
+        FileLineReader reader;
+        reader.open("local", TEST_FILE_NAME);
+        for (uint32_t i = 0; i < NUM_LINES; i++)
+        {
+            reader.readLine((uint8_t*)lineBuf, sizeof(lineBuf));
+            benchConsume(lineBuf[0]);
+        }
+    }
+    PERF_BENCH_END(fileLineReader, results, "FileLines/lineReader_20k", NUM_LINES);
+
+    // Random access to lines using the line index
+    static const uint32_t NUM_RANDOM_LINES = 2000;
+    FileLineReader reader;
+    reader.open("local", TEST_FILE_NAME);
+    PERF_BENCH_START(fileLineIndex);
+    reader.buildLineIndex();
+    PERF_BENCH_END(fileLineIndex, results, "FileLines/buildLineIndex_20k", 1);
+    PERF_BENCH_START(fileLineRandom);
+    for (uint32_t i = 0; i < NUM_RANDOM_LINES; i++)
+    {
+        reader.seekToLine((i * 7919) % NUM_LINES);
+        reader.readLine((uint8_t*)lineBuf, sizeof(lineBuf));
+        benchConsume(lineBuf[0]);
+    }
+    PERF_BENCH_END(fileLineRandom, results, "FileLines/seekToLine_random", NUM_RANDOM_LINES);
+    reader.close();
+    fileSystem.deleteFile("local", TEST_FILE_NAME);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// REST API responses
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchRestResp(PerfBenchResults& results)
+{
+    // File listing (the largest standard response)
+    static const uint32_t NUM_FILES = 200;
+    static const uint32_t NUM_LISTINGS = 200;
+    fileSystem.setup(FileSystem::LOCAL_FS_SPIFFS, false, false, -1, -1, -1, -1, false, false);
+    String folder = "rbench_files";
+    String folderPath = "/tmp/sandbot_local/" + folder;
+    mkdir("/tmp/sandbot_local", 0777);
+    mkdir(folderPath.c_str(), 0777);
+    for (uint32_t i = 0; i < NUM_FILES; i++)
+    {
+        String contents = "file contents " + String(i);
+        fileSystem.setFileContents("local", folderPath + "/datafile_" + String(i) + ".csv", contents);
+    }
+    String respStr;
+    PERF_BENCH_START(restFileList);
+    for (uint32_t i = 0; i < NUM_LISTINGS; i++)
+    {
+        fileSystem.getFilesJSON("files", "local", folder, respStr);
+        benchConsume(respStr.length());
+    }
+    if (respStr.indexOf("datafile_199.csv") < 0)
+        printf("  RestResp getFilesJSON missing files %s\n", respStr.substring(0, 100).c_str());
+    PERF_BENCH_END(restFileList, results, "RestResp/getFilesJSON_200files", NUM_LISTINGS);
+    for (uint32_t i = 0; i < NUM_FILES; i++)
+        fileSystem.deleteFile("local", folderPath + "/datafile_" + String(i) + ".csv");
+    rmdir(folderPath.c_str());
+
+    // Device status list built by String concatenation vs the response sink
+    static const uint32_t NUM_DEVS = 100;
+    static const uint32_t NUM_RESPS = 1000;
+    PERF_BENCH_START(restConcat);
+    for (uint32_t i = 0; i < NUM_RESPS; i++)
+    {
+        String devsStr;
+        for (uint32_t devIdx = 0; devIdx < NUM_DEVS; devIdx++)
+        {
+            devsStr += (devIdx == 0 ? "{\"name\":\"" : ",{\"name\":\"") + String("Device") + String(devIdx) +
+                        "\",\"online\":" + String(devIdx % 2) + ",\"type\":" + String(devIdx * 3) + "}";
+        }
+        respStr = "{\"req\":\"devman/status\",\"devs\":[" + devsStr + "],\"rslt\":\"ok\"}";
+        benchConsume(respStr.length());
+    }
+    PERF_BENCH_END(restConcat, results, "RestResp/concat_100devs", NUM_RESPS);
+    String concatResp = respStr;
+    PERF_BENCH_START(restSink);
+    for (uint32_t i = 0; i < NUM_RESPS; i++)
+    {
+        RestAPIRespSink sink(respStr, 4096);
+        sink.startResponse("devman/status");
+        sink.arrStart("devs");
+        char nameStr[20];
+        for (uint32_t devIdx = 0; devIdx < NUM_DEVS; devIdx++)
+        {
+            sink.objStart();
+            snprintf(nameStr, sizeof(nameStr), "Device%u", (unsigned)devIdx);
+            sink.addStr("name", nameStr);
+            sink.addInt("online", devIdx % 2);
+            sink.addInt("type", devIdx * 3);
+            sink.objEnd();
+        }
+        sink.arrEnd();
+        sink.endResponse(true);
+        benchConsume(respStr.length());
+    }
+    PERF_BENCH_END(restSink, results, "RestResp/sink_100devs", NUM_RESPS);
+    if (respStr != concatResp)
+        printf("  RestResp sink output differs from concatenation\n");
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Settings upload (chunked POST of a settings document)
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchSettingsUpload(PerfBenchResults& results)
+{
+    // Settings document (~12KB) posted in 1KB chunks over an existing document of the same size
+    static const uint32_t CHUNK_LEN = 1024;
+    static const uint32_t NUM_UPLOADS = 200;
+    String doc = "{";
+    for (int i = 0; i < 300; i++)
+        doc += (i > 0 ? ",\"setting" : "\"setting") + String(i) + "\":{\"val\":" + String(i * 7) + ",\"name\":\"name" + String(i) + "\"}";
+    doc += "}";
+    const uint8_t* pDoc = (const uint8_t*)doc.c_str();
+    uint32_t total = doc.length();
+
+    // Accumulate into a growing buffer then copy into the config (the previous approach)
+    RaftJson config(doc);
+    std::vector<char> postBuf;
+    int64_t bufferedPeak = 0;
+    PERF_BENCH_START(uploadBuffered);
+    for (uint32_t i = 0; i < NUM_UPLOADS; i++)
+    {
+        std::vector<char>().swap(postBuf);
+        PerfAllocStats::resetPeak();
+        int64_t baseline = PerfAllocStats::bytesInUse;
+        for (uint32_t index = 0; index < total; index += CHUNK_LEN)
+        {
+            uint32_t len = index + CHUNK_LEN > total ? total - index : CHUNK_LEN;
+            postBuf.insert(postBuf.end(), pDoc + index, pDoc + index + len);
+        }
+        postBuf.push_back(0);
+        config.setJsonDoc(postBuf.data());
+        postBuf.clear();
+        bufferedPeak = PerfAllocStats::peakBytesInUse - baseline;
+    }
+    PERF_BENCH_END(uploadBuffered, results, "SettingsUpload/buffered_12KB", NUM_UPLOADS);
+
+    // Validate chunks as they arrive into a buffer allocated once and hand it over without copying
+    RaftJsonChunkedDoc chunkedDoc;
+    int64_t streamedPeak = 0;
+    PERF_BENCH_START(uploadStreamed);
+    for (uint32_t i = 0; i < NUM_UPLOADS; i++)
+    {
+        PerfAllocStats::resetPeak();
+        int64_t baseline = PerfAllocStats::bytesInUse;
+        for (uint32_t index = 0; index < total; index += CHUNK_LEN)
+        {
+            uint32_t len = index + CHUNK_LEN > total ? total - index : CHUNK_LEN;
+            if (chunkedDoc.addChunk(pDoc + index, len, index, total) == RaftJsonChunkedDoc::CHUNK_COMPLETE)
+                config.takeJsonDoc(chunkedDoc.getDoc());
+        }
+        chunkedDoc.clear();
+        streamedPeak = PerfAllocStats::peakBytesInUse - baseline;
+    }
+    PERF_BENCH_END(uploadStreamed, results, "SettingsUpload/streamed_12KB", NUM_UPLOADS);
+    if (config.getInt("setting299/val", 0) != 299 * 7)
+        printf("  SettingsUpload document not applied\n");
+    printf("  SettingsUpload %u byte document peak heap above baseline buffered %lld streamed %lld\n",
+                (unsigned)total, (long long)bufferedPeak, (long long)streamedPeak);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Locks
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Shared state guarded by each kind of lock - reads scan a small table (like a device list) and writes
+// update one entry
+enum BenchLockType
+{
+    BENCH_LOCK_MUTEX,
+    BENCH_LOCK_RWLOCK,
+    BENCH_LOCK_ADAPTIVE
+};
+struct BenchLockState
+{
+    BenchLockType lockType = BENCH_LOCK_MUTEX;
+    uint32_t writeEvery = 0;
+    uint32_t opsPerThread = 0;
+    RaftMutex mutex;
+    RaftRWLock rwLock;
+    RaftAdaptiveMutex adaptiveMutex;
+    uint32_t table[16] = {};
+};
+
+static void benchLockThread(void* pArg)
+{
+    BenchLockState& state = *(BenchLockState*)pArg;
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < state.opsPerThread; i++)
+    {
+        bool isWrite = (state.writeEvery != 0) && (i % state.writeEvery == 0);
+        switch (state.lockType)
+        {
+            case BENCH_LOCK_MUTEX: RaftMutex_lock(state.mutex, RAFT_MUTEX_WAIT_FOREVER); break;
+            case BENCH_LOCK_RWLOCK:
+                if (isWrite)
+                    RaftRWLock_lockWrite(state.rwLock, RAFT_WAIT_FOREVER);
+                else
+                    RaftRWLock_lockRead(state.rwLock, RAFT_WAIT_FOREVER);
+                break;
+            case BENCH_LOCK_ADAPTIVE: RaftAdaptiveMutex_lock(state.adaptiveMutex, RAFT_WAIT_FOREVER); break;
+        }
+        if (isWrite)
+        {
+            state.table[i % 16]++;
+        }
+        else
+        {
+            for (uint32_t val : state.table)
+                sum += val;
+        }
+        switch (state.lockType)
+        {
+            case BENCH_LOCK_MUTEX: RaftMutex_unlock(state.mutex); break;
+            case BENCH_LOCK_RWLOCK:
+                if (isWrite)
+                    RaftRWLock_unlockWrite(state.rwLock);
+                else
+                    RaftRWLock_unlockRead(state.rwLock);
+                break;
+            case BENCH_LOCK_ADAPTIVE: RaftAdaptiveMutex_unlock(state.adaptiveMutex); break;
+        }
+    }
+    benchConsume(sum);
+}
+
+static void benchLocks(PerfBenchResults& results)
+{
+    static const uint32_t NUM_THREADS = 4;
+    static const uint32_t OPS_PER_THREAD = 200000;
+    static const char* lockNames[] = { "mutex", "rwlock", "adaptive" };
+    struct Ratio
+    {
+        const char* pName;
+        uint32_t writeEvery;
+    };
+    static const Ratio ratios[] = { { "reads", 0 }, { "1in100w", 100 }, { "1in10w", 10 }, { "1in2w", 2 } };
+    for (const Ratio& ratio : ratios)
+    {
+        for (uint32_t lockType = BENCH_LOCK_MUTEX; lockType <= BENCH_LOCK_ADAPTIVE; lockType++)
+        {
+            BenchLockState state;
+            state.lockType = (BenchLockType)lockType;
+            state.writeEvery = ratio.writeEvery;
+            state.opsPerThread = OPS_PER_THREAD;
+            RaftMutex_init(state.mutex);
+            RaftRWLock_init(state.rwLock);
+            RaftAdaptiveMutex_init(state.adaptiveMutex);
+            RaftThreadHandle threads[NUM_THREADS];
+            PERF_BENCH_START(lockOps);
+            for (RaftThreadHandle& thread : threads)
+                RaftThread_start(thread, benchLockThread, &state);
+            for (RaftThreadHandle& thread : threads)
+                pthread_join(thread, NULL);
+            String benchName = String("Locks/") + lockNames[lockType] + "_4thr_" + ratio.pName;
+            PERF_BENCH_END(lockOps, results, benchName.c_str(), NUM_THREADS * OPS_PER_THREAD);
+            RaftAdaptiveMutex_destroy(state.adaptiveMutex);
+            RaftRWLock_destroy(state.rwLock);
+            RaftMutex_destroy(state.mutex);
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// GPIO (simulated backend)
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void benchGPIO(PerfBenchResults& results)
+{
+    // Drive and sample 8 pins together, as a status display or multiplexed button scan would
+    static const uint32_t NUM_LOOPS = 100000;
+    static const uint8_t pins[] = { 12, 13, 14, 15, 16, 17, 18, 19 };
+    uint64_t pinMask = 0;
+    for (uint8_t pin : pins)
+        pinMask |= 1ULL << pin;
+    PERF_BENCH_START(gpioPerPin);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        for (uint32_t pinIdx = 0; pinIdx < sizeof(pins); pinIdx++)
+            digitalWrite(pins[pinIdx], (i >> pinIdx) & 1);
+        uint32_t levels = 0;
+        for (uint32_t pinIdx = 0; pinIdx < sizeof(pins); pinIdx++)
+            levels |= digitalRead(pins[pinIdx]) << pinIdx;
+        benchConsume(levels);
+    }
+    PERF_BENCH_END(gpioPerPin, results, "GPIO/write_read_8pins_per_pin", NUM_LOOPS);
+    PERF_BENCH_START(gpioMask);
+    for (uint32_t i = 0; i < NUM_LOOPS; i++)
+    {
+        uint64_t setMask = (uint64_t)(i & 0xff) << pins[0];
+        digitalWriteMask(setMask, pinMask & ~setMask);
+        benchConsume(digitalReadMask(pinMask) >> pins[0]);
+    }
+    PERF_BENCH_END(gpioMask, results, "GPIO/write_read_8pins_mask", NUM_LOOPS);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Main
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv)
+{
+    printf("Running benchmarks...\n");
+    PerfBenchResults results;
+    benchRaftJson(results);
+    benchMiniHDLC(results);
+    benchRICREST(results);
+    benchExpressionEval(results);
+    benchRingBuffer(results);
+    benchDeviceDecode(results);
+    benchProfileZone(results);
+    benchJsonNumbers(results);
+    benchFileLines(results);
+    benchRestResp(results);
+    benchSettingsUpload(results);
+    benchLocks(results);
+    benchGPIO(results);
+
+    // Output JSON
+    std::string json = results.toJSON();
+    if (argc > 1)
+    {
+        FILE* pFile = fopen(argv[1], "w");
+        if (!pFile)
+        {
+            printf("Failed to open %s\n", argv[1]);
+            return 1;
+        }
+        fprintf(pFile, "%s\n", json.c_str());
+        fclose(pFile);
+        printf("Results written to %s\n", argv[1]);
+    }
+    else
+    {
+        printf("%s\n", json.c_str());
+    }
+    return 0;
+}
@@ -6,6 +6,29 @@
 #include "PlatformUtils.h"
 
 #include "MsgExchangeHookTest.h"
+#include "StateHashTest.h"
+#include "TimeSeriesTest.h"
+#include "SampleTimeTest.h"
+#include "DeviceCmdBinaryTest.h"
+#include "ProfileZonesTest.h"
+#include "BusSerialTest.h"
+#include "RaftJsonNumbersTest.h"
+#include "FileSystemCacheTest.h"
+#include "FileLineReaderTest.h"
+#include "DeviceTypeRecordsTest.h"
+#include "BusTopologyCacheTest.h"
+#include "RestAPIRespSinkTest.h"
+#include "DeviceLoopBudgetTest.h"
+#include "RaftBusStatsTest.h"
+#include "RaftJsonDiffTest.h"
+#include "RaftJsonChunkedDocTest.h"
+#include "RaftThreadingWaitTest.h"
+#include "RaftLockTest.h"
+#include "DebounceButtonTest.h"
+#include "ArduinoGPIOTest.h"
+#include "DNSResolverCacheTest.h"
+#include "StatusIndicatorTest.h"
+#include "RestAPIBodyTest.h"
 
 #include "JSON_test_data_large.h"
 #include "JSON_test_data_small.h"
@@ -343,6 +366,98 @@ int main()
     MsgExchangeHookTest msgExchangeHookTest;
     msgExchangeHookTest.loop();
 
+    // Test state hashing
+    StateHashTest stateHashTest;
+    stateHashTest.loop();
+
+    // Test time-series storage
+    TimeSeriesTest timeSeriesTest;
+    timeSeriesTest.loop();
+
+    // Test poll result sample time alignment
+    SampleTimeTest sampleTimeTest;
+    sampleTimeTest.loop();
+
+    // Test binary device command path
+    DeviceCmdBinaryTest deviceCmdBinaryTest;
+    deviceCmdBinaryTest.loop();
+
+    // Test profiling zones
+    ProfileZonesTest profileZonesTest;
+    profileZonesTest.loop();
+
+    // Test serial bus framing and response matching
+    BusSerialTest busSerialTest;
+    busSerialTest.loop();
+
+    // Test JSON number parsing and formatting
+    RaftJsonNumbersTest raftJsonNumbersTest;
+    raftJsonNumbersTest.loop();
+
+    // Test file contents cache
+    FileSystemCacheTest fileSystemCacheTest;
+    fileSystemCacheTest.loop();
+
+    // Test buffered line reader
+    FileLineReaderTest fileLineReaderTest;
+    fileLineReaderTest.loop();
+
+    // Test compressed device type records
+    DeviceTypeRecordsTest deviceTypeRecordsTest;
+    deviceTypeRecordsTest.loop();
+
+    // Test persisted bus topology
+    BusTopologyCacheTest busTopologyCacheTest;
+    busTopologyCacheTest.loop();
+
+    // Test REST API JSON response building
+    RestAPIRespSinkTest restAPIRespSinkTest;
+    restAPIRespSinkTest.loop();
+
+    // Test device manager loop budgeting
+    DeviceLoopBudgetTest deviceLoopBudgetTest;
+    deviceLoopBudgetTest.loop();
+
+    // Test bus statistics counters and rates
+    RaftBusStatsTest raftBusStatsTest;
+    raftBusStatsTest.loop();
+
+    // Test JSON structural diff and path-scoped change notification
+    RaftJsonDiffTest raftJsonDiffTest;
+    raftJsonDiffTest.loop();
+
+    // Test chunked JSON document validation and assembly
+    RaftJsonChunkedDocTest raftJsonChunkedDocTest;
+    raftJsonChunkedDocTest.loop();
+
+    // Test blocking wait primitives and blocking queue get/put
+    RaftThreadingWaitTest raftThreadingWaitTest;
+    raftThreadingWaitTest.loop();
+
+    // Test reader-writer and adaptive locks
+    RaftLockTest raftLockTest;
+    raftLockTest.loop();
+
+    // Test interrupt-driven button debounce
+    DebounceButtonTest debounceButtonTest;
+    debounceButtonTest.loop();
+
+    // Test multi-pin GPIO access and the simulated GPIO backend
+    ArduinoGPIOTest arduinoGPIOTest;
+    arduinoGPIOTest.loop();
+
+    // Test shared DNS resolver cache
+    DNSResolverCacheTest dnsResolverCacheTest;
+    dnsResolverCacheTest.loop();
+
+    // Test timer-driven status indicator patterns
+    StatusIndicatorTest statusIndicatorTest;
+    statusIndicatorTest.loop();
+
+    // Test REST API request body accumulation and streaming
+    RestAPIBodyTest restAPIBodyTest;
+    restAPIBodyTest.loop();
+
     // Check failCount
     if (failCount > 0)
         printf("testPrimitives FAILED %d tests\n", failCount);
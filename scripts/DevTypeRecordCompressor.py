@@ -0,0 +1,166 @@
+# DevTypeRecordCompressor.py
+# Rob Dobson 2025
+# Compresses device type record strings using the LZ4 block format with a shared dictionary
+# The dictionary is trained on the records themselves (substrings common to many records are
+# placed in the dictionary) so that small records compress well - records are decompressed
+# individually on the device (see RaftLZ4.h) with matches able to refer back into the dictionary
+
+from collections import Counter
+
+class DevTypeRecordCompressor:
+
+    MIN_MATCH = 4
+    MAX_OFFSET = 65535
+    HASH_CHAIN_MAX = 64
+
+    def __init__(self, dict_max_len=1024, dict_seg_len=48):
+        self.dict_max_len = dict_max_len
+        self.dict_seg_len = dict_seg_len
+        self.dictionary = b""
+
+    def train_dictionary(self, samples):
+        """Build a dictionary from segments which occur in the most samples"""
+        # Count the number of samples each k-gram appears in
+        gram_len = 8
+        gram_counts = Counter()
+        for sample in samples:
+            grams = set(sample[i:i+gram_len] for i in range(len(sample) - gram_len + 1))
+            gram_counts.update(grams)
+
+        # Score every segment of every sample by the popularity of the k-grams it contains
+        candidates = {}
+        for sample in samples:
+            for start in range(0, max(1, len(sample) - self.dict_seg_len + 1), 4):
+                seg = sample[start:start+self.dict_seg_len]
+                if seg in candidates:
+                    continue
+                score = 0
+                for i in range(0, len(seg) - gram_len + 1):
+                    count = gram_counts[seg[i:i+gram_len]]
+                    if count > 1:
+                        score += count - 1
+                if score > 0:
+                    candidates[seg] = score
+
+        # Greedily add the best segments which aren't already covered by the dictionary
+        dict_segs = []
+        dict_len = 0
+        covered = set()
+        for seg, score in sorted(candidates.items(), key=lambda item: (-item[1], item[0])):
+            if dict_len + len(seg) > self.dict_max_len:
+                break
+            seg_grams = set(seg[i:i+gram_len] for i in range(len(seg) - gram_len + 1))
+            if len(seg_grams - covered) < len(seg_grams) // 2:
+                continue
+            covered |= seg_grams
+            dict_segs.append(seg)
+            dict_len += len(seg)
+
+        # Most valuable segments last (nearest to the data so offsets are smallest)
+        self.dictionary = b"".join(reversed(dict_segs))
+        return self.dictionary
+
+    def compress(self, data):
+        """Compress data to LZ4 block format using the dictionary as history"""
+        hist = self.dictionary + data
+        start = len(self.dictionary)
+        out = bytearray()
+        chains = {}
+
+        def add_pos(pos):
+            if pos + self.MIN_MATCH <= len(hist):
+                chains.setdefault(hist[pos:pos+self.MIN_MATCH], []).append(pos)
+
+        for pos in range(start):
+            add_pos(pos)
+
+        lit_start = start
+        pos = start
+        while pos < len(hist):
+            best_len = 0
+            best_off = 0
+            key = hist[pos:pos+self.MIN_MATCH]
+            if len(key) == self.MIN_MATCH:
+                for cand in reversed(chains.get(key, [])[-self.HASH_CHAIN_MAX:]):
+                    off = pos - cand
+                    if off > self.MAX_OFFSET:
+                        break
+                    match_len = 0
+                    while pos + match_len < len(hist) and hist[cand + match_len] == hist[pos + match_len]:
+                        match_len += 1
+                    if match_len > best_len:
+                        best_len = match_len
+                        best_off = off
+            if best_len >= self.MIN_MATCH:
+                self._write_sequence(out, hist[lit_start:pos], best_off, best_len)
+                for p in range(pos, pos + best_len):
+                    add_pos(p)
+                pos += best_len
+                lit_start = pos
+            else:
+                add_pos(pos)
+                pos += 1
+
+        # Final literals
+        self._write_sequence(out, hist[lit_start:], 0, 0)
+        return bytes(out)
+
+    def decompress(self, comp, raw_len):
+        """Decompress (used to verify the compressed output)"""
+        out = bytearray(self.dictionary)
+        start = len(out)
+        idx = 0
+        while idx < len(comp):
+            token = comp[idx]
+            idx += 1
+            lit_len = token >> 4
+            if lit_len == 15:
+                while True:
+                    val = comp[idx]
+                    idx += 1
+                    lit_len += val
+                    if val != 255:
+                        break
+            out += comp[idx:idx+lit_len]
+            idx += lit_len
+            if idx >= len(comp):
+                break
+            off = comp[idx] | (comp[idx+1] << 8)
+            idx += 2
+            match_len = token & 0x0f
+            if match_len == 15:
+                while True:
+                    val = comp[idx]
+                    idx += 1
+                    match_len += val
+                    if val != 255:
+                        break
+            match_len += self.MIN_MATCH
+            for _ in range(match_len):
+                out.append(out[-off])
+        result = bytes(out[start:])
+        if len(result) != raw_len:
+            raise ValueError(f"Decompressed length {len(result)} expected {raw_len}")
+        return result
+
+    @staticmethod
+    def _write_len_ext(out, val):
+        while val >= 255:
+            out.append(255)
+            val -= 255
+        out.append(val)
+
+    def _write_sequence(self, out, literals, offset, match_len):
+        lit_len = len(literals)
+        match_code = match_len - self.MIN_MATCH if match_len > 0 else 0
+        token = (min(lit_len, 15) << 4) | min(match_code, 15)
+        out.append(token)
+        if lit_len >= 15:
+            self._write_len_ext(out, lit_len - 15)
+        out += literals
+        if match_len == 0:
+            return
+        out.append(offset & 0xff)
+        out.append(offset >> 8)
+        if match_code >= 15:
+            self._write_len_ext(out, match_code - 15)
@@ -5,6 +5,7 @@ import argparse
 
 from DecodeGenerator import DecodeGenerator
 from MicroPythonGenerator import MicroPythonGenerator
+from DevTypeRecordCompressor import DevTypeRecordCompressor
 
 # ProcessDevTypeJsonToC.py
 # Rob Dobson 2024
@@ -23,6 +24,8 @@ from MicroPythonGenerator import MicroPythonGenerator
 # --POLL_RESULT_RESOLUTION_US - the resolution of the timestamp in the poll result data
 # --DECODE_STRUCT_TIMESTAMP_C_TYPE - the C data type for the timestamp in the decoded data struct
 # --DECODE_STRUCT_TIMESTAMP_RESOLUTION_US - the resolution of the timestamp in the decoded data struct
+# --nocompress - emit detection, init, poll and device info strings uncompressed (by default they are
+#                compressed with a shared dictionary and decompressed on first use by DeviceTypeRecords)
 
 def process_dev_types(json_paths, dev_type_header_path, dev_poll_header_path, gen_options):
     # Remove any leading or trailing square brackets
@@ -152,6 +155,32 @@ def process_dev_types(json_paths, dev_type_header_path, dev_poll_header_path, ge
                 header_file.write(struct_def)
                 header_file.write("\n")
 
+    # Compress the detection, init, poll and device info strings of each record with a shared dictionary
+    # Each record is stored as detectionValues\0initValues\0pollInfo\0devInfoJson\0
+    compress_recs = gen_options.get("compress_recs", False)
+    comp_recs = []
+    if compress_recs:
+        raw_recs = []
+        for dev_type in dev_ident_json['devTypes'].values():
+            dev_info_json_str = json.dumps(dev_type.get("devInfoJson",{}), separators=(',', ':')) if gen_options.get("inc_dev_info_json", False) else ""
+            raw_rec = "\0".join([dev_type.get("detectionValues",""), dev_type.get("initValues",""),
+                        json.dumps(dev_type.get("pollInfo",{}), separators=(',', ':')), dev_info_json_str]) + "\0"
+            raw_recs.append(raw_rec.encode('utf-8'))
+        compressor = DevTypeRecordCompressor()
+        compressor.train_dictionary(raw_recs)
+        for raw_rec in raw_recs:
+            if len(raw_rec) > 0xffff:
+                print(f"Device type record too long to compress {len(raw_rec)} bytes")
+                sys.exit(1)
+            comp_rec = compressor.compress(raw_rec)
+            if compressor.decompress(comp_rec, len(raw_rec)) != raw_rec:
+                print("Compressed record verification failed")
+                sys.exit(1)
+            comp_recs.append((comp_rec, len(raw_rec)))
+        raw_total = sum(len(raw_rec) for raw_rec in raw_recs)
+        comp_total = sum(len(comp_rec) for comp_rec, _ in comp_recs)
+        print(f"Device type records raw {raw_total} bytes compressed {comp_total} bytes + dictionary {len(compressor.dictionary)} bytes")
+
     # Generate dev type header file
     with open(dev_type_header_path, 'w') as header_file:
 
@@ -185,11 +214,18 @@ def process_dev_types(json_paths, dev_type_header_path, dev_poll_header_path, ge
             header_file.write('    {\n')
             header_file.write(f'        R"({dev_type.get("deviceType","")})",\n')
             header_file.write(f'        R"({dev_type.get("addresses","")})",\n')
-            header_file.write(f'        R"({dev_type.get("detectionValues","")})",\n')
-            header_file.write(f'        R"({dev_type.get("initValues","")})",\n')
-            header_file.write(f'        R"({polling_config_json_str})",\n')
+            if compress_recs:
+                header_file.write(f'        nullptr,\n')
+                header_file.write(f'        nullptr,\n')
+                header_file.write(f'        nullptr,\n')
+            else:
+                header_file.write(f'        R"({dev_type.get("detectionValues","")})",\n')
+                header_file.write(f'        R"({dev_type.get("initValues","")})",\n')
+                header_file.write(f'        R"({polling_config_json_str})",\n')
             header_file.write(f'        {str(poll_data_size_bytes)},\n')
-            if gen_options.get("inc_dev_info_json", False):
+            if compress_recs:
+                header_file.write(f'        nullptr')
+            elif gen_options.get("inc_dev_info_json", False):
                 header_file.write(f'        R"({dev_info_json_str})"')
             else:
                 header_file.write(f'        nullptr')
@@ -203,6 +239,19 @@ def process_dev_types(json_paths, dev_type_header_path, dev_poll_header_path, ge
 
         header_file.write('};\n\n')
 
+        # Write compressed record data
+        if compress_recs:
+            header_file.write('#define DEV_TYPE_RECORDS_COMPRESSED\n\n')
+            header_file.write(f'// Compressed records {comp_total} bytes (raw {raw_total} bytes) dictionary {len(compressor.dictionary)} bytes\n')
+            header_file.write(write_c_byte_array('baseDevTypeRecDict', compressor.dictionary))
+            header_file.write(write_c_byte_array('baseDevTypeRecCompData', b"".join(comp_rec for comp_rec, _ in comp_recs)))
+            header_file.write('static const DeviceTypeRecordCompressedLoc baseDevTypeRecCompLocs[] =\n{\n')
+            comp_offset = 0
+            for comp_rec, raw_len in comp_recs:
+                header_file.write(f'    {{{comp_offset}, {len(comp_rec)}, {raw_len}}},\n')
+                comp_offset += len(comp_rec)
+            header_file.write('};\n\n')
+
         # Write constants for the min and max values of array index
         header_file.write(f'static const uint32_t BASE_DEV_INDEX_BY_ARRAY_MIN_ADDR = 0;\n')
         header_file.write(f'static const uint32_t BASE_DEV_INDEX_BY_ARRAY_MAX_ADDR = 0x77;\n\n')
@@ -279,6 +328,13 @@ def process_dev_types(json_paths, dev_type_header_path, dev_poll_header_path, ge
     if micropython_generator:
         generate_micropython_files(dev_ident_json['devTypes'], micropython_generator, gen_options)
 
+def write_c_byte_array(var_name, data):
+    lines = [f'static const uint8_t {var_name}[] =\n{{\n']
+    for i in range(0, len(data), 24):
+        lines.append('    ' + ''.join(f'0x{b:02x},' for b in data[i:i+24]) + '\n')
+    lines.append('};\n\n')
+    return ''.join(lines)
+
 def generate_micropython_files(dev_type_records, micropython_generator, gen_options):
     """Generate all MicroPython support files in separate function"""
     
@@ -316,6 +372,8 @@ if __name__ == "__main__":
     argparse.add_argument("--decodestructtsresus", help="Decoded struct timestamp resolution in us", type=int, default=1000)
     # Arg for decoded timestamp variable name
     argparse.add_argument("--decodestructtsvar", help="Decoded struct timestamp variable name", default="")
+    # Arg to disable compression of device type record strings
+    argparse.add_argument("--nocompress", help="Don't compress device type record strings", action="store_true")
     
     # MicroPython generation arguments
     argparse.add_argument("--gen-micropython", help="Generate MicroPython support files", action="store_true")
@@ -335,6 +393,7 @@ if __name__ == "__main__":
         "DECODE_STRUCT_TIMESTAMP_C_TYPE": args.decodestructtsctype,
         "DECODE_STRUCT_TIMESTAMP_RESOLUTION_US": args.decodestructtsresus,
         "struct_time_var_name": args.decodestructtsvar,
+        "compress_recs": not args.nocompress,
         # MicroPython options
         "generate_micropython": args.gen_micropython,
         "mp_qstr_header": args.mp_qstr_header,
@@ -1,7 +1,13 @@
-
 #pragma once
 
+#ifdef ESP_PLATFORM
 #include "esp_system.h"
 #define EVAL_PERF_START(SVar) uint64_t SVar ## _us1 = micros(); uint32_t SVar ## _mem1 = esp_get_free_heap_size();
 #define EVAL_PERF_END(SVar) uint32_t SVar ## _us = uint32_t(micros() - SVar ## _us1); uint32_t SVar ## _mem = (SVar ## _mem1 - esp_get_free_heap_size());
+#else
+// Linux - heap usage is tracked by the operator new/delete hooks in linux_unit_tests/PerfAllocHooks.cpp
+#include "PerfBench.h"
+#define EVAL_PERF_START(SVar) uint64_t SVar ## _us1 = PerfBenchResults::timeNowNs() / 1000; int64_t SVar ## _mem1 = PerfAllocStats::bytesInUse;
+#define EVAL_PERF_END(SVar) uint32_t SVar ## _us = uint32_t(PerfBenchResults::timeNowNs() / 1000 - SVar ## _us1); uint32_t SVar ## _mem = uint32_t(PerfAllocStats::bytesInUse - SVar ## _mem1);
+#endif
 #define EVAL_PERF_LOG(SVar, SStr, NLoops) LOG_I(MODULE_PREFIX, "%s: %u us %u bytes", SStr, SVar ## _us / NLoops, SVar ## _mem);
@@ -503,3 +503,60 @@ TEST_CASE("Builtins test", "[expressions]")
         TEST_ASSERT_EQUAL_DOUBLE_MESSAGE(expectedVal, actualVal, tests[i].builtinFnExpr);
     }
 }
+
+static double incrementalCallCount = 0;
+static double testCallCounter()
+{
+    return incrementalCallCount++;
+}
+
+static const char* testTrajIncremental =
+R"(
+    a = x * 2
+    b = y + 1
+    c = a + b
+    acc = acc + c
+    cnt = counter()
+)"
+;
+
+TEST_CASE("Expression incremental evaluation", "[expressions]")
+{
+    // Set values
+    evaluator.clear();
+    evaluator.addVariables(R"({"x":1,"y":2,"acc":0})", false);
+    evaluator.addFunction("counter", testCallCounter);
+    uint32_t errorLine = 0;
+    TEST_ASSERT_TRUE(evaluator.addExpressions(testTrajIncremental, errorLine));
+
+    // First evaluation evaluates all statements
+    uint32_t numEvaluated = 0, numSkipped = 0;
+    evaluator.evalStatements("");
+    evaluator.getEvalStats(numEvaluated, numSkipped);
+    TEST_ASSERT_EQUAL_UINT32(5, numEvaluated);
+    TEST_ASSERT_TRUE(checkVal(evaluator, "c", 5));
+    TEST_ASSERT_TRUE(checkVal(evaluator, "acc", 5));
+
+    // Nothing changed - only the self-referencing accumulator and the custom function are evaluated
+    evaluator.evalStatements("");
+    evaluator.getEvalStats(numEvaluated, numSkipped);
+    TEST_ASSERT_EQUAL_UINT32(2, numEvaluated);
+    TEST_ASSERT_EQUAL_UINT32(3, numSkipped);
+    TEST_ASSERT_TRUE(checkVal(evaluator, "acc", 10));
+    TEST_ASSERT_TRUE(checkVal(evaluator, "cnt", 1));
+
+    // Change an input - only dependent statements are evaluated
+    evaluator.addVariable("y", 5);
+    evaluator.evalStatements("");
+    evaluator.getEvalStats(numEvaluated, numSkipped);
+    TEST_ASSERT_EQUAL_UINT32(4, numEvaluated);
+    TEST_ASSERT_TRUE(checkVal(evaluator, "b", 6));
+    TEST_ASSERT_TRUE(checkVal(evaluator, "c", 8));
+    TEST_ASSERT_TRUE(checkVal(evaluator, "acc", 18));
+
+    // An assigned variable set externally is restored on the next evaluation
+    evaluator.addVariable("a", 100);
+    evaluator.evalStatements("");
+    TEST_ASSERT_TRUE(checkVal(evaluator, "a", 2));
+    TEST_ASSERT_TRUE(checkVal(evaluator, "c", 8));
+}